@@ -161,6 +161,17 @@
 #define RIPPLE_TRACK_MUTEXES 0
 #endif
 
+/** Config: RIPPLE_PROFILE_MUTEXES
+    Turns on a feature that measures the wait time, hold time and number of
+    acquisitions for mutex and recursive mutex objects at every lock site.
+    The results are available through the lock_profile RPC command. This
+    affects the type of lock used by RippleMutex and RippleRecursiveMutex,
+    and is ignored if RIPPLE_TRACK_MUTEXES is on.
+*/
+#ifndef RIPPLE_PROFILE_MUTEXES
+#define RIPPLE_PROFILE_MUTEXES 0
+#endif
+
 //------------------------------------------------------------------------------
 
 // These control whether or not certain functionality gets
@@ -199,4 +210,10 @@
 #define  RIPPLE_USE_RPC_SERVICE_MANAGER 0
 #endif
 
+// Controls whether signatures are verified by the built in secp256k1
+// code instead of OpenSSL. Signatures it cannot parse still go to OpenSSL.
+#ifndef RIPPLE_USE_SECP256K1_VERIFY
+#define RIPPLE_USE_SECP256K1_VERIFY 1
+#endif
+
 #endif
@@ -26,10 +26,14 @@
 #include "insight/EventImpl.h"
 #include "insight/Gauge.h"
 #include "insight/GaugeImpl.h"
+#include "insight/Histogram.h"
+#include "insight/HistogramBuckets.h"
+#include "insight/HistogramImpl.h"
 #include "insight/Hook.h"
 #include "insight/HookImpl.h"
 #include "insight/Collector.h"
 #include "insight/NullCollector.h"
 #include "insight/StatsDCollector.h"
+#include "insight/TextCollector.h"
 
 #endif
@@ -26,6 +26,7 @@
 #include "Counter.h"
 #include "Event.h"
 #include "Gauge.h"
+#include "Histogram.h"
 #include "Hook.h"
 #include "Meter.h"
 
@@ -39,8 +40,8 @@ namespace insight {
     as desired (counters, events, gauges, meters, and an optional hook)
     using the interface.
 
-    @see Counter, Event, Gauge, Hook, Meter
-    @see NullCollector, StatsDCollector
+    @see Counter, Event, Gauge, Histogram, Hook, Meter
+    @see NullCollector, StatsDCollector, TextCollector
 */
 class Collector
 {
@@ -84,6 +85,11 @@ public:
     */
     virtual Gauge make_gauge (std::string const& name) = 0;
 
+    /** Create a histogram with the specified name.
+        @see Histogram
+    */
+    virtual Histogram make_histogram (std::string const& name) = 0;
+
     /** Create a meter with the specified name.
         @see Meter
     */
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2013, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_INSIGHT_HISTOGRAM_H_INCLUDED
+#define BEAST_INSIGHT_HISTOGRAM_H_INCLUDED
+
+#include "HistogramImpl.h"
+
+#include "../stl/shared_ptr.h"
+
+namespace beast {
+namespace insight {
+
+/** A metric for reporting the distribution of a value.
+
+    A histogram counts each recorded value, typically a latency, and reports
+    the count, the sum, and percentiles. Unlike an event, recording a value
+    only increments a counter belonging to the calling thread, so it is
+    cheap enough to call on every pass through a hot path.
+
+    This is a lightweight reference wrapper which is cheap to copy and assign.
+    When the last reference goes away, the metric is no longer collected.
+*/
+class Histogram
+{
+public:
+    typedef HistogramImpl::value_type value_type;
+
+    /** Create a null metric.
+        A null metric reports no information.
+    */
+    Histogram ()
+    {
+    }
+
+    /** Create the metric reference the specified implementation.
+        Normally this won't be called directly. Instead, call the appropriate
+        factory function in the Collector interface.
+        @see Collector.
+    */
+    explicit Histogram (shared_ptr <HistogramImpl> const& impl)
+        : m_impl (impl)
+    {
+    }
+
+    /** Record a value.
+        The value is typically an elapsed time in milliseconds or
+        microseconds, or any other domain specific value.
+    */
+    void record (value_type value) const
+    {
+        if (m_impl)
+            m_impl->record (value);
+    }
+
+private:
+    shared_ptr <HistogramImpl> m_impl;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2013, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_INSIGHT_HISTOGRAMBUCKETS_H_INCLUDED
+#define BEAST_INSIGHT_HISTOGRAMBUCKETS_H_INCLUDED
+
+#include "../Atomic.h"
+#include "../Uncopyable.h"
+
+#include <vector>
+
+namespace beast {
+namespace insight {
+
+/** Lock-free counts of the values recorded in a histogram.
+
+    Values below 16 each have their own bucket. Above that, every power of
+    two is split into eight buckets, so a bucket never spans more than an
+    eighth of its lower bound.
+
+    Each thread counts into its own set of buckets, chosen by thread id and
+    allocated the first time the thread records a value. Recording never
+    takes a lock or waits on a reader. Readers add up the sets, so a
+    snapshot taken while values are being recorded may be slightly behind.
+
+    Collectors use this to implement HistogramImpl.
+*/
+class HistogramBuckets : public Uncopyable
+{
+public:
+    typedef uint64 value_type;
+
+    enum
+    {
+        exactBuckets = 16,
+        subBuckets = 8,
+        bucketCount = exactBuckets + (64 - 4) * subBuckets,
+
+        // The most sets of buckets. Threads share sets beyond this.
+        maxShards = 16
+    };
+
+    /** The totals over all threads. */
+    struct Snapshot
+    {
+        Snapshot ();
+
+        /** Returns an upper bound on the given fraction of the values.
+            For example, percentile (0.99) is a value which 99% of the
+            recorded values are less than or equal to.
+        */
+        value_type percentile (double fraction) const;
+
+        /** Returns what was recorded after an earlier snapshot was taken.
+            The maximum is bounded by the largest non-empty bucket.
+        */
+        Snapshot since (Snapshot const& earlier) const;
+
+        uint64 count;
+        uint64 sum;
+        value_type max;
+        std::vector <uint64> buckets;
+    };
+
+    HistogramBuckets ();
+    ~HistogramBuckets ();
+
+    /** Count a value. This may be called from any thread. */
+    void record (value_type value);
+
+    /** Returns the totals of everything recorded so far. */
+    Snapshot snapshot () const;
+
+    /** Returns the bucket which counts a value. */
+    static int bucketIndex (value_type value);
+
+    /** Returns the largest value counted by a bucket. */
+    static value_type bucketLimit (int index);
+
+private:
+    struct Shard
+    {
+        Atomic <int64> counts [bucketCount];
+        Atomic <int64> sum;
+        Atomic <int64> max;
+    };
+
+    Shard& getShard ();
+
+    Atomic <Shard*> m_shards [maxShards];
+};
+
+}
+}
+
+#endif
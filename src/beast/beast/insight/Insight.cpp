@@ -26,7 +26,9 @@
 #include "../Insight.h"
 
 #include "impl/Collector.cpp"
+#include "impl/HistogramBuckets.cpp"
 #include "impl/Hook.cpp"
 #include "impl/Metric.cpp"
 #include "impl/NullCollector.cpp"
 #include "impl/StatsDCollector.cpp"
+#include "impl/TextCollector.cpp"
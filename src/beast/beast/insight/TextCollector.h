@@ -0,0 +1,53 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2013, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_INSIGHT_TEXTCOLLECTOR_H_INCLUDED
+#define BEAST_INSIGHT_TEXTCOLLECTOR_H_INCLUDED
+
+#include "Collector.h"
+
+namespace beast {
+namespace insight {
+
+/** A Collector that keeps metrics in memory and reports them as text.
+
+    The text is in the Prometheus exposition format, so the server which
+    owns the collector can hand it to any HTTP client that scrapes it.
+    Meters are reported as counters, counters and gauges as gauges, and
+    events and histograms as summaries with the 50th, 90th and 99th
+    percentiles. Metrics which share a name are added together.
+
+    Hooks and handlers are called each time the text is produced.
+*/
+class TextCollector : public Collector
+{
+public:
+    /** Create a text collector.
+        @param prefix A string pre-pended before each metric name.
+    */
+    static shared_ptr <TextCollector> New (std::string const& prefix);
+
+    /** Returns the current value of every metric. */
+    virtual std::string text () = 0;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2013, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace beast {
+namespace insight {
+
+HistogramBuckets::Snapshot::Snapshot ()
+    : count (0)
+    , sum (0)
+    , max (0)
+    , buckets (bucketCount, 0)
+{
+}
+
+HistogramBuckets::value_type HistogramBuckets::Snapshot::percentile (
+    double fraction) const
+{
+    if (count == 0)
+        return 0;
+
+    uint64 rank (static_cast <uint64> (fraction * count + 0.5));
+
+    if (rank < 1)
+        rank = 1;
+    else if (rank > count)
+        rank = count;
+
+    uint64 seen (0);
+
+    for (int i = 0; i < bucketCount; ++i)
+    {
+        seen += buckets [i];
+
+        if (seen >= rank)
+            return std::min (bucketLimit (i), max);
+    }
+
+    return max;
+}
+
+HistogramBuckets::Snapshot HistogramBuckets::Snapshot::since (
+    Snapshot const& earlier) const
+{
+    Snapshot result;
+
+    result.count = count - earlier.count;
+    result.sum = sum - earlier.sum;
+
+    for (int i = 0; i < bucketCount; ++i)
+    {
+        result.buckets [i] = buckets [i] - earlier.buckets [i];
+
+        if (result.buckets [i] != 0)
+            result.max = std::min (bucketLimit (i), max);
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+HistogramBuckets::HistogramBuckets ()
+{
+}
+
+HistogramBuckets::~HistogramBuckets ()
+{
+    for (int i = 0; i < maxShards; ++i)
+        delete m_shards [i].get ();
+}
+
+void HistogramBuckets::record (value_type value)
+{
+    Shard& shard (getShard ());
+
+    ++shard.counts [bucketIndex (value)];
+    shard.sum += static_cast <int64> (value);
+
+    for (int64 max (shard.max.get ()); static_cast <value_type> (max) < value;
+        max = shard.max.get ())
+    {
+        if (shard.max.compareAndSetBool (static_cast <int64> (value), max))
+            break;
+    }
+}
+
+HistogramBuckets::Snapshot HistogramBuckets::snapshot () const
+{
+    Snapshot result;
+
+    for (int i = 0; i < maxShards; ++i)
+    {
+        Shard const* const shard (m_shards [i].get ());
+
+        if (shard == nullptr)
+            continue;
+
+        for (int j = 0; j < bucketCount; ++j)
+        {
+            uint64 const n (shard->counts [j].get ());
+            result.buckets [j] += n;
+            result.count += n;
+        }
+
+        result.sum += static_cast <uint64> (shard->sum.get ());
+        result.max = std::max (result.max,
+            static_cast <value_type> (shard->max.get ()));
+    }
+
+    return result;
+}
+
+int HistogramBuckets::bucketIndex (value_type value)
+{
+    if (value < exactBuckets)
+        return static_cast <int> (value);
+
+    // Position of the highest set bit
+    int log2 (0);
+    for (int shift = 32; shift > 0; shift /= 2)
+    {
+        if ((value >> (log2 + shift)) != 0)
+            log2 += shift;
+    }
+
+    int const sub (static_cast <int> ((value >> (log2 - 3)) & (subBuckets - 1)));
+
+    return exactBuckets + (log2 - 4) * subBuckets + sub;
+}
+
+HistogramBuckets::value_type HistogramBuckets::bucketLimit (int index)
+{
+    if (index < exactBuckets)
+        return static_cast <value_type> (index);
+
+    int const log2 (4 + (index - exactBuckets) / subBuckets);
+    value_type const sub ((index - exactBuckets) % subBuckets);
+    value_type const lower ((subBuckets + sub) << (log2 - 3));
+
+    return lower + ((value_type (1) << (log2 - 3)) - 1);
+}
+
+HistogramBuckets::Shard& HistogramBuckets::getShard ()
+{
+    // Thread ids are usually aligned addresses, so mix the bits
+    uint64 const id (reinterpret_cast <std::size_t> (Thread::getCurrentThreadId ()));
+    int const index (static_cast <int> (
+        ((id * 0x9E3779B97F4A7C15ULL) >> 32) % maxShards));
+
+    Shard* shard (m_shards [index].get ());
+
+    if (shard == nullptr)
+    {
+        Shard* const fresh (new Shard);
+
+        if (m_shards [index].compareAndSetBool (fresh, nullptr))
+            shard = fresh;
+        else
+        {
+            delete fresh;
+            shard = m_shards [index].get ();
+        }
+    }
+
+    return *shard;
+}
+
+//------------------------------------------------------------------------------
+
+class HistogramBucketsTests : public UnitTest
+{
+public:
+    HistogramBucketsTests () : UnitTest ("HistogramBuckets", "beast")
+    {
+    }
+
+    void testIndex ()
+    {
+        beginTestCase ("index");
+
+        bool ok (true);
+        int last (-1);
+
+        for (int shift = 0; shift < 64; ++shift)
+        {
+            for (int offset = -1; offset <= 1; ++offset)
+            {
+                uint64 const value ((uint64 (1) << shift) + offset);
+                int const index (HistogramBuckets::bucketIndex (value));
+
+                // Every value is within its bucket, and close to the limit
+                if (index < 0 || index >= HistogramBuckets::bucketCount ||
+                    HistogramBuckets::bucketLimit (index) < value ||
+                    (index > 0 && HistogramBuckets::bucketLimit (index - 1) >= value) ||
+                    HistogramBuckets::bucketLimit (index) - value > value / 8)
+                {
+                    ok = false;
+                }
+            }
+
+            int const index (HistogramBuckets::bucketIndex (uint64 (1) << shift));
+            if (index < last)
+                ok = false;
+            last = index;
+        }
+
+        expect (HistogramBuckets::bucketIndex (~uint64 (0)) ==
+            HistogramBuckets::bucketCount - 1);
+        expect (HistogramBuckets::bucketLimit (
+            HistogramBuckets::bucketCount - 1) == ~uint64 (0));
+        expect (ok, "Bucket bounds are wrong");
+    }
+
+    void testPercentile ()
+    {
+        beginTestCase ("percentile");
+
+        HistogramBuckets h;
+
+        for (uint64 i = 1; i <= 1000; ++i)
+            h.record (i);
+
+        HistogramBuckets::Snapshot const s (h.snapshot ());
+
+        expect (s.count == 1000);
+        expect (s.sum == 500500);
+        expect (s.max == 1000);
+        expect (s.percentile (1.0) == 1000);
+
+        uint64 const median (s.percentile (0.5));
+        expect (median >= 500 && median <= 500 + 500 / 8, "Median is out of range");
+
+        uint64 const p99 (s.percentile (0.99));
+        expect (p99 >= 990 && p99 <= 1000, "99th percentile is out of range");
+    }
+
+    void runTest ()
+    {
+        testIndex ();
+        testPercentile ();
+    }
+};
+
+static HistogramBucketsTests histogramBucketsTests;
+
+}
+}
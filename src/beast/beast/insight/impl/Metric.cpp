@@ -32,6 +32,10 @@ GaugeImpl::~GaugeImpl ()
 {
 }
 
+HistogramImpl::~HistogramImpl ()
+{
+}
+
 MeterImpl::~MeterImpl ()
 {
 }
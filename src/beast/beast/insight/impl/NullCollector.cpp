@@ -81,6 +81,19 @@ private:
 
 //------------------------------------------------------------------------------
 
+class NullHistogramImpl : public HistogramImpl
+{
+public:
+    void record (value_type)
+    {
+    }
+
+private:
+    NullHistogramImpl& operator= (NullHistogramImpl const&);
+};
+
+//------------------------------------------------------------------------------
+
 class NullMeterImpl : public MeterImpl
 {
 public:
@@ -129,6 +142,11 @@ public:
     {
         return Gauge (make_shared <detail::NullGaugeImpl> ());
     }
+
+    Histogram make_histogram (std::string const&)
+    {
+        return Histogram (make_shared <detail::NullHistogramImpl> ());
+    }
     
     Meter make_meter (std::string const&)
     {
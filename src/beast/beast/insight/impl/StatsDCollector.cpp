@@ -156,6 +156,31 @@ private:
 
 //------------------------------------------------------------------------------
 
+class StatsDHistogramImpl
+    : public HistogramImpl
+    , public StatsDMetricBase
+{
+public:
+    StatsDHistogramImpl (std::string const& name,
+        beast::shared_ptr <StatsDCollectorImp> const& impl);
+
+    ~StatsDHistogramImpl ();
+
+    void record (HistogramImpl::value_type value);
+
+    void do_process ();
+
+private:
+    StatsDHistogramImpl& operator= (StatsDHistogramImpl const&);
+
+    beast::shared_ptr <StatsDCollectorImp> m_impl;
+    std::string m_name;
+    HistogramBuckets m_buckets;
+    HistogramBuckets::Snapshot m_last;
+};
+
+//------------------------------------------------------------------------------
+
 class StatsDMeterImpl
     : public MeterImpl
     , public StatsDMetricBase
@@ -281,6 +306,12 @@ public:
             name, shared_from_this ()));
     }
 
+    Histogram make_histogram (std::string const& name)
+    {
+        return Histogram (beast::make_shared <detail::StatsDHistogramImpl> (
+            name, shared_from_this ()));
+    }
+
     Meter make_meter (std::string const& name)
     {
         return Meter (beast::make_shared <detail::StatsDMeterImpl> (
@@ -641,6 +672,47 @@ void StatsDGaugeImpl::do_process ()
 
 //------------------------------------------------------------------------------
 
+StatsDHistogramImpl::StatsDHistogramImpl (std::string const& name,
+    beast::shared_ptr <StatsDCollectorImp> const& impl)
+    : m_impl (impl)
+    , m_name (name)
+{
+    m_impl->add (*this);
+}
+
+StatsDHistogramImpl::~StatsDHistogramImpl ()
+{
+    m_impl->remove (*this);
+}
+
+void StatsDHistogramImpl::record (HistogramImpl::value_type value)
+{
+    // Counted in place, the timer sends the percentiles
+    m_buckets.record (value);
+}
+
+void StatsDHistogramImpl::do_process ()
+{
+    HistogramBuckets::Snapshot const current (m_buckets.snapshot ());
+    HistogramBuckets::Snapshot const interval (current.since (m_last));
+    m_last = current;
+
+    if (interval.count == 0)
+        return;
+
+    std::string const name (m_impl->prefix() + "." + m_name);
+    std::stringstream ss;
+    ss <<
+        name << ".count:" << interval.count << "|c" << "\n" <<
+        name << ".p50:" << interval.percentile (0.50) << "|g" << "\n" <<
+        name << ".p90:" << interval.percentile (0.90) << "|g" << "\n" <<
+        name << ".p99:" << interval.percentile (0.99) << "|g" << "\n" <<
+        name << ".max:" << interval.max << "|g" << "\n";
+    m_impl->post_buffer (ss.str ());
+}
+
+//------------------------------------------------------------------------------
+
 StatsDMeterImpl::StatsDMeterImpl (std::string const& name,
     beast::shared_ptr <StatsDCollectorImp> const& impl)
     : m_impl (impl)
@@ -0,0 +1,659 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2013, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "../../threads/SharedData.h"
+
+#include <map>
+#include <sstream>
+
+namespace beast {
+namespace insight {
+
+namespace detail {
+
+class TextCollectorImp;
+
+//------------------------------------------------------------------------------
+
+/** The value of one name, added up over the metrics which share it. */
+struct TextMetricValue
+{
+    enum Kind
+    {
+        counter,
+        gauge,
+        summary
+    };
+
+    TextMetricValue ()
+        : kind (gauge)
+        , value (0)
+    {
+    }
+
+    Kind kind;
+    int64 value;
+    HistogramBuckets::Snapshot snapshot;
+};
+
+typedef std::map <std::string, TextMetricValue> TextMetricValues;
+
+//------------------------------------------------------------------------------
+
+class TextMetricBase : public List <TextMetricBase>::Node
+{
+public:
+    virtual void do_process () = 0;
+    virtual void do_report (TextMetricValues& values) = 0;
+};
+
+//------------------------------------------------------------------------------
+
+class TextHookImpl
+    : public HookImpl
+    , public TextMetricBase
+{
+public:
+    TextHookImpl (HandlerType const& handler,
+        beast::shared_ptr <TextCollectorImp> const& impl);
+
+    ~TextHookImpl ();
+
+    void do_process ();
+    void do_report (TextMetricValues&);
+
+private:
+    TextHookImpl& operator= (TextHookImpl const&);
+
+    beast::shared_ptr <TextCollectorImp> m_impl;
+    HandlerType m_handler;
+};
+
+//------------------------------------------------------------------------------
+
+class TextCounterImpl
+    : public CounterImpl
+    , public TextMetricBase
+{
+public:
+    TextCounterImpl (std::string const& name,
+        beast::shared_ptr <TextCollectorImp> const& impl);
+
+    ~TextCounterImpl ();
+
+    void increment (CounterImpl::value_type amount);
+    void set_handler (HandlerType const& handler);
+
+    void do_process ();
+    void do_report (TextMetricValues& values);
+
+private:
+    TextCounterImpl& operator= (TextCounterImpl const&);
+
+    beast::shared_ptr <TextCollectorImp> m_impl;
+    std::string m_name;
+    Atomic <int64> m_value;
+    HandlerType m_handler;
+};
+
+//------------------------------------------------------------------------------
+
+class TextEventImpl
+    : public EventImpl
+    , public TextMetricBase
+{
+public:
+    TextEventImpl (std::string const& name,
+        beast::shared_ptr <TextCollectorImp> const& impl);
+
+    ~TextEventImpl ();
+
+    void notify (EventImpl::value_type value);
+
+    void do_process ();
+    void do_report (TextMetricValues& values);
+
+private:
+    TextEventImpl& operator= (TextEventImpl const&);
+
+    beast::shared_ptr <TextCollectorImp> m_impl;
+    std::string m_name;
+    HistogramBuckets m_buckets;
+};
+
+//------------------------------------------------------------------------------
+
+class TextHistogramImpl
+    : public HistogramImpl
+    , public TextMetricBase
+{
+public:
+    TextHistogramImpl (std::string const& name,
+        beast::shared_ptr <TextCollectorImp> const& impl);
+
+    ~TextHistogramImpl ();
+
+    void record (HistogramImpl::value_type value);
+
+    void do_process ();
+    void do_report (TextMetricValues& values);
+
+private:
+    TextHistogramImpl& operator= (TextHistogramImpl const&);
+
+    beast::shared_ptr <TextCollectorImp> m_impl;
+    std::string m_name;
+    HistogramBuckets m_buckets;
+};
+
+//------------------------------------------------------------------------------
+
+class TextGaugeImpl
+    : public GaugeImpl
+    , public TextMetricBase
+{
+public:
+    TextGaugeImpl (std::string const& name,
+        beast::shared_ptr <TextCollectorImp> const& impl);
+
+    ~TextGaugeImpl ();
+
+    void set (GaugeImpl::value_type value);
+    void increment (GaugeImpl::difference_type amount);
+    void set_handler (HandlerType const& handler);
+
+    void do_process ();
+    void do_report (TextMetricValues& values);
+
+private:
+    TextGaugeImpl& operator= (TextGaugeImpl const&);
+
+    beast::shared_ptr <TextCollectorImp> m_impl;
+    std::string m_name;
+    Atomic <int64> m_value;
+    HandlerType m_handler;
+};
+
+//------------------------------------------------------------------------------
+
+class TextMeterImpl
+    : public MeterImpl
+    , public TextMetricBase
+{
+public:
+    TextMeterImpl (std::string const& name,
+        beast::shared_ptr <TextCollectorImp> const& impl);
+
+    ~TextMeterImpl ();
+
+    void increment (MeterImpl::value_type amount);
+    void set_handler (HandlerType const& handler);
+
+    void do_process ();
+    void do_report (TextMetricValues& values);
+
+private:
+    TextMeterImpl& operator= (TextMeterImpl const&);
+
+    beast::shared_ptr <TextCollectorImp> m_impl;
+    std::string m_name;
+    Atomic <int64> m_value;
+    HandlerType m_handler;
+};
+
+//------------------------------------------------------------------------------
+
+class TextCollectorImp
+    : public TextCollector
+    , public beast::enable_shared_from_this <TextCollectorImp>
+{
+private:
+    struct StateType
+    {
+        List <TextMetricBase> metrics;
+    };
+
+    typedef SharedData <StateType> State;
+
+    std::string m_prefix;
+    State m_state;
+
+public:
+    explicit TextCollectorImp (std::string const& prefix)
+        : m_prefix (prefix)
+    {
+    }
+
+    ~TextCollectorImp ()
+    {
+    }
+
+    Hook make_hook (HookImpl::HandlerType const& handler)
+    {
+        return Hook (beast::make_shared <detail::TextHookImpl> (
+            handler, shared_from_this ()));
+    }
+
+    Counter make_counter (std::string const& name)
+    {
+        return Counter (beast::make_shared <detail::TextCounterImpl> (
+            name, shared_from_this ()));
+    }
+
+    Event make_event (std::string const& name)
+    {
+        return Event (beast::make_shared <detail::TextEventImpl> (
+            name, shared_from_this ()));
+    }
+
+    Gauge make_gauge (std::string const& name)
+    {
+        return Gauge (beast::make_shared <detail::TextGaugeImpl> (
+            name, shared_from_this ()));
+    }
+
+    Histogram make_histogram (std::string const& name)
+    {
+        return Histogram (beast::make_shared <detail::TextHistogramImpl> (
+            name, shared_from_this ()));
+    }
+
+    Meter make_meter (std::string const& name)
+    {
+        return Meter (beast::make_shared <detail::TextMeterImpl> (
+            name, shared_from_this ()));
+    }
+
+    //--------------------------------------------------------------------------
+
+    void add (TextMetricBase& metric)
+    {
+        State::Access state (m_state);
+        state->metrics.push_back (metric);
+    }
+
+    void remove (TextMetricBase& metric)
+    {
+        State::Access state (m_state);
+        state->metrics.erase (state->metrics.iterator_to (metric));
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Metric names may only contain letters, digits, underscores and colons
+    std::string sanitize (std::string const& name) const
+    {
+        std::string result (m_prefix.empty () ? name : m_prefix + "_" + name);
+
+        for (std::size_t i = 0; i < result.size (); ++i)
+        {
+            char const c (result [i]);
+            if (! ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                (c >= '0' && c <= '9') || c == '_' || c == ':'))
+                result [i] = '_';
+        }
+
+        if (result.empty () || (result [0] >= '0' && result [0] <= '9'))
+            result.insert (result.begin (), '_');
+
+        return result;
+    }
+
+    std::string text ()
+    {
+        TextMetricValues values;
+
+        {
+            State::Access state (m_state);
+
+            for (List <TextMetricBase>::iterator iter (state->metrics.begin());
+                iter != state->metrics.end(); ++iter)
+                iter->do_process ();
+
+            for (List <TextMetricBase>::iterator iter (state->metrics.begin());
+                iter != state->metrics.end(); ++iter)
+                iter->do_report (values);
+        }
+
+        std::stringstream ss;
+
+        for (TextMetricValues::const_iterator iter (values.begin());
+            iter != values.end(); ++iter)
+        {
+            std::string const name (sanitize (iter->first));
+            TextMetricValue const& value (iter->second);
+
+            switch (value.kind)
+            {
+            case TextMetricValue::counter:
+                ss <<
+                    "# TYPE " << name << " counter\n" <<
+                    name << " " << value.value << "\n";
+                break;
+
+            case TextMetricValue::gauge:
+                ss <<
+                    "# TYPE " << name << " gauge\n" <<
+                    name << " " << value.value << "\n";
+                break;
+
+            case TextMetricValue::summary:
+                ss <<
+                    "# TYPE " << name << " summary\n" <<
+                    name << "{quantile=\"0.5\"} " <<
+                        value.snapshot.percentile (0.50) << "\n" <<
+                    name << "{quantile=\"0.9\"} " <<
+                        value.snapshot.percentile (0.90) << "\n" <<
+                    name << "{quantile=\"0.99\"} " <<
+                        value.snapshot.percentile (0.99) << "\n" <<
+                    name << "_sum " << value.snapshot.sum << "\n" <<
+                    name << "_count " << value.snapshot.count << "\n";
+                break;
+            }
+        }
+
+        return ss.str ();
+    }
+};
+
+//------------------------------------------------------------------------------
+
+TextHookImpl::TextHookImpl (HandlerType const& handler,
+    beast::shared_ptr <TextCollectorImp> const& impl)
+    : m_impl (impl)
+    , m_handler (handler)
+{
+    m_impl->add (*this);
+}
+
+TextHookImpl::~TextHookImpl ()
+{
+    m_impl->remove (*this);
+}
+
+void TextHookImpl::do_process ()
+{
+    m_handler ();
+}
+
+void TextHookImpl::do_report (TextMetricValues&)
+{
+}
+
+//------------------------------------------------------------------------------
+
+TextCounterImpl::TextCounterImpl (std::string const& name,
+    beast::shared_ptr <TextCollectorImp> const& impl)
+    : m_impl (impl)
+    , m_name (name)
+{
+    m_impl->add (*this);
+}
+
+TextCounterImpl::~TextCounterImpl ()
+{
+    m_impl->remove (*this);
+}
+
+void TextCounterImpl::increment (CounterImpl::value_type amount)
+{
+    m_value += amount;
+}
+
+void TextCounterImpl::set_handler (HandlerType const& handler)
+{
+    m_handler = handler;
+}
+
+void TextCounterImpl::do_process ()
+{
+    if (m_handler)
+        m_handler (Counter (shared_from_this ()));
+}
+
+void TextCounterImpl::do_report (TextMetricValues& values)
+{
+    TextMetricValue& value (values [m_name]);
+    value.kind = TextMetricValue::counter;
+    value.value += m_value.get ();
+}
+
+//------------------------------------------------------------------------------
+
+// Events are reported the same way as histograms
+static void report_summary (TextMetricValues& values,
+    std::string const& name, HistogramBuckets const& buckets)
+{
+    HistogramBuckets::Snapshot const snapshot (buckets.snapshot ());
+    TextMetricValue& value (values [name]);
+    value.kind = TextMetricValue::summary;
+    value.snapshot.count += snapshot.count;
+    value.snapshot.sum += snapshot.sum;
+    value.snapshot.max = std::max (value.snapshot.max, snapshot.max);
+    for (int i = 0; i < HistogramBuckets::bucketCount; ++i)
+        value.snapshot.buckets [i] += snapshot.buckets [i];
+}
+
+TextEventImpl::TextEventImpl (std::string const& name,
+    beast::shared_ptr <TextCollectorImp> const& impl)
+    : m_impl (impl)
+    , m_name (name)
+{
+    m_impl->add (*this);
+}
+
+TextEventImpl::~TextEventImpl ()
+{
+    m_impl->remove (*this);
+}
+
+void TextEventImpl::notify (EventImpl::value_type value)
+{
+    m_buckets.record (value);
+}
+
+void TextEventImpl::do_process ()
+{
+}
+
+void TextEventImpl::do_report (TextMetricValues& values)
+{
+    report_summary (values, m_name, m_buckets);
+}
+
+//------------------------------------------------------------------------------
+
+TextHistogramImpl::TextHistogramImpl (std::string const& name,
+    beast::shared_ptr <TextCollectorImp> const& impl)
+    : m_impl (impl)
+    , m_name (name)
+{
+    m_impl->add (*this);
+}
+
+TextHistogramImpl::~TextHistogramImpl ()
+{
+    m_impl->remove (*this);
+}
+
+void TextHistogramImpl::record (HistogramImpl::value_type value)
+{
+    m_buckets.record (value);
+}
+
+void TextHistogramImpl::do_process ()
+{
+}
+
+void TextHistogramImpl::do_report (TextMetricValues& values)
+{
+    report_summary (values, m_name, m_buckets);
+}
+
+//------------------------------------------------------------------------------
+
+TextGaugeImpl::TextGaugeImpl (std::string const& name,
+    beast::shared_ptr <TextCollectorImp> const& impl)
+    : m_impl (impl)
+    , m_name (name)
+{
+    m_impl->add (*this);
+}
+
+TextGaugeImpl::~TextGaugeImpl ()
+{
+    m_impl->remove (*this);
+}
+
+void TextGaugeImpl::set (GaugeImpl::value_type value)
+{
+    m_value.set (static_cast <int64> (value));
+}
+
+void TextGaugeImpl::increment (GaugeImpl::difference_type amount)
+{
+    // Saturate at zero, like the other collectors
+    for (;;)
+    {
+        int64 const value (m_value.get ());
+        int64 const result (std::max (value + amount, int64 (0)));
+
+        if (m_value.compareAndSetBool (result, value))
+            break;
+    }
+}
+
+void TextGaugeImpl::set_handler (HandlerType const& handler)
+{
+    m_handler = handler;
+}
+
+void TextGaugeImpl::do_process ()
+{
+    if (m_handler)
+        m_handler (Gauge (shared_from_this ()));
+}
+
+void TextGaugeImpl::do_report (TextMetricValues& values)
+{
+    TextMetricValue& value (values [m_name]);
+    value.kind = TextMetricValue::gauge;
+    value.value += m_value.get ();
+}
+
+//------------------------------------------------------------------------------
+
+TextMeterImpl::TextMeterImpl (std::string const& name,
+    beast::shared_ptr <TextCollectorImp> const& impl)
+    : m_impl (impl)
+    , m_name (name)
+{
+    m_impl->add (*this);
+}
+
+TextMeterImpl::~TextMeterImpl ()
+{
+    m_impl->remove (*this);
+}
+
+void TextMeterImpl::increment (MeterImpl::value_type amount)
+{
+    m_value += static_cast <int64> (amount);
+}
+
+void TextMeterImpl::set_handler (HandlerType const& handler)
+{
+    m_handler = handler;
+}
+
+void TextMeterImpl::do_process ()
+{
+    if (m_handler)
+        m_handler (Meter (shared_from_this ()));
+}
+
+void TextMeterImpl::do_report (TextMetricValues& values)
+{
+    TextMetricValue& value (values [m_name]);
+    value.kind = TextMetricValue::counter;
+    value.value += m_value.get ();
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+shared_ptr <TextCollector> TextCollector::New (std::string const& prefix)
+{
+    return beast::make_shared <detail::TextCollectorImp> (prefix);
+}
+
+//------------------------------------------------------------------------------
+
+class TextCollectorTests : public UnitTest
+{
+public:
+    TextCollectorTests () : UnitTest ("TextCollector", "beast")
+    {
+    }
+
+    bool contains (std::string const& text, std::string const& line)
+    {
+        return text.find (line + "\n") != std::string::npos;
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("text");
+
+        shared_ptr <TextCollector> collector (TextCollector::New ("rippled"));
+
+        Meter meter (collector->make_meter ("peer.messages"));
+        Counter counter (collector->make_counter ("ledger.fetches"));
+        Gauge gauge (collector->make_gauge ("peer.count"));
+        Histogram histogram (collector->make_histogram ("fetch_us"));
+
+        meter += 3;
+        ++meter;
+        counter.increment (5);
+        gauge = 7;
+        for (Histogram::value_type i = 1; i <= 100; ++i)
+            histogram.record (i);
+
+        // Metrics with the same name are added together
+        Gauge other (collector->make_gauge ("peer.count"));
+        other = 2;
+
+        std::string const text (collector->text ());
+
+        expect (contains (text, "# TYPE rippled_peer_messages counter"));
+        expect (contains (text, "rippled_peer_messages 4"));
+        expect (contains (text, "# TYPE rippled_ledger_fetches counter"));
+        expect (contains (text, "rippled_ledger_fetches 5"));
+        expect (contains (text, "rippled_peer_count 9"));
+        expect (contains (text, "# TYPE rippled_fetch_us summary"));
+        expect (contains (text, "rippled_fetch_us_sum 5050"));
+        expect (contains (text, "rippled_fetch_us_count 100"));
+    }
+};
+
+static TextCollectorTests textCollectorTests;
+
+}
+}
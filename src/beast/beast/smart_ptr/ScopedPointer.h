@@ -152,7 +152,9 @@ public:
     }
 
    #if BEAST_COMPILER_SUPPORTS_MOVE_SEMANTICS
-    ScopedPointer (ScopedPointer&& other)
+    // Must be noexcept or std::vector will copy through the
+    // implicit conversion to ObjectType* when it grows.
+    ScopedPointer (ScopedPointer&& other) noexcept
         : object (other.object)
     {
         other.object = nullptr;
@@ -52,7 +52,8 @@ std::size_t HTTPParser::process (void const* buf, std::size_t bytes)
                 m_impl->version (),
                 m_impl->fields (),
                 m_impl->body (),
-                m_impl->method ());
+                m_impl->method (),
+                m_impl->url ());
         }
         else if (m_type == typeResponse)
         {
@@ -81,6 +82,11 @@ bool HTTPParser::finished () const
     return m_impl->finished();
 }
 
+bool HTTPParser::keepAlive () const
+{
+    return m_impl->keep_alive();
+}
+
 StringPairArray const& HTTPParser::fields () const
 {
     return m_impl->fields();
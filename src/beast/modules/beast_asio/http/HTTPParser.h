@@ -48,7 +48,8 @@ public:
 
     /** Parse the buffer and return the amount used.
         Typically it is an error when this returns less than
-        the amount passed in.
+        the amount passed in. A request parser stops at the end of
+        the request, leaving any bytes that follow unused.
     */
     std::size_t process (void const* buf, std::size_t bytes);
 
@@ -59,6 +60,12 @@ public:
     /** Returns `true` when parsing is successful and complete. */
     bool finished () const;
 
+    /** Returns `true` if the connection should persist after this message.
+        This follows the HTTP version and the Connection header.
+        Only valid after finished returns `true`.
+    */
+    bool keepAlive () const;
+
     /** Peek at the header fields as they are being built.
         Only complete pairs will show up, never partial strings.
     */
@@ -30,6 +30,7 @@ public:
 
     explicit HTTPParserImpl (enum http_parser_type type)
         : m_finished (false)
+        , m_keepAlive (false)
         , m_was_value (false)
         , m_headersComplete (false)
     {
@@ -55,7 +56,7 @@ public:
 
     unsigned char error () const
     {
-        return m_parser.http_errno;
+        return http_errno ();
     }
 
     String message () const
@@ -80,6 +81,11 @@ public:
         return m_finished;
     }
 
+    bool keep_alive () const
+    {
+        return m_keepAlive;
+    }
+
     HTTPVersion version () const
     {
         return HTTPVersion (
@@ -98,8 +104,17 @@ public:
         return m_parser.method;
     }
 
+    // Only for HTTPRequest!
+    String url () const
+    {
+        return String (m_url);
+    }
+
+    // A paused parser is not in error, see onMessageComplete
     unsigned char http_errno () const
     {
+        if (m_parser.http_errno == HPE_PAUSED)
+            return HPE_OK;
         return m_parser.http_errno;
     }
 
@@ -145,10 +160,11 @@ private:
         return ec;
     }
 
-    int onUrl (char const*, std::size_t)
+    int onUrl (char const* at, std::size_t length)
     {
         int ec (0);
         // This is for HTTP Request
+        m_url.append (at, length);
         return ec;
     }
 
@@ -198,6 +214,13 @@ private:
     {
         int ec (0);
         m_finished = true;
+        m_keepAlive = http_should_keep_alive (&m_parser) != 0;
+
+        // Stop at the end of a request, so that the bytes of a pipelined
+        // request which follows are left for the caller's next parser.
+        if (m_parser.type == HTTP_REQUEST)
+            http_parser_pause (&m_parser, 1);
+
         return ec;
     }
 
@@ -252,12 +275,14 @@ private:
 
 private:
     bool m_finished;
+    bool m_keepAlive;
     http_parser_settings m_settings;
     http_parser m_parser;
     StringPairArray m_fields;
     bool m_was_value;
     std::string m_field;
     std::string m_value;
+    std::string m_url;
     bool m_headersComplete;
     DynamicBuffer m_body;
 };
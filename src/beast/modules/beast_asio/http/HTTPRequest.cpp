@@ -21,9 +21,11 @@ HTTPRequest::HTTPRequest (
     HTTPVersion const& version_,
     StringPairArray& fields,
     DynamicBuffer& body,
-    unsigned short method_)
+    unsigned short method_,
+    String const& url_)
     : HTTPMessage (version_, fields, body)
     , m_method (method_)
+    , m_url (url_)
 {
 }
 
@@ -32,10 +34,16 @@ unsigned short HTTPRequest::method () const
     return m_method;
 }
 
+String const& HTTPRequest::url () const
+{
+    return m_url;
+}
+
 String HTTPRequest::toString () const
 {
     String s;
     s << "Method: " << String::fromNumber (method ()) << newLine;
+    s << "URL: " << url () << newLine;
     s << this->HTTPMessage::toString ();
     return s;
 }
@@ -31,15 +31,20 @@ public:
         HTTPVersion const& version_,
         StringPairArray& fields,
         DynamicBuffer& body,
-        unsigned short method_);
+        unsigned short method_,
+        String const& url_);
 
     unsigned short method () const;
 
+    /** Returns the request target, for example "/path?query". */
+    String const& url () const;
+
     /** Convert the request into a string, excluding the body. */
     String toString () const;
 
 private:
     unsigned short m_method;
+    String m_url;
 };
 
 #endif
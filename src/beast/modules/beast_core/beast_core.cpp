@@ -187,6 +187,7 @@ namespace beast
 #include "text/TextDiff.cpp"
 
 #include "thread/impl/TrackedMutex.cpp"
+#include "thread/impl/ProfiledMutex.cpp"
 #include "thread/DeadlineTimer.cpp"
 #include "thread/Semaphore.cpp"
 #include "thread/Workers.cpp"
@@ -90,6 +90,12 @@ public:
     /** Returns the section of the file at which the mapped memory represents. */
     Range<int64> getRange() const noexcept      { return range; }
 
+    /** Writes any changes made through the mapping to disk.
+        This blocks until the data has been written, and returns false if
+        it could not be. Otherwise changes are written at the whim of the OS.
+    */
+    bool flush();
+
 private:
     //==============================================================================
     void* address;
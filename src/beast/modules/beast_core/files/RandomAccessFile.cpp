@@ -62,6 +62,11 @@ Result RandomAccessFile::read (void* buffer, ByteCount numBytes, ByteCount* pAct
     return nativeRead (buffer, numBytes, pActualAmount);
 }
 
+Result RandomAccessFile::readAt (FileOffset position, void* buffer, ByteCount numBytes, ByteCount* pActualAmount)
+{
+    return nativeReadAt (position, buffer, numBytes, pActualAmount);
+}
+
 Result RandomAccessFile::write (const void* data, ByteCount numBytes, ByteCount* pActualAmount)
 {
     bassert (data != nullptr && ((ssize_t) numBytes) >= 0);
@@ -211,6 +216,45 @@ public:
         }
     }
 
+    // Read the records by position, leaving the current position alone.
+    void readRecordsAt (RandomAccessFile& file,
+                        int numRecords,
+                        HeapBlock <Record> const& records,
+                        int64 seedValue)
+    {
+        using namespace UnitTestUtilities;
+
+        RandomAccessFile::FileOffset const position (file.getPosition ());
+
+        for (int i = 0; i < numRecords; ++i)
+        {
+            Record const& record (records [i]);
+
+            int const bytes = record.bytes;
+
+            Payload p1 (bytes);
+            Payload p2 (bytes);
+
+            p1.repeatableRandomFill (bytes, bytes, record.index + seedValue);
+
+            RandomAccessFile::ByteCount actual = 0;
+
+            Result result = file.readAt (record.offset, p2.data.getData (), bytes, &actual);
+
+            expect (result.wasOk (), "Should be ok");
+            expect (actual == bytes, "Should read every byte");
+
+            if (result.wasOk ())
+            {
+                p2.bytes = bytes;
+
+                expect (p1 == p2, "Should be equal");
+            }
+        }
+
+        expect (file.getPosition () == position, "Position should be unchanged");
+    }
+
     // Perform the test at the given buffer size.
     void testFile (int const numRecords)
     {
@@ -257,6 +301,8 @@ public:
             if (result.wasOk ())
             {
                 readRecords (file, numRecords, records, seedValue);
+
+                readRecordsAt (file, numRecords, records, seedValue);
             }
         }
     }
@@ -31,8 +31,8 @@
     @note All files are opened in binary mode. No text newline conversions
           are performed.
 
-    @note None of these members are thread safe. The caller is responsible
-          for synchronization.
+    @note None of these members are thread safe, except for readAt. The caller
+          is responsible for synchronization.
 
     @see FileInputStream, FileOutputStream
 */
@@ -142,6 +142,26 @@ public:
     */
     Result read (void* buffer, ByteCount numBytes, ByteCount* pActualAmount = 0);
 
+    /** Read data at the given position.
+
+        The current position is not used, and is left unchanged. This may be
+        called from several threads at once, and while another thread is
+        writing, which makes it suitable for files that are read randomly.
+
+        Reading past the end of the file is not an error; the actual amount
+        read will be less than requested.
+
+        @note The file must have been opened with read permission.
+
+        @param position The byte FileOffset from the beginning of the file.
+        @param buffer The memory to store the incoming data
+        @param numBytes The number of bytes to read.
+        @param pActualAmount Pointer to store the actual amount read, or `nullptr`.
+
+        @return `true` if no error occurred.
+    */
+    Result readAt (FileOffset position, void* buffer, ByteCount numBytes, ByteCount* pActualAmount = 0);
+
     /** Write data at the current position.
 
         The current position is advanced past the data written. If data is
@@ -181,6 +201,7 @@ private:
     void nativeClose ();
     Result nativeSetPosition (FileOffset newPosition);
     Result nativeRead (void* buffer, ByteCount numBytes, ByteCount* pActualAmount = 0);
+    Result nativeReadAt (FileOffset position, void* buffer, ByteCount numBytes, ByteCount* pActualAmount = 0);
     Result nativeWrite (const void* data, ByteCount numBytes, ByteCount* pActualAmount = 0);
     Result nativeTruncate ();
     Result nativeFlush ();
@@ -530,6 +530,26 @@ Result RandomAccessFile::nativeRead (void* buffer, ByteCount numBytes, ByteCount
     return Result::ok();
 }
 
+Result RandomAccessFile::nativeReadAt (FileOffset position, void* buffer, ByteCount numBytes, ByteCount* pActualAmount)
+{
+    bassert (isOpen ());
+
+    ssize_t bytesRead = ::pread (getFD (fileHandle), buffer, numBytes, (off_t) position);
+
+    if (bytesRead < 0)
+    {
+        if (pActualAmount != nullptr)
+            *pActualAmount = 0;
+
+        return getResultForErrno();
+    }
+
+    if (pActualAmount != nullptr)
+        *pActualAmount = bytesRead;
+
+    return Result::ok();
+}
+
 Result RandomAccessFile::nativeWrite (void const* data, ByteCount numBytes, size_t* pActualAmount)
 {
     bassert (isOpen ());
@@ -637,6 +657,12 @@ MemoryMappedFile::~MemoryMappedFile()
         close (fileHandle);
 }
 
+bool MemoryMappedFile::flush()
+{
+    return address != nullptr
+        && msync (address, (size_t) range.getLength(), MS_SYNC) == 0;
+}
+
 //==============================================================================
 #if BEAST_PROBEASTR_LIVE_BUILD
 extern "C" const char* beast_getCurrentExecutablePath();
@@ -28,6 +28,17 @@
 //==============================================================================
 namespace WindowsFileHelpers
 {
+    // Reads and writes through one of these happen at the given offset,
+    // whatever the handle's file pointer is.
+    OVERLAPPED overlappedAt (int64 position)
+    {
+        OVERLAPPED overlapped;
+        zerostruct (overlapped);
+        overlapped.Offset = (DWORD) position;
+        overlapped.OffsetHigh = (DWORD) (position >> 32);
+        return overlapped;
+    }
+
     DWORD getAtts (const String& path)
     {
         return GetFileAttributes (path.toWideCharPointer());
@@ -411,7 +422,11 @@ Result RandomAccessFile::nativeRead (void* buffer, ByteCount numBytes, ByteCount
 
     DWORD actualNum = 0;
 
-    if (! ReadFile ((HANDLE) fileHandle, buffer, (DWORD) numBytes, &actualNum, 0))
+    // The position is passed explicitly since readAt moves the file pointer.
+    OVERLAPPED overlapped (WindowsFileHelpers::overlappedAt (currentPosition));
+
+    if (! ReadFile ((HANDLE) fileHandle, buffer, (DWORD) numBytes, &actualNum, &overlapped)
+            && GetLastError () != ERROR_HANDLE_EOF)
         result = WindowsFileHelpers::getResultForLastError();
 
     currentPosition += actualNum;
@@ -422,6 +437,26 @@ Result RandomAccessFile::nativeRead (void* buffer, ByteCount numBytes, ByteCount
     return result;
 }
 
+Result RandomAccessFile::nativeReadAt (FileOffset position, void* buffer, ByteCount numBytes, ByteCount* pActualAmount)
+{
+    bassert (isOpen ());
+
+    Result result (Result::ok ());
+
+    DWORD actualNum = 0;
+
+    OVERLAPPED overlapped (WindowsFileHelpers::overlappedAt (position));
+
+    if (! ReadFile ((HANDLE) fileHandle, buffer, (DWORD) numBytes, &actualNum, &overlapped)
+            && GetLastError () != ERROR_HANDLE_EOF)
+        result = WindowsFileHelpers::getResultForLastError();
+
+    if (pActualAmount != nullptr)
+        *pActualAmount = actualNum;
+
+    return result;
+}
+
 Result RandomAccessFile::nativeWrite (void const* data, ByteCount numBytes, size_t* pActualAmount)
 {
     bassert (isOpen ());
@@ -430,7 +465,9 @@ Result RandomAccessFile::nativeWrite (void const* data, ByteCount numBytes, size
 
     DWORD actualNum = 0;
 
-    if (! WriteFile ((HANDLE) fileHandle, data, (DWORD) numBytes, &actualNum, 0))
+    OVERLAPPED overlapped (WindowsFileHelpers::overlappedAt (currentPosition));
+
+    if (! WriteFile ((HANDLE) fileHandle, data, (DWORD) numBytes, &actualNum, &overlapped))
         result = WindowsFileHelpers::getResultForLastError();
 
     if (pActualAmount != nullptr)
@@ -443,9 +480,9 @@ Result RandomAccessFile::nativeTruncate ()
 {
     bassert (isOpen ());
 
-    Result result (Result::ok ());
+    Result result (nativeSetPosition (currentPosition));
 
-    if (! SetEndOfFile ((HANDLE) fileHandle))
+    if (result.wasOk () && ! SetEndOfFile ((HANDLE) fileHandle))
         result = WindowsFileHelpers::getResultForLastError();
 
     return result;
@@ -519,6 +556,13 @@ MemoryMappedFile::~MemoryMappedFile()
         CloseHandle ((HANDLE) fileHandle);
 }
 
+bool MemoryMappedFile::flush()
+{
+    return address != nullptr
+        && FlushViewOfFile (address, 0) != 0
+        && FlushFileBuffers ((HANDLE) fileHandle) != 0;
+}
+
 //==============================================================================
 int64 File::getSize() const
 {
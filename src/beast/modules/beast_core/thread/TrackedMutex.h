@@ -26,5 +26,7 @@
 #include "impl/TrackedMutex.h"
 #include "impl/TrackedMutexType.h"
 #include "impl/UntrackedMutexType.h"
+#include "impl/ProfiledMutex.h"
+#include "impl/ProfiledMutexType.h"
 
 #endif
@@ -64,6 +64,9 @@ struct TrackedMutexBasics
         TrackedMutex const* blocked;
         String threadName;      // at the time of the block
         String sourceLocation;  // at the time of the block
+
+        int64 blockedTicks;     // high resolution ticks at the time of the block
+        int64 waitTicks;        // total high resolution ticks spent blocked
     };
 
     // This turns the thread local into a POD which will be
@@ -0,0 +1,397 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2013, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+struct ProfiledMutex::Group
+{
+    explicit Group (String const& name_)
+        : name (name_)
+    {
+    }
+
+    String const name;
+};
+
+struct ProfiledMutex::Stats
+{
+    Stats (PerThreadData& thread_, Group const& group_,
+        char const* fileName_, int lineNumber_)
+        : thread (thread_)
+        , group (group_)
+        , fileName (fileName_)
+        , lineNumber (lineNumber_)
+        , count (0)
+        , contended (0)
+        , waitTicks (0)
+        , maxWaitTicks (0)
+        , holdTicks (0)
+    {
+    }
+
+    PerThreadData& thread;
+    Group const& group;
+    char const* const fileName;
+    int const lineNumber;
+
+    int64 count;
+    int64 contended;
+    int64 waitTicks;
+    int64 maxWaitTicks;
+    int64 holdTicks;
+};
+
+struct ProfiledMutex::PerThreadData
+{
+    struct Key
+    {
+        Key (Group const* group_, char const* fileName_, int lineNumber_)
+            : group (group_)
+            , fileName (fileName_)
+            , lineNumber (lineNumber_)
+        {
+        }
+
+        bool operator< (Key const& other) const
+        {
+            if (group != other.group)
+                return group < other.group;
+            if (fileName != other.fileName)
+                return fileName < other.fileName;
+            return lineNumber < other.lineNumber;
+        }
+
+        Group const* group;
+        char const* fileName;
+        int lineNumber;
+    };
+
+    typedef std::map <Key, Stats*> StatsMap;
+
+    PerThreadData ()
+        : waitTicks (0)
+    {
+    }
+
+    // Only the owning thread inserts, so lookups need no lock.
+    Stats& getStats (Group const& group, char const* fileName, int lineNumber)
+    {
+        Key const key (&group, fileName, lineNumber);
+        StatsMap::const_iterator const iter (stats.find (key));
+        if (iter != stats.end ())
+            return *iter->second;
+
+        Stats* const s (new Stats (*this, group, fileName, lineNumber));
+        CriticalSection::ScopedLockType lock (mutex);
+        stats.insert (std::make_pair (key, s));
+        return *s;
+    }
+
+    // Protects the map and the contents of every Stats in it
+    CriticalSection mutex;
+    StatsMap stats;
+    int64 waitTicks;
+};
+
+// The state is never destroyed, since mutexes may be locked
+// during static destruction.
+struct ProfiledMutex::State
+{
+    typedef std::map <String, Group*> Groups;
+
+    CriticalSection mutex;
+    Groups groups;
+    Array <PerThreadData*> threads;
+    ThreadLocalValue <PerThreadData*> threadLocal;
+};
+
+//------------------------------------------------------------------------------
+
+ProfiledMutex::Site::Site ()
+    : count (0)
+    , contended (0)
+    , waitSeconds (0)
+    , maxWaitSeconds (0)
+    , holdSeconds (0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+ProfiledMutex::State& ProfiledMutex::getState ()
+{
+    static State* const state (new State);
+    return *state;
+}
+
+ProfiledMutex::PerThreadData& ProfiledMutex::getPerThreadData ()
+{
+    State& state (getState ());
+    PerThreadData*& thread (state.threadLocal.get ());
+
+    if (thread == nullptr)
+    {
+        thread = new PerThreadData;
+        CriticalSection::ScopedLockType lock (state.mutex);
+        state.threads.add (thread);
+    }
+
+    return *thread;
+}
+
+ProfiledMutex::Group const& ProfiledMutex::getGroup (String const& name)
+{
+    State& state (getState ());
+    CriticalSection::ScopedLockType lock (state.mutex);
+    Group*& group (state.groups [name]);
+    if (group == nullptr)
+        group = new Group (name);
+    return *group;
+}
+
+//------------------------------------------------------------------------------
+
+ProfiledMutex::ProfiledMutex (String const& name) noexcept
+    : m_group (getGroup (name))
+    , m_depth (0)
+    , m_acquiredTicks (0)
+    , m_stats (nullptr)
+{
+}
+
+String ProfiledMutex::getName () const noexcept
+{
+    return m_group.name;
+}
+
+// Called after we already have ownership of the mutex
+//
+void ProfiledMutex::acquired (char const* fileName, int lineNumber,
+    int64 waitTicks) const noexcept
+{
+    // A recursive acquisition is part of the outermost hold
+    if (m_depth++ != 0)
+        return;
+
+    PerThreadData& thread (getPerThreadData ());
+    Stats& stats (thread.getStats (m_group, fileName, lineNumber));
+
+    {
+        CriticalSection::ScopedLockType lock (thread.mutex);
+
+        ++stats.count;
+        if (waitTicks > 0)
+        {
+            ++stats.contended;
+            stats.waitTicks += waitTicks;
+            if (waitTicks > stats.maxWaitTicks)
+                stats.maxWaitTicks = waitTicks;
+            thread.waitTicks += waitTicks;
+        }
+    }
+
+    m_stats = &stats;
+    m_acquiredTicks = Time::getHighResolutionTicks ();
+}
+
+// Called before we give up ownership of the mutex
+//
+void ProfiledMutex::release () const noexcept
+{
+    // If this goes off it means we don't own the mutex!
+    bassert (m_depth > 0);
+
+    if (--m_depth != 0)
+        return;
+
+    int64 const holdTicks (Time::getHighResolutionTicks () - m_acquiredTicks);
+    Stats& stats (*m_stats);
+    m_stats = nullptr;
+
+    CriticalSection::ScopedLockType lock (stats.thread.mutex);
+    stats.holdTicks += holdTicks;
+}
+
+//------------------------------------------------------------------------------
+
+void ProfiledMutex::getSites (Array <Site>& sites)
+{
+    typedef std::map <String, Site> SiteMap;
+    SiteMap merged;
+
+    State& state (getState ());
+    CriticalSection::ScopedLockType lock (state.mutex);
+
+    for (int i = 0; i < state.threads.size (); ++i)
+    {
+        PerThreadData& thread (*state.threads [i]);
+        CriticalSection::ScopedLockType threadLock (thread.mutex);
+
+        for (PerThreadData::StatsMap::const_iterator iter (thread.stats.begin ());
+            iter != thread.stats.end (); ++iter)
+        {
+            Stats const& stats (*iter->second);
+            if (stats.count == 0)
+                continue;
+
+            String const sourceLocation (Debug::getFileNameFromPath (
+                stats.fileName, 1) + "(" + String::fromNumber (stats.lineNumber) + ")");
+
+            Site& site (merged [stats.group.name + "|" + sourceLocation]);
+            site.mutexName = stats.group.name;
+            site.sourceLocation = sourceLocation;
+            site.count += stats.count;
+            site.contended += stats.contended;
+            site.waitSeconds += Time::highResolutionTicksToSeconds (stats.waitTicks);
+            site.maxWaitSeconds = std::max (site.maxWaitSeconds,
+                Time::highResolutionTicksToSeconds (stats.maxWaitTicks));
+            site.holdSeconds += Time::highResolutionTicksToSeconds (stats.holdTicks);
+        }
+    }
+
+    sites.clearQuick ();
+    sites.ensureStorageAllocated (int (merged.size ()));
+    for (SiteMap::const_iterator iter (merged.begin ()); iter != merged.end (); ++iter)
+        sites.add (iter->second);
+}
+
+void ProfiledMutex::reset ()
+{
+    State& state (getState ());
+    CriticalSection::ScopedLockType lock (state.mutex);
+
+    for (int i = 0; i < state.threads.size (); ++i)
+    {
+        PerThreadData& thread (*state.threads [i]);
+        CriticalSection::ScopedLockType threadLock (thread.mutex);
+
+        // The Stats objects are kept, since held mutexes refer to them.
+        for (PerThreadData::StatsMap::iterator iter (thread.stats.begin ());
+            iter != thread.stats.end (); ++iter)
+        {
+            Stats& stats (*iter->second);
+            stats.count = 0;
+            stats.contended = 0;
+            stats.waitTicks = 0;
+            stats.maxWaitTicks = 0;
+            stats.holdTicks = 0;
+        }
+    }
+}
+
+double ProfiledMutex::getThreadWaitSeconds () noexcept
+{
+    PerThreadData& thread (getPerThreadData ());
+    CriticalSection::ScopedLockType lock (thread.mutex);
+    return Time::highResolutionTicksToSeconds (thread.waitTicks);
+}
+
+//------------------------------------------------------------------------------
+
+class ProfiledMutexTests : public UnitTest
+{
+public:
+    typedef ProfiledMutex::Site Site;
+    typedef ProfiledMutexType <CriticalSection> MutexType;
+
+    ProfiledMutexTests () : UnitTest ("ProfiledMutex", "beast")
+    {
+    }
+
+    class Holder : public Thread
+    {
+    public:
+        Holder (MutexType& mutex, WaitableEvent& locked)
+            : Thread ("ProfiledMutexTests")
+            , m_mutex (mutex)
+            , m_locked (locked)
+        {
+        }
+
+        void run ()
+        {
+            MutexType::ScopedLockType lock (m_mutex, __FILE__, __LINE__);
+            m_locked.signal ();
+            Thread::sleep (50);
+        }
+
+    private:
+        MutexType& m_mutex;
+        WaitableEvent& m_locked;
+    };
+
+    Site const* findSite (Array <Site> const& sites, String const& name)
+    {
+        for (int i = 0; i < sites.size (); ++i)
+            if (sites.getReference (i).mutexName.startsWith (name))
+                return &sites.getReference (i);
+        return nullptr;
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("contention");
+
+        MutexType mutex ("ProfiledMutexTests", __FILE__, __LINE__);
+
+        {
+            MutexType::ScopedLockType lock (mutex, __FILE__, __LINE__);
+            MutexType::ScopedLockType recursive (mutex, __FILE__, __LINE__);
+        }
+
+        WaitableEvent locked;
+        Holder holder (mutex, locked);
+        holder.startThread ();
+        locked.wait ();
+
+        double const waitBefore (ProfiledMutex::getThreadWaitSeconds ());
+        {
+            MutexType::ScopedLockType lock (mutex, __FILE__, __LINE__);
+        }
+        holder.stopThread (-1);
+
+        expect (ProfiledMutex::getThreadWaitSeconds () - waitBefore > 0.01,
+            "thread wait not recorded");
+
+        Array <Site> sites;
+        ProfiledMutex::getSites (sites);
+
+        int64 count (0);
+        int64 contended (0);
+        double holdSeconds (0);
+        for (int i = 0; i < sites.size (); ++i)
+        {
+            Site const& site (sites.getReference (i));
+            if (site.mutexName.startsWith ("ProfiledMutexTests"))
+            {
+                count += site.count;
+                contended += site.contended;
+                holdSeconds += site.holdSeconds;
+            }
+        }
+
+        expect (count == 3, "recursive acquisitions should not be counted");
+        expect (contended == 1);
+        expect (holdSeconds > 0.04, "hold time not recorded");
+
+        ProfiledMutex::reset ();
+        ProfiledMutex::getSites (sites);
+        expect (findSite (sites, "ProfiledMutexTests") == nullptr);
+    }
+};
+
+static ProfiledMutexTests profiledMutexTests;
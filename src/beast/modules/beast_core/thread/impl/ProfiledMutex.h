@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2013, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_CORE_THREAD_IMPL_PROFILEDMUTEX_H_INCLUDED
+#define BEAST_CORE_THREAD_IMPL_PROFILEDMUTEX_H_INCLUDED
+
+/** Common types and member functions for a ProfiledMutex.
+
+    A ProfiledMutex measures how long callers wait to acquire it and how long
+    they hold it, aggregated by mutex name and acquisition site. Measurements
+    are accumulated per thread, so profiling adds no contention of its own.
+*/
+class ProfiledMutex : public Uncopyable
+{
+public:
+    /** Contention statistics for one mutex and source code location. */
+    struct Site
+    {
+        Site ();
+
+        String mutexName;
+        String sourceLocation;
+        int64 count;            // Number of acquisitions
+        int64 contended;        // Acquisitions which had to wait
+        double waitSeconds;     // Total time spent waiting to acquire
+        double maxWaitSeconds;  // Longest single wait
+        double holdSeconds;     // Total time the mutex was held
+    };
+
+    /** Retrieve the name of this mutex. */
+    String getName () const noexcept;
+
+    /** Retrieve the statistics for every acquisition site.
+        Statistics from all threads are merged.
+        Thread safety: May be called from any thread.
+    */
+    static void getSites (Array <Site>& sites);
+
+    /** Reset the statistics for every acquisition site to zero. */
+    static void reset ();
+
+    /** Returns the total time the calling thread has spent waiting to
+        acquire profiled mutexes, in seconds.
+    */
+    static double getThreadWaitSeconds () noexcept;
+
+protected:
+    explicit ProfiledMutex (String const& name) noexcept;
+
+    void acquired (char const* fileName, int lineNumber,
+        int64 waitTicks) const noexcept;
+    void release () const noexcept;
+
+private:
+    struct Group;
+    struct Stats;
+    struct PerThreadData;
+    struct State;
+
+    static State& getState ();
+    static Group const& getGroup (String const& name);
+    static PerThreadData& getPerThreadData ();
+
+    Group const& m_group;
+    int mutable m_depth;
+    int64 mutable m_acquiredTicks;
+    Stats mutable* m_stats;
+};
+
+#endif
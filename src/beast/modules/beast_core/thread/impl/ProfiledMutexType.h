@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2013, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_CORE_THREAD_PROFILEDMUTEXTYPE_H_INCLUDED
+#define BEAST_CORE_THREAD_PROFILEDMUTEXTYPE_H_INCLUDED
+
+/** A template that measures contention on a Mutex.
+    This is a drop-in replacement for TrackedMutexType.
+    @see ProfiledMutex
+*/
+template <typename Mutex>
+class ProfiledMutexType
+    : public ProfiledMutex
+{
+public:
+    /** The type of ScopedLock to use with this ProfiledMutexType object. */
+    typedef detail::TrackedScopedLock <ProfiledMutexType <Mutex> > ScopedLockType;
+
+    /** The type of ScopedTrylock to use with this ProfiledMutexType object. */
+    typedef detail::TrackedScopedTryLock <ProfiledMutexType <Mutex> > ScopedTryLockType;
+
+    /** The type of ScopedUnlock to use with this ProfiledMutexType object. */
+    typedef detail::TrackedScopedUnlock <ProfiledMutexType <Mutex> > ScopedUnlockType;
+
+    /** Construct a mutex, keyed to a particular class.
+        Mutexes with the same name and construction site are profiled
+        together, so every instance of a class shares one set of statistics.
+    */
+    template <typename Object>
+    ProfiledMutexType (Object const*,
+                       String name,
+                       char const* fileName,
+                       int lineNumber)
+        : ProfiledMutex (detail::TrackedMutexBasics::createName (
+            name, fileName, lineNumber, 0))
+    {
+    }
+
+    /** Construct a mutex, without a class association. */
+    ProfiledMutexType (String name, char const* fileName, int lineNumber)
+        : ProfiledMutex (detail::TrackedMutexBasics::createName (
+            name, fileName, lineNumber, 0))
+    {
+    }
+
+    ~ProfiledMutexType () noexcept
+    {
+    }
+
+    inline void lock (char const* fileName, int lineNumber) const noexcept
+    {
+        if (MutexTraits <Mutex>::try_lock (m_mutex))
+        {
+            acquired (fileName, lineNumber, 0);
+        }
+        else
+        {
+            int64 const start (Time::getHighResolutionTicks ());
+            MutexTraits <Mutex>::lock (m_mutex);
+            acquired (fileName, lineNumber,
+                Time::getHighResolutionTicks () - start);
+        }
+    }
+
+    inline void unlock () const noexcept
+    {
+        release ();
+        MutexTraits <Mutex>::unlock (m_mutex);
+    }
+
+    inline bool try_lock (char const* fileName, int lineNumber) const noexcept
+    {
+        bool const success = MutexTraits <Mutex>::try_lock (m_mutex);
+        if (success)
+            acquired (fileName, lineNumber, 0);
+        return success;
+    }
+
+private:
+    Mutex const m_mutex;
+};
+
+#endif
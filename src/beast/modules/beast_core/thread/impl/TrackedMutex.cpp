@@ -40,6 +40,8 @@ ThreadLocalValue <TrackedMutexBasics::PerThreadDataStorage> TrackedMutexBasics::
 
 TrackedMutexBasics::PerThreadData::PerThreadData ()
     : id (++lastThreadId)
+    , blockedTicks (0)
+    , waitTicks (0)
 {
 }
 
@@ -310,6 +312,16 @@ void TrackedMutex::generateGlobalBlockedReport (StringArray& report)
 
 //------------------------------------------------------------------------------
 
+double TrackedMutex::getThreadWaitSeconds () noexcept
+{
+    detail::TrackedMutexBasics::PerThreadData const& thread
+        (detail::TrackedMutexBasics::getPerThreadData ());
+
+    return Time::highResolutionTicksToSeconds (thread.waitTicks);
+}
+
+//------------------------------------------------------------------------------
+
 // Called before we attempt to acquire the mutex.
 //
 void TrackedMutex::block (char const* fileName, int lineNumber) const noexcept
@@ -320,6 +332,8 @@ void TrackedMutex::block (char const* fileName, int lineNumber) const noexcept
 
     ++thread.refCount;
 
+    thread.blockedTicks = Time::getHighResolutionTicks ();
+
     String const sourceLocation (makeSourceLocation (fileName, lineNumber));
 
     {
@@ -356,6 +370,8 @@ void TrackedMutex::acquired (char const* fileName, int lineNumber) const noexcep
     // If this goes off it means block() wasn't called.
     bassert (thread.refCount > 0);
 
+    thread.waitTicks += Time::getHighResolutionTicks () - thread.blockedTicks;
+
     ++m_count;
 
     // Take ownership on the first count.
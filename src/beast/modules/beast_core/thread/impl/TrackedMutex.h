@@ -141,6 +141,13 @@ public:
     /** Produce a report on the state of all blocked threads. */
     static void generateGlobalBlockedReport (StringArray& report);
 
+    /** Returns the total time the calling thread has spent waiting to
+        acquire tracked mutexes, in seconds.
+        Callers measure the wait over an interval by taking the difference
+        between two calls.
+    */
+    static double getThreadWaitSeconds () noexcept;
+
 protected:
     static String makeThreadName (detail::TrackedMutexBasics::PerThreadData const&) noexcept;
     static String makeSourceLocation (char const* fileName, int lineNumber) noexcept;
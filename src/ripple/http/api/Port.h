@@ -45,6 +45,10 @@ struct Port
     IPAddress addr;
     Security security;
     SSLContext* context;
+
+    // The most requests from one connection that may be in progress at
+    // once. Further pipelined requests wait until a response completes.
+    int maxConcurrentRequests;
 };
 
 bool operator== (Port const& lhs, Port const& rhs);
@@ -100,10 +100,19 @@ public:
     /** Detach the session.
         This holds the session open so that the response can be sent
         asynchronously. Calls to io_service::run made by the server
-        will not return until all detached sessions are closed.
+        will not return until all detached sessions are completed
+        or closed.
     */
     virtual void detach() = 0;
 
+    /** Indicate that the response is complete.
+        If the request asked for a persistent connection the next request
+        on the connection is processed, otherwise the connection is closed
+        once everything has been sent. Responses to pipelined requests are
+        sent in the order the requests arrived, whichever finishes first.
+    */
+    virtual void complete() = 0;
+
     /** Close the session.
         This will be performed asynchronously. The session will be
         closed gracefully after all pending writes have completed.
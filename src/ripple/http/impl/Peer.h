@@ -26,6 +26,66 @@ namespace HTTP {
 // Holds the copy of buffers being sent
 typedef SharedArg <std::string> SharedBuffer;
 
+class Peer;
+
+/** One request received on a connection, and its response.
+
+    A connection may carry several pipelined requests at once. Each one
+    is delivered to the Handler as its own Session, and the Peer sends
+    the responses in the order the requests arrived.
+*/
+class Request
+    : public SharedObject
+    , public Session
+    , public LeakChecked <Request>
+{
+public:
+    typedef SharedPtr <Request> Ptr;
+
+    Request (Peer& peer, HTTPRequestParser& parser, IPAddress const& remoteAddress);
+    ~Request ();
+
+    Journal journal();
+    IPAddress remoteAddress();
+    bool headersComplete();
+    HTTPHeaders headers();
+    SharedPtr <beast::HTTPRequest> const& request();
+    std::string content();
+    void write (void const* buffer, std::size_t bytes);
+    void detach ();
+    void complete ();
+    void close ();
+
+    Session& session ()
+    {
+        return *this;
+    }
+
+    // Everything below is only touched on the Peer's strand
+
+    SharedPtr <Peer> m_peer;
+    SharedPtr <beast::HTTPRequest> m_request;
+    StringPairArray m_fields;
+    IPAddress m_remoteAddress;
+    std::string m_content;
+    bool m_keepAlive;
+
+    // Response data waiting for earlier responses to finish
+    std::string m_response;
+
+    // True when this is the oldest response, whose data goes straight out
+    bool m_head;
+
+    bool m_complete;
+    bool m_closeAfter;
+
+    Atomic <int> m_detached;
+    SharedPtr <Request> m_detach_ref;
+    boost::optional <boost::asio::io_service::work> m_work;
+};
+
+//------------------------------------------------------------------------------
+
 /** Represents an active connection. */
 class Peer
     : public SharedObject
@@ -47,7 +107,10 @@ public:
         dataTimeoutSeconds = 10,
 
         // Max seconds without completing the request
-        requestTimeoutSeconds = 30
+        requestTimeoutSeconds = 30,
+
+        // Max seconds a persistent connection may sit idle between requests
+        keepAliveTimeoutSeconds = 30
 
     };
 
@@ -59,7 +122,7 @@ public:
     boost::asio::deadline_timer m_request_timer;
     ScopedPointer <MultiSocket> m_socket;
     MemoryBlock m_buffer;
-    HTTPRequestParser m_parser;
+    ScopedPointer <HTTPRequestParser> m_parser;
     int m_writesPending;
     bool m_closed;
     bool m_callClose;
@@ -68,6 +131,21 @@ public:
     boost::optional <boost::asio::io_service::work> m_work;
     int m_errorCode;
 
+    // Received bytes not yet given to the parser
+    std::string m_pending;
+
+    // Requests being processed or waiting for their turn to respond
+    std::deque <Request::Ptr> m_requests;
+
+    int m_maxConcurrentRequests;
+    std::size_t m_requestBytes;
+    bool m_requestStarted;
+    bool m_reading;
+    bool m_eof;
+    bool m_readClosed;
+    bool m_idle;
+    int m_idleSeconds;
+
     //--------------------------------------------------------------------------
 
     Peer (ServerImpl& impl, Port const& port)
@@ -76,10 +154,19 @@ public:
         , m_data_timer (m_impl.get_io_service())
         , m_request_timer (m_impl.get_io_service())
         , m_buffer (bufferSize)
+        , m_parser (new HTTPRequestParser)
         , m_writesPending (0)
         , m_closed (false)
         , m_callClose (false)
         , m_errorCode (0)
+        , m_maxConcurrentRequests (std::max (1, port.maxConcurrentRequests))
+        , m_requestBytes (0)
+        , m_requestStarted (false)
+        , m_reading (false)
+        , m_eof (false)
+        , m_readClosed (false)
+        , m_idle (false)
+        , m_idleSeconds (0)
     {
         tag = nullptr;
 
@@ -123,17 +210,17 @@ public:
 
     bool headersComplete()
     {
-        return m_parser.headersComplete();
+        return m_parser->headersComplete();
     }
 
     HTTPHeaders headers()
     {
-        return HTTPHeaders (m_parser.fields());
+        return HTTPHeaders (m_parser->fields());
     }
 
     SharedPtr <beast::HTTPRequest> const& request()
     {
-        return m_parser.request();
+        return m_parser->request();
     }
 
     // Returns the Content-Body as a single buffer.
@@ -142,7 +229,7 @@ public:
     {
         std::string s;
         DynamicBuffer const& body (
-            m_parser.request()->body ());
+            m_parser->request()->body ());
         s.resize (body.size ());
         boost::asio::buffer_copy (
             boost::asio::buffer (&s[0],
@@ -180,6 +267,12 @@ public:
         }
     }
 
+    // The connection itself has no response to complete.
+    void complete ()
+    {
+        close ();
+    }
+
     // Called by the Handler to close the session.
     void close ()
     {
@@ -212,14 +305,7 @@ public:
             return;
         }
 
-        m_request_timer.expires_from_now (
-            boost::posix_time::seconds (
-                requestTimeoutSeconds));
-
-        m_request_timer.async_wait (m_strand.wrap (boost::bind (
-            &Peer::handle_request_timer, Ptr(this),
-                boost::asio::placeholders::error,
-                    CompletionCounter (this))));
+        start_request_timer ();
 
         if (m_socket->needs_handshake ())
         {
@@ -264,7 +350,11 @@ public:
             return;
 
         if (m_closed)
+        {
+            // The remote end did not finish the close in time
+            cancel ();
             return;
+        }
 
         if (ec != 0)
         {
@@ -272,6 +362,20 @@ public:
             return;
         }
 
+        if (m_idle)
+        {
+            // A persistent connection waiting for its next request. The
+            // timer ticks every second so a stopping server is noticed.
+            if (m_impl.stopping () || (++m_idleSeconds >= keepAliveTimeoutSeconds))
+            {
+                cancel ();
+                return;
+            }
+
+            start_data_timer ();
+            return;
+        }
+
         failed (boost::system::errc::make_error_code (
             boost::system::errc::timed_out));
     }
@@ -317,64 +421,36 @@ public:
     // Called when async_read_some completes.
     void handle_read (error_code ec, std::size_t bytes_transferred, CompletionCounter)
     {
-        if (ec == boost::asio::error::operation_aborted)
-            return;
+        m_reading = false;
 
-        if (ec != 0 && ec != boost::asio::error::eof)
-        {
-            failed (ec);
+        if (ec == boost::asio::error::operation_aborted)
             return;
-        }
-
-        std::size_t const bytes_parsed (m_parser.process (
-            m_buffer.getData(), bytes_transferred));
 
-        if (m_parser.error() ||
-            bytes_parsed != bytes_transferred)
+        if (m_closed)
         {
-            failed (boost::system::errc::make_error_code (
-                boost::system::errc::bad_message));
+            // Nothing is left to wait for
+            error_code ec;
+            m_data_timer.cancel (ec);
             return;
         }
 
-        if (ec == boost::asio::error::eof)
-        {
-            m_parser.process_eof();
-            ec = error_code();
-        }
-
-        if (m_parser.error())
+        if (ec != 0 && ec != boost::asio::error::eof)
         {
-            failed (boost::system::errc::make_error_code (
-                boost::system::errc::bad_message));
+            failed (ec);
             return;
         }
 
-        if (! m_parser.finished())
+        if (bytes_transferred > 0)
         {
-            // Feed some headers to the callback
-            if (m_parser.fields().size() > 0)
-            {
-                handle_headers();
-                if (m_closed)
-                    return;
-            }
+            m_pending.append (static_cast <char const*> (
+                m_buffer.getData()), bytes_transferred);
+            m_idleSeconds = 0;
         }
 
-        if (m_parser.finished ())
-        {
-            m_data_timer.cancel();
-            // VFALCO NOTE: Should we cancel this one?
-            m_request_timer.cancel();
-
-            if (! m_socket->needs_handshake())
-                m_socket->shutdown (socket::shutdown_receive);
-
-            handle_request ();
-            return;
-        }
+        if (ec == boost::asio::error::eof)
+            m_eof = true;
 
-        async_read_some();
+        proceed ();
     }
 
     // Called when we have some new headers.
@@ -392,19 +468,106 @@ public:
         if (m_closed)
             return;
 
+        m_request_timer.cancel();
+        m_requestStarted = false;
+        m_requestBytes = 0;
+
+        IPAddress remote;
+        {
+            error_code ec;
+            endpoint_t const endpoint (get_socket().remote_endpoint (ec));
+            if (! ec)
+                remote = from_asio (endpoint);
+        }
+
+        Request::Ptr const request (new Request (*this, *m_parser, remote));
+        m_parser = new HTTPRequestParser;
+
+        error_code ec;
+        m_data_timer.cancel (ec);
+
+        // Anything after a request which does not keep the
+        // connection alive is ignored.
+        if (! request->m_keepAlive)
+        {
+            m_readClosed = true;
+            m_pending.clear ();
+        }
+
+        request->m_head = m_requests.empty ();
+        m_requests.push_back (request);
+
         // Process the HTTPRequest
-        m_impl.handler().onRequest (session());
+        m_impl.handler().onRequest (request->session());
     }
 
     // Called to close the session.
     void handle_close (CompletionCounter)
     {
         m_closed = true;
+        m_requests.clear ();
 
         // Release our additional reference
         m_detach_ref = nullptr;
     }
 
+    // Called from an io_service thread to write part of a response.
+    void handle_response_write (Request::Ptr const& request,
+        SharedBuffer const& buf, CompletionCounter)
+    {
+        if (m_closed)
+            return;
+
+        if (request->m_head)
+            async_write (buf);
+        else
+            request->m_response.append (*buf);
+    }
+
+    // Called from an io_service thread when a response is finished.
+    void handle_response_complete (Request::Ptr const& request,
+        bool closeAfter, CompletionCounter)
+    {
+        request->m_complete = true;
+        request->m_closeAfter = request->m_closeAfter || closeAfter;
+
+        // Release the request's additional reference
+        request->m_detach_ref = nullptr;
+        request->m_work = boost::none;
+
+        if (m_closed)
+            return;
+
+        // Retire finished responses from the front of the queue
+        while (! m_requests.empty () && m_requests.front ()->m_complete)
+        {
+            Request::Ptr const done (m_requests.front ());
+            m_requests.pop_front ();
+
+            if (done->m_closeAfter || ! done->m_keepAlive || m_impl.stopping ())
+            {
+                m_readClosed = true;
+                m_requests.clear ();
+                break;
+            }
+
+            if (! m_requests.empty ())
+            {
+                Request& next (*m_requests.front ());
+                next.m_head = true;
+                if (! next.m_response.empty ())
+                {
+                    async_write (SharedBuffer (
+                        next.m_response.data (), next.m_response.size ()));
+                    next.m_response.clear ();
+                }
+            }
+        }
+
+        // Requests held back by the concurrency limit may go ahead
+        proceed ();
+    }
+
     //--------------------------------------------------------------------------
     //
     // Peer
@@ -430,6 +593,7 @@ public:
         m_request_timer.cancel (ec);
         m_socket->cancel (ec);
         m_socket->shutdown (socket::shutdown_both);
+        m_requests.clear ();
     }
 
     // Called by a completion handler when error is not eof or aborted.
@@ -437,29 +601,165 @@ public:
     {
         m_errorCode = ec.value();
         bassert (m_errorCode != 0);
+        m_closed = true;
         cancel ();
     }
 
-    // Call the async_read_some initiating function.
-    void async_read_some ()
+    // Close gracefully once all pending writes are sent.
+    void finish ()
+    {
+        m_closed = true;
+        m_requests.clear ();
+
+        error_code ec;
+        m_request_timer.cancel (ec);
+        m_data_timer.cancel (ec);
+
+        if (m_reading)
+        {
+            if (! m_socket->needs_handshake())
+                m_socket->shutdown (socket::shutdown_receive);
+
+            // Give the remote end a little time to finish the close
+            m_idle = false;
+            start_data_timer ();
+        }
+
+        if (m_writesPending == 0)
+            m_socket->shutdown (socket::shutdown_send);
+    }
+
+    // Decides what to do after new input or a completed response.
+    void proceed ()
+    {
+        process_input ();
+
+        if (m_closed)
+            return;
+
+        if (m_eof && m_pending.empty ())
+        {
+            if (m_requestStarted)
+            {
+                // The connection ended in the middle of a request
+                failed (boost::system::errc::make_error_code (
+                    boost::system::errc::bad_message));
+                return;
+            }
+
+            m_readClosed = true;
+        }
+
+        if (m_readClosed)
+        {
+            if (m_requests.empty ())
+                finish ();
+            return;
+        }
+
+        async_read_some ();
+    }
+
+    // Feed received bytes to the parser, delivering each complete
+    // request until the concurrency limit is reached.
+    void process_input ()
+    {
+        while (! m_closed && ! m_readClosed && ! m_pending.empty () &&
+            (m_requests.size () < std::size_t (m_maxConcurrentRequests)))
+        {
+            if (! m_requestStarted)
+            {
+                m_requestStarted = true;
+                start_request_timer ();
+            }
+
+            std::size_t const bytes_parsed (m_parser->process (
+                m_pending.data(), m_pending.size()));
+
+            if (m_parser->error())
+            {
+                failed (boost::system::errc::make_error_code (
+                    boost::system::errc::bad_message));
+                return;
+            }
+
+            m_pending.erase (0, bytes_parsed);
+            m_requestBytes += bytes_parsed;
+
+            if (m_requestBytes > maxRequestBytes)
+            {
+                failed (boost::system::errc::make_error_code (
+                    boost::system::errc::message_size));
+                return;
+            }
+
+            if (! m_parser->finished ())
+            {
+                // Feed some headers to the callback
+                if (m_parser->fields().size() > 0)
+                    handle_headers();
+                break;
+            }
+
+            handle_request ();
+        }
+    }
+
+    void start_request_timer ()
+    {
+        m_request_timer.expires_from_now (
+            boost::posix_time::seconds (
+                requestTimeoutSeconds));
+
+        m_request_timer.async_wait (m_strand.wrap (boost::bind (
+            &Peer::handle_request_timer, Ptr(this),
+                boost::asio::placeholders::error,
+                    CompletionCounter (this))));
+    }
+
+    // (this cancels the previous wait, if any)
+    void start_data_timer ()
     {
-        // re-arm the data timer
-        // (this cancels the previous wait, if any)
-        //
         m_data_timer.expires_from_now (
             boost::posix_time::seconds (
-                dataTimeoutSeconds));
+                m_idle ? 1 : dataTimeoutSeconds));
 
         m_data_timer.async_wait (m_strand.wrap (boost::bind (
             &Peer::handle_data_timer, Ptr(this),
                 boost::asio::placeholders::error,
                     CompletionCounter (this))));
+    }
+
+    // Call the async_read_some initiating function.
+    void async_read_some ()
+    {
+        // Requests beyond the limit stay unread until a response completes
+        if (m_reading || m_eof || m_readClosed ||
+            (m_requests.size () >= std::size_t (m_maxConcurrentRequests)) ||
+            (m_pending.size () >= maxRequestBytes))
+            return;
+
+        // re-arm the data timer. There is no timeout while
+        // the handler is working on a request.
+        //
+        if (m_requestStarted || m_requests.empty ())
+        {
+            m_idle = ! m_requestStarted;
+            start_data_timer ();
+        }
+        else
+        {
+            error_code ec;
+            m_data_timer.cancel (ec);
+        }
 
         // issue the read
         //
         boost::asio::mutable_buffers_1 buf (
             m_buffer.getData (), m_buffer.getSize ());
 
+        m_reading = true;
+
         m_socket->async_read_some (buf, m_strand.wrap (
             boost::bind (&Peer::handle_read, Ptr (this),
                 boost::asio::placeholders::error,
@@ -507,6 +807,100 @@ public:
     }
 };
 
+//------------------------------------------------------------------------------
+
+inline Request::Request (Peer& peer, HTTPRequestParser& parser,
+    IPAddress const& remoteAddress)
+    : m_peer (&peer)
+    , m_request (parser.request())
+    , m_fields (parser.fields())
+    , m_remoteAddress (remoteAddress)
+    , m_keepAlive (parser.keepAlive())
+    , m_head (false)
+    , m_complete (false)
+    , m_closeAfter (false)
+{
+    tag = nullptr;
+
+    DynamicBuffer const& body (m_request->body ());
+    m_content.resize (body.size ());
+    if (! m_content.empty ())
+        boost::asio::buffer_copy (
+            boost::asio::buffer (&m_content[0],
+                m_content.size()), body.data <boost::asio::const_buffer>());
+}
+
+inline Request::~Request ()
+{
+}
+
+inline Journal Request::journal()
+{
+    return m_peer->journal();
+}
+
+inline IPAddress Request::remoteAddress()
+{
+    return m_remoteAddress;
+}
+
+inline bool Request::headersComplete()
+{
+    return true;
+}
+
+inline HTTPHeaders Request::headers()
+{
+    return HTTPHeaders (m_fields);
+}
+
+inline SharedPtr <beast::HTTPRequest> const& Request::request()
+{
+    return m_request;
+}
+
+inline std::string Request::content()
+{
+    return m_content;
+}
+
+inline void Request::write (void const* buffer, std::size_t bytes)
+{
+    // Posted rather than dispatched, so a Handler which responds from
+    // inside onRequest does not re-enter the Peer's input processing.
+    m_peer->m_impl.get_io_service().post (m_peer->m_strand.wrap (
+        boost::bind (&Peer::handle_response_write, m_peer,
+            Ptr (this), SharedBuffer (static_cast <char const*> (buffer), bytes),
+                Peer::CompletionCounter (m_peer.get ()))));
+}
+
+inline void Request::detach ()
+{
+    if (m_detached.compareAndSetBool (1, 0))
+    {
+        // Maintain an additional reference until the response completes
+        m_detach_ref = this;
+
+        // Prevent the io_service from running out of work.
+        m_work = boost::in_place (boost::ref (
+            m_peer->m_impl.get_io_service()));
+    }
+}
+
+inline void Request::complete ()
+{
+    m_peer->m_impl.get_io_service().post (m_peer->m_strand.wrap (
+        boost::bind (&Peer::handle_response_complete, m_peer,
+            Ptr (this), false, Peer::CompletionCounter (m_peer.get ()))));
+}
+
+inline void Request::close ()
+{
+    m_peer->m_impl.get_io_service().post (m_peer->m_strand.wrap (
+        boost::bind (&Peer::handle_response_complete, m_peer,
+            Ptr (this), true, Peer::CompletionCounter (m_peer.get ()))));
+}
+
 }
 }
 
@@ -24,6 +24,7 @@ Port::Port ()
     : port (0)
     , security (no_ssl)
     , context (nullptr)
+    , maxConcurrentRequests (1)
 {
 }
 
@@ -32,6 +33,7 @@ Port::Port (Port const& other)
     , addr (other.addr)
     , security (other.security)
     , context (other.context)
+    , maxConcurrentRequests (other.maxConcurrentRequests)
 {
 }
 
@@ -41,6 +43,7 @@ Port& Port::operator= (Port const& other)
     addr = other.addr;
     security = other.security;
     context = other.context;
+    maxConcurrentRequests = other.maxConcurrentRequests;
     return *this;
 }
 
@@ -53,6 +56,7 @@ Port::Port (
     , addr (addr_)
     , security (security_)
     , context (context_)
+    , maxConcurrentRequests (1)
 {
 }
 
@@ -64,7 +68,7 @@ bool operator== (Port const& lhs, Port const& rhs)
         return false;
     if (lhs.security != rhs.security)
         return false;
-    // 'context' does not participate in the comparison
+    // 'context' and 'maxConcurrentRequests' do not participate in the comparison
     return true;
 }
 
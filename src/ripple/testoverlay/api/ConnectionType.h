@@ -31,26 +31,37 @@ public:
     typedef typename Config::Peer    Peer;
     typedef typename Config::Message Message;
     typedef typename Config::State   State;
+    typedef typename Config::SizeType SizeType;
     typedef typename State::UniqueID UniqueID;
 
     typedef std::vector <Message> Messages;
+    typedef std::deque <std::pair <SizeType, Message> > Transit;
     typedef boost::unordered_set <UniqueID> MessageTable;
 
     /** Create the 'no connection' object. */
     ConnectionType ()
         : m_peer (nullptr)
+        , m_latency (0)
+        , m_bandwidth (0)
+        , m_busyUntil (0)
     {
     }
 
     ConnectionType (Peer& peer, bool inbound)
         : m_peer (&peer)
         , m_inbound (inbound)
+        , m_latency (0)
+        , m_bandwidth (0)
+        , m_busyUntil (0)
     {
     }
 
     ConnectionType (ConnectionType const& other)
         : m_peer (other.m_peer)
         , m_inbound (other.m_inbound)
+        , m_latency (other.m_latency)
+        , m_bandwidth (other.m_bandwidth)
+        , m_busyUntil (other.m_busyUntil)
     {
     }
 
@@ -58,6 +69,9 @@ public:
     {
         m_peer = other.m_peer;
         m_inbound = other.m_inbound;
+        m_latency = other.m_latency;
+        m_bandwidth = other.m_bandwidth;
+        m_busyUntil = other.m_busyUntil;
         return *this;
     }
 
@@ -121,6 +135,68 @@ public:
     }
     /** @} */
 
+    /** Returns the extra number of steps a message spends in transit.
+        Messages arriving on this connection are delivered this many
+        steps later than they would be on an ideal link. The default
+        is zero, which delivers on the step after the message was sent.
+    */
+    SizeType latency () const
+    {
+        return m_latency;
+    }
+
+    void setLatency (SizeType steps)
+    {
+        m_latency = steps;
+    }
+
+    /** Returns the number of payload bytes the link carries per step.
+        Zero means unlimited. When limited, messages are serialized onto
+        the link in the order they were sent so a large message delays
+        every message queued behind it. This requires Payload::bytes().
+    */
+    SizeType bandwidth () const
+    {
+        return m_bandwidth;
+    }
+
+    void setBandwidth (SizeType bytesPerStep)
+    {
+        m_bandwidth = bytesPerStep;
+    }
+
+    /** Returns the number of messages still travelling on this link. */
+    SizeType inTransit () const
+    {
+        return m_transit.size ();
+    }
+
+    /** Replace the current messages with the ones due at step `now`.
+        The pending messages are first put on the link, then every
+        message whose arrival step has been reached is made current.
+    */
+    void deliver (SizeType now)
+    {
+        m_messages.clear ();
+
+        for (typename Messages::iterator iter (m_pending.begin ());
+            iter != m_pending.end (); ++iter)
+        {
+            SizeType const start (std::max (now, m_busyUntil));
+            SizeType transmit (0);
+            if (m_bandwidth != 0)
+                transmit = (iter->payload ().bytes () + m_bandwidth - 1) / m_bandwidth;
+            m_busyUntil = start + transmit;
+            m_transit.push_back (std::make_pair (m_busyUntil + m_latency, *iter));
+        }
+        m_pending.clear ();
+
+        while (! m_transit.empty () && m_transit.front ().first <= now)
+        {
+            m_messages.push_back (m_transit.front ().second);
+            m_transit.pop_front ();
+        }
+    }
 
     //--------------------------------------------------------------------------
 
@@ -179,8 +255,12 @@ public:
 private:
     Peer* m_peer;
     bool m_inbound;
+    SizeType m_latency;
+    SizeType m_bandwidth;
+    SizeType m_busyUntil;
     Messages m_messages;
     Messages m_pending;
+    Transit m_transit;
 };
 
 }
@@ -272,13 +272,13 @@ public:
     /** Called once on each Peer object after every iteration. */
     void post_step ()
     {
-        // Move pending messages to current messages
+        // Move pending messages onto the link and
+        // make the ones that have arrived current.
         for (typename Connections::iterator iter (connections().begin());
             iter != connections().end(); ++iter)
         {
             Connection& c (*iter);
-            c.messages().clear ();
-            c.messages().swap (c.pending());
+            c.deliver (network().steps());
         }
 
         m_logic.post_step ();
@@ -73,6 +73,12 @@ public:
         return m_data;
     }
 
+    /** Returns the simulated size of the payload on the wire. */
+    std::size_t bytes () const
+    {
+        return sizeof (m_what) + sizeof (m_hops) + m_data.getNumBytesAsUTF8 ();
+    }
+
 private:
     int m_hops;
     int m_what;
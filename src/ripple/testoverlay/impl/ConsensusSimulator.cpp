@@ -0,0 +1,954 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace TestOverlay
+{
+
+/** A deterministic network and timing simulator for consensus.
+
+    A network of validators is simulated in a single thread on top of the
+    TestOverlay framework. One step of the network is one millisecond of
+    simulated time, and every link has its own latency and bandwidth. A
+    synthetic transaction load is submitted at a fixed rate and flooded to
+    all nodes. Each node then runs a model of the ledger consensus rounds:
+    it closes its open ledger, exchanges proposals, updates its position
+    with the avalanche thresholds from LedgerTiming.h, declares consensus,
+    and broadcasts a validation.
+
+    This models the rounds, it does not run LedgerConsensus, Validations
+    or any transaction processing. It shows how the timing parameters
+    behave under a given topology and load, not how much work the server
+    does to reach consensus.
+
+    Given the same Setup, every run produces the same ledgers and message
+    counts. Only the measured wall time varies from run to run.
+*/
+class ConsensusSimulator : public UnitTest
+{
+public:
+    /** Parameters for one simulation run.
+        All times are in milliseconds, which is also the size of a step.
+    */
+    struct Setup
+    {
+        Setup ()
+            : nodes (10)
+            , outgoing (3)
+            , latency (50)
+            , jitter (0)
+            , bandwidth (0)
+            , txRate (100)
+            , txBytes (250)
+            , ledgers (20)
+            , minClose (LEDGER_MIN_CLOSE)
+            , idleInterval (LEDGER_IDLE_INTERVAL * 1000)
+            , granularity (LEDGER_GRANULARITY)
+            , minConsensus (LEDGER_MIN_CONSENSUS)
+            , quorum (80)
+            , seed (42)
+        {
+        }
+
+        String toString () const
+        {
+            return String (name)
+                + ": nodes(" + String (nodes) + ")"
+                + ", latency(" + String (latency) + "+" + String (jitter) + "ms)"
+                + ", bandwidth(" + (bandwidth == 0 ? String ("unlimited")
+                    : String (bandwidth) + " bytes/ms") + ")"
+                + ", load(" + String (txRate) + " tx/s)";
+        }
+
+        String name;
+        int nodes;          // number of validators, all on every UNL
+        int outgoing;       // outgoing connections made by each node
+        int latency;        // one-way link latency
+        int jitter;         // extra random latency per link, up to this
+        int bandwidth;      // bytes per millisecond per link, 0 is unlimited
+        int txRate;         // transactions submitted per second, network wide
+        int txBytes;        // size of a transaction on the wire
+        int ledgers;        // stop once every node has validated this many
+        int minClose;       // LEDGER_MIN_CLOSE
+        int idleInterval;   // LEDGER_IDLE_INTERVAL
+        int granularity;    // LEDGER_GRANULARITY
+        int minConsensus;   // LEDGER_MIN_CONSENSUS
+        int quorum;         // percentage of nodes needed to agree or validate
+        int64 seed;
+    };
+
+    //--------------------------------------------------------------------------
+
+    /** The figures measured by one simulation run. */
+    struct Report
+    {
+        Report ()
+            : simulatedSeconds (0)
+            , wallSeconds (0)
+            , ledgers (0)
+            , txSubmitted (0)
+            , txValidated (0)
+            , txPerLedger (0)
+            , maxTxPerLedger (0)
+            , closeLatency (0)
+            , maxCloseLatency (0)
+            , ledgerInterval (0)
+            , proposals (0)
+            , proposalMessages (0)
+            , validations (0)
+            , validationMessages (0)
+            , txMessages (0)
+            , bytes (0)
+            , jumps (0)
+            , forks (0)
+            , fingerprint (0)
+        {
+        }
+
+        String toString () const
+        {
+            String s;
+            s << "ledgers(" << String (ledgers) << ")"
+              << ", simulated(" << String (simulatedSeconds, 1) << "s)"
+              << ", wall(" << String (wallSeconds, 3) << "s)" << newLine
+              << "  tx: submitted(" << String (txSubmitted) << ")"
+              << ", validated(" << String (txValidated) << ")"
+              << ", per ledger(" << String (txPerLedger, 1)
+              << " avg, " << String (maxTxPerLedger) << " max)" << newLine
+              << "  close latency(" << String (closeLatency, 1)
+              << "ms avg, " << String (maxCloseLatency) << "ms max)"
+              << ", ledger interval(" << String (ledgerInterval, 1) << "ms)" << newLine
+              << "  messages: proposals(" << String (proposals) << " created, "
+              << String (proposalMessages) << " received)"
+              << ", validations(" << String (validations) << " created, "
+              << String (validationMessages) << " received)"
+              << ", transactions(" << String (txMessages) << " received)"
+              << ", bytes(" << String (bytes) << ")" << newLine
+              << "  jumps(" << String (jumps) << ")"
+              << ", forks(" << String (forks) << ")";
+            return s;
+        }
+
+        double simulatedSeconds;
+        double wallSeconds;
+        int ledgers;            // validated by every node
+        int64 txSubmitted;
+        int64 txValidated;
+        double txPerLedger;
+        int maxTxPerLedger;
+        double closeLatency;    // first close to validation, per node
+        int maxCloseLatency;
+        double ledgerInterval;  // between successive first closes
+        int64 proposals;
+        int64 proposalMessages;
+        int64 validations;
+        int64 validationMessages;
+        int64 txMessages;
+        int64 bytes;
+        int jumps;              // nodes that adopted the network's ledger
+        int forks;              // ledgers validated with differing hashes
+        uint64 fingerprint;     // identical for identical runs
+    };
+
+    //--------------------------------------------------------------------------
+
+    /** A set of transaction ids, shared between the messages carrying it. */
+    class TxSet : public SharedObject
+    {
+    public:
+        typedef SharedPtr <TxSet> Ptr;
+
+        template <class Iterator>
+        TxSet (Iterator first, Iterator last)
+            : m_txs (first, last)
+            , m_hash (0x5bd1e995)
+        {
+            for (std::vector <uint64>::const_iterator iter (m_txs.begin ());
+                iter != m_txs.end (); ++iter)
+                m_hash = mix (m_hash ^ *iter);
+        }
+
+        std::vector <uint64> const& txs () const
+        {
+            return m_txs;
+        }
+
+        uint64 hash () const
+        {
+            return m_hash;
+        }
+
+    private:
+        std::vector <uint64> m_txs;
+        uint64 m_hash;
+    };
+
+    /** Stands in for a cryptographic hash in the simulation. */
+    static uint64 mix (uint64 h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    //--------------------------------------------------------------------------
+
+    /** The payload of every message in the simulation. */
+    class Payload
+    {
+    public:
+        enum Kind
+        {
+            transaction,
+            proposal,
+            validation
+        };
+
+        Payload ()
+            : m_kind (transaction)
+            , m_node (0)
+            , m_seq (0)
+            , m_proposeSeq (0)
+            , m_hash (0)
+            , m_prevHash (0)
+            , m_bytes (0)
+        {
+        }
+
+        Payload (Kind kind, uint64 node, int seq, int proposeSeq,
+            uint64 hash, uint64 prevHash, TxSet::Ptr const& set, int bytes)
+            : m_kind (kind)
+            , m_node (node)
+            , m_seq (seq)
+            , m_proposeSeq (proposeSeq)
+            , m_hash (hash)
+            , m_prevHash (prevHash)
+            , m_set (set)
+            , m_bytes (bytes)
+        {
+        }
+
+        Kind kind () const
+        {
+            return m_kind;
+        }
+
+        uint64 node () const
+        {
+            return m_node;
+        }
+
+        int seq () const
+        {
+            return m_seq;
+        }
+
+        int proposeSeq () const
+        {
+            return m_proposeSeq;
+        }
+
+        /** The transaction id, position hash or ledger hash. */
+        uint64 hash () const
+        {
+            return m_hash;
+        }
+
+        /** The hash of the ledger a proposal builds on. */
+        uint64 prevHash () const
+        {
+            return m_prevHash;
+        }
+
+        /** The proposed or validated transaction set.
+            A real node would acquire the set from its peers; here it rides
+            along with the message, and its size is charged in bytes().
+        */
+        TxSet::Ptr const& set () const
+        {
+            return m_set;
+        }
+
+        std::size_t bytes () const
+        {
+            return m_bytes;
+        }
+
+    private:
+        Kind m_kind;
+        uint64 m_node;
+        int m_seq;
+        int m_proposeSeq;
+        uint64 m_hash;
+        uint64 m_prevHash;
+        TxSet::Ptr m_set;
+        int m_bytes;
+    };
+
+    //--------------------------------------------------------------------------
+
+    /** Network wide setup and measurements. */
+    template <class Config>
+    class SimState : public StateBase <Config>
+    {
+    public:
+        struct NodeStats
+        {
+            NodeStats ()
+                : validatedSeq (0)
+            {
+            }
+
+            int validatedSeq;
+        };
+
+        struct LedgerStats
+        {
+            LedgerStats ()
+                : hash (0)
+                , txCount (0)
+                , firstClose (-1)
+            {
+            }
+
+            uint64 hash;
+            int txCount;
+            int64 firstClose;
+        };
+
+        SimState ()
+            : m_nextTxID (0)
+            , m_latencySum (0)
+            , m_latencyCount (0)
+        {
+        }
+
+        Setup const& setup ()
+        {
+            return m_setup;
+        }
+
+        void setup (Setup const& setup)
+        {
+            m_setup = setup;
+            m_nodes.resize (setup.nodes);
+            this->random ().setSeed (setup.seed);
+        }
+
+        Report& report ()
+        {
+            return m_report;
+        }
+
+        NodeStats& node (uint64 id)
+        {
+            return m_nodes [static_cast <std::size_t> (id - 1)];
+        }
+
+        uint64 nextTxID ()
+        {
+            return ++m_nextTxID;
+        }
+
+        /** Returns true if every node validated at least `seq`. */
+        bool allValidated (int seq) const
+        {
+            for (std::size_t i = 0; i < m_nodes.size (); ++i)
+                if (m_nodes [i].validatedSeq < seq)
+                    return false;
+            return true;
+        }
+
+        void onClose (int seq, int64 now)
+        {
+            LedgerStats& ledger (getLedger (seq));
+            if (ledger.firstClose < 0)
+                ledger.firstClose = now;
+        }
+
+        void onValidated (uint64 node, int seq, uint64 hash,
+            TxSet::Ptr const& set, int64 now)
+        {
+            this->node (node).validatedSeq = seq;
+
+            LedgerStats& ledger (getLedger (seq));
+            if (ledger.hash == 0)
+            {
+                ledger.hash = hash;
+                ledger.txCount = set->txs ().size ();
+            }
+            else if (ledger.hash != hash)
+            {
+                ++m_report.forks;
+            }
+
+            if (ledger.firstClose >= 0)
+            {
+                int const latency (static_cast <int> (now - ledger.firstClose));
+                m_latencySum += latency;
+                ++m_latencyCount;
+                m_report.maxCloseLatency = std::max (
+                    m_report.maxCloseLatency, latency);
+            }
+        }
+
+        /** Fill in the summary figures once the run is over. */
+        void finish (int64 steps, double wallSeconds)
+        {
+            Report& r (m_report);
+
+            r.simulatedSeconds = steps / 1000.0;
+            r.wallSeconds = wallSeconds;
+            r.ledgers = m_setup.ledgers;
+            for (std::size_t i = 0; i < m_nodes.size (); ++i)
+                r.ledgers = std::min (r.ledgers, m_nodes [i].validatedSeq);
+
+            int64 intervals (0);
+            uint64 fingerprint (m_setup.seed);
+            for (int seq = 1; seq <= r.ledgers; ++seq)
+            {
+                LedgerStats const& ledger (m_ledgers [seq - 1]);
+                r.txValidated += ledger.txCount;
+                r.maxTxPerLedger = std::max (r.maxTxPerLedger, ledger.txCount);
+                if (seq > 1)
+                    intervals += ledger.firstClose - m_ledgers [seq - 2].firstClose;
+                fingerprint = mix (fingerprint ^ ledger.hash);
+            }
+            if (r.ledgers > 0)
+                r.txPerLedger = double (r.txValidated) / r.ledgers;
+            if (r.ledgers > 1)
+                r.ledgerInterval = double (intervals) / (r.ledgers - 1);
+            if (m_latencyCount > 0)
+                r.closeLatency = double (m_latencySum) / m_latencyCount;
+
+            fingerprint = mix (fingerprint ^ r.proposalMessages);
+            fingerprint = mix (fingerprint ^ r.validationMessages);
+            fingerprint = mix (fingerprint ^ r.txMessages);
+            fingerprint = mix (fingerprint ^ steps);
+            r.fingerprint = fingerprint;
+        }
+
+    private:
+        LedgerStats& getLedger (int seq)
+        {
+            if (m_ledgers.size () < std::size_t (seq))
+                m_ledgers.resize (seq);
+            return m_ledgers [seq - 1];
+        }
+
+        Setup m_setup;
+        Report m_report;
+        uint64 m_nextTxID;
+        std::vector <NodeStats> m_nodes;
+        std::vector <LedgerStats> m_ledgers;
+        int64 m_latencySum;
+        int64 m_latencyCount;
+    };
+
+    //--------------------------------------------------------------------------
+
+    /** The consensus model run by each validator. */
+    template <class Config>
+    class NodeLogic : public PeerLogicBase <Config>
+    {
+    public:
+        typedef PeerLogicBase <Config>      Base;
+        typedef typename Base::Connection   Connection;
+        typedef typename Base::Peer         Peer;
+        typedef typename Base::Message      Message;
+        typedef typename Config::State      State;
+        typedef typename State::UniqueID    UniqueID;
+
+        explicit NodeLogic (Peer& peer)
+            : Base (peer)
+            , m_establish (false)
+            , m_lclSeq (0)
+            , m_lclHash (1)
+            , m_validatedSeq (0)
+            , m_openStart (0)
+            , m_closeStart (0)
+            , m_lastPropose (0)
+            , m_prevRoundTime (0)
+            , m_proposeSeq (0)
+            , m_txCredit (0)
+        {
+        }
+
+        void receive (Connection const& c, Message const& m)
+        {
+            State& state (this->peer().network().state());
+            Payload const& payload (m.payload ());
+
+            state.report().bytes += payload.bytes ();
+
+            switch (payload.kind ())
+            {
+            case Payload::transaction:
+                ++state.report().txMessages;
+                if (m_applied.count (payload.hash ()) == 0)
+                    m_pool.insert (payload.hash ());
+                break;
+
+            case Payload::proposal:
+            {
+                ++state.report().proposalMessages;
+                typename Proposals::iterator const iter (
+                    m_proposals.find (payload.node ()));
+                if (iter == m_proposals.end ())
+                    m_proposals.insert (std::make_pair (payload.node (), payload));
+                else if (isNewer (payload, iter->second))
+                    iter->second = payload;
+                break;
+            }
+
+            case Payload::validation:
+                ++state.report().validationMessages;
+                addValidation (payload.seq (), payload.hash (), payload.set ());
+                break;
+            }
+
+            this->peer().send_all_if (m,
+                typename Connection::IsNotPeer (c.peer()));
+        }
+
+        void step ()
+        {
+            int64 const now (this->peer().network().steps());
+
+            submitTransactions ();
+
+            if (! m_establish)
+            {
+                if (shouldClose (now))
+                    closeLedger (now);
+            }
+            else
+            {
+                if (now - m_lastPropose >= setup().granularity)
+                    updatePosition (now);
+                checkConsensus (now);
+            }
+        }
+
+    private:
+        typedef std::map <UniqueID, Payload> Proposals;
+        typedef std::pair <int, uint64> LedgerID;
+
+        struct Validations
+        {
+            Validations ()
+                : count (0)
+            {
+            }
+
+            int count;
+            TxSet::Ptr set;
+        };
+
+        typedef std::map <LedgerID, Validations> ValidationMap;
+
+        static bool isNewer (Payload const& lhs, Payload const& rhs)
+        {
+            if (lhs.seq () != rhs.seq ())
+                return lhs.seq () > rhs.seq ();
+            return lhs.proposeSeq () > rhs.proposeSeq ();
+        }
+
+        Setup const& setup ()
+        {
+            return this->peer().network().state().setup();
+        }
+
+        // Returns true if the proposal builds on the same ledger we do.
+        bool isCurrent (Payload const& proposal) const
+        {
+            return proposal.seq () == m_lclSeq + 1 &&
+                proposal.prevHash () == m_lclHash;
+        }
+
+        void submitTransactions ()
+        {
+            State& state (this->peer().network().state());
+            m_txCredit += double (setup().txRate) / 1000 / setup().nodes;
+            while (m_txCredit >= 1)
+            {
+                m_txCredit -= 1;
+                uint64 const id (state.nextTxID ());
+                ++state.report().txSubmitted;
+                m_pool.insert (id);
+                this->peer().send_all (Payload (Payload::transaction,
+                    this->peer().id(), 0, 0, id, 0, TxSet::Ptr (),
+                        setup().txBytes));
+            }
+        }
+
+        bool shouldClose (int64 now)
+        {
+            int64 const sinceOpen (now - m_openStart);
+
+            if (sinceOpen >= setup().idleInterval)
+                return true;
+
+            if (! m_pool.empty () && sinceOpen >= setup().minClose)
+                return true;
+
+            // Close if more than half of the network already has
+            int closed (0);
+            for (typename Proposals::const_iterator iter (m_proposals.begin ());
+                iter != m_proposals.end (); ++iter)
+                if (isCurrent (iter->second))
+                    ++closed;
+            return closed * 2 > setup().nodes;
+        }
+
+        void closeLedger (int64 now)
+        {
+            m_establish = true;
+            m_closeStart = now;
+            m_proposeSeq = 0;
+            m_position = new TxSet (m_pool.begin (), m_pool.end ());
+            this->peer().network().state().onClose (m_lclSeq + 1, now);
+            propose (now);
+        }
+
+        void propose (int64 now)
+        {
+            State& state (this->peer().network().state());
+            m_lastPropose = now;
+            ++state.report().proposals;
+            this->peer().send_all (Payload (Payload::proposal,
+                this->peer().id(), m_lclSeq + 1, m_proposeSeq,
+                    m_position->hash (), m_lclHash, m_position,
+                        150 + 32 * m_position->txs ().size ()));
+        }
+
+        // Returns the percentage of proposers that must include a
+        // transaction, based on how long this round has been running.
+        int getThreshold (int64 now)
+        {
+            int64 const elapsed (now - m_closeStart);
+            int64 const expected (std::max <int64> (
+                m_prevRoundTime, setup().minConsensus));
+            int64 const percent (elapsed * 100 / expected);
+
+            if (percent < AV_MID_CONSENSUS_TIME)
+                return AV_INIT_CONSENSUS_PCT;
+            if (percent < AV_LATE_CONSENSUS_TIME)
+                return AV_MID_CONSENSUS_PCT;
+            if (percent < AV_STUCK_CONSENSUS_TIME)
+                return AV_LATE_CONSENSUS_PCT;
+            return AV_STUCK_CONSENSUS_PCT;
+        }
+
+        void updatePosition (int64 now)
+        {
+            m_lastPropose = now;
+
+            std::map <uint64, int> votes;
+            int proposers (1);
+            addVotes (votes, *m_position);
+            for (typename Proposals::const_iterator iter (m_proposals.begin ());
+                iter != m_proposals.end (); ++iter)
+            {
+                if (isCurrent (iter->second))
+                {
+                    ++proposers;
+                    addVotes (votes, *iter->second.set ());
+                }
+            }
+
+            int const threshold (getThreshold (now));
+            std::vector <uint64> txs;
+            for (std::map <uint64, int>::const_iterator iter (votes.begin ());
+                iter != votes.end (); ++iter)
+                if (iter->second * 100 > threshold * proposers)
+                    txs.push_back (iter->first);
+
+            TxSet::Ptr const position (new TxSet (txs.begin (), txs.end ()));
+            if (position->hash () != m_position->hash ())
+            {
+                m_position = position;
+                ++m_proposeSeq;
+                propose (now);
+            }
+        }
+
+        static void addVotes (std::map <uint64, int>& votes, TxSet const& set)
+        {
+            for (std::vector <uint64>::const_iterator iter (set.txs ().begin ());
+                iter != set.txs ().end (); ++iter)
+                ++votes [*iter];
+        }
+
+        void checkConsensus (int64 now)
+        {
+            if (now - m_closeStart < setup().minConsensus)
+                return;
+
+            int agree (1);
+            for (typename Proposals::const_iterator iter (m_proposals.begin ());
+                iter != m_proposals.end (); ++iter)
+                if (isCurrent (iter->second) &&
+                    iter->second.hash () == m_position->hash ())
+                    ++agree;
+
+            if (agree * 100 >= setup().quorum * setup().nodes)
+                accept (now);
+        }
+
+        void accept (int64 now)
+        {
+            State& state (this->peer().network().state());
+            int const seq (m_lclSeq + 1);
+            uint64 const hash (mix (m_lclHash ^ mix (m_position->hash () + seq)));
+            TxSet::Ptr const set (m_position);
+
+            m_prevRoundTime = now - m_closeStart;
+            applyLedger (seq, hash, *set, now);
+
+            ++state.report().validations;
+            this->peer().send_all (Payload (Payload::validation,
+                this->peer().id(), seq, 0, hash, m_lclHash, set, 200));
+            addValidation (seq, hash, set);
+        }
+
+        void applyLedger (int seq, uint64 hash, TxSet const& set, int64 now)
+        {
+            m_lclSeq = seq;
+            m_lclHash = hash;
+            for (std::vector <uint64>::const_iterator iter (set.txs ().begin ());
+                iter != set.txs ().end (); ++iter)
+            {
+                m_pool.erase (*iter);
+                m_applied.insert (*iter);
+            }
+            m_establish = false;
+            m_openStart = now;
+        }
+
+        void addValidation (int seq, uint64 hash, TxSet::Ptr const& set)
+        {
+            if (seq <= m_validatedSeq)
+                return;
+
+            State& state (this->peer().network().state());
+            Validations& v (m_validations [LedgerID (seq, hash)]);
+            ++v.count;
+            if (v.set.empty ())
+                v.set = set;
+
+            if (v.count * 100 < setup().quorum * setup().nodes)
+                return;
+
+            int64 const now (this->peer().network().steps());
+            m_validatedSeq = seq;
+            state.onValidated (this->peer().id(), seq, hash, v.set, now);
+
+            // The network validated a ledger we did not build, so adopt it.
+            if (seq > m_lclSeq || (seq == m_lclSeq && hash != m_lclHash))
+            {
+                ++state.report().jumps;
+                applyLedger (seq, hash, *v.set, now);
+            }
+
+            m_validations.erase (m_validations.begin (),
+                m_validations.upper_bound (LedgerID (seq,
+                    std::numeric_limits <uint64>::max ())));
+        }
+
+        bool m_establish;
+        int m_lclSeq;
+        uint64 m_lclHash;
+        int m_validatedSeq;
+        int64 m_openStart;
+        int64 m_closeStart;
+        int64 m_lastPropose;
+        int64 m_prevRoundTime;
+        int m_proposeSeq;
+        double m_txCredit;
+        TxSet::Ptr m_position;
+        std::set <uint64> m_pool;
+        boost::unordered_set <uint64> m_applied;
+        Proposals m_proposals;
+        ValidationMap m_validations;
+    };
+
+    //--------------------------------------------------------------------------
+
+    struct Params : ConfigType <
+        Params,
+        SimState,
+        NodeLogic
+    >
+    {
+        typedef ConsensusSimulator::Payload Payload;
+    };
+
+    typedef Params::Network Network;
+    typedef Network::Peer Peer;
+
+    /** Stops the simulation when the run is complete or has stalled. */
+    class IsFinished
+    {
+    public:
+        bool operator() (Network& network) const
+        {
+            Setup const& setup (network.state ().setup ());
+            return network.state ().allValidated (setup.ledgers) ||
+                network.steps () >= Network::SizeType (
+                    setup.ledgers) * setup.idleInterval * 2;
+        }
+    };
+
+    // Connect every node to its predecessor so the network is never
+    // partitioned, then add random outgoing connections.
+    static void buildNetwork (Network& network)
+    {
+        Setup const& setup (network.state ().setup ());
+        Random& random (network.state ().random ());
+
+        for (int i = 0; i < setup.nodes; ++i)
+            network.createPeer ();
+
+        Network::Peers& peers (network.peers ());
+        for (int i = 1; i < setup.nodes; ++i)
+        {
+            Peer& peer (*peers [i]);
+            connect (peer, *peers [i - 1], setup, random);
+            for (int j = 1; j < setup.outgoing; ++j)
+                connect (peer, *peers [random.nextInt (setup.nodes)],
+                    setup, random);
+        }
+    }
+
+    static void connect (Peer& from, Peer& to, Setup const& setup,
+        Random& random)
+    {
+        if (! from.connect_to (to))
+            return;
+        int const latency (setup.latency +
+            (setup.jitter > 0 ? random.nextInt (setup.jitter + 1) : 0));
+        setLink (from.connections ().back (), latency, setup.bandwidth);
+        setLink (to.connections ().back (), latency, setup.bandwidth);
+    }
+
+    static void setLink (Peer::Connection& c, int latency, int bandwidth)
+    {
+        c.setLatency (latency);
+        c.setBandwidth (bandwidth);
+    }
+
+    /** Run one simulation and return its measurements. */
+    static Report run (Setup const& setup)
+    {
+        Network network;
+        network.state ().setup (setup);
+        buildNetwork (network);
+
+        int64 const start (Time::getHighResolutionTicks ());
+        network.step_until (IsFinished ());
+        double const wallSeconds (Time::highResolutionTicksToSeconds (
+            Time::getHighResolutionTicks () - start));
+
+        network.state ().finish (network.steps (), wallSeconds);
+        return network.state ().report ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void runSetup (Setup const& setup)
+    {
+        beginTestCase (setup.name);
+
+        Report const report (run (setup));
+        logMessage (setup.toString ());
+        logMessage (report.toString ());
+
+        expect (report.ledgers == setup.ledgers, "Ledgers not validated");
+        expect (report.forks == 0, "Validated ledgers differ");
+    }
+
+    void testDeterminism ()
+    {
+        beginTestCase ("determinism");
+
+        Setup setup;
+        setup.nodes = 7;
+        setup.latency = 20;
+        setup.jitter = 30;
+        setup.ledgers = 5;
+
+        Report const first (run (setup));
+        Report const second (run (setup));
+        expect (first.fingerprint == second.fingerprint,
+            "Identical setups produced different runs");
+
+        setup.seed = 43;
+        Report const third (run (setup));
+        expect (first.fingerprint != third.fingerprint,
+            "The seed does not change the run");
+    }
+
+    void runTest ()
+    {
+        testDeterminism ();
+
+        {
+            Setup setup;
+            setup.name = "lan";
+            setup.nodes = 5;
+            setup.outgoing = 4;
+            setup.latency = 1;
+            runSetup (setup);
+        }
+
+        {
+            Setup setup;
+            setup.name = "wan";
+            setup.nodes = 15;
+            setup.latency = 60;
+            setup.jitter = 80;
+            setup.bandwidth = 1250;
+            setup.txRate = 200;
+            runSetup (setup);
+        }
+
+        {
+            Setup setup;
+            setup.name = "large";
+            setup.nodes = 50;
+            setup.outgoing = 5;
+            setup.latency = 40;
+            setup.jitter = 60;
+            setup.txRate = 200;
+            setup.ledgers = 10;
+            runSetup (setup);
+        }
+    }
+
+    ConsensusSimulator () : UnitTest ("ConsensusSimulator", "ripple", runManual)
+    {
+    }
+};
+
+static ConsensusSimulator consensusSimulator;
+
+}
@@ -23,6 +23,10 @@
 
 namespace ripple {
 
+// The consensus simulator uses the same timing constants as the server
+#include "../../ripple_app/ledger/LedgerTiming.h"
+
 #include "impl/TestOverlay.cpp"
+#include "impl/ConsensusSimulator.cpp"
 
 }
@@ -23,8 +23,16 @@
 
 SETUP_LOG (LedgerConsensus)
 
-LedgerConsensus::LedgerConsensus (uint256 const& prevLCLHash, Ledger::ref previousLedger, uint32 closeTime)
-    :  mState (lcsPRE_CLOSE), mCloseTime (closeTime), mPrevLedgerHash (prevLCLHash), mPreviousLedger (previousLedger),
+LedgerConsensus::Metrics::Metrics (shared_ptr <insight::Collector> const& collector)
+    : open (collector->make_histogram ("consensus_open_ms"))
+    , establish (collector->make_histogram ("consensus_establish_ms"))
+    , accept (collector->make_histogram ("consensus_accept_ms"))
+{
+}
+
+LedgerConsensus::LedgerConsensus (uint256 const& prevLCLHash, Ledger::ref previousLedger, uint32 closeTime,
+                                  Metrics const& metrics)
+    :  mState (lcsPRE_CLOSE), m_metrics (metrics), mCloseTime (closeTime), mPrevLedgerHash (prevLCLHash), mPreviousLedger (previousLedger),
        mValPublic (getConfig ().VALIDATION_PUB), mValPrivate (getConfig ().VALIDATION_PRIV), mConsensusFail (false),
        mCurrentMSeconds (0), mClosePercent (0), mHaveCloseTimeConsensus (false),
        mConsensusStartTime (boost::posix_time::microsec_clock::universal_time ())
@@ -521,7 +529,9 @@ void LedgerConsensus::closeLedger ()
 {
     checkOurValidation ();
     mState = lcsESTABLISH;
-    mConsensusStartTime = boost::posix_time::microsec_clock::universal_time ();
+    boost::posix_time::ptime const now (boost::posix_time::microsec_clock::universal_time ());
+    m_metrics.open.record ((now - mConsensusStartTime).total_milliseconds ());
+    mConsensusStartTime = now;
     mCloseTime = getApp().getOPs ().getCloseTimeNC ();
     getApp().getOPs ().setLastCloseTime (mCloseTime);
     statusChange (protocol::neCLOSING_LEDGER, *mPreviousLedger);
@@ -1054,6 +1064,7 @@ void LedgerConsensus::beginAccept (bool synchronous)
     }
 
     getApp().getOPs ().newLCL (mPeerPositions.size (), mCurrentMSeconds, mNewLedgerHash);
+    m_metrics.establish.record (mCurrentMSeconds);
 
     if (synchronous)
         accept (consensusSet, LoadEvent::pointer ());
@@ -1072,18 +1083,42 @@ void LedgerConsensus::playbackProposals ()
     boost::unordered_map < uint160,
           std::list<LedgerProposal::pointer> > & storedProposals = getApp().getOPs ().peekStoredProposals ();
 
+    // We have the signatures but didn't know the ledger so couldn't verify.
+    // Check them all together now, in the order they are applied below.
+    SignatureVerifier::Checks checks;
+
     for (boost::unordered_map< uint160, std::list<LedgerProposal::pointer> >::iterator
             it = storedProposals.begin (), end = storedProposals.end (); it != end; ++it)
     {
-        bool relay = false;
         BOOST_FOREACH (LedgerProposal::ref proposal, it->second)
         {
             if (proposal->hasSignature ())
             {
-                // we have the signature but don't know the ledger so couldn't verify
                 proposal->setPrevLedger (mPrevLedgerHash);
 
-                if (proposal->checkSign ())
+                SignatureVerifier::Check check;
+                check.signingHash = proposal->getSigningHash ();
+                check.publicKey = proposal->getPubKey ();
+                check.signature.assign (proposal->getSignature ().begin (),
+                    proposal->getSignature ().end ());
+                checks.push_back (check);
+            }
+        }
+    }
+
+    getApp().getSignatureVerifier ().verifyBatch (checks);
+
+    SignatureVerifier::Checks::const_iterator result (checks.begin ());
+
+    for (boost::unordered_map< uint160, std::list<LedgerProposal::pointer> >::iterator
+            it = storedProposals.begin (), end = storedProposals.end (); it != end; ++it)
+    {
+        bool relay = false;
+        BOOST_FOREACH (LedgerProposal::ref proposal, it->second)
+        {
+            if (proposal->hasSignature ())
+            {
+                if ((result++)->valid)
                 {
                     WriteLog (lsINFO, LedgerConsensus) << "Applying stored proposal";
                     relay = peerPosition (proposal);
@@ -1130,18 +1165,7 @@ int LedgerConsensus::applyTransaction (TransactionEngine& engine, SerializedTran
                                        bool openLedger, bool retryAssured)
 {
     // Returns false if the transaction has need not be retried.
-    TransactionEngineParams parms = openLedger ? tapOPEN_LEDGER : tapNONE;
-
-    if (retryAssured)
-        parms = static_cast<TransactionEngineParams> (parms | tapRETRY);
-
-    if (getApp().getHashRouter ().setFlag (txn->getTransactionID (), SF_SIGGOOD))
-        parms = static_cast<TransactionEngineParams> (parms | tapNO_CHECK_SIGN);
-
-    WriteLog (lsDEBUG, LedgerConsensus) << "TXN " << txn->getTransactionID ()
-                                        << (openLedger ? " open" : " closed")
-                                        << (retryAssured ? "/retry" : "/final");
-    WriteLog (lsTRACE, LedgerConsensus) << txn->getJson (0);
+    TransactionEngineParams parms = getApplyParams (txn, openLedger, retryAssured);
 
     // VFALCO TODO figure out what this "trust network" is all about and why it needs exceptions.
 #ifndef TRUST_NETWORK
@@ -1153,22 +1177,7 @@ int LedgerConsensus::applyTransaction (TransactionEngine& engine, SerializedTran
         bool didApply;
         TER result = engine.applyTransaction (*txn, parms, didApply);
 
-        if (didApply)
-        {
-            WriteLog (lsDEBUG, LedgerConsensus) << "Transaction success: " << transHuman (result);
-            return LCAT_SUCCESS;
-        }
-
-        if (isTefFailure (result) || isTemMalformed (result) || isTelLocal (result))
-        {
-            // failure
-            WriteLog (lsDEBUG, LedgerConsensus) << "Transaction failure: " << transHuman (result);
-            return LCAT_FAIL;
-        }
-
-        WriteLog (lsDEBUG, LedgerConsensus) << "Transaction retry: " << transHuman (result);
-        assert (!ledger->hasTransaction (txn->getTransactionID ()));
-        return LCAT_RETRY;
+        return getApplyResult (result, didApply, txn, ledger);
 
 #ifndef TRUST_NETWORK
     }
@@ -1181,6 +1190,49 @@ int LedgerConsensus::applyTransaction (TransactionEngine& engine, SerializedTran
 #endif
 }
 
+/** Determine the parameters for applying a transaction
+*/
+TransactionEngineParams LedgerConsensus::getApplyParams (SerializedTransaction::ref txn, bool openLedger,
+                                                         bool retryAssured)
+{
+    TransactionEngineParams parms = openLedger ? tapOPEN_LEDGER : tapNONE;
+
+    if (retryAssured)
+        parms = static_cast<TransactionEngineParams> (parms | tapRETRY);
+
+    if (getApp().getHashRouter ().setFlag (txn->getTransactionID (), SF_SIGGOOD))
+        parms = static_cast<TransactionEngineParams> (parms | tapNO_CHECK_SIGN);
+
+    WriteLog (lsDEBUG, LedgerConsensus) << "TXN " << txn->getTransactionID ()
+                                        << (openLedger ? " open" : " closed")
+                                        << (retryAssured ? "/retry" : "/final");
+    WriteLog (lsTRACE, LedgerConsensus) << txn->getJson (0);
+
+    return parms;
+}
+
+/** Classify the result of applying a transaction
+*/
+int LedgerConsensus::getApplyResult (TER result, bool didApply, SerializedTransaction::ref txn, Ledger::ref ledger)
+{
+    if (didApply)
+    {
+        WriteLog (lsDEBUG, LedgerConsensus) << "Transaction success: " << transHuman (result);
+        return LCAT_SUCCESS;
+    }
+
+    if (isTefFailure (result) || isTemMalformed (result) || isTelLocal (result))
+    {
+        // failure
+        WriteLog (lsDEBUG, LedgerConsensus) << "Transaction failure: " << transHuman (result);
+        return LCAT_FAIL;
+    }
+
+    WriteLog (lsDEBUG, LedgerConsensus) << "Transaction retry: " << transHuman (result);
+    assert (!ledger->hasTransaction (txn->getTransactionID ()));
+    return LCAT_RETRY;
+}
+
 /** Apply a set of transactions to a ledger
 */
 void LedgerConsensus::applyTransactions (SHAMap::ref set, Ledger::ref applyLedger,
@@ -1188,6 +1240,9 @@ void LedgerConsensus::applyTransactions (SHAMap::ref set, Ledger::ref applyLedge
 {
     TransactionEngine engine (applyLedger);
 
+    // The first pass is applied as one batch, which may run in parallel
+    SpeculativeEngine::Items candidates;
+
     for (SHAMapItem::pointer item = set->peekFirstItem (); !!item; item = set->peekNextItem (item->getTag ()))
         if (!checkLedger->hasTransaction (item->getTag ()))
         {
@@ -1198,10 +1253,10 @@ void LedgerConsensus::applyTransactions (SHAMap::ref set, Ledger::ref applyLedge
             {
 #endif
                 SerializerIterator sit (item->peekSerializer ());
-                SerializedTransaction::pointer txn = boost::make_shared<SerializedTransaction> (boost::ref (sit));
-
-                if (applyTransaction (engine, txn, applyLedger, openLgr, true) == LCAT_RETRY)
-                    failedTransactions.push_back (txn);
+                SpeculativeEngine::Item candidate;
+                candidate.txn = boost::make_shared<SerializedTransaction> (boost::ref (sit));
+                candidate.params = getApplyParams (candidate.txn, openLgr, true);
+                candidates.push_back (candidate);
 
 #ifndef TRUST_NETWORK
             }
@@ -1213,6 +1268,18 @@ void LedgerConsensus::applyTransactions (SHAMap::ref set, Ledger::ref applyLedge
 #endif
         }
 
+    getApp().getSpeculativeEngine ().apply (engine, candidates);
+
+    for (std::size_t i = 0; i < candidates.size (); ++i)
+    {
+        SpeculativeEngine::Item const& candidate (candidates [i]);
+
+        if (candidate.threw)
+            WriteLog (lsWARNING, LedgerConsensus) << "Throws";
+        else if (getApplyResult (candidate.result, candidate.didApply, candidate.txn, applyLedger) == LCAT_RETRY)
+            failedTransactions.push_back (candidate.txn);
+    }
+
     int changes;
     bool certainRetry = true;
 
@@ -1271,6 +1338,8 @@ uint32 LedgerConsensus::roundCloseTime (uint32 closeTime)
 */
 void LedgerConsensus::accept (SHAMap::ref set, LoadEvent::pointer)
 {
+    double const start (Time::getMillisecondCounterHiRes ());
+
     if (set->getHash ().isNonZero ()) // put our set where others can get it later
         getApp().getOPs ().takePosition (mPreviousLedger->getLedgerSeq (), set);
 
@@ -1427,6 +1496,9 @@ void LedgerConsensus::accept (SHAMap::ref set, LoadEvent::pointer)
             getApp().getOPs ().closeTimeOffset (offset);
         }
     }
+
+    m_metrics.accept.record (static_cast <insight::Histogram::value_type> (
+        Time::getMillisecondCounterHiRes () - start));
 }
 
 void LedgerConsensus::endConsensus ()
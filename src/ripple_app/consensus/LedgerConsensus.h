@@ -32,7 +32,20 @@ class LedgerConsensus
 public:
     static char const* getCountedObjectName () { return "LedgerConsensus"; }
 
-    LedgerConsensus (LedgerHash const & prevLCLHash, Ledger::ref previousLedger, uint32 closeTime);
+    /** Durations of the consensus phases, in milliseconds.
+        These outlive each round, so one set is shared by every round.
+    */
+    struct Metrics
+    {
+        explicit Metrics (shared_ptr <insight::Collector> const& collector);
+
+        insight::Histogram open;        // From the last close until our close
+        insight::Histogram establish;   // From our close until consensus
+        insight::Histogram accept;      // Building the new last closed ledger
+    };
+
+    LedgerConsensus (LedgerHash const & prevLCLHash, Ledger::ref previousLedger, uint32 closeTime,
+                     Metrics const& metrics);
 
     int startup ();
 
@@ -106,6 +119,8 @@ private:
                             Ledger::ref checkLedger, CanonicalTXSet & failedTransactions, bool openLgr);
     int applyTransaction (TransactionEngine & engine, SerializedTransaction::ref txn, Ledger::ref targetLedger,
                           bool openLgr, bool retryAssured);
+    TransactionEngineParams getApplyParams (SerializedTransaction::ref txn, bool openLgr, bool retryAssured);
+    int getApplyResult (TER result, bool didApply, SerializedTransaction::ref txn, Ledger::ref targetLedger);
 
     uint32 roundCloseTime (uint32 closeTime);
 
@@ -134,6 +149,7 @@ private:
     };
 
     LCState mState;
+    Metrics const& m_metrics;
     uint32 mCloseTime;                      // The wall time this ledger closed
     uint256 mPrevLedgerHash, mNewLedgerHash;
     Ledger::pointer mPreviousLedger;
@@ -60,6 +60,11 @@ public:
     {
         return mMeta;
     }
+    /** The metadata as stored in the ledger, empty if not read from one. */
+    Blob const& getRawMeta () const
+    {
+        return mRawMeta;
+    }
     std::vector <RippleAddress> const& getAffected () const
     {
         return mAffected;
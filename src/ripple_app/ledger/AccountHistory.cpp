@@ -0,0 +1,678 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+/*
+
+AccountHistory
+
+Each entry is stored under a 28 byte key:
+
+    account ID (20 bytes) | ledger sequence (4 bytes) | transaction sequence (4 bytes)
+
+with the integers in big-endian order, so that the keys of one account sort
+by ledger and then by position in the ledger. The value is the raw
+transaction and the raw metadata, each prefixed with its VL length.
+
+The set of ledgers held is kept under a separate key in the same database
+and is updated in the same write batch as the entries it describes.
+
+The keys written for each ledger are listed under a 15 byte key:
+
+    "ledger_keys" | ledger sequence (4 bytes)
+
+so that when a ledger is stored again, entries for accounts it no longer
+affects can be removed. Both special keys are shorter than an account ID
+and so never fall inside the range of one account's entries.
+
+*/
+
+class AccountHistoryImp
+    : public AccountHistory
+    , public LeakChecked <AccountHistoryImp>
+{
+public:
+    enum
+    {
+        keyBytes = 20 + 4 + 4,
+
+        // Ledgers copied from the transaction database per job
+        backfillChunkLedgers = 256
+    };
+
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    // The concatenated entry keys written for each ledger in a batch
+    typedef std::map <uint32, std::string> LedgerKeys;
+
+    AccountHistoryImp (StringPairArray const& parameters, Journal journal)
+        : m_journal (journal)
+        , m_lock (this, "AccountHistory", __FILE__, __LINE__)
+        , m_backfillMin (0)
+        , m_backfillMax (0)
+    {
+        std::string const path (parameters ["path"].toStdString ());
+
+        if (path.empty ())
+            Throw (std::runtime_error ("Missing path in account history database"));
+
+        if (parameters ["cache_mb"].isEmpty ())
+            m_cache = leveldb::NewLRUCache (getConfig ().getSize (siTxnDBCache) * 1024 * 1024);
+        else
+            m_cache = leveldb::NewLRUCache (parameters ["cache_mb"].getIntValue () * 1024L * 1024L);
+
+        // Every lookup is a seek, which a bloom filter cannot help
+        leveldb::Options options;
+        options.create_if_missing = true;
+        options.block_cache = m_cache;
+
+        if (! parameters ["open_files"].isEmpty ())
+            options.max_open_files = parameters ["open_files"].getIntValue ();
+
+        leveldb::DB* db = nullptr;
+        leveldb::Status status = leveldb::DB::Open (options, path, &db);
+        if (!status.ok () || !db)
+            Throw (std::runtime_error (std::string ("Unable to open/create leveldb: ") + status.ToString ()));
+
+        m_db = db;
+
+        std::string complete;
+        if (m_db->Get (leveldb::ReadOptions (), completeKey (), &complete).ok ())
+        {
+            if (! parseRanges (complete, m_complete))
+            {
+                m_journal.warning << "Discarding unreadable ledger range '" << complete << "'";
+                m_complete = RangeSet ();
+            }
+        }
+
+        m_journal.info << "Opened " << path << ", ledgers " << m_complete.toString ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    static leveldb::Slice completeKey ()
+    {
+        return leveldb::Slice ("complete_ledgers");
+    }
+
+    static void appendBigEndian (std::string& s, uint32 v)
+    {
+        s.push_back (static_cast <char> ((v >> 24) & 0xff));
+        s.push_back (static_cast <char> ((v >> 16) & 0xff));
+        s.push_back (static_cast <char> ((v >> 8) & 0xff));
+        s.push_back (static_cast <char> (v & 0xff));
+    }
+
+    static uint32 readBigEndian (char const* p)
+    {
+        unsigned char const* const u = reinterpret_cast <unsigned char const*> (p);
+        return (uint32 (u[0]) << 24) | (uint32 (u[1]) << 16) | (uint32 (u[2]) << 8) | uint32 (u[3]);
+    }
+
+    static std::string makeKey (uint160 const& account, Marker const& position)
+    {
+        std::string key;
+        key.reserve (keyBytes);
+        key.append (reinterpret_cast <char const*> (account.begin ()), uint160::bytes);
+        appendBigEndian (key, position.ledgerSeq);
+        appendBigEndian (key, position.txnSeq);
+        return key;
+    }
+
+    static std::string makeLedgerKey (uint32 ledgerSeq)
+    {
+        std::string key ("ledger_keys");
+        appendBigEndian (key, ledgerSeq);
+        return key;
+    }
+
+    static std::string makeValue (Blob const& rawTxn, Blob const& rawMeta)
+    {
+        Serializer s (rawTxn.size () + rawMeta.size () + 8);
+        s.addVL (rawTxn);
+        s.addVL (rawMeta);
+        return s.getString ();
+    }
+
+    // Parses the output of RangeSet::toString
+    static bool parseRanges (std::string const& s, RangeSet& set)
+    {
+        if (s == "empty")
+            return true;
+
+        try
+        {
+            std::string::size_type start = 0;
+
+            while (start < s.size ())
+            {
+                std::string::size_type end = s.find (',', start);
+                if (end == std::string::npos)
+                    end = s.size ();
+
+                std::string const range (s.substr (start, end - start));
+                std::string::size_type const dash = range.find ('-');
+
+                if (dash == std::string::npos)
+                {
+                    set.setValue (lexicalCastThrow <uint32> (range));
+                }
+                else
+                {
+                    set.setRange (lexicalCastThrow <uint32> (range.substr (0, dash)),
+                        lexicalCastThrow <uint32> (range.substr (dash + 1)));
+                }
+
+                start = end + 1;
+            }
+        }
+        catch (...)
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void put (leveldb::WriteBatch& batch, LedgerKeys& ledgerKeys, uint160 const& account,
+        Marker const& position, std::string const& value)
+    {
+        std::string const key (makeKey (account, position));
+        batch.Put (key, value);
+        ledgerKeys [position.ledgerSeq].append (key);
+    }
+
+    // Deletes the entries previously written for a ledger which are not
+    // being written again
+    static void removeStale (leveldb::WriteBatch& batch,
+        std::string const& previousKeys, std::string const& keys)
+    {
+        std::set <std::string> current;
+        for (std::size_t i = 0; (i + keyBytes) <= keys.size (); i += keyBytes)
+            current.insert (keys.substr (i, keyBytes));
+
+        for (std::size_t i = 0; (i + keyBytes) <= previousKeys.size (); i += keyBytes)
+        {
+            std::string const key (previousKeys.substr (i, keyBytes));
+
+            if (current.find (key) == current.end ())
+                batch.Delete (key);
+        }
+    }
+
+    // Commits the batch along with the ledgers it completes. Each ledger in
+    // ledgerKeys replaces whatever was stored for it before.
+    void write (leveldb::WriteBatch& batch, LedgerKeys const& ledgerKeys,
+        std::vector <uint32> const& ledgers)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        for (LedgerKeys::const_iterator it = ledgerKeys.begin (); it != ledgerKeys.end (); ++it)
+        {
+            std::string const ledgerKey (makeLedgerKey (it->first));
+            std::string previousKeys;
+
+            if (m_db->Get (leveldb::ReadOptions (), ledgerKey, &previousKeys).ok ())
+                removeStale (batch, previousKeys, it->second);
+
+            batch.Put (ledgerKey, it->second);
+        }
+
+        RangeSet const previous (m_complete);
+
+        for (std::size_t i = 0; i < ledgers.size (); ++i)
+            m_complete.setValue (ledgers [i]);
+
+        batch.Put (completeKey (), m_complete.toString ());
+
+        leveldb::Status const status (m_db->Write (leveldb::WriteOptions (), &batch));
+
+        if (! status.ok ())
+        {
+            m_complete = previous;
+
+            m_journal.error << "Write of " << ledgers.size () <<
+                " ledgers failed: " << status.ToString ();
+        }
+    }
+
+    void storeLedger (AcceptedLedger const& ledger)
+    {
+        uint32 const ledgerSeq = ledger.getLedgerSeq ();
+        leveldb::WriteBatch batch;
+
+        // A ledger without transactions still replaces the old entries
+        LedgerKeys ledgerKeys;
+        ledgerKeys [ledgerSeq];
+
+        BOOST_FOREACH (AcceptedLedger::value_type const& vt, ledger.getMap ())
+        {
+            AcceptedLedgerTx const& tx (*vt.second);
+            Serializer const s (tx.getTxn ()->getSerializer ());
+            std::string const value (makeValue (s.peekData (), tx.getRawMeta ()));
+            Marker const position (ledgerSeq, tx.getTxnSeq ());
+
+            BOOST_FOREACH (RippleAddress const& account, tx.getAffected ())
+                put (batch, ledgerKeys, account.getAccountID (), position, value);
+        }
+
+        write (batch, ledgerKeys, std::vector <uint32> (1, ledgerSeq));
+    }
+
+    bool hasLedgers (uint32 minLedger, uint32 maxLedger)
+    {
+        if (minLedger > maxLedger)
+            return false;
+
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        return m_complete.prevMissing (maxLedger + 1) < minLedger;
+    }
+
+    bool fetch (Query const& query, Page& page)
+    {
+        page = Page ();
+
+        if (! hasLedgers (query.minLedger, query.maxLedger))
+            return false;
+
+        Marker first;
+
+        if (query.hasMarker)
+            first = query.marker;
+        else if (query.forward)
+            first = Marker (query.minLedger, 0);
+        else
+            first = Marker (query.maxLedger, static_cast <uint32> (-1));
+
+        std::string const start (makeKey (query.account, first));
+        ScopedPointer <leveldb::Iterator> it (m_db->NewIterator (leveldb::ReadOptions ()));
+
+        it->Seek (start);
+
+        if (! query.forward)
+        {
+            // Seek lands on the first key at or after the start,
+            // step back onto the last key at or before it.
+            if (! it->Valid ())
+                it->SeekToLast ();
+            else if (it->key ().compare (start) > 0)
+                it->Prev ();
+        }
+
+        uint32 skip = query.offset;
+
+        for (; it->Valid (); query.forward ? it->Next () : it->Prev ())
+        {
+            leveldb::Slice const key (it->key ());
+
+            if (key.size () != keyBytes ||
+                memcmp (key.data (), query.account.begin (), uint160::bytes) != 0)
+                break;
+
+            Marker const position (
+                readBigEndian (key.data () + uint160::bytes),
+                readBigEndian (key.data () + uint160::bytes + 4));
+
+            if (query.forward ? (position.ledgerSeq > query.maxLedger)
+                              : (position.ledgerSeq < query.minLedger))
+                break;
+
+            if (skip > 0)
+            {
+                --skip;
+                continue;
+            }
+
+            if (page.entries.size () >= query.limit)
+            {
+                page.more = true;
+                page.next = position;
+                break;
+            }
+
+            Serializer s (it->value ().ToString ());
+            SerializerIterator sit (s);
+
+            page.entries.push_back (Entry ());
+            Entry& entry (page.entries.back ());
+            entry.position = position;
+            entry.rawTxn = sit.getVL ();
+            entry.rawMeta = sit.getVL ();
+        }
+
+        if (! it->status ().ok ())
+            m_journal.warning << "Iteration failed: " << it->status ().ToString ();
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void backfill (JobQueue& jobQueue, DatabaseCon& txnDB, DatabaseCon& ledgerDB)
+    {
+        {
+            Database* db = txnDB.getDB ();
+            DeprecatedScopedLock sl (txnDB.getDBLock ());
+
+            SQL_FOREACH (db, "SELECT MIN(LedgerSeq) AS Min, MAX(LedgerSeq) AS Max FROM AccountTransactions;")
+            {
+                m_backfillMin = db->getInt ("Min");
+                m_backfillMax = db->getInt ("Max");
+            }
+        }
+
+        if (m_backfillMax == 0)
+            return;
+
+        m_journal.info << "Backfilling ledgers " << m_backfillMin << "-" << m_backfillMax;
+
+        jobQueue.addJob (jtADMIN, "AccountHistory::backfill",
+            BIND_TYPE (&AccountHistoryImp::backfillChunk, this, P_1,
+                boost::ref (jobQueue), boost::ref (txnDB), boost::ref (ledgerDB)));
+    }
+
+    void backfillChunk (Job&, JobQueue& jobQueue, DatabaseCon& txnDB, DatabaseCon& ledgerDB)
+    {
+        uint32 maxLedger;
+        {
+            ScopedLockType sl (m_lock, __FILE__, __LINE__);
+            maxLedger = m_complete.prevMissing (m_backfillMax + 1);
+        }
+
+        if (maxLedger == RangeSet::absent || maxLedger < m_backfillMin)
+        {
+            m_journal.info << "Backfill complete, ledgers " << getCompleteLedgers ();
+            return;
+        }
+
+        uint32 const minLedger = (maxLedger - m_backfillMin < backfillChunkLedgers)
+            ? m_backfillMin : (maxLedger - backfillChunkLedgers + 1);
+
+        // A ledger missing from the ledger database may be missing some of
+        // its transactions too, so it is copied but not marked as held.
+        std::vector <uint32> ledgers;
+        {
+            Database* db = ledgerDB.getDB ();
+            DeprecatedScopedLock sl (ledgerDB.getDBLock ());
+
+            SQL_FOREACH (db, boost::str (boost::format (
+                "SELECT LedgerSeq FROM Ledgers WHERE LedgerSeq BETWEEN %u AND %u;")
+                    % minLedger % maxLedger))
+            {
+                ledgers.push_back (db->getInt ("LedgerSeq"));
+            }
+        }
+
+        std::string const sql (boost::str (boost::format (
+            "SELECT AccountTransactions.Account,AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,RawTxn,TxnMeta "
+            "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
+            "WHERE AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u';")
+                % minLedger % maxLedger));
+
+        leveldb::WriteBatch batch;
+        LedgerKeys ledgerKeys;
+        int entries = 0;
+
+        for (std::size_t i = 0; i < ledgers.size (); ++i)
+            ledgerKeys [ledgers [i]];
+        {
+            Database* db = txnDB.getDB ();
+            DeprecatedScopedLock sl (txnDB.getDBLock ());
+
+            SQL_FOREACH (db, sql)
+            {
+                std::string human;
+                RippleAddress account;
+
+                db->getStr ("Account", human);
+
+                if (! account.setAccountID (human))
+                {
+                    m_journal.warning << "Skipping unparseable account " << human;
+                    continue;
+                }
+
+                put (batch, ledgerKeys, account.getAccountID (),
+                    Marker (db->getInt ("LedgerSeq"), db->getInt ("TxnSeq")),
+                    makeValue (db->getBinary ("RawTxn"), db->getBinary ("TxnMeta")));
+                ++entries;
+            }
+        }
+
+        write (batch, ledgerKeys, ledgers);
+
+        m_journal.debug << "Backfilled ledgers " << minLedger << "-" << maxLedger <<
+            ", " << ledgers.size () << " held, " << entries << " entries";
+
+        // Gaps stay missing, so continue below this chunk rather than
+        // starting from the newest missing ledger again
+        {
+            ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+            if (minLedger <= m_backfillMin)
+            {
+                m_journal.info << "Backfill complete, ledgers " << m_complete.toString ();
+                return;
+            }
+
+            m_backfillMax = minLedger - 1;
+        }
+
+        jobQueue.addJob (jtADMIN, "AccountHistory::backfill",
+            BIND_TYPE (&AccountHistoryImp::backfillChunk, this, P_1,
+                boost::ref (jobQueue), boost::ref (txnDB), boost::ref (ledgerDB)));
+    }
+
+    std::string getCompleteLedgers ()
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        return m_complete.toString ();
+    }
+
+private:
+    Journal m_journal;
+    ScopedPointer <leveldb::Cache> m_cache;
+    ScopedPointer <leveldb::DB> m_db;
+
+    LockType m_lock;
+    RangeSet m_complete;
+
+    uint32 m_backfillMin;
+    uint32 m_backfillMax;
+};
+
+//------------------------------------------------------------------------------
+
+AccountHistory* AccountHistory::New (StringPairArray const& parameters,
+    Journal journal)
+{
+    return new AccountHistoryImp (parameters, journal);
+}
+
+//------------------------------------------------------------------------------
+
+class AccountHistoryTests : public UnitTest
+{
+public:
+    AccountHistoryTests () : UnitTest ("AccountHistory", "ripple")
+    {
+    }
+
+    static Blob makeBlob (uint32 ledgerSeq, uint32 txnSeq)
+    {
+        Serializer s;
+        s.add32 (ledgerSeq);
+        s.add32 (txnSeq);
+        return s.peekData ();
+    }
+
+    void runTest ()
+    {
+        File const path (File::createTempFile ("account_history"));
+        StringPairArray params;
+        params.set ("path", path.getFullPathName ());
+
+        testHistory (params);
+
+        path.deleteRecursively ();
+    }
+
+    void testHistory (StringPairArray const& params)
+    {
+        uint160 alice, bob;
+        alice.SetHex ("00000000000000000000000000000000000000A1");
+        bob.SetHex ("00000000000000000000000000000000000000A2");
+
+        {
+            AccountHistoryImp history (params, journal ());
+
+            // Ledgers 10 through 12, three transactions for alice in each,
+            // and one for bob in the middle of each ledger.
+            leveldb::WriteBatch batch;
+            AccountHistoryImp::LedgerKeys ledgerKeys;
+            std::vector <uint32> ledgers;
+            for (uint32 ledger = 10; ledger <= 12; ++ledger)
+            {
+                ledgers.push_back (ledger);
+
+                for (uint32 txn = 0; txn < 3; ++txn)
+                {
+                    AccountHistory::Marker const position (ledger, txn);
+                    history.put (batch, ledgerKeys, alice, position, AccountHistoryImp::makeValue (
+                        makeBlob (ledger, txn), makeBlob (txn, ledger)));
+                    if (txn == 1)
+                        history.put (batch, ledgerKeys, bob, position, AccountHistoryImp::makeValue (
+                            makeBlob (ledger, txn), Blob ()));
+                }
+            }
+            history.write (batch, ledgerKeys, ledgers);
+        }
+
+        AccountHistoryImp history (params, journal ());
+
+        beginTestCase ("coverage");
+
+        expect (history.getCompleteLedgers () == "10-12", "coverage should persist");
+        expect (history.hasLedgers (10, 12));
+        expect (history.hasLedgers (11, 11));
+        expect (! history.hasLedgers (9, 12));
+        expect (! history.hasLedgers (10, 13));
+
+        AccountHistory::Query query;
+        query.account = alice;
+        query.minLedger = 9;
+        query.maxLedger = 12;
+        query.limit = 100;
+
+        AccountHistory::Page page;
+        expect (! history.fetch (query, page), "uncovered range should be refused");
+
+        beginTestCase ("forward");
+
+        query.minLedger = 10;
+        query.forward = true;
+        query.limit = 4;
+
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 4);
+        expect (page.entries.front ().rawTxn == makeBlob (10, 0));
+        expect (page.entries.front ().rawMeta == makeBlob (0, 10));
+        expect (page.entries.back ().rawTxn == makeBlob (11, 0));
+        expect (page.more && page.next.ledgerSeq == 11 && page.next.txnSeq == 1);
+
+        query.hasMarker = true;
+        query.marker = page.next;
+
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 4);
+        expect (page.entries.front ().rawTxn == makeBlob (11, 1));
+        expect (page.more && page.next.ledgerSeq == 12 && page.next.txnSeq == 2);
+
+        query.marker = page.next;
+
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 1 && ! page.more);
+
+        beginTestCase ("backward");
+
+        query.forward = false;
+        query.hasMarker = false;
+        query.maxLedger = 11;
+        query.limit = 2;
+
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 2);
+        expect (page.entries.front ().rawTxn == makeBlob (11, 2));
+        expect (page.more && page.next.ledgerSeq == 11 && page.next.txnSeq == 0);
+
+        query.offset = 4;
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 2);
+        expect (page.entries.front ().rawTxn == makeBlob (10, 1));
+        expect (! page.more, "range should end at minLedger");
+
+        beginTestCase ("accounts");
+
+        query = AccountHistory::Query ();
+        query.account = bob;
+        query.minLedger = 10;
+        query.maxLedger = 12;
+        query.limit = 100;
+
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 3 && ! page.more);
+        expect (page.entries.front ().rawTxn == makeBlob (12, 1));
+        expect (page.entries.front ().rawMeta.empty ());
+
+        beginTestCase ("replace");
+
+        {
+            // Ledger 12 again, now with a single transaction for alice only
+            leveldb::WriteBatch batch;
+            AccountHistoryImp::LedgerKeys ledgerKeys;
+            history.put (batch, ledgerKeys, alice, AccountHistory::Marker (12, 5),
+                AccountHistoryImp::makeValue (makeBlob (12, 5), Blob ()));
+            history.write (batch, ledgerKeys, std::vector <uint32> (1, 12));
+        }
+
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 2, "bob kept an entry for the replaced ledger");
+        expect (page.entries.front ().rawTxn == makeBlob (11, 1));
+
+        query.account = alice;
+        query.minLedger = 12;
+
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 1, "alice kept old entries for the replaced ledger");
+        expect (page.entries.front ().rawTxn == makeBlob (12, 5));
+
+        query.minLedger = 10;
+        query.maxLedger = 11;
+
+        expect (history.fetch (query, page));
+        expect (page.entries.size () == 6, "other ledgers were changed");
+    }
+};
+
+static AccountHistoryTests accountHistoryTests;
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_ACCOUNTHISTORY_H_INCLUDED
+#define RIPPLE_ACCOUNTHISTORY_H_INCLUDED
+
+/** Key-ordered store of the transactions affecting each account.
+
+    Entries are keyed by (account, ledger sequence, transaction sequence)
+    and carry the raw transaction and metadata, so a page of an account's
+    history is a single seek followed by a sequential scan. This replaces
+    the join of AccountTransactions with Transactions for account_tx.
+
+    The store remembers which ledgers it holds. Queries for a range it
+    does not fully cover are refused, and the caller falls back to the
+    transaction database.
+*/
+class AccountHistory
+{
+public:
+    /** A position in an account's history. */
+    struct Marker
+    {
+        Marker ()
+            : ledgerSeq (0)
+            , txnSeq (0)
+        {
+        }
+
+        Marker (uint32 ledgerSeq_, uint32 txnSeq_)
+            : ledgerSeq (ledgerSeq_)
+            , txnSeq (txnSeq_)
+        {
+        }
+
+        uint32 ledgerSeq;
+        uint32 txnSeq;
+    };
+
+    /** A transaction affecting an account. */
+    struct Entry
+    {
+        Marker position;
+        Blob rawTxn;
+        Blob rawMeta;
+    };
+
+    /** Describes a page of an account's history. */
+    struct Query
+    {
+        Query ()
+            : minLedger (0)
+            , maxLedger (0)
+            , forward (false)
+            , hasMarker (false)
+            , offset (0)
+            , limit (0)
+        {
+        }
+
+        uint160 account;
+        uint32 minLedger;
+        uint32 maxLedger;
+        bool forward;       // Oldest first if true
+        bool hasMarker;     // Resume at (and including) marker
+        Marker marker;
+        uint32 offset;      // Entries to skip before the page starts
+        uint32 limit;
+    };
+
+    /** The result of a query. */
+    struct Page
+    {
+        Page ()
+            : more (false)
+        {
+        }
+
+        std::vector <Entry> entries;
+        bool more;          // true if 'next' is the first entry not returned
+        Marker next;
+    };
+
+    /** Create the store described by the configuration parameters.
+        The 'path' key is required. 'cache_mb' and 'open_files' are optional.
+        The caller receives ownership and must delete the object when done.
+    */
+    static AccountHistory* New (StringPairArray const& parameters,
+        Journal journal);
+
+    virtual ~AccountHistory () { }
+
+    /** Add the transactions of a validated ledger.
+        Thread safety:
+            Safe to call from any thread.
+    */
+    virtual void storeLedger (AcceptedLedger const& ledger) = 0;
+
+    /** Returns true if every ledger in [minLedger, maxLedger] is stored. */
+    virtual bool hasLedgers (uint32 minLedger, uint32 maxLedger) = 0;
+
+    /** Retrieve a page of an account's history.
+        @return false if the store does not cover the requested range.
+    */
+    virtual bool fetch (Query const& query, Page& page) = 0;
+
+    /** Copy ledgers held in the transaction database into the store.
+        Works downward from the newest ledger not yet stored, one chunk
+        per job, so an interrupted backfill picks up where it left off.
+        Only ledgers present in the ledger database are marked as held,
+        since a ledger missing there may be missing transactions too.
+    */
+    virtual void backfill (JobQueue& jobQueue, DatabaseCon& txnDB,
+        DatabaseCon& ledgerDB) = 0;
+
+    /** Returns a description of the ledgers held by the store. */
+    virtual std::string getCompleteLedgers () = 0;
+};
+
+#endif
@@ -242,14 +242,15 @@ void InboundLedger::addPeers ()
     if (vSize == 0)
         return;
 
-    // We traverse the peer list in random order so as not to favor any particular peer
-    int firstPeer = rand () % vSize;
+    // We traverse the peer list in random order weighted towards peers
+    // which have answered our requests quickly and reliably
+    orderByScore (peerList);
 
     int found = 0;
 
     for (int i = 0; i < vSize; ++i)
     {
-        Peer::ref peer = peerList[ (i + firstPeer) % vSize];
+        Peer::ref peer = peerList[i];
 
         if (peer->hasLedger (getHash (), mSeq))
         {
@@ -262,7 +263,7 @@ void InboundLedger::addPeers ()
     {
         for (int i = 0; (i < 6) && (i < vSize); ++i)
         {
-            if (peerHas (peerList[ (i + firstPeer) % vSize]))
+            if (peerHas (peerList[i]))
                 ++found;
 	}
 	if (mSeq != 0)
@@ -422,6 +423,7 @@ void InboundLedger::trigger (Peer::ref peer)
                         if (iPeer)
                         {
                             mByHash = false;
+                            iPeer->getScore ().onRequest (protocol::mtGET_OBJECTS, mHash);
                             iPeer->sendPacket (packet, false);
                         }
                     }
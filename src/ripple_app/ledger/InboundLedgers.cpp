@@ -19,10 +19,14 @@
 
 typedef std::pair<uint256, InboundLedger::pointer> u256_acq_pair;
 
-InboundLedgers::InboundLedgers (Stoppable& parent)
+InboundLedgers::InboundLedgers (Stoppable& parent,
+    shared_ptr <insight::Collector> const& collector)
     : Stoppable ("InboundLedgers", parent)
     , mLock (this, "InboundLedger", __FILE__, __LINE__)
     , mRecentFailures ("LedgerAcquireRecentFailures", 0, kReacquireIntervalSeconds)
+    , m_nodesReceived (collector->make_meter ("ledger_fetch_nodes"))
+    , m_replyNodes (collector->make_histogram ("ledger_fetch_reply_nodes"))
+    , m_takeLatency (collector->make_histogram ("ledger_fetch_take_us"))
 {
 }
 
@@ -207,11 +211,18 @@ void InboundLedgers::gotLedgerData (Job&, LedgerHash hash,
 
         SHAMapAddNode ret;
 
+        double const start (Time::getMillisecondCounterHiRes ());
+
         if (packet.type () == protocol::liTX_NODE)
             ledger->takeTxNode (nodeIDs, nodeData, ret);
         else
             ledger->takeAsNode (nodeIDs, nodeData, ret);
 
+        m_takeLatency.record (static_cast <insight::Histogram::value_type> (
+            (Time::getMillisecondCounterHiRes () - start) * 1000));
+        m_replyNodes.record (nodeIDs.size ());
+        m_nodesReceived += nodeIDs.size ();
+
         if (!ret.isInvalid ())
         {
             ledger->progress ();
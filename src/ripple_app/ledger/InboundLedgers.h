@@ -34,7 +34,8 @@ public:
     // How long before we try again to acquire the same ledger
     static const int kReacquireIntervalSeconds = 300;
 
-    explicit InboundLedgers (Stoppable& parent);
+    InboundLedgers (Stoppable& parent,
+        shared_ptr <insight::Collector> const& collector);
 
     // VFALCO TODO Should this be called findOrAdd ?
     //
@@ -86,6 +87,10 @@ private:
 
     MapType mLedgers;
     KeyCache <uint256, UptimeTimerAdapter> mRecentFailures;
+
+    insight::Meter m_nodesReceived;
+    insight::Histogram m_replyNodes;
+    insight::Histogram m_takeLatency;
 };
 
 #endif
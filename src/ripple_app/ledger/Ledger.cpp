@@ -127,6 +127,52 @@ Ledger::Ledger (Ledger& ledger,
     initializeFees ();
 }
 
+// Mount a ledger whose maps are read from a snapshot file. A snapshot of a
+// flag ledger's state has no transactions, those come from the NodeStore.
+Ledger::Ledger (LedgerSnapshot::ref snapshot, bool& loaded)
+    : mClosed (true)
+    , mValidated (false)
+    , mValidHash (false)
+    , mAccepted (true)
+    , mImmutable (true)
+{
+    Serializer s (snapshot->getRawHeader ());
+    setRaw (s, false);
+
+    loaded = true;
+
+    if (snapshot->hasMap (smtTRANSACTION))
+    {
+        mTransactionMap = boost::make_shared <SHAMap> (smtTRANSACTION, snapshot);
+
+        if (mTransHash.isNonZero () && !mTransactionMap->fetchRoot (mTransHash, NULL))
+        {
+            loaded = false;
+            WriteLog (lsWARNING, Ledger) << "Snapshot lacks TX root for ledger";
+        }
+    }
+    else
+    {
+        mTransactionMap = boost::make_shared <SHAMap> (smtTRANSACTION, mTransHash);
+
+        if (mTransHash.isNonZero () && !mTransactionMap->fetchRoot (mTransHash, NULL))
+            WriteLog (lsINFO, Ledger) << "Don't have TX root for snapshot ledger";
+    }
+
+    mAccountStateMap = boost::make_shared <SHAMap> (smtSTATE, snapshot);
+
+    if (mAccountHash.isNonZero () && !mAccountStateMap->fetchRoot (mAccountHash, NULL))
+    {
+        loaded = false;
+        WriteLog (lsWARNING, Ledger) << "Snapshot lacks AS root for ledger";
+    }
+
+    mTransactionMap->setImmutable ();
+    mAccountStateMap->setImmutable ();
+
+    initializeFees ();
+}
+
 // Create a new ledger that follows this one
 Ledger::Ledger (bool /* dummy */,
                 Ledger& prevLedger)
@@ -595,6 +641,7 @@ bool Ledger::saveValidatedLedger (bool current)
         DeprecatedScopedLock sl (getApp().getLedgerDB ()->getDBLock ());
         getApp().getLedgerDB ()->getDB ()->executeSQL (boost::str (deleteLedger % mLedgerSeq));
     }
+    getApp().getLedgerHeaderIndex ().erase (mLedgerSeq);
 
     {
         Database* db = getApp().getTxnDB ()->getDB ();
@@ -651,6 +698,9 @@ bool Ledger::saveValidatedLedger (bool current)
         db->executeSQL ("COMMIT TRANSACTION;");
     }
 
+    if (AccountHistory* history = getApp().getAccountHistory ())
+        history->storeLedger (*aLedger);
+
     {
         DeprecatedScopedLock sl (getApp().getLedgerDB ()->getDBLock ());
 
@@ -660,6 +710,14 @@ bool Ledger::saveValidatedLedger (bool current)
                 mCloseResolution % mCloseFlags % mAccountHash.GetHex () % mTransHash.GetHex ()));
     }
 
+    {
+        LedgerHeaderIndex::Header header;
+        header.hash = getHash ();
+        header.parentHash = mParentHash;
+        header.closeTime = mCloseTime;
+        getApp().getLedgerHeaderIndex ().insert (mLedgerSeq, header);
+    }
+
     { // Clients can now trust the database for information about this ledger sequence
         StaticScopedLockType sl (sPendingSaveLock, __FILE__, __LINE__);
         sPendingSaves.erase(getLedgerSeq());
@@ -866,6 +924,15 @@ uint256 Ledger::getHashByIndex (uint32 ledgerIndex)
 {
     uint256 ret;
 
+    LedgerHeaderIndex& index (getApp().getLedgerHeaderIndex ());
+    if (index.isLoaded ())
+    {
+        LedgerHeaderIndex::Header header;
+        if (index.find (ledgerIndex, header))
+            ret = header.hash;
+        return ret;
+    }
+
     std::string sql = "SELECT LedgerHash FROM Ledgers INDEXED BY SeqLedger WHERE LedgerSeq='";
     sql.append (lexicalCastThrow <std::string> (ledgerIndex));
     sql.append ("';");
@@ -888,6 +955,18 @@ uint256 Ledger::getHashByIndex (uint32 ledgerIndex)
 
 bool Ledger::getHashesByIndex (uint32 ledgerIndex, uint256& ledgerHash, uint256& parentHash)
 {
+    LedgerHeaderIndex& index (getApp().getLedgerHeaderIndex ());
+    if (index.isLoaded ())
+    {
+        LedgerHeaderIndex::Header header;
+        if (!index.find (ledgerIndex, header))
+            return false;
+
+        ledgerHash = header.hash;
+        parentHash = header.parentHash;
+        return true;
+    }
+
 #ifndef NO_SQLITE3_PREPARE
 
     DatabaseCon* con = getApp().getLedgerDB ();
@@ -951,6 +1030,13 @@ std::map< uint32, std::pair<uint256, uint256> > Ledger::getHashesByIndex (uint32
 {
     std::map< uint32, std::pair<uint256, uint256> > ret;
 
+    LedgerHeaderIndex& index (getApp().getLedgerHeaderIndex ());
+    if (index.isLoaded ())
+    {
+        index.getHashes (minSeq, maxSeq, ret);
+        return ret;
+    }
+
     std::string sql = "SELECT LedgerSeq,LedgerHash,PrevHash FROM Ledgers WHERE LedgerSeq >= ";
     sql.append (lexicalCastThrow <std::string> (minSeq));
     sql.append (" AND LedgerSeq <= ");
@@ -1000,11 +1086,20 @@ static void stateItemFullAppender(Json::Value& value, SLE::ref sle)
     value.append (sle->getJson (0));
 }
 
+static void stateItemBinaryAppender(Json::Value& value, SHAMapItem::ref smi)
+{
+    Json::Value& entry = value.append (Json::objectValue);
+
+    entry["index"] = smi->getTag ().GetHex ();
+    entry["data"] = strHex (smi->peekData ());
+}
+
 Json::Value Ledger::getJson (int options)
 {
     Json::Value ledger (Json::objectValue);
 
     bool bFull = isSetBit (options, LEDGER_JSON_FULL);
+    bool bBinary = isSetBit (options, LEDGER_JSON_BINARY);
 
     ScopedLockType sl (mLock, __FILE__, __LINE__);
 
@@ -1036,6 +1131,13 @@ Json::Value Ledger::getJson (int options)
             if ((mCloseFlags & sLCF_NoConsensusTime) != 0)
                 ledger["close_time_estimated"] = true;
         }
+
+        if (bBinary)
+        {
+            Serializer s (128);
+            addRaw (s);
+            ledger["ledger_data"]   = strHex (s.peekData ());
+        }
     }
     else
     {
@@ -1051,7 +1153,25 @@ Json::Value Ledger::getJson (int options)
         for (SHAMapItem::pointer item = mTransactionMap->peekFirstItem (type); !!item;
                 item = mTransactionMap->peekNextItem (item->getTag (), type))
         {
-            if (bFull || isSetBit (options, LEDGER_JSON_EXPAND))
+            if (bBinary && (bFull || isSetBit (options, LEDGER_JSON_EXPAND)))
+            {
+                // Hand back the canonical blobs as stored in the map
+                Json::Value& txJson = txns.append (Json::objectValue);
+
+                txJson["hash"] = item->getTag ().GetHex ();
+
+                if (type == SHAMapTreeNode::tnTRANSACTION_MD)
+                {
+                    SerializerIterator sit (item->peekSerializer ());
+                    txJson["tx_blob"] = strHex (sit.getVL ());
+                    txJson["meta"] = strHex (sit.getVL ());
+                }
+                else
+                {
+                    txJson["tx_blob"] = strHex (item->peekData ());
+                }
+            }
+            else if (bFull || isSetBit (options, LEDGER_JSON_EXPAND))
             {
                 if (type == SHAMapTreeNode::tnTRANSACTION_NM)
                 {
@@ -1088,7 +1208,9 @@ Json::Value Ledger::getJson (int options)
     if (mAccountStateMap && (bFull || isSetBit (options, LEDGER_JSON_DUMP_STATE)))
     {
         Json::Value& state = (ledger["accountState"] = Json::arrayValue);
-        if (bFull || isSetBit (options, LEDGER_JSON_EXPAND))
+        if (bBinary && (bFull || isSetBit (options, LEDGER_JSON_EXPAND)))
+            mAccountStateMap->visitLeaves(BIND_TYPE(stateItemBinaryAppender, beast::ref(state), P_1));
+        else if (bFull || isSetBit (options, LEDGER_JSON_EXPAND))
             visitStateItems(BIND_TYPE(stateItemFullAppender, beast::ref(state), P_1));
         else
             mAccountStateMap->visitLeaves(BIND_TYPE(stateItemTagAppender, beast::ref(state), P_1));
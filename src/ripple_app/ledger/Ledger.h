@@ -37,6 +37,7 @@ enum LedgerStateParms
     lepERROR        = 32,   // error
 };
 
+#define LEDGER_JSON_BINARY      0x08000000
 #define LEDGER_JSON_DUMP_TXRP   0x10000000
 #define LEDGER_JSON_DUMP_STATE  0x20000000
 #define LEDGER_JSON_EXPAND      0x40000000
@@ -114,6 +115,8 @@ public:
 
     Ledger (Ledger & target, bool isMutable); // snapshot
 
+    Ledger (LedgerSnapshot::ref snapshot, bool & loaded); // mounted from a snapshot file
+
     ~Ledger ();
 
     static Ledger::pointer getSQL (const std::string & sqlStatement);
@@ -59,6 +59,7 @@ public:
 
     SharedState m_state;
     Journal m_journal;
+    ScopedPointer <LedgerVerifier> m_verifier;
 
     //--------------------------------------------------------------------------
 
@@ -88,6 +89,9 @@ public:
 
     void onStart ()
     {
+        m_verifier = LedgerVerifier::New (getApp().getNodeStore (),
+            getApp().getCollectorManager ().collector (), m_journal);
+
         startThread();
     }
 
@@ -95,6 +99,8 @@ public:
     {
         m_journal.info << "Stopping";
         signalThreadShouldExit();
+        if (m_verifier != nullptr)
+            m_verifier->stop ();
         notify();
     }
 
@@ -287,11 +293,22 @@ public:
             doTxns = true;
         }
 
-        if (doNodes && !nodeLedger->walkLedger())
+        if (doNodes)
         {
-            m_journal.debug << "Ledger " << ledgerIndex << " is missing nodes";
-            getApp().getInboundLedgers().findCreate(ledgerHash, ledgerIndex, false);
-            return false;
+            LedgerVerifier::Result result;
+            // One ledger at a time, in the background: a single worker
+            // keeps the cleaner from competing with the server for CPU.
+            m_verifier->verify (*nodeLedger, 1, File::nonexistent (), result);
+
+            if (result.stopped)
+                return false;
+
+            if (!result.passed ())
+            {
+                m_journal.debug << "Ledger " << ledgerIndex << " is missing nodes";
+                getApp().getInboundLedgers().findCreate(ledgerHash, ledgerIndex, false);
+                return false;
+            }
         }
 
         if (doTxns && !nodeLedger->pendSaveValidated(true, false))
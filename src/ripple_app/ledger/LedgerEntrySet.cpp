@@ -26,6 +26,28 @@ SETUP_LOG (LedgerEntrySet)
 //
 #define DIR_NODE_MAX        32
 
+bool LedgerReadLog::intersects (std::set <uint256> const& keys) const
+{
+    if (keys.empty ())
+        return false;
+
+    for (std::size_t i = 0; i < mKeys.size (); ++i)
+    {
+        if (keys.count (mKeys[i]) != 0)
+            return true;
+    }
+
+    for (std::size_t i = 0; i < mRanges.size (); ++i)
+    {
+        std::set <uint256>::const_iterator const it = keys.upper_bound (mRanges[i].first);
+
+        if ((it != keys.end ()) && (mRanges[i].second.isZero () || (*it <= mRanges[i].second)))
+            return true;
+    }
+
+    return false;
+}
+
 void LedgerEntrySet::init (Ledger::ref ledger, uint256 const& transactionID,
                            uint32 ledgerID, TransactionEngineParams params)
 {
@@ -44,7 +66,7 @@ void LedgerEntrySet::clear ()
 
 LedgerEntrySet LedgerEntrySet::duplicate () const
 {
-    return LedgerEntrySet (mLedger, mEntries, mSet, mSeq + 1);
+    return LedgerEntrySet (mLedger, mEntries, mSet, mSeq + 1, mReads);
 }
 
 void LedgerEntrySet::setTo (const LedgerEntrySet& e)
@@ -54,6 +76,7 @@ void LedgerEntrySet::setTo (const LedgerEntrySet& e)
     mSet = e.mSet;
     mParams = e.mParams;
     mSeq = e.mSeq;
+    mReads = e.mReads;
 }
 
 void LedgerEntrySet::swapWith (LedgerEntrySet& e)
@@ -63,6 +86,7 @@ void LedgerEntrySet::swapWith (LedgerEntrySet& e)
     mSet.swap (e.mSet);
     std::swap (mParams, e.mParams);
     std::swap (mSeq, e.mSeq);
+    mReads.swap (e.mReads);
 }
 
 // Find an entry in the set.  If it has the wrong sequence number, copy it and update the sequence number.
@@ -110,6 +134,10 @@ SLE::pointer LedgerEntrySet::entryCache (LedgerEntryType letType, uint256 const&
         {
             assert (action != taaDELETE);
             sleEntry = mImmutable ? mLedger->getSLEi (index) : mLedger->getSLE (index);
+            TransactionProfile::onRead ();
+
+            if (mReads)
+                mReads->addKey (index);
 
             if (sleEntry)
                 entryCache (sleEntry);
@@ -1006,6 +1034,9 @@ uint256 LedgerEntrySet::getNextLedgerIndex (uint256 const& uHash)
     }
     while ((it != mEntries.end ()) && (it->second.mAction == taaDELETE));
 
+    if (mReads)
+        mReads->addRange (uHash, ledgerNext);
+
     // find next node in LES that isn't deleted
     for (it = mEntries.upper_bound (uHash); it != mEntries.end (); ++it)
     {
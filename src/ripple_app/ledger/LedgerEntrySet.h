@@ -63,6 +63,39 @@ public:
     }
 };
 
+/** The ledger keys read through a LedgerEntrySet.
+
+    Transactions applied speculatively record what they read so that a
+    later check can tell whether an earlier transaction changed any of it.
+    Copies and duplicates of a set share the same log.
+*/
+class LedgerReadLog
+{
+public:
+    typedef boost::shared_ptr <LedgerReadLog> pointer;
+
+    /** Record a read of one entry, whether or not it exists. */
+    void addKey (uint256 const& index)
+    {
+        mKeys.push_back (index);
+    }
+
+    /** Record a scan of the keys in (after, upTo].
+        A zero upTo means the scan ran off the end of the ledger.
+    */
+    void addRange (uint256 const& after, uint256 const& upTo)
+    {
+        mRanges.push_back (std::make_pair (after, upTo));
+    }
+
+    /** Returns true if any recorded read would see a key in the set. */
+    bool intersects (std::set <uint256> const& keys) const;
+
+private:
+    std::vector <uint256> mKeys;
+    std::vector <std::pair <uint256, uint256> > mRanges;
+};
+
 /** An LES is a LedgerEntrySet.
 
     It's a view into a ledger used while a transaction is processing.
@@ -142,6 +175,12 @@ public:
         return mLedger;
     }
 
+    // Record every key this set reads from its ledger in the log
+    void setReadLog (LedgerReadLog::pointer const& log)
+    {
+        mReads = log;
+    }
+
     // basic entry functions
     SLE::pointer getEntry (uint256 const & index, LedgerEntryAction&);
     LedgerEntryAction hasEntry (uint256 const & index) const;
@@ -254,10 +293,11 @@ private:
     TransactionEngineParams mParams;
     int mSeq;
     bool mImmutable;
+    LedgerReadLog::pointer mReads;
 
     LedgerEntrySet (Ledger::ref ledger, const std::map<uint256, LedgerEntrySetEntry>& e,
-                    const TransactionMetaSet & s, int m) :
-        mLedger (ledger), mEntries (e), mSet (s), mParams (tapNONE), mSeq (m), mImmutable (false)
+                    const TransactionMetaSet & s, int m, LedgerReadLog::pointer const& reads) :
+        mLedger (ledger), mEntries (e), mSet (s), mParams (tapNONE), mSeq (m), mImmutable (false), mReads (reads)
     {
         ;
     }
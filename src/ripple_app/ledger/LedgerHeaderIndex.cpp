@@ -0,0 +1,428 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+/*
+
+LedgerHeaderIndex
+
+Headers are held in a vector indexed by (sequence - m_firstSeq). A zero
+hash marks a sequence that is not stored. Ledgers acquired while filling
+in history usually arrive in descending order, so when the vector has to
+grow downward it grows by a proportional amount to keep the cost linear.
+
+The saved file is a 16 byte preamble (magic, first sequence, record size)
+followed by one 68 byte record per sequence in native byte order. It is a
+cache of the database on this machine and is not meant to be portable.
+
+*/
+
+class LedgerHeaderIndexImp
+    : public LedgerHeaderIndex
+    , public LeakChecked <LedgerHeaderIndexImp>
+{
+public:
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    enum
+    {
+        hashBytes = 32,
+        recordBytes = hashBytes + hashBytes + 4,
+        preambleBytes = 16,
+
+        // Smallest amount to grow the index downward by
+        minimumGrowth = 1024
+    };
+
+    static char const* getMagic ()
+    {
+        return "RLHDRIX1";
+    }
+
+    explicit LedgerHeaderIndexImp (Journal journal)
+        : m_journal (journal)
+        , m_lock (this, "LedgerHeaderIndex", __FILE__, __LINE__)
+        , m_loaded (false)
+        , m_firstSeq (0)
+    {
+    }
+
+    //--------------------------------------------------------------------------
+
+    void load (DatabaseCon& ledgerDB, File const& file)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        m_file = file;
+
+        LedgerIndex lastSeq = 0;
+
+        if (loadFile (file))
+        {
+            // The file only describes the database as of the last clean
+            // shutdown. Remove it now so that if we crash, the next launch
+            // rebuilds from the database instead of trusting stale headers.
+            if (!file.deleteFile ())
+            {
+                m_journal.warning << "Unable to remove " << file.getFullPathName () << ", rebuilding";
+                clear ();
+            }
+            else if (!m_headers.empty () && !matchesDatabase (ledgerDB))
+            {
+                m_journal.warning << file.getFullPathName () << " is out of date, rebuilding";
+                clear ();
+            }
+            else if (!m_headers.empty ())
+            {
+                lastSeq = m_firstSeq + m_headers.size () - 1;
+            }
+        }
+
+        std::string const sql (boost::str (boost::format (
+            "SELECT LedgerSeq,LedgerHash,PrevHash,ClosingTime FROM Ledgers WHERE LedgerSeq > %u;")
+                % lastSeq));
+
+        int loaded = 0;
+        {
+            Database* db = ledgerDB.getDB ();
+            DeprecatedScopedLock dbl (ledgerDB.getDBLock ());
+
+            SQL_FOREACH (db, sql)
+            {
+                std::string hash, parentHash;
+                Header header;
+
+                db->getStr ("LedgerHash", hash);
+                db->getStr ("PrevHash", parentHash);
+                header.hash.SetHexExact (hash);
+                header.parentHash.SetHexExact (parentHash);
+                header.closeTime = static_cast <uint32> (db->getBigInt ("ClosingTime"));
+
+                set (static_cast <LedgerIndex> (db->getBigInt ("LedgerSeq")), header);
+                ++loaded;
+            }
+        }
+
+        m_loaded = true;
+
+        m_journal.info << "Loaded " << countStored () << " ledger headers, " <<
+            loaded << " from the database";
+    }
+
+    void save ()
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        if (m_loaded && (m_file != File::nonexistent ()))
+            saveFile (m_file);
+    }
+
+    bool isLoaded ()
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        return m_loaded;
+    }
+
+    void insert (LedgerIndex seq, Header const& header)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        set (seq, header);
+    }
+
+    void erase (LedgerIndex seq)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        if (contains (seq))
+            m_headers [seq - m_firstSeq] = Header ();
+    }
+
+    bool find (LedgerIndex seq, Header& header)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        if (!isStored (seq))
+            return false;
+
+        header = m_headers [seq - m_firstSeq];
+        return true;
+    }
+
+    void getHashes (LedgerIndex minSeq, LedgerIndex maxSeq, HashMap& hashes)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        if (m_headers.empty () || (minSeq > maxSeq))
+            return;
+
+        LedgerIndex const first = std::max (minSeq, m_firstSeq);
+        LedgerIndex const last = std::min <LedgerIndex> (maxSeq, m_firstSeq + m_headers.size () - 1);
+
+        for (LedgerIndex seq = first; (seq <= last) && (seq >= first); ++seq)
+        {
+            Header const& header (m_headers [seq - m_firstSeq]);
+
+            if (header.hash.isNonZero ())
+                hashes [seq] = std::make_pair (header.hash, header.parentHash);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Cheap sanity check against the whole Ledgers table, in case the
+    // database was replaced while the server was stopped.
+    bool matchesDatabase (DatabaseCon& ledgerDB) const
+    {
+        int stored = 0;
+        LedgerIndex minSeq = 0;
+        LedgerIndex maxSeq = 0;
+
+        {
+            Database* db = ledgerDB.getDB ();
+            DeprecatedScopedLock dbl (ledgerDB.getDBLock ());
+
+            SQL_FOREACH (db, "SELECT COUNT(*) AS Count, MIN(LedgerSeq) AS MinSeq, "
+                "MAX(LedgerSeq) AS MaxSeq FROM Ledgers;")
+            {
+                stored = db->getInt ("Count");
+                minSeq = static_cast <LedgerIndex> (db->getBigInt ("MinSeq"));
+                maxSeq = static_cast <LedgerIndex> (db->getBigInt ("MaxSeq"));
+            }
+        }
+
+        return (stored == countStored ()) && isStored (minSeq) && isStored (maxSeq);
+    }
+
+    bool isStored (LedgerIndex seq) const
+    {
+        return contains (seq) && m_headers [seq - m_firstSeq].hash.isNonZero ();
+    }
+
+    bool contains (LedgerIndex seq) const
+    {
+        return (seq >= m_firstSeq) && ((seq - m_firstSeq) < m_headers.size ());
+    }
+
+    int countStored () const
+    {
+        int count = 0;
+
+        for (std::vector <Header>::const_iterator it = m_headers.begin (); it != m_headers.end (); ++it)
+            if (it->hash.isNonZero ())
+                ++count;
+
+        return count;
+    }
+
+    void clear ()
+    {
+        m_headers.clear ();
+        m_firstSeq = 0;
+    }
+
+    void set (LedgerIndex seq, Header const& header)
+    {
+        if (m_headers.empty ())
+        {
+            m_firstSeq = seq;
+        }
+        else if (seq < m_firstSeq)
+        {
+            std::size_t const growth = std::min <std::size_t> (m_firstSeq,
+                std::max <std::size_t> (m_firstSeq - seq,
+                    std::max <std::size_t> (minimumGrowth, m_headers.size () / 4)));
+
+            m_headers.insert (m_headers.begin (), growth, Header ());
+            m_firstSeq -= growth;
+        }
+
+        std::size_t const offset = seq - m_firstSeq;
+
+        if (offset >= m_headers.size ())
+            m_headers.resize (offset + 1);
+
+        m_headers [offset] = header;
+    }
+
+    bool loadFile (File const& file)
+    {
+        if (!file.existsAsFile ())
+            return false;
+
+        MemoryMappedFile map (file, MemoryMappedFile::readOnly);
+        char const* const data = static_cast <char const*> (map.getData ());
+
+        if ((data == nullptr) || (map.getSize () < preambleBytes) ||
+            (memcmp (data, getMagic (), 8) != 0) ||
+            (readInt (data + 12) != recordBytes) ||
+            (((map.getSize () - preambleBytes) % recordBytes) != 0))
+        {
+            m_journal.warning << "Ignoring unreadable " << file.getFullPathName ();
+            return false;
+        }
+
+        std::size_t const count = (map.getSize () - preambleBytes) / recordBytes;
+        char const* record = data + preambleBytes;
+
+        m_firstSeq = readInt (data + 8);
+        m_headers.resize (count);
+
+        for (std::size_t i = 0; i < count; ++i, record += recordBytes)
+        {
+            Header& header (m_headers [i]);
+            memcpy (header.hash.begin (), record, hashBytes);
+            memcpy (header.parentHash.begin (), record + hashBytes, hashBytes);
+            header.closeTime = readInt (record + hashBytes + hashBytes);
+        }
+
+        return true;
+    }
+
+    // Writes to a temporary file first so a failed save leaves no partial index
+    bool saveFile (File const& file)
+    {
+        File const temp (file.getSiblingFile (file.getFileName () + ".tmp"));
+        temp.deleteFile ();
+
+        {
+            FileOutputStream out (temp);
+
+            if (out.failedToOpen ())
+            {
+                m_journal.warning << "Unable to create " << temp.getFullPathName ();
+                return false;
+            }
+
+            uint32 const firstSeq = m_firstSeq;
+            uint32 const size = recordBytes;
+
+            out.write (getMagic (), 8);
+            out.write (&firstSeq, 4);
+            out.write (&size, 4);
+
+            for (std::vector <Header>::const_iterator it = m_headers.begin (); it != m_headers.end (); ++it)
+            {
+                out.write (it->hash.begin (), hashBytes);
+                out.write (it->parentHash.begin (), hashBytes);
+                out.write (&it->closeTime, 4);
+            }
+
+            out.flush ();
+
+            if (out.getStatus ().failed ())
+            {
+                m_journal.warning << "Unable to write " << temp.getFullPathName ();
+                temp.deleteFile ();
+                return false;
+            }
+        }
+
+        return temp.moveFileTo (file);
+    }
+
+    static uint32 readInt (char const* p)
+    {
+        uint32 v;
+        memcpy (&v, p, 4);
+        return v;
+    }
+
+private:
+    Journal m_journal;
+    LockType m_lock;
+
+    bool m_loaded;
+    File m_file;
+    LedgerIndex m_firstSeq;
+    std::vector <Header> m_headers;
+};
+
+//------------------------------------------------------------------------------
+
+LedgerHeaderIndex* LedgerHeaderIndex::New (Journal journal)
+{
+    return new LedgerHeaderIndexImp (journal);
+}
+
+//------------------------------------------------------------------------------
+
+class LedgerHeaderIndexTests : public UnitTest
+{
+public:
+    LedgerHeaderIndexTests () : UnitTest ("LedgerHeaderIndex", "ripple")
+    {
+    }
+
+    static LedgerHeaderIndex::Header makeHeader (LedgerIndex seq)
+    {
+        LedgerHeaderIndex::Header header;
+        header.hash = uint256 (seq + 1);
+        header.parentHash = uint256 (seq);
+        header.closeTime = seq * 10;
+        return header;
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("insert");
+
+        LedgerHeaderIndexImp index (journal ());
+        LedgerHeaderIndex::Header header;
+
+        for (LedgerIndex seq = 5000; seq <= 5010; ++seq)
+            index.insert (seq, makeHeader (seq));
+
+        // Growing downward, as when history is acquired
+        for (LedgerIndex seq = 4999; seq >= 4000; --seq)
+            index.insert (seq, makeHeader (seq));
+
+        index.insert (20, makeHeader (20));
+        index.erase (5005);
+
+        expect (index.countStored () == 1011);
+        expect (index.find (20, header) && header.closeTime == 200);
+        expect (index.find (4000, header) && header.hash == uint256 (4001));
+        expect (index.find (5010, header) && header.parentHash == uint256 (5010));
+        expect (!index.find (5005, header), "erased ledger should be missing");
+        expect (!index.find (21, header));
+        expect (!index.find (5011, header));
+
+        LedgerHeaderIndex::HashMap hashes;
+        index.getHashes (5000, 6000, hashes);
+        expect (hashes.size () == 10);
+        expect (hashes [5010].first == uint256 (5011));
+
+        beginTestCase ("file");
+
+        File const file (File::createTempFile ("ledger_headers"));
+        expect (index.saveFile (file));
+
+        LedgerHeaderIndexImp reloaded (journal ());
+        expect (reloaded.loadFile (file));
+        expect (reloaded.countStored () == 1011);
+        expect (reloaded.find (4321, header) && header.closeTime == 43210);
+        expect (!reloaded.find (5005, header));
+
+        file.deleteFile ();
+    }
+};
+
+static LedgerHeaderIndexTests ledgerHeaderIndexTests;
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGERHEADERINDEX_H_INCLUDED
+#define RIPPLE_LEDGERHEADERINDEX_H_INCLUDED
+
+/** Dense in-memory index of stored ledger headers by sequence.
+
+    Mirrors the sequence, hash, parent hash and close time columns of the
+    Ledgers table so that hash-by-sequence lookups are an array access
+    instead of a query. The index is saved to a flat file at shutdown and
+    memory-mapped at the next launch, after which only ledgers newer than
+    the file are read from the database. The file is removed once read, so
+    after an unclean shutdown the index is rebuilt from the database.
+*/
+class LedgerHeaderIndex
+{
+public:
+    struct Header
+    {
+        Header ()
+            : closeTime (0)
+        {
+        }
+
+        LedgerHash hash;
+        LedgerHash parentHash;
+        uint32 closeTime;
+    };
+
+    typedef std::map <LedgerIndex, std::pair <LedgerHash, LedgerHash> > HashMap;
+
+    /** Create a new, empty, index.
+        The caller receives ownership and must delete the object when done.
+    */
+    static LedgerHeaderIndex* New (Journal journal);
+
+    virtual ~LedgerHeaderIndex () { }
+
+    /** Populate the index from the saved file and the ledger database.
+        If the file is missing or does not match the database, the whole
+        Ledgers table is read instead. The file is deleted once it has
+        been read and is written again by save().
+    */
+    virtual void load (DatabaseCon& ledgerDB, File const& file) = 0;
+
+    /** Write the index to the file it was loaded from. */
+    virtual void save () = 0;
+
+    /** Returns true once load() has completed.
+        Until then lookups must go to the database.
+    */
+    virtual bool isLoaded () = 0;
+
+    /** Record a ledger written to the Ledgers table. */
+    virtual void insert (LedgerIndex seq, Header const& header) = 0;
+
+    /** Forget a ledger removed from the Ledgers table. */
+    virtual void erase (LedgerIndex seq) = 0;
+
+    /** Look up a ledger by sequence.
+        @return false if no ledger with this sequence is stored.
+    */
+    virtual bool find (LedgerIndex seq, Header& header) = 0;
+
+    /** Retrieve the hash and parent hash of stored ledgers in a range. */
+    virtual void getHashes (LedgerIndex minSeq, LedgerIndex maxSeq, HashMap& hashes) = 0;
+};
+
+#endif
@@ -76,7 +76,17 @@ Ledger::pointer LedgerHistory::getLedgerBySeq (uint32 index)
     Ledger::pointer ret (Ledger::loadByIndex (index));
 
     if (!ret)
+    {
+        // A mounted snapshot is not recorded as the history for its
+        // sequence, the ledger database stays authoritative
+        std::map <LedgerIndex, LedgerHash>::const_iterator const snapshot (
+            mSnapshotsByIndex.find (index));
+
+        if (snapshot != mSnapshotsByIndex.end ())
+            return getLedgerByHash (snapshot->second);
+
         return ret;
+    }
 
     assert (ret->getLedgerSeq () == index);
 
@@ -100,6 +110,15 @@ Ledger::pointer LedgerHistory::getLedgerByHash (uint256 const& hash)
 
     ret = Ledger::loadByHash (hash);
 
+    if (!ret)
+    {
+        std::map <LedgerHash, LedgerSnapshot::pointer>::const_iterator const snapshot (
+            mSnapshotsByHash.find (hash));
+
+        if (snapshot != mSnapshotsByHash.end ())
+            ret = loadSnapshot (snapshot->second);
+    }
+
     if (!ret)
         return ret;
 
@@ -174,6 +193,58 @@ bool LedgerHistory::fixIndex (LedgerIndex ledgerIndex, LedgerHash const& ledgerH
     return true;
 }
 
+void LedgerHistory::mountSnapshots (File const& directory, Journal journal)
+{
+    Array <File> files;
+    directory.findChildFiles (files, File::findFiles, false);
+
+    for (int i = 0; i < files.size (); ++i)
+    {
+        LedgerSnapshot::pointer const snapshot (LedgerSnapshot::open (files [i], journal));
+
+        if (!snapshot)
+        {
+            journal.warning << "Skipping " << files [i].getFullPathName ();
+            continue;
+        }
+
+        Ledger::pointer const ledger (loadSnapshot (snapshot));
+
+        if (!ledger)
+        {
+            journal.warning << "Unable to mount " << files [i].getFullPathName ();
+            continue;
+        }
+
+        // Only a ledger which the database does not contradict is mounted
+        uint256 const expected (Ledger::getHashByIndex (ledger->getLedgerSeq ()));
+
+        if (expected.isNonZero () && (expected != ledger->getHash ()))
+        {
+            journal.warning << files [i].getFullPathName () << " holds ledger " <<
+                ledger->getHash () << ", not ledger " << expected;
+            continue;
+        }
+
+        journal.info << "Mounted ledger " << ledger->getLedgerSeq () <<
+            " from " << files [i].getFullPathName ();
+
+        mSnapshotsByIndex [ledger->getLedgerSeq ()] = ledger->getHash ();
+        mSnapshotsByHash [ledger->getHash ()] = snapshot;
+    }
+}
+
+Ledger::pointer LedgerHistory::loadSnapshot (LedgerSnapshot::ref snapshot)
+{
+    bool loaded;
+    Ledger::pointer ret (boost::make_shared <Ledger> (snapshot, boost::ref (loaded)));
+
+    if (!loaded)
+        return Ledger::pointer ();
+
+    return ret;
+}
+
 void LedgerHistory::tune (int size, int age)
 {
     mLedgersByHash.setTargetSize (size);
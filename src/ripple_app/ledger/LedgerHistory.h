@@ -52,13 +52,27 @@ public:
 
     bool fixIndex(LedgerIndex ledgerIndex, LedgerHash const& ledgerHash);
 
+    /** Mount every ledger snapshot in a directory.
+        A ledger that cannot be loaded from the ledger database is looked
+        up in the mounted snapshots. A snapshot is skipped if the database
+        has a different hash for its sequence. Must be called before any
+        lookups.
+    */
+    void mountSnapshots (File const& directory, Journal journal);
+
 private:
+    Ledger::pointer loadSnapshot (LedgerSnapshot::ref snapshot);
+
     TaggedCacheType <LedgerHash, Ledger, UptimeTimerAdapter> mLedgersByHash;
     TaggedCacheType <LedgerIndex, std::pair< LedgerHash, LedgerHash >, UptimeTimerAdapter> mConsensusValidated;
 
 
     // Maps ledger indexes to the corresponding hash.
     std::map <LedgerIndex, LedgerHash> mLedgersByIndex; // validated ledgers
+
+    // Mounted snapshots, read-only once mountSnapshots returns.
+    std::map <LedgerIndex, LedgerHash> mSnapshotsByIndex;
+    std::map <LedgerHash, LedgerSnapshot::pointer> mSnapshotsByHash;
 };
 
 #endif
@@ -88,6 +88,7 @@ public:
         , mValidLedgerClose (0)
         , mValidLedgerSeq (0)
         , mHeldTransactions (uint256 ())
+        , mCompleteLock (this, "LedgerMaster.complete", __FILE__, __LINE__)
         , mLedgerCleaner (LedgerCleaner::New(*this, LogPartition::getJournal<LedgerCleanerLog>()))
         , mMinValidations (0)
         , mLastValidateSeq (0)
@@ -494,18 +495,20 @@ public:
     void getFetchPack (Ledger::ref nextLedger)
     {
         Peer::pointer target;
-        int count = 0;
+        std::vector<Peer::pointer> candidates;
 
         std::vector<Peer::pointer> peerList = getApp().getPeers ().getPeerVector ();
         BOOST_FOREACH (const Peer::pointer & peer, peerList)
         {
             if (peer->hasRange (nextLedger->getLedgerSeq() - 1, nextLedger->getLedgerSeq()))
-            {
-                if (count++ == 0)
-                    target = peer;
-                else if ((rand () % ++count) == 0)
-                    target = peer;
-            }
+                candidates.push_back (peer);
+        }
+
+        if (!candidates.empty ())
+        {
+            // Favor peers which answer our requests quickly
+            PeerSet::orderByScore (candidates);
+            target = candidates.front ();
         }
 
         if (target)
@@ -1246,6 +1249,11 @@ public:
         mLedgerHistory.tune (size, age);
     }
 
+    void mountSnapshots (File const& directory)
+    {
+        mLedgerHistory.mountSnapshots (directory, m_journal);
+    }
+
     void sweep ()
     {
         mLedgerHistory.sweep ();
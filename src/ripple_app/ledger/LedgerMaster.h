@@ -120,6 +120,12 @@ public:
     virtual bool getFullValidatedRange (uint32& minVal, uint32& maxVal) = 0;
 
     virtual void tune (int size, int age) = 0;
+
+    /** Serve ledgers from the snapshot files in a directory.
+        @see LedgerHistory::mountSnapshots
+    */
+    virtual void mountSnapshots (File const& directory) = 0;
+
     virtual void sweep () = 0;
     virtual float getCacheHitRate () = 0;
     virtual void addValidateCallback (callback& c) = 0;
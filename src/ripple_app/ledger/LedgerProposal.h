@@ -95,6 +95,10 @@ public:
     {
         mSignature = signature;
     }
+    std::string const& getSignature () const
+    {
+        return mSignature;
+    }
     bool hasSignature ()
     {
         return !mSignature.empty ();
@@ -0,0 +1,423 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+class LedgerReplayBenchmarkImp
+    : public LedgerReplayBenchmark
+    , public LeakChecked <LedgerReplayBenchmarkImp>
+{
+public:
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    enum
+    {
+        // Stop logging individual problems after this many
+        maxReported = 32
+    };
+
+    // A transaction as it was applied in the stored ledger
+    struct Recorded
+    {
+        Recorded (uint32 index_, SerializedTransaction::pointer const& txn_, TER result_)
+            : index (index_)
+            , txn (txn_)
+            , result (result_)
+        {
+        }
+
+        bool operator< (Recorded const& other) const
+        {
+            return index < other.index;
+        }
+
+        uint32 index;
+        SerializedTransaction::pointer txn;
+        TER result;
+    };
+
+    // The measurements of one replayed transaction
+    struct Applied
+    {
+        Applied (TxType type_, int64 ticks_, TransactionProfile::Sample const& sample_)
+            : type (type_)
+            , ticks (ticks_)
+            , sample (sample_)
+        {
+        }
+
+        TxType type;
+        int64 ticks;
+        TransactionProfile::Sample sample;
+    };
+
+    // The totals for one transaction type
+    struct TypeTotals
+    {
+        TypeTotals ()
+            : count (0)
+            , ticks (0)
+            , sleReads (0)
+            , sleWrites (0)
+        {
+            for (int i = 0; i < TransactionProfile::sectionCount; ++i)
+                sectionTicks [i] = 0;
+        }
+
+        uint64 count;
+        int64 ticks;
+        int64 sectionTicks [TransactionProfile::sectionCount];
+        uint64 sleReads;
+        uint64 sleWrites;
+        insight::HistogramBuckets micros;
+    };
+
+    typedef std::map <TxType, TypeTotals> TypeMap;
+
+    struct Totals
+    {
+        Totals ()
+            : ledgers (0)
+            , transactions (0)
+            , missing (0)
+            , mismatchedLedgers (0)
+            , mismatchedTransactions (0)
+            , loadTicks (0)
+            , applyTicks (0)
+            , seconds (0)
+        {
+        }
+
+        uint32 ledgers;
+        uint64 transactions;
+        uint32 missing;
+        uint32 mismatchedLedgers;
+        uint64 mismatchedTransactions;
+        int64 loadTicks;
+        int64 applyTicks;
+        double seconds;
+    };
+
+    //--------------------------------------------------------------------------
+
+    class Worker : public Thread
+    {
+    public:
+        explicit Worker (LedgerReplayBenchmarkImp& owner)
+            : Thread ("LedgerReplay")
+            , m_owner (owner)
+        {
+        }
+
+        ~Worker ()
+        {
+            stopThread ();
+        }
+
+        void run ()
+        {
+            m_owner.runWorker ();
+        }
+
+    private:
+        LedgerReplayBenchmarkImp& m_owner;
+    };
+
+    //--------------------------------------------------------------------------
+
+    explicit LedgerReplayBenchmarkImp (Journal journal)
+        : m_journal (journal)
+        , m_lock (this, "LedgerReplayBenchmark", __FILE__, __LINE__)
+        , m_nextLedger (0)
+        , m_reported (0)
+    {
+    }
+
+    bool run (Setup const& setup)
+    {
+        double const start = Time::getMillisecondCounterHiRes ();
+
+        m_setup = setup;
+        m_totals = Totals ();
+        m_types.clear ();
+        m_nextLedger = setup.firstLedger;
+        m_reported = 0;
+
+        int threads (setup.threads);
+        if (threads <= 0)
+            threads = SystemStats::getNumCpus ();
+        if (setup.lastLedger >= setup.firstLedger)
+            threads = std::max (1, std::min <int> (threads,
+                setup.lastLedger - setup.firstLedger + 1));
+        m_setup.threads = threads;
+
+        m_journal.info << "Replaying ledgers " << setup.firstLedger <<
+            " through " << setup.lastLedger << " on " << threads << " threads";
+
+        {
+            OwnedArray <Worker> workers;
+
+            for (int i = 0; i < threads; ++i)
+            {
+                workers.add (new Worker (*this));
+                workers [i]->startThread ();
+            }
+
+            for (int i = 0; i < threads; ++i)
+                workers [i]->waitForThreadToExit (-1);
+        }
+
+        m_totals.seconds = (Time::getMillisecondCounterHiRes () - start) / 1000.0;
+
+        m_journal.info << "Replayed " << m_totals.ledgers << " ledgers and " <<
+            m_totals.transactions << " transactions in " << m_totals.seconds << "s, " <<
+            m_totals.missing << " missing, " << m_totals.mismatchedLedgers <<
+            " ledgers and " << m_totals.mismatchedTransactions << " transactions differ";
+
+        return (m_totals.missing == 0) && (m_totals.mismatchedLedgers == 0) &&
+            (m_totals.mismatchedTransactions == 0);
+    }
+
+    Json::Value getJson ()
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        Json::Value ret (Json::objectValue);
+
+        ret["first_ledger"] = m_setup.firstLedger;
+        ret["last_ledger"] = m_setup.lastLedger;
+        ret["threads"] = m_setup.threads;
+        ret["ledgers"] = m_totals.ledgers;
+        ret["transactions"] = static_cast <double> (m_totals.transactions);
+        ret["missing_ledgers"] = m_totals.missing;
+        ret["mismatched_ledgers"] = m_totals.mismatchedLedgers;
+        ret["mismatched_transactions"] = static_cast <double> (m_totals.mismatchedTransactions);
+        ret["seconds"] = m_totals.seconds;
+        ret["load_seconds"] = Time::highResolutionTicksToSeconds (m_totals.loadTicks);
+        ret["apply_seconds"] = Time::highResolutionTicksToSeconds (m_totals.applyTicks);
+
+        if (m_totals.seconds > 0)
+        {
+            ret["ledgers_per_second"] = m_totals.ledgers / m_totals.seconds;
+            ret["transactions_per_second"] = m_totals.transactions / m_totals.seconds;
+        }
+
+        Json::Value& types (ret["types"] = Json::objectValue);
+
+        for (TypeMap::iterator iter = m_types.begin (); iter != m_types.end (); ++iter)
+        {
+            TypeTotals& totals (iter->second);
+            insight::HistogramBuckets::Snapshot const micros (totals.micros.snapshot ());
+            double const count (static_cast <double> (totals.count));
+
+            Json::Value& entry (types[getTypeName (iter->first)] = Json::objectValue);
+            entry["count"] = count;
+            entry["mean_us"] = getMicros (totals.ticks) / count;
+            entry["p50_us"] = static_cast <double> (micros.percentile (0.50));
+            entry["p99_us"] = static_cast <double> (micros.percentile (0.99));
+            entry["p999_us"] = static_cast <double> (micros.percentile (0.999));
+            entry["max_us"] = static_cast <double> (micros.max);
+            entry["ripple_calc_us"] = getMicros (
+                totals.sectionTicks [TransactionProfile::rippleCalc]) / count;
+            entry["take_offers_us"] = getMicros (
+                totals.sectionTicks [TransactionProfile::takeOffers]) / count;
+            entry["sle_reads"] = totals.sleReads / count;
+            entry["sle_writes"] = totals.sleWrites / count;
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    static double getMicros (int64 ticks)
+    {
+        return Time::highResolutionTicksToSeconds (ticks) * 1000000;
+    }
+
+    static std::string getTypeName (TxType type)
+    {
+        TxFormats::Item const* const item (TxFormats::getInstance ()->findByType (type));
+
+        if (item == nullptr)
+            return lexicalCastThrow <std::string> (static_cast <int> (type));
+
+        return item->getName ();
+    }
+
+    void runWorker ()
+    {
+        for (;;)
+        {
+            uint32 seq;
+
+            {
+                ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+                if (m_nextLedger > m_setup.lastLedger)
+                    return;
+
+                seq = m_nextLedger++;
+            }
+
+            try
+            {
+                replayLedger (seq);
+            }
+            catch (SHAMapMissingNode&)
+            {
+                report ("Ledger is missing nodes", seq);
+                ScopedLockType sl (m_lock, __FILE__, __LINE__);
+                ++m_totals.missing;
+            }
+        }
+    }
+
+    void report (char const* what, uint32 seq)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        if (m_reported++ < maxReported)
+            m_journal.warning << what << ": " << seq;
+    }
+
+    void replayLedger (uint32 seq)
+    {
+        int64 const loadStart (Time::getHighResolutionTicks ());
+
+        Ledger::pointer const stored (Ledger::loadByIndex (seq));
+        Ledger::pointer const parent ((seq > 1) ? Ledger::loadByIndex (seq - 1) : Ledger::pointer ());
+
+        if (!stored || !parent || (stored->getParentHash () != parent->getHash ()))
+        {
+            report ("Ledger or its parent is missing", seq);
+            ScopedLockType sl (m_lock, __FILE__, __LINE__);
+            ++m_totals.missing;
+            return;
+        }
+
+        // Read the transactions in the order they were applied
+        std::vector <Recorded> transactions;
+        {
+            SHAMap::ref txMap (stored->peekTransactionMap ());
+            SHAMapTreeNode::TNType type;
+
+            for (SHAMapItem::pointer item = txMap->peekFirstItem (type); !!item;
+                item = txMap->peekNextItem (item->getTag (), type))
+            {
+                TransactionMetaSet::pointer meta;
+                SerializedTransaction::pointer txn (stored->getSMTransaction (item, type, meta));
+
+                if (!txn || !meta)
+                {
+                    report ("Transaction without metadata in ledger", seq);
+                    ScopedLockType sl (m_lock, __FILE__, __LINE__);
+                    ++m_totals.missing;
+                    return;
+                }
+
+                transactions.push_back (Recorded (meta->getIndex (), txn, meta->getResultTER ()));
+            }
+        }
+        std::sort (transactions.begin (), transactions.end ());
+
+        int64 const applyStart (Time::getHighResolutionTicks ());
+
+        parent->setClosed ();
+        Ledger::pointer const ledger (boost::make_shared <Ledger> (false, boost::ref (*parent)));
+        TransactionEngine engine (ledger);
+        TransactionEngineParams const params (m_setup.checkSignatures ? tapNONE : tapNO_CHECK_SIGN);
+
+        std::vector <Applied> applied;
+        applied.reserve (transactions.size ());
+        uint64 mismatched (0);
+
+        for (std::size_t i = 0; i < transactions.size (); ++i)
+        {
+            Recorded const& recorded (transactions [i]);
+            TransactionProfile::Sample sample;
+            bool didApply (false);
+            TER result;
+
+            int64 const start (Time::getHighResolutionTicks ());
+            {
+                TransactionProfile::ScopedSample scope (sample);
+                result = engine.applyTransaction (*recorded.txn, params, didApply);
+            }
+            applied.push_back (Applied (recorded.txn->getTxnType (),
+                Time::getHighResolutionTicks () - start, sample));
+
+            if (!didApply || (result != recorded.result))
+            {
+                ++mismatched;
+                report ("Transaction result differs in ledger", seq);
+            }
+        }
+
+        ledger->updateSkipList ();
+
+        int64 const applyTicks (Time::getHighResolutionTicks () - applyStart);
+
+        bool const matched (
+            (ledger->peekAccountStateMap ()->getHash () == stored->getAccountHash ()) &&
+            (ledger->peekTransactionMap ()->getHash () == stored->getTransHash ()));
+
+        if (!matched)
+            report ("Replayed ledger differs", seq);
+
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        ++m_totals.ledgers;
+        m_totals.transactions += transactions.size ();
+        m_totals.mismatchedTransactions += mismatched;
+        m_totals.loadTicks += applyStart - loadStart;
+        m_totals.applyTicks += applyTicks;
+        if (!matched)
+            ++m_totals.mismatchedLedgers;
+
+        for (std::size_t i = 0; i < applied.size (); ++i)
+        {
+            Applied const& a (applied [i]);
+            TypeTotals& totals (m_types [a.type]);
+
+            ++totals.count;
+            totals.ticks += a.ticks;
+            for (int j = 0; j < TransactionProfile::sectionCount; ++j)
+                totals.sectionTicks [j] += a.sample.ticks [j];
+            totals.sleReads += a.sample.sleReads;
+            totals.sleWrites += a.sample.sleWrites;
+            totals.micros.record (static_cast <uint64> (getMicros (a.ticks)));
+        }
+    }
+
+private:
+    Journal m_journal;
+    LockType m_lock;
+    Setup m_setup;
+    uint32 m_nextLedger;
+    Totals m_totals;
+    TypeMap m_types;
+    int m_reported;
+};
+
+//------------------------------------------------------------------------------
+
+LedgerReplayBenchmark* LedgerReplayBenchmark::New (Journal journal)
+{
+    return new LedgerReplayBenchmarkImp (journal);
+}
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGERREPLAYBENCHMARK_H_INCLUDED
+#define RIPPLE_LEDGERREPLAYBENCHMARK_H_INCLUDED
+
+/** Measures the transaction engine against stored ledgers.
+
+    Each ledger in a range is rebuilt from its stored parent. Its
+    transactions are applied with a TransactionEngine in the order their
+    metadata records, and the result of each one, the account state hash
+    and the transaction tree hash are compared with the stored ledger.
+
+    Apply latency is reported per transaction type, together with the time
+    spent in RippleCalc and takeOffers and the ledger entries read and
+    written. With more than one thread, different ledgers of the range are
+    replayed at the same time.
+*/
+class LedgerReplayBenchmark
+{
+public:
+    struct Setup
+    {
+        Setup ()
+            : firstLedger (0)
+            , lastLedger (0)
+            , threads (1)
+            , checkSignatures (false)
+        {
+        }
+
+        uint32 firstLedger;
+        uint32 lastLedger;
+        int threads;            // 0 for one per CPU
+        bool checkSignatures;   // Verify each transaction's signature
+    };
+
+    /** Create a benchmark.
+        The caller receives ownership and must delete the object when done.
+    */
+    static LedgerReplayBenchmark* New (Journal journal);
+
+    virtual ~LedgerReplayBenchmark () { }
+
+    /** Replay the range of ledgers, blocking until done.
+        @return `true` if every ledger was found and reproduced exactly.
+    */
+    virtual bool run (Setup const& setup) = 0;
+
+    /** Returns the measurements from the last run. */
+    virtual Json::Value getJson () = 0;
+};
+
+#endif
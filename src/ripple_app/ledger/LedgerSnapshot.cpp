@@ -0,0 +1,641 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+/*
+
+LedgerSnapshot
+
+The file starts with a 16 byte preamble: the magic, the size of the ledger
+header and the number of maps. The ledger header follows, then one 72 byte
+descriptor per map:
+
+    type (4), reserved (4), node count (8), first node (8),
+    end of nodes (8), index (8), root hash (32)
+
+Each map's nodes are written as they are visited by SHAMap::getFetchPack,
+an inner node followed by its leaves and then its inner children, so that
+a walk down the tree touches neighbouring pages. A node is stored as its
+size (4) and its data in prefix format. The map's index follows its nodes,
+one 40 byte entry per node, sorted by hash:
+
+    node hash (32), offset of the node's data (8)
+
+Descriptors and indexes start on 8 byte boundaries. Offsets are from the
+start of the file and every integer is big-endian.
+
+*/
+
+class LedgerSnapshotWriter
+{
+public:
+    typedef std::pair <uint256, uint64> Entry;
+
+    enum
+    {
+        preambleBytes = 16,
+        descriptorBytes = 72,
+        entryBytes = 40
+    };
+
+    static char const* getMagic ()
+    {
+        return "RLSNAP01";
+    }
+
+    LedgerSnapshotWriter (FileOutputStream& out, Journal journal)
+        : m_out (out)
+        , m_journal (journal)
+        , m_ok (true)
+    {
+    }
+
+    bool write (Blob const& rawHeader, SHAMap& stateMap, SHAMap* transactionMap)
+    {
+        int const mapCount = (transactionMap != nullptr) ? 2 : 1;
+
+        m_out.write (getMagic (), 8);
+        m_out.writeIntBigEndian (static_cast <int> (rawHeader.size ()));
+        m_out.writeIntBigEndian (mapCount);
+        m_out.write (&rawHeader.front (), rawHeader.size ());
+        pad ();
+
+        // The descriptors are filled in once the maps have been written
+        int64 const descriptors = m_out.getPosition ();
+        m_out.writeRepeatedByte (0, mapCount * descriptorBytes);
+
+        writeMap (descriptors, smtSTATE, stateMap);
+
+        if (transactionMap != nullptr)
+            writeMap (descriptors + descriptorBytes, smtTRANSACTION, *transactionMap);
+
+        m_out.flush ();
+
+        return m_ok && m_out.getStatus ().wasOk ();
+    }
+
+private:
+    void pad ()
+    {
+        int64 const position = m_out.getPosition ();
+
+        if ((position % 8) != 0)
+            m_out.writeRepeatedByte (0, 8 - (position % 8));
+    }
+
+    void onNode (uint256 const& hash, Blob const& data)
+    {
+        m_out.writeIntBigEndian (static_cast <int> (data.size ()));
+        m_entries.push_back (Entry (hash, m_out.getPosition ()));
+        m_out.write (&data.front (), data.size ());
+    }
+
+    void writeMap (int64 descriptor, SHAMapType type, SHAMap& map)
+    {
+        m_entries.clear ();
+
+        pad ();
+        int64 const nodesBegin = m_out.getPosition ();
+
+        try
+        {
+            map.getFetchPack (nullptr, true, std::numeric_limits <int>::max (),
+                BIND_TYPE (&LedgerSnapshotWriter::onNode, this, P_1, P_2));
+        }
+        catch (SHAMapMissingNode const& mn)
+        {
+            m_journal.warning << "Snapshot is incomplete: " << mn;
+            m_ok = false;
+        }
+
+        int64 const nodesEnd = m_out.getPosition ();
+
+        // A node shared by two branches is stored twice but indexed once
+        std::sort (m_entries.begin (), m_entries.end ());
+        m_entries.erase (std::unique (m_entries.begin (), m_entries.end (), hashEquals),
+            m_entries.end ());
+
+        pad ();
+        int64 const index = m_out.getPosition ();
+
+        for (std::vector <Entry>::const_iterator it = m_entries.begin (); it != m_entries.end (); ++it)
+        {
+            m_out.write (it->first.begin (), it->first.size ());
+            m_out.writeInt64BigEndian (it->second);
+        }
+
+        int64 const end = m_out.getPosition ();
+        uint256 const rootHash (map.getHash ());
+
+        m_out.setPosition (descriptor);
+        m_out.writeIntBigEndian (type);
+        m_out.writeIntBigEndian (0);
+        m_out.writeInt64BigEndian (m_entries.size ());
+        m_out.writeInt64BigEndian (nodesBegin);
+        m_out.writeInt64BigEndian (nodesEnd);
+        m_out.writeInt64BigEndian (index);
+        m_out.write (rootHash.begin (), rootHash.size ());
+        m_out.setPosition (end);
+
+        m_journal.info << "Wrote " << m_entries.size () << " nodes of the " <<
+            ((type == smtSTATE) ? "state" : "transaction") << " map";
+    }
+
+    static bool hashEquals (Entry const& lhs, Entry const& rhs)
+    {
+        return lhs.first == rhs.first;
+    }
+
+    FileOutputStream& m_out;
+    Journal m_journal;
+    bool m_ok;
+    std::vector <Entry> m_entries;
+};
+
+//------------------------------------------------------------------------------
+
+bool LedgerSnapshot::write (File const& file, Blob const& rawHeader,
+    SHAMap& stateMap, SHAMap* transactionMap, Journal journal)
+{
+    // Write to a temporary file first so a failed export leaves nothing behind
+    File const temp (file.getSiblingFile (file.getFileName () + ".tmp"));
+    temp.deleteFile ();
+
+    bool ok;
+
+    {
+        FileOutputStream out (temp);
+
+        if (out.failedToOpen ())
+        {
+            journal.warning << "Unable to create " << temp.getFullPathName ();
+            return false;
+        }
+
+        LedgerSnapshotWriter writer (out, journal);
+        ok = writer.write (rawHeader, stateMap, transactionMap);
+    }
+
+    if (!ok)
+    {
+        journal.warning << "Unable to write " << temp.getFullPathName ();
+        temp.deleteFile ();
+        return false;
+    }
+
+    file.deleteFile ();
+    return temp.moveFileTo (file);
+}
+
+LedgerSnapshot::pointer LedgerSnapshot::open (File const& file, Journal journal)
+{
+    typedef LedgerSnapshotWriter Format;
+
+    pointer snapshot;
+
+    ScopedPointer <MemoryMappedFile> map (
+        new MemoryMappedFile (file, MemoryMappedFile::readOnly));
+
+    unsigned char const* const data = static_cast <unsigned char const*> (map->getData ());
+    uint64 const size = map->getSize ();
+
+    if ((data == nullptr) || (size < Format::preambleBytes) ||
+        (memcmp (data, Format::getMagic (), 8) != 0))
+    {
+        journal.warning << file.getFullPathName () << " is not a ledger snapshot";
+        return snapshot;
+    }
+
+    uint64 const headerBytes = ByteOrder::bigEndianInt (data + 8);
+    uint64 const mapCount = ByteOrder::bigEndianInt (data + 12);
+    uint64 const descriptors = (Format::preambleBytes + headerBytes + 7) & ~uint64 (7);
+
+    bool valid = (mapCount >= 1) && (mapCount <= 2) &&
+        ((descriptors + mapCount * Format::descriptorBytes) <= size);
+
+    snapshot.reset (new LedgerSnapshot (file, map.release ()));
+    snapshot->m_rawHeader.assign (data + Format::preambleBytes,
+        data + Format::preambleBytes + (valid ? headerBytes : 0));
+
+    for (uint64 i = 0; valid && (i < mapCount); ++i)
+    {
+        unsigned char const* const d = data + descriptors + i * Format::descriptorBytes;
+        uint64 const nodeCount = ByteOrder::bigEndianInt64 (d + 8);
+        uint64 const nodesBegin = ByteOrder::bigEndianInt64 (d + 16);
+        uint64 const nodesEnd = ByteOrder::bigEndianInt64 (d + 24);
+        uint64 const index = ByteOrder::bigEndianInt64 (d + 32);
+
+        valid = (nodesBegin <= nodesEnd) && (nodesEnd <= index) && (index <= size) &&
+            (nodeCount <= ((size - index) / Format::entryBytes));
+
+        Section section;
+        section.type = static_cast <SHAMapType> (ByteOrder::bigEndianInt (d));
+        section.rootHash = uint256::fromVoid (d + 40);
+        section.nodeCount = static_cast <std::size_t> (nodeCount);
+        section.index = data + index;
+        section.nodesBegin = data + nodesBegin;
+        section.nodesEnd = data + nodesEnd;
+
+        if (valid)
+            snapshot->m_sections.push_back (section);
+    }
+
+    if (!valid)
+    {
+        journal.warning << file.getFullPathName () << " is damaged";
+        snapshot.reset ();
+    }
+
+    return snapshot;
+}
+
+LedgerSnapshot::LedgerSnapshot (File const& file, MemoryMappedFile* map)
+    : m_file (file)
+    , m_map (map)
+{
+}
+
+LedgerSnapshot::~LedgerSnapshot ()
+{
+}
+
+bool LedgerSnapshot::hasMap (SHAMapType type) const
+{
+    return findSection (type) != nullptr;
+}
+
+uint256 LedgerSnapshot::getRootHash (SHAMapType type) const
+{
+    Section const* const section (findSection (type));
+
+    return (section != nullptr) ? section->rootHash : uint256 ();
+}
+
+std::size_t LedgerSnapshot::getNodeCount (SHAMapType type) const
+{
+    Section const* const section (findSection (type));
+
+    return (section != nullptr) ? section->nodeCount : 0;
+}
+
+bool LedgerSnapshot::findNode (SHAMapType type, uint256 const& hash,
+    unsigned char const*& data, std::size_t& size) const
+{
+    typedef LedgerSnapshotWriter Format;
+
+    Section const* const section (findSection (type));
+
+    if (section == nullptr)
+        return false;
+
+    std::size_t first = 0;
+    std::size_t last = section->nodeCount;
+
+    while (first < last)
+    {
+        std::size_t const middle = first + (last - first) / 2;
+        unsigned char const* const entry = section->index + middle * Format::entryBytes;
+        int const compare = memcmp (entry, hash.begin (), hash.size ());
+
+        if (compare < 0)
+        {
+            first = middle + 1;
+        }
+        else if (compare > 0)
+        {
+            last = middle;
+        }
+        else
+        {
+            return getNode (*section, entry, data, size);
+        }
+    }
+
+    return false;
+}
+
+uint256 LedgerSnapshot::getLedgerHash () const
+{
+    Serializer s (128);
+    s.add32 (HashPrefix::ledgerMaster);
+    s.addRaw (m_rawHeader);
+    return s.getSHA512Half ();
+}
+
+bool LedgerSnapshot::import (NodeStore::Database& database, Journal journal) const
+{
+    LedgerIndex ledgerSeq;
+    uint256 transHash;
+    uint256 accountHash;
+
+    try
+    {
+        // The layout written by Ledger::addRaw
+        Serializer s (m_rawHeader);
+        SerializerIterator sit (s);
+
+        ledgerSeq = sit.get32 ();
+        sit.get64 ();
+        sit.get256 ();
+        transHash = sit.get256 ();
+        accountHash = sit.get256 ();
+    }
+    catch (...)
+    {
+        journal.warning << m_file.getFullPathName () << " has a short ledger header";
+        return false;
+    }
+
+    return importMap (database, smtTRANSACTION, transHash, ledgerSeq, journal) &&
+           importMap (database, smtSTATE, accountHash, ledgerSeq, journal);
+}
+
+bool LedgerSnapshot::getNode (Section const& section, unsigned char const* entry,
+    unsigned char const*& data, std::size_t& size) const
+{
+    unsigned char const* const base = static_cast <unsigned char const*> (m_map->getData ());
+    unsigned char const* const node = base + ByteOrder::bigEndianInt64 (entry + 32);
+
+    if ((node < section.nodesBegin + 4) || (node > section.nodesEnd))
+        return false;
+
+    size = ByteOrder::bigEndianInt (node - 4);
+
+    if (size > static_cast <std::size_t> (section.nodesEnd - node))
+        return false;
+
+    data = node;
+    return true;
+}
+
+bool LedgerSnapshot::importMap (NodeStore::Database& database, SHAMapType type,
+    uint256 const& rootHash, LedgerIndex ledgerSeq, Journal journal) const
+{
+    typedef LedgerSnapshotWriter Format;
+
+    char const* const name = (type == smtSTATE) ? "state" : "transaction";
+
+    // A ledger without transactions has an empty transaction map
+    if (rootHash.isZero ())
+        return true;
+
+    Section const* const section (findSection (type));
+
+    if (section == nullptr)
+    {
+        journal.warning << "Snapshot has no " << name << " map";
+        return false;
+    }
+
+    if (section->rootHash != rootHash)
+    {
+        journal.warning << "Snapshot " << name << " map does not match the ledger header";
+        return false;
+    }
+
+    unsigned char const* data;
+    std::size_t size;
+
+    if (!findNode (type, rootHash, data, size))
+    {
+        journal.warning << "Snapshot " << name << " map has no root";
+        return false;
+    }
+
+    NodeObjectType const objectType = (type == smtSTATE) ? hotACCOUNT_NODE : hotTRANSACTION_NODE;
+
+    NodeStore::Batch batch;
+    batch.reserve (NodeStore::batchWritePreallocationSize);
+
+    for (std::size_t i = 0; i < section->nodeCount; ++i)
+    {
+        unsigned char const* const entry = section->index + i * Format::entryBytes;
+        uint256 const hash (uint256::fromVoid (entry));
+
+        // Binary searches rely on the order of the index
+        if ((i > 0) && (memcmp (entry - Format::entryBytes, entry, hash.size ()) >= 0))
+        {
+            journal.warning << "Snapshot " << name << " index is out of order";
+            return false;
+        }
+
+        if (!getNode (*section, entry, data, size) ||
+            (Serializer::getSHA512Half (data, static_cast <int> (size)) != hash))
+        {
+            journal.warning << "Snapshot " << name << " node " << hash << " is corrupt";
+            return false;
+        }
+
+        // An inner node in prefix format is the prefix and sixteen child hashes
+        if ((size == (4 + 16 * 32)) && (ByteOrder::bigEndianInt (data) == HashPrefix::innerNode))
+        {
+            for (int branch = 0; branch < 16; ++branch)
+            {
+                uint256 const child (uint256::fromVoid (data + 4 + branch * 32));
+                unsigned char const* childData;
+                std::size_t childSize;
+
+                if (child.isNonZero () && !findNode (type, child, childData, childSize))
+                {
+                    journal.warning << "Snapshot " << name << " map is missing node " << child;
+                    return false;
+                }
+            }
+        }
+
+        Blob blob (data, data + size);
+        batch.push_back (NodeObject::createObject (objectType, ledgerSeq, blob, hash));
+
+        if (batch.size () >= NodeStore::batchWritePreallocationSize)
+        {
+            database.storeBatch (batch);
+            batch.clear ();
+        }
+    }
+
+    if (!batch.empty ())
+        database.storeBatch (batch);
+
+    journal.info << "Imported " << section->nodeCount << " nodes of the " << name << " map";
+
+    return true;
+}
+
+LedgerSnapshot::Section const* LedgerSnapshot::findSection (SHAMapType type) const
+{
+    for (std::vector <Section>::const_iterator it = m_sections.begin (); it != m_sections.end (); ++it)
+        if (it->type == type)
+            return &*it;
+
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+class LedgerSnapshotTests : public UnitTest
+{
+public:
+    LedgerSnapshotTests () : UnitTest ("LedgerSnapshot", "ripple")
+    {
+    }
+
+    static void addRandomItems (int count, SHAMap& map, bool isTransaction, Random& r)
+    {
+        while (count--)
+        {
+            Serializer s;
+            for (int i = 0; i < 8; ++i)
+                s.add32 (r.nextInt ());
+
+            SHAMapItem const item (s.getSHA512Half (), s.peekData ());
+            map.addItem (item, isTransaction, false);
+        }
+    }
+
+    void testMount (SHAMap& original, LedgerSnapshot::ref snapshot, SHAMapType type)
+    {
+        SHAMap mounted (type, snapshot);
+
+        expect (mounted.fetchRoot (original.getHash (), nullptr), "Missing root");
+        expect (mounted.getHash () == original.getHash ());
+        expect (mounted.deepCompare (original), "Mounted map differs");
+
+        for (SHAMapItem::pointer item = original.peekFirstItem (); item;
+            item = original.peekNextItem (item->getTag ()))
+        {
+            SHAMapItem::pointer const found (mounted.peekItem (item->getTag ()));
+
+            if (!expect (found && (found->peekData () == item->peekData ()), "Missing item"))
+                break;
+        }
+    }
+
+    void runTest ()
+    {
+        Random r (42);
+
+        SHAMap state (smtSTATE);
+        SHAMap transactions (smtTRANSACTION);
+        addRandomItems (2000, state, false, r);
+        addRandomItems (100, transactions, true, r);
+        state.setImmutable ();
+        transactions.setImmutable ();
+
+        Blob rawHeader (118);
+        r.fillBitsRandomly (&rawHeader.front (), rawHeader.size ());
+
+        File const file (File::createTempFile ("ledger_snapshot"));
+
+        beginTestCase ("ledger");
+        {
+            expect (LedgerSnapshot::write (file, rawHeader, state, &transactions, journal ()));
+
+            LedgerSnapshot::pointer const snapshot (LedgerSnapshot::open (file, journal ()));
+
+            if (expect (snapshot != nullptr, "Unable to open"))
+            {
+                expect (snapshot->getRawHeader () == rawHeader);
+                expect (snapshot->getRootHash (smtSTATE) == state.getHash ());
+                expect (snapshot->getRootHash (smtTRANSACTION) == transactions.getHash ());
+                expect (snapshot->getNodeCount (smtSTATE) > 2000);
+
+                testMount (state, snapshot, smtSTATE);
+                testMount (transactions, snapshot, smtTRANSACTION);
+
+                unsigned char const* data;
+                std::size_t size;
+                expect (!snapshot->findNode (smtSTATE, transactions.getHash (), data, size),
+                    "Found a node of another map");
+            }
+        }
+
+        beginTestCase ("state only");
+        {
+            expect (LedgerSnapshot::write (file, rawHeader, state, nullptr, journal ()));
+
+            LedgerSnapshot::pointer const snapshot (LedgerSnapshot::open (file, journal ()));
+
+            if (expect (snapshot != nullptr, "Unable to open"))
+            {
+                expect (!snapshot->hasMap (smtTRANSACTION));
+                testMount (state, snapshot, smtSTATE);
+            }
+        }
+
+        beginTestCase ("import");
+        {
+            NodeStore::DummyScheduler scheduler;
+            StringPairArray params;
+            params.set ("type", "memory");
+            params.set ("path", "ledger_snapshot");
+            ScopedPointer <NodeStore::Database> db (NodeStore::Database::New (
+                "test", scheduler, params));
+
+            // Nothing is stored from a snapshot which does not match its header
+            expect (LedgerSnapshot::write (file, rawHeader, state, &transactions, journal ()));
+            expect (!LedgerSnapshot::open (file, journal ())->import (*db, journal ()),
+                "Imported maps which do not match the header");
+
+            Serializer header;
+            header.add32 (3);
+            header.add64 (100000000000000000ull);
+            header.add256 (uint256 ());
+            header.add256 (transactions.getHash ());
+            header.add256 (state.getHash ());
+            header.add32 (0);
+            header.add32 (0);
+            header.add8 (30);
+            header.add8 (0);
+
+            expect (LedgerSnapshot::write (file, header.peekData (), state, &transactions, journal ()));
+            expect (LedgerSnapshot::open (file, journal ())->import (*db, journal ()), "Import failed");
+
+            int missing = 0;
+            std::list <SHAMap::fetchPackEntry_t> nodes (state.getFetchPack (nullptr, true, 1000000));
+            std::list <SHAMap::fetchPackEntry_t> const txNodes (transactions.getFetchPack (nullptr, true, 1000000));
+            nodes.insert (nodes.end (), txNodes.begin (), txNodes.end ());
+
+            for (std::list <SHAMap::fetchPackEntry_t>::const_iterator it = nodes.begin (); it != nodes.end (); ++it)
+            {
+                NodeObject::pointer const object (db->fetch (it->first));
+
+                if (!object || (object->getData () != it->second))
+                    ++missing;
+            }
+
+            expect (missing == 0, "Imported nodes are missing");
+        }
+
+        beginTestCase ("damaged");
+        {
+            MemoryBlock contents;
+            file.loadFileAsData (contents);
+            file.replaceWithData (contents.getData (), 100);
+
+            expect (LedgerSnapshot::open (file, journal ()) == nullptr, "Opened a truncated file");
+
+            file.replaceWithText ("Not a ledger snapshot");
+
+            expect (LedgerSnapshot::open (file, journal ()) == nullptr, "Opened a text file");
+        }
+
+        file.deleteFile ();
+    }
+};
+
+static LedgerSnapshotTests ledgerSnapshotTests;
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGERSNAPSHOT_H_INCLUDED
+#define RIPPLE_LEDGERSNAPSHOT_H_INCLUDED
+
+class SHAMap;
+
+/** A ledger written to a single file which is memory-mapped for reading.
+
+    The file holds the ledger's header, the nodes of its state map and,
+    optionally, the nodes of its transaction map. Each map's nodes are laid
+    out in tree order and followed by an index sorted by node hash. A SHAMap
+    attached to a mounted snapshot reads its nodes from the mapping instead
+    of from the NodeStore, and leaves the tree node cache alone.
+
+    Integers in the file are big-endian so a snapshot can be copied to
+    another machine and mounted there.
+*/
+class LedgerSnapshot : public LeakChecked <LedgerSnapshot>
+{
+public:
+    typedef boost::shared_ptr <LedgerSnapshot> pointer;
+    typedef pointer const& ref;
+
+    /** Write a ledger to a snapshot file.
+        @param rawHeader The ledger header, as produced by Ledger::addRaw.
+        @param transactionMap The transactions, or nullptr to write only the
+                              state. Such a snapshot cannot be imported.
+        @return `true` if every node of the maps was written.
+    */
+    static bool write (File const& file, Blob const& rawHeader,
+        SHAMap& stateMap, SHAMap* transactionMap, Journal journal);
+
+    /** Mount a snapshot file.
+        @return The snapshot, or an empty pointer if the file is not one.
+    */
+    static pointer open (File const& file, Journal journal);
+
+    ~LedgerSnapshot ();
+
+    File const& getFile () const
+    {
+        return m_file;
+    }
+
+    /** Returns the ledger header, in the form Ledger::setRaw expects. */
+    Blob const& getRawHeader () const
+    {
+        return m_rawHeader;
+    }
+
+    /** Returns the hash of the ledger described by the header. */
+    uint256 getLedgerHash () const;
+
+    /** Returns `true` if the snapshot holds the nodes of this map. */
+    bool hasMap (SHAMapType type) const;
+
+    /** Returns the root hash of a map, or zero if the snapshot lacks it. */
+    uint256 getRootHash (SHAMapType type) const;
+
+    /** Returns the number of nodes stored for a map. */
+    std::size_t getNodeCount (SHAMapType type) const;
+
+    /** Find a node of a map by its hash.
+        The node is in prefix format. The data points into the mapping
+        and remains valid for as long as the snapshot does.
+        @return `true` if the node was found.
+    */
+    bool findNode (SHAMapType type, uint256 const& hash,
+        unsigned char const*& data, std::size_t& size) const;
+
+    /** Copy the nodes of both maps into a node store.
+        Nodes are read in order of hash and stored in batches straight to
+        the persistent backend. The roots must match the hashes in the
+        ledger header, each node is checked against its hash and each child
+        of an inner node must be present. A failure part way through leaves
+        the nodes stored so far in place.
+        @return `true` if the whole ledger was verified and stored.
+    */
+    bool import (NodeStore::Database& database, Journal journal) const;
+
+private:
+    struct Section
+    {
+        SHAMapType type;
+        uint256 rootHash;
+        std::size_t nodeCount;
+        unsigned char const* index;
+        unsigned char const* nodesBegin;
+        unsigned char const* nodesEnd;
+    };
+
+    LedgerSnapshot (File const& file, MemoryMappedFile* map);
+
+    Section const* findSection (SHAMapType type) const;
+
+    bool getNode (Section const& section, unsigned char const* entry,
+        unsigned char const*& data, std::size_t& size) const;
+
+    bool importMap (NodeStore::Database& database, SHAMapType type,
+        uint256 const& rootHash, LedgerIndex ledgerSeq, Journal journal) const;
+
+    File m_file;
+    ScopedPointer <MemoryMappedFile> m_map;
+    Blob m_rawHeader;
+    std::vector <Section> m_sections;
+};
+
+#endif
@@ -0,0 +1,401 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+class LedgerVerifierImp
+    : public LedgerVerifier
+    , public LeakChecked <LedgerVerifierImp>
+{
+public:
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    enum
+    {
+        // Subtrees are rooted at this depth
+        partitionDepth = 2,
+        partitionsPerTree = 256,
+
+        // The account state tree, then the transaction tree
+        partitionCount = 2 * partitionsPerTree,
+
+        // Stop logging individual problems after this many
+        maxReported = 32
+    };
+
+    typedef std::bitset <partitionCount> Partitions;
+
+    struct Metrics
+    {
+        insight::Meter nodes;
+        insight::Gauge nodes_per_second;
+    };
+
+    struct Counts
+    {
+        Counts ()
+            : nodes (0)
+            , missing (0)
+            , invalid (0)
+        {
+        }
+
+        void add (Counts const& other)
+        {
+            nodes += other.nodes;
+            missing += other.missing;
+            invalid += other.invalid;
+        }
+
+        uint64 nodes;
+        uint64 missing;
+        uint64 invalid;
+    };
+
+    struct Task
+    {
+        Task (int partition_, SHAMapNode const& id_, uint256 const& hash_)
+            : partition (partition_)
+            , id (id_)
+            , hash (hash_)
+        {
+        }
+
+        int partition;
+        SHAMapNode id;
+        uint256 hash;
+    };
+
+    //--------------------------------------------------------------------------
+
+    class Worker : public Thread
+    {
+    public:
+        explicit Worker (LedgerVerifierImp& owner)
+            : Thread ("LedgerVerifier")
+            , m_owner (owner)
+        {
+        }
+
+        ~Worker ()
+        {
+            stopThread ();
+        }
+
+        void run ()
+        {
+            m_owner.runWorker ();
+        }
+
+    private:
+        LedgerVerifierImp& m_owner;
+    };
+
+    //--------------------------------------------------------------------------
+
+    LedgerVerifierImp (NodeStore::Database& nodeStore,
+        shared_ptr <insight::Collector> const& collector, Journal journal)
+        : m_nodeStore (nodeStore)
+        , m_journal (journal)
+        , m_lock (this, "LedgerVerifier", __FILE__, __LINE__)
+        , m_nextTask (0)
+        , m_reported (0)
+    {
+        m_metrics.nodes = collector->make_meter ("ledger_verify_nodes");
+        m_metrics.nodes_per_second = collector->make_gauge ("ledger_verify_nodes_per_second");
+    }
+
+    void stop ()
+    {
+        m_stop.set (1);
+    }
+
+    void verify (Ledger& ledger, int threads, File const& checkpoint, Result& result)
+    {
+        double const start = Time::getMillisecondCounterHiRes ();
+
+        result = Result ();
+        m_totals = Counts ();
+        m_tasks.clear ();
+        m_nextTask = 0;
+        m_reported = 0;
+        m_ledgerHash = ledger.getHash ();
+        m_checkpoint = checkpoint;
+        m_done.reset ();
+
+        loadCheckpoint ();
+
+        // The top of each tree is checked here to find the subtrees
+        Counts top;
+        addTree (0, ledger.getAccountHash (), top);
+        addTree (partitionsPerTree, ledger.getTransHash (), top);
+        m_totals.add (top);
+
+        if (threads <= 0)
+            threads = SystemStats::getNumCpus ();
+        threads = std::max (1, std::min <int> (threads, m_tasks.size ()));
+
+        m_journal.info << "Verifying ledger " << m_ledgerHash << ", " <<
+            m_tasks.size () << " subtrees on " << threads << " threads";
+
+        {
+            OwnedArray <Worker> workers;
+
+            for (int i = 0; i < threads; ++i)
+            {
+                workers.add (new Worker (*this));
+                workers [i]->startThread ();
+            }
+
+            for (int i = 0; i < threads; ++i)
+                workers [i]->waitForThreadToExit (-1);
+        }
+
+        result.nodes = m_totals.nodes;
+        result.missing = m_totals.missing;
+        result.invalid = m_totals.invalid;
+        result.stopped = m_stop.get () != 0;
+        result.seconds = (Time::getMillisecondCounterHiRes () - start) / 1000.0;
+
+        uint64 const rate = (result.seconds > 0)
+            ? static_cast <uint64> (result.nodes / result.seconds) : result.nodes;
+        m_metrics.nodes_per_second = rate;
+
+        m_journal.info << "Verified " << result.nodes << " nodes in " <<
+            result.seconds << "s (" << rate << " nodes/sec), " <<
+            result.missing << " missing, " << result.invalid << " invalid" <<
+            (result.stopped ? ", interrupted" : "");
+
+        if (result.passed () && (m_checkpoint != File::nonexistent ()))
+            m_checkpoint.deleteFile ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Checks the nodes above partitionDepth and queues the subtrees below
+    void addTree (int firstPartition, uint256 const& rootHash, Counts& counts)
+    {
+        if (rootHash.isZero ())
+            return;
+
+        std::vector <std::pair <SHAMapNode, uint256> > level;
+        level.push_back (std::make_pair (SHAMapNode (), rootHash));
+
+        for (int depth = 0; depth < partitionDepth; ++depth)
+        {
+            std::vector <std::pair <SHAMapNode, uint256> > next;
+
+            for (std::size_t i = 0; i < level.size (); ++i)
+            {
+                SHAMapTreeNode::pointer const node (
+                    fetchNode (level [i].first, level [i].second, counts));
+
+                if (node && node->isInner ())
+                {
+                    for (int branch = 0; branch < 16; ++branch)
+                    {
+                        if (!node->isEmptyBranch (branch))
+                            next.push_back (std::make_pair (
+                                node->getChildNodeID (branch), node->getChildHash (branch)));
+                    }
+                }
+            }
+
+            level.swap (next);
+        }
+
+        for (std::size_t i = 0; i < level.size (); ++i)
+        {
+            int const partition = firstPartition + partitionOf (level [i].first);
+
+            if (!m_done.test (partition))
+                m_tasks.push_back (Task (partition, level [i].first, level [i].second));
+        }
+    }
+
+    // The position of a depth two node among the 256 possible ones
+    static int partitionOf (SHAMapNode const& id)
+    {
+        return *id.getNodeID ().begin ();
+    }
+
+    SHAMapTreeNode::pointer fetchNode (SHAMapNode const& id,
+        uint256 const& hash, Counts& counts)
+    {
+        SHAMapTreeNode::pointer node;
+
+        NodeObject::pointer const object (m_nodeStore.fetch (hash));
+
+        if (!object)
+        {
+            ++counts.missing;
+            report ("Missing node ", id, hash);
+            return node;
+        }
+
+        try
+        {
+            // Passing hashValid=false makes the node compute its own hash
+            node = boost::make_shared <SHAMapTreeNode> (
+                id, object->getData (), 0, snfPREFIX, hash, false);
+        }
+        catch (...)
+        {
+        }
+
+        if (!node || (node->getNodeHash () != hash))
+        {
+            ++counts.invalid;
+            report ("Invalid node ", id, hash);
+            return SHAMapTreeNode::pointer ();
+        }
+
+        ++counts.nodes;
+        m_metrics.nodes.increment (1);
+
+        return node;
+    }
+
+    void report (char const* what, SHAMapNode const& id, uint256 const& hash)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        if (++m_reported <= maxReported)
+            m_journal.warning << what << id << " " << hash;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool getTask (Task& task)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        if (m_nextTask >= m_tasks.size ())
+            return false;
+
+        task = m_tasks [m_nextTask++];
+        return true;
+    }
+
+    void runWorker ()
+    {
+        Task task (0, SHAMapNode (), uint256 ());
+
+        while ((m_stop.get () == 0) && getTask (task))
+        {
+            Counts counts;
+            std::stack <std::pair <SHAMapNode, uint256> > stack;
+            stack.push (std::make_pair (task.id, task.hash));
+
+            while (!stack.empty () && (m_stop.get () == 0))
+            {
+                std::pair <SHAMapNode, uint256> const item (stack.top ());
+                stack.pop ();
+
+                SHAMapTreeNode::pointer const node (fetchNode (item.first, item.second, counts));
+
+                if (node && node->isInner ())
+                {
+                    for (int branch = 0; branch < 16; ++branch)
+                    {
+                        if (!node->isEmptyBranch (branch))
+                            stack.push (std::make_pair (
+                                node->getChildNodeID (branch), node->getChildHash (branch)));
+                    }
+                }
+            }
+
+            bool const finished = stack.empty () &&
+                (counts.missing == 0) && (counts.invalid == 0);
+
+            ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+            m_totals.add (counts);
+
+            if (finished)
+            {
+                m_done.set (task.partition);
+                saveCheckpoint ();
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    // The checkpoint holds the ledger hash and one character per subtree
+    void loadCheckpoint ()
+    {
+        if ((m_checkpoint == File::nonexistent ()) || !m_checkpoint.existsAsFile ())
+            return;
+
+        std::string const text (m_checkpoint.loadFileAsString ().toStdString ());
+        std::string::size_type const space = text.find (' ');
+
+        if ((space == std::string::npos) ||
+            (text.substr (0, space) != m_ledgerHash.GetHex ()) ||
+            (text.size () < (space + 1 + partitionCount)))
+        {
+            m_journal.info << "Ignoring checkpoint for another ledger";
+            return;
+        }
+
+        std::string const bits (text.substr (space + 1, partitionCount));
+
+        if (bits.find_first_not_of ("01") != std::string::npos)
+        {
+            m_journal.warning << "Ignoring checkpoint, it is damaged";
+            return;
+        }
+
+        m_done = Partitions (bits);
+
+        m_journal.info << "Resuming, " << m_done.count () << " subtrees already verified";
+    }
+
+    void saveCheckpoint ()
+    {
+        if (m_checkpoint == File::nonexistent ())
+            return;
+
+        std::string const text (m_ledgerHash.GetHex () + " " + m_done.to_string ());
+        m_checkpoint.replaceWithText (text);
+    }
+
+private:
+    NodeStore::Database& m_nodeStore;
+    Journal m_journal;
+    Metrics m_metrics;
+    Atomic <int> m_stop;
+
+    LockType m_lock;
+    uint256 m_ledgerHash;
+    File m_checkpoint;
+    Partitions m_done;
+    std::vector <Task> m_tasks;
+    std::size_t m_nextTask;
+    Counts m_totals;
+    int m_reported;
+};
+
+//------------------------------------------------------------------------------
+
+LedgerVerifier* LedgerVerifier::New (NodeStore::Database& nodeStore,
+    shared_ptr <insight::Collector> const& collector, Journal journal)
+{
+    return new LedgerVerifierImp (nodeStore, collector, journal);
+}
@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGERVERIFIER_H_INCLUDED
+#define RIPPLE_LEDGERVERIFIER_H_INCLUDED
+
+/** Checks a ledger's trees against the node store using several threads.
+
+    Every node of the account state and transaction trees is fetched from
+    the node store, rehashed, and compared with the hash its parent holds.
+    Unlike Ledger::walkLedger the fetched nodes are not added to the maps,
+    so checking a large ledger does not pull it into memory.
+
+    Each tree is split into 256 subtrees at depth two and the subtrees are
+    handed out to the worker threads. Finished subtrees can be recorded in
+    a checkpoint file so that an interrupted check of the same ledger only
+    repeats the unfinished ones.
+*/
+class LedgerVerifier
+{
+public:
+    struct Result
+    {
+        Result ()
+            : nodes (0)
+            , missing (0)
+            , invalid (0)
+            , stopped (false)
+            , seconds (0)
+        {
+        }
+
+        /** Returns true if the whole ledger was checked and found intact. */
+        bool passed () const
+        {
+            return !stopped && (missing == 0) && (invalid == 0);
+        }
+
+        uint64 nodes;       // Nodes fetched and verified
+        uint64 missing;     // Nodes not in the node store
+        uint64 invalid;     // Nodes that failed to parse or hash correctly
+        bool stopped;       // The check was interrupted by stop()
+        double seconds;
+    };
+
+    /** Create a verifier.
+        The caller receives ownership and must delete the object when done.
+    */
+    static LedgerVerifier* New (NodeStore::Database& nodeStore,
+        shared_ptr <insight::Collector> const& collector, Journal journal);
+
+    virtual ~LedgerVerifier () { }
+
+    /** Check a ledger, blocking until done.
+
+        @param threads The number of worker threads, or 0 for one per CPU.
+        @param checkpoint A file to record progress in, or File::nonexistent ()
+                          to check from the beginning without recording.
+    */
+    virtual void verify (Ledger& ledger, int threads, File const& checkpoint,
+        Result& result) = 0;
+
+    /** Interrupt a check in progress.
+        Any later call to verify() returns immediately as stopped.
+        Thread safety:
+            Safe to call from any thread.
+    */
+    virtual void stop () = 0;
+};
+
+#endif
@@ -245,7 +245,8 @@ BookListeners::pointer OrderBookDB::getBookListeners (const uint160& currencyPay
 
 // Based on the meta, send the meta to the streams that are listening
 // We need to determine which streams a given meta effects
-void OrderBookDB::processTxn (Ledger::ref ledger, const AcceptedLedgerTx& alTx, Json::Value& jvObj)
+void OrderBookDB::processTxn (Ledger::ref ledger, const AcceptedLedgerTx& alTx,
+    FUNCTION_TYPE <EventPayload::pointer (InfoSub::ref)> getPayload)
 {
     ScopedLockType sl (mLock, __FILE__, __LINE__);
 
@@ -293,7 +294,7 @@ void OrderBookDB::processTxn (Ledger::ref ledger, const AcceptedLedgerTx& alTx,
                                 getBookListeners (currencyPays, currencyGets, issuerPays, issuerGets);
 
                             if (book)
-                                book->publish (jvObj);
+                                book->publish (getPayload);
                         }
                     }
                 }
@@ -325,11 +326,8 @@ void BookListeners::removeSubscriber (uint64 seq)
     mListeners.erase (seq);
 }
 
-void BookListeners::publish (Json::Value& jvObj)
+void BookListeners::publish (FUNCTION_TYPE <EventPayload::pointer (InfoSub::ref)> const& getPayload)
 {
-    Json::FastWriter jfwWriter;
-    std::string sObj = jfwWriter.write (jvObj);
-
     ScopedLockType sl (mLock, __FILE__, __LINE__);
     NetworkOPs::SubMapType::const_iterator it = mListeners.begin ();
 
@@ -339,7 +337,7 @@ void BookListeners::publish (Json::Value& jvObj)
 
         if (p)
         {
-            p->send (jvObj, sObj, true);
+            p->send (getPayload (p), true);
             ++it;
         }
         else
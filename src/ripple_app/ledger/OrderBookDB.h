@@ -78,7 +78,7 @@ public:
     BookListeners ();
     void addSubscriber (InfoSub::ref sub);
     void removeSubscriber (uint64 sub);
-    void publish (Json::Value& jvObj);
+    void publish (FUNCTION_TYPE <EventPayload::pointer (InfoSub::ref)> const& getPayload);
 
 private:
     typedef RippleRecursiveMutex LockType;
@@ -122,7 +122,10 @@ public:
             const uint160& issuerPays, const uint160& issuerGets);
 
     // see if this txn effects any orderbook
-    void processTxn (Ledger::ref ledger, const AcceptedLedgerTx& alTx, Json::Value& jvObj);
+    // getPayload picks the form each listener wants, so a form is only
+    // rendered if some listener of an affected book wants it
+    void processTxn (Ledger::ref ledger, const AcceptedLedgerTx& alTx,
+        FUNCTION_TYPE <EventPayload::pointer (InfoSub::ref)> getPayload);
 
 private:
     boost::unordered_map< currencyIssuer_t, std::vector<OrderBook::pointer> > mSourceMap;   // by ci/ii
@@ -45,6 +45,12 @@ class LoadManagerLog;
 template <> char const* LogPartition::getPartitionName <LoadManagerLog> () { return "LoadManager"; }
 class ResourceManagerLog;
 template <> char const* LogPartition::getPartitionName <ResourceManagerLog> () { return "ResourceManager"; }
+class AccountHistoryLog;
+template <> char const* LogPartition::getPartitionName <AccountHistoryLog> () { return "AccountHistory"; }
+class CacheWarmupLog;
+template <> char const* LogPartition::getPartitionName <CacheWarmupLog> () { return "CacheWarmup"; }
+class SSLHandshakerLog;
+template <> char const* LogPartition::getPartitionName <SSLHandshakerLog> () { return "SSLHandshaker"; }
 
 template <> char const* LogPartition::getPartitionName <CollectorManager> () { return "Collector"; }
 
@@ -73,6 +79,7 @@ public:
     ApplicationImp ()
         : RootStoppable ("Application")
         , m_journal (LogPartition::getJournal <ApplicationLog> ())
+        , m_masterMutex (this, "MasterLock", __FILE__, __LINE__)
         , m_tempNodeCache ("NodeCache", 16384, 90)
         , m_sleCache ("LedgerEntryCache", 4096, 120)
 
@@ -96,7 +103,14 @@ public:
         // The io_service must be a child of the JobQueue since we call addJob
         // in response to newtwork data from peers and also client requests.
         //
-        , m_mainIoPool (*m_jobQueue, "io", (getConfig ().NODE_SIZE >= 2) ? 2 : 1)
+        , m_mainIoPool (*m_jobQueue, "io",
+            (getConfig ().IO_REACTORS > 0) ? getConfig ().IO_REACTORS
+                : ((getConfig ().NODE_SIZE >= 2) ? 2 : 1),
+            getConfig ().IO_REACTORS > 0, m_collectorManager->collector ())
+
+        , m_sslHandshaker (SSLHandshaker::New (m_mainIoPool,
+            getConfig ().PEER_HANDSHAKE_THREADS, m_collectorManager->collector (),
+                LogPartition::getJournal <SSLHandshakerLog> ()))
 
         //
         // Anything which calls addJob must be a descendant of the JobQueue
@@ -111,8 +125,8 @@ public:
             *m_jobQueue, LogPartition::getJournal <LedgerMaster> ()))
 
         // VFALCO NOTE Does NetworkOPs depend on LedgerMaster?
-        , m_networkOPs (NetworkOPs::New (
-            *m_ledgerMaster, *m_jobQueue, LogPartition::getJournal <NetworkOPsLog> ()))
+        , m_networkOPs (NetworkOPs::New (*m_ledgerMaster, *m_jobQueue,
+            m_collectorManager->collector (), LogPartition::getJournal <NetworkOPsLog> ()))
 
         // VFALCO NOTE LocalCredentials starts the deprecated UNL service
         , m_deprecatedUNL (UniqueNodeList::New (*m_jobQueue))
@@ -124,14 +138,15 @@ public:
         , m_rpcServerHandler (*m_networkOPs, *m_resourceManager) // passive object, not a Service
 #endif
 
-        , m_nodeStoreScheduler (*m_jobQueue, *m_jobQueue)
+        , m_nodeStoreScheduler (*m_jobQueue, *m_jobQueue,
+            m_collectorManager->collector ())
 
         , m_nodeStore (NodeStore::Database::New ("NodeStore.main", m_nodeStoreScheduler,
             getConfig ().nodeDatabase, getConfig ().ephemeralNodeDatabase))
 
         , m_sntpClient (SNTPClient::New (*this))
 
-        , m_inboundLedgers (*m_jobQueue)
+        , m_inboundLedgers (*m_jobQueue, m_collectorManager->collector ())
 
         , m_txQueue (TxQueue::New ())
 
@@ -146,6 +161,16 @@ public:
 
         , mHashRouter (IHashRouter::New (IHashRouter::getDefaultHoldTime ()))
 
+        , m_publicKeyCache (PublicKeyCache::New (4096,
+            m_collectorManager->collector ()))
+
+        , m_signatureVerifier (SignatureVerifier::New (
+            std::max (1, std::min (4, SystemStats::getNumCpus () / 2)), 16384,
+                *m_publicKeyCache, m_collectorManager->collector ()))
+
+        , m_speculativeEngine (SpeculativeEngine::New (
+            getConfig ().TX_APPLY_THREADS, m_collectorManager->collector ()))
+
         , mValidations (Validations::New ())
 
         , mProofOfWorkFactory (ProofOfWorkFactory::New ())
@@ -155,12 +180,24 @@ public:
         , m_sweepTimer (this)
 
         , mShutdown (false)
+
+        , m_ledgerHeaderIndex (LedgerHeaderIndex::New (LogPartition::getJournal <Ledger> ()))
     {
         bassert (s_instance == nullptr);
         s_instance = this;
 
         add (m_ledgerMaster->getPropertySource ());
 
+        shared_ptr <insight::Collector> const& collector (
+            m_collectorManager->collector ());
+        m_cacheMetrics.hook = collector->make_hook (beast::bind (
+            &ApplicationImp::collectCacheMetrics, this));
+        m_cacheMetrics.sle_hit_percent = collector->make_gauge ("cache_sle_hit_percent");
+        m_cacheMetrics.node_hit_percent = collector->make_gauge ("cache_node_hit_percent");
+        m_cacheMetrics.ledger_hit_percent = collector->make_gauge ("cache_ledger_hit_percent");
+        m_cacheMetrics.accepted_ledger_hit_percent = collector->make_gauge (
+            "cache_accepted_ledger_hit_percent");
+
         // VFALCO TODO remove these once the call is thread safe.
         HashMaps::getInstance ().initializeNonce <size_t> ();
     }
@@ -171,6 +208,19 @@ public:
         s_instance = nullptr;
     }
 
+    // Called by the collector to poll the cache hit rates
+    void collectCacheMetrics ()
+    {
+        m_cacheMetrics.sle_hit_percent = static_cast <insight::Gauge::value_type> (
+            m_sleCache.getHitRate ());
+        m_cacheMetrics.node_hit_percent = static_cast <insight::Gauge::value_type> (
+            m_nodeStore->getCacheHitRate ());
+        m_cacheMetrics.ledger_hit_percent = static_cast <insight::Gauge::value_type> (
+            m_ledgerMaster->getCacheHitRate ());
+        m_cacheMetrics.accepted_ledger_hit_percent = static_cast <insight::Gauge::value_type> (
+            AcceptedLedger::getCacheHitRate ());
+    }
+
     //--------------------------------------------------------------------------
     
     CollectorManager& getCollectorManager ()
@@ -288,6 +338,21 @@ public:
         return *mHashRouter;
     }
 
+    PublicKeyCache& getPublicKeyCache ()
+    {
+        return *m_publicKeyCache;
+    }
+
+    SignatureVerifier& getSignatureVerifier ()
+    {
+        return *m_signatureVerifier;
+    }
+
+    SpeculativeEngine& getSpeculativeEngine ()
+    {
+        return *m_speculativeEngine;
+    }
+
     Validations& getValidations ()
     {
         return *mValidations;
@@ -335,6 +400,16 @@ public:
         return mWalletDB;
     }
 
+    AccountHistory* getAccountHistory ()
+    {
+        return m_accountHistory;
+    }
+
+    LedgerHeaderIndex& getLedgerHeaderIndex ()
+    {
+        return *m_ledgerHeaderIndex;
+    }
+
     bool isShutdown ()
     {
         return mShutdown;
@@ -432,6 +507,23 @@ public:
         if (!getConfig ().RUN_STANDALONE)
             updateTables ();
 
+        m_ledgerHeaderIndex->load (*mLedgerDB,
+            getConfig ().getDatabaseDir ().getChildFile ("ledger_headers.idx"));
+
+        if (!getConfig ().LEDGER_SNAPSHOTS.empty ())
+            m_ledgerMaster->mountSnapshots (File::getCurrentWorkingDirectory ().getChildFile (
+                getConfig ().LEDGER_SNAPSHOTS));
+
+        if (getConfig ().accountHistoryDatabase.size () > 0)
+        {
+            m_accountHistory = AccountHistory::New (getConfig ().accountHistoryDatabase,
+                LogPartition::getJournal <AccountHistoryLog> ());
+
+            // Ledgers already in the transaction database are copied over in
+            // the background. Until they are, account_tx falls back to SQL.
+            m_accountHistory->backfill (*m_jobQueue, *mTxnDB, *mLedgerDB);
+        }
+
         mFeatures->addInitialFeatures ();
         Pathfinder::initPathTable ();
 
@@ -454,6 +546,16 @@ public:
                 exit (-1);
             }
         }
+        else if (getConfig ().START_UP == Config::SNAPSHOT)
+        {
+            m_journal.info << "Importing ledger snapshot";
+
+            if (!loadSnapshot (getConfig ().START_SNAPSHOT, getConfig ().START_LEDGER))
+            {
+                getApp().signalStop ();
+                exit (-1);
+            }
+        }
         else if (getConfig ().START_UP == Config::NETWORK)
         {
             // This should probably become the default once we have a stable network
@@ -487,6 +589,15 @@ public:
         m_sleCache.setTargetAge (getConfig ().getSize (siSLECacheAge));
         SHAMap::setTreeCache (getConfig ().getSize (siTreeCacheSize), getConfig ().getSize (siTreeCacheAge));
 
+        // Refill the node caches with what was hot before the last shutdown.
+        // This finishes before the overlay starts, so the server never
+        // reports itself full while still running on cold caches.
+        {
+            ScopedPointer <CacheWarmup> warmup (CacheWarmup::New (*m_nodeStore,
+                LogPartition::getJournal <CacheWarmupLog> ()));
+            warmup->load (getCacheWarmupFile (), 0);
+        }
+
 
         //----------------------------------------------------------------------
         //
@@ -508,7 +619,8 @@ public:
         //             the conditional.
         //
         m_peers = add (Peers::New (m_mainIoPool, *m_resourceManager, *m_siteFiles,
-            m_mainIoPool, m_peerSSLContext->get ()));
+            m_mainIoPool, m_peerSSLContext->get (), *m_sslHandshaker,
+                m_collectorManager->collector ()));
 
         // If we're not in standalone mode,
         // prepare ourselves for  networking
@@ -524,7 +636,8 @@ public:
                 getConfig ().PEER_IP,
                 getConfig ().peerListeningPort,
                 m_mainIoPool,
-                m_peerSSLContext->get ()));
+                m_peerSSLContext->get (),
+                *m_sslHandshaker));
 
             if (getConfig ().peerPROXYListeningPort != 0)
             {
@@ -536,7 +649,8 @@ public:
                     getConfig ().PEER_IP,
                     getConfig ().peerPROXYListeningPort,
                     m_mainIoPool,
-                    m_peerSSLContext->get ()));
+                    m_peerSSLContext->get (),
+                    *m_sslHandshaker));
             }
         }
         else
@@ -625,7 +739,9 @@ public:
         {
             try
             {
-                m_rpcDoor = RPCDoor::New (m_mainIoPool, m_rpcServerHandler);
+                m_rpcDoor = RPCDoor::New (m_mainIoPool,
+                    BIND_TYPE (&IoServicePool::getNextService, &m_mainIoPool),
+                        m_rpcServerHandler);
             }
             catch (const std::exception& e)
             {
@@ -778,6 +894,15 @@ public:
 
         doStop ();
 
+        m_ledgerHeaderIndex->save ();
+
+        {
+            ScopedPointer <CacheWarmup> warmup (CacheWarmup::New (*m_nodeStore,
+                LogPartition::getJournal <CacheWarmupLog> ()));
+            warmup->save (getCacheWarmupFile (),
+                getConfig ().getSize (siNodeCacheSize), getConfig ().getSize (siTreeCacheSize));
+        }
+
         {
             // These two asssignment should no longer be necessary
             // once the WSDoor cancels its pending I/O correctly
@@ -880,8 +1005,14 @@ public:
 
 private:
     void updateTables ();
+    File getCacheWarmupFile () const
+    {
+        return getConfig ().getDatabaseDir ().getChildFile ("cache_warmup.bin");
+    }
+
     void startNewLedger ();
     bool loadOldLedger (const std::string&, bool);
+    bool loadSnapshot (std::string const& path, std::string const& expectedHash);
 
     void onAnnounceAddress ();
 
@@ -902,6 +1033,7 @@ private:
     // These are Stoppable-related
     ScopedPointer <JobQueue> m_jobQueue;
     IoServicePool m_mainIoPool;
+    ScopedPointer <SSLHandshaker> m_sslHandshaker;
     ScopedPointer <SiteFiles::Manager> m_siteFiles;
     OrderBookDB m_orderBookDB;
     ScopedPointer <LedgerMaster> m_ledgerMaster;
@@ -921,6 +1053,9 @@ private:
     ScopedPointer <IFeeVote> mFeeVote;
     ScopedPointer <LoadFeeTrack> mFeeTrack;
     ScopedPointer <IHashRouter> mHashRouter;
+    ScopedPointer <PublicKeyCache> m_publicKeyCache;
+    ScopedPointer <SignatureVerifier> m_signatureVerifier;
+    ScopedPointer <SpeculativeEngine> m_speculativeEngine;
     ScopedPointer <Validations> mValidations;
     ScopedPointer <ProofOfWorkFactory> mProofOfWorkFactory;
     ScopedPointer <LoadManager> m_loadManager;
@@ -931,6 +1066,8 @@ private:
     ScopedPointer <DatabaseCon> mTxnDB;
     ScopedPointer <DatabaseCon> mLedgerDB;
     ScopedPointer <DatabaseCon> mWalletDB;
+    ScopedPointer <AccountHistory> m_accountHistory;
+    ScopedPointer <LedgerHeaderIndex> m_ledgerHeaderIndex;
 
     ScopedPointer <SSLContext> m_peerSSLContext;
     ScopedPointer <SSLContext> m_wsSSLContext;
@@ -942,6 +1079,18 @@ private:
     ScopedPointer <WSDoor> m_wsProxyDoor;
 
     WaitableEvent m_stop;
+
+    // Declared last so the hook is removed before the caches go away
+    struct CacheMetrics
+    {
+        insight::Hook hook;
+        insight::Gauge sle_hit_percent;
+        insight::Gauge node_hit_percent;
+        insight::Gauge ledger_hit_percent;
+        insight::Gauge accepted_ledger_hit_percent;
+    };
+
+    CacheMetrics m_cacheMetrics;
 };
 
 //------------------------------------------------------------------------------
@@ -1023,10 +1172,21 @@ bool ApplicationImp::loadOldLedger (const std::string& l, bool bReplay)
             return false;
         }
 
-        if (!loadLedger->walkLedger ())
         {
-            m_journal.fatal << "Ledger is missing nodes.";
-            return false;
+            // Progress is checkpointed so an interrupted load resumes the check
+            ScopedPointer <LedgerVerifier> verifier (LedgerVerifier::New (
+                getNodeStore (), m_collectorManager->collector (),
+                LogPartition::getJournal <Ledger> ()));
+
+            LedgerVerifier::Result result;
+            verifier->verify (*loadLedger, 0,
+                getConfig ().getDatabaseDir ().getChildFile ("ledger_verify.checkpoint"), result);
+
+            if (!result.passed ())
+            {
+                m_journal.fatal << "Ledger is missing nodes.";
+                return false;
+            }
         }
 
         if (!loadLedger->assertSane ())
@@ -1074,6 +1234,79 @@ bool ApplicationImp::loadOldLedger (const std::string& l, bool bReplay)
     return true;
 }
 
+// Import a ledger from a snapshot file into the node store and start from it,
+// instead of acquiring the whole ledger from the network node by node.
+bool ApplicationImp::loadSnapshot (std::string const& path, std::string const& expectedHash)
+{
+    Journal const journal (LogPartition::getJournal <Ledger> ());
+
+    LedgerSnapshot::pointer snapshot (LedgerSnapshot::open (
+        File::getCurrentWorkingDirectory ().getChildFile (path), journal));
+
+    if (!snapshot)
+    {
+        m_journal.fatal << "Unable to open snapshot " << path;
+        return false;
+    }
+
+    uint256 const hash (snapshot->getLedgerHash ());
+    uint256 expected;
+
+    // The ledger becomes the validated ledger without any validations,
+    // so it must be the one the operator asked for.
+    if (!expected.SetHex (expectedHash) || (expected != hash))
+    {
+        m_journal.fatal << "Snapshot is of ledger " << hash << ", not " << expectedHash;
+        return false;
+    }
+
+    m_journal.info << "Importing ledger " << hash << " from " << path;
+
+    if (!snapshot->import (getNodeStore (), journal))
+    {
+        m_journal.fatal << "Snapshot failed verification";
+        return false;
+    }
+
+    Ledger::pointer loadLedger (boost::make_shared <Ledger> (snapshot->getRawHeader (), false));
+    snapshot.reset ();
+
+    if (loadLedger->getAccountHash ().isZero ())
+    {
+        m_journal.fatal << "Ledger is empty.";
+        return false;
+    }
+
+    // The import verified every node, so the roots are all that is needed
+    if ((loadLedger->getTransHash ().isNonZero () &&
+            !loadLedger->peekTransactionMap ()->fetchRoot (loadLedger->getTransHash (), nullptr)) ||
+        !loadLedger->peekAccountStateMap ()->fetchRoot (loadLedger->getAccountHash (), nullptr))
+    {
+        m_journal.fatal << "Imported ledger is missing its roots";
+        return false;
+    }
+
+    loadLedger->setClosed ();
+    loadLedger->setImmutable ();
+
+    if (!loadLedger->assertSane ())
+    {
+        m_journal.fatal << "Ledger is not sane.";
+        return false;
+    }
+
+    m_ledgerMaster->setLedgerRangePresent (loadLedger->getLedgerSeq (), loadLedger->getLedgerSeq ());
+
+    Ledger::pointer openLedger = boost::make_shared<Ledger> (false, boost::ref (*loadLedger));
+    m_ledgerMaster->switchLedgers (loadLedger, openLedger);
+    m_ledgerMaster->forceValid (loadLedger);
+    m_networkOPs->setLastCloseTime (loadLedger->getCloseTimeNC ());
+
+    m_journal.info << "Starting from snapshot ledger " << hash << " seq:" << loadLedger->getLedgerSeq ();
+
+    return true;
+}
+
 bool serverOkay (std::string& reason)
 {
     if (!getConfig ().ELB_SUPPORT)
@@ -31,6 +31,9 @@ class CollectorManager;
 class IFeatures;
 class IFeeVote;
 class IHashRouter;
+class PublicKeyCache;
+class SignatureVerifier;
+class SpeculativeEngine;
 class LoadFeeTrack;
 class Peers;
 class UniqueNodeList;
@@ -47,6 +50,8 @@ class TxQueue;
 class LocalCredentials;
 
 class DatabaseCon;
+class AccountHistory;
+class LedgerHeaderIndex;
 
 typedef TaggedCacheType <uint256, Blob , UptimeTimerAdapter> NodeCache;
 typedef TaggedCacheType <uint256, SerializedLedgerEntry, UptimeTimerAdapter> SLECache;
@@ -88,6 +93,9 @@ public:
     virtual IFeatures&              getFeatureTable () = 0;
     virtual IFeeVote&               getFeeVote () = 0;
     virtual IHashRouter&            getHashRouter () = 0;
+    virtual PublicKeyCache&         getPublicKeyCache () = 0;
+    virtual SignatureVerifier&      getSignatureVerifier () = 0;
+    virtual SpeculativeEngine&      getSpeculativeEngine () = 0;
     virtual LoadFeeTrack&           getFeeTrack () = 0;
     virtual LoadManager&            getLoadManager () = 0;
     virtual Peers&                  getPeers () = 0;
@@ -108,6 +116,12 @@ public:
     virtual DatabaseCon* getTxnDB () = 0;
     virtual DatabaseCon* getLedgerDB () = 0;
 
+    /** Retrieve the account history store, or nullptr if not configured. */
+    virtual AccountHistory* getAccountHistory () = 0;
+
+    /** Retrieve the index of ledger headers held in the ledger database. */
+    virtual LedgerHeaderIndex& getLedgerHeaderIndex () = 0;
+
     /** Retrieve the "wallet database"
 
         It looks like this is used to store the unique node list.
@@ -0,0 +1,483 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+class CacheWarmupImp
+    : public CacheWarmup
+    , public LeakChecked <CacheWarmupImp>
+{
+public:
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    enum
+    {
+        // Keys are handed to the workers in runs of this many, which
+        // keeps each worker's reads in key order
+        keysPerTask = 256,
+
+        objectRecordBytes = 32,
+        nodeRecordBytes = 32 + 1 + 32,
+
+        // Magic, object count, tree node count
+        preambleBytes = 8 + 4 + 4
+    };
+
+    static char const* magic ()
+    {
+        return "RCWARMU1";
+    }
+
+    struct Counts
+    {
+        Counts ()
+            : fetched (0)
+            , missing (0)
+        {
+        }
+
+        void add (Counts const& other)
+        {
+            fetched += other.fetched;
+            missing += other.missing;
+        }
+
+        int fetched;
+        int missing;
+    };
+
+    //--------------------------------------------------------------------------
+
+    class Worker : public Thread
+    {
+    public:
+        explicit Worker (CacheWarmupImp& owner)
+            : Thread ("CacheWarmup")
+            , m_owner (owner)
+        {
+        }
+
+        ~Worker ()
+        {
+            stopThread ();
+        }
+
+        void run ()
+        {
+            m_owner.runWorker ();
+        }
+
+    private:
+        CacheWarmupImp& m_owner;
+    };
+
+    //--------------------------------------------------------------------------
+
+    CacheWarmupImp (NodeStore::Database& nodeStore, Journal journal)
+        : m_nodeStore (nodeStore)
+        , m_journal (journal)
+        , m_lock (this, "CacheWarmup", __FILE__, __LINE__)
+        , m_next (0)
+    {
+    }
+
+    void save (File const& file, int maxObjects, int maxTreeNodes)
+    {
+        std::vector <uint256> objects;
+        m_nodeStore.getCachedKeys (objects, maxObjects);
+
+        std::vector <SHAMap::TNIndex> nodes;
+        SHAMap::getRecentTreeNodes (nodes, maxTreeNodes);
+
+        Serializer s (preambleBytes +
+            (objects.size () * objectRecordBytes) + (nodes.size () * nodeRecordBytes));
+
+        s.addRaw (magic (), 8);
+        s.add32 (objects.size ());
+        s.add32 (nodes.size ());
+
+        for (std::size_t i = 0; i < objects.size (); ++i)
+            s.add256 (objects [i]);
+
+        for (std::size_t i = 0; i < nodes.size (); ++i)
+        {
+            s.add256 (nodes [i].first);
+            s.add8 (nodes [i].second.getDepth ());
+            s.add256 (nodes [i].second.getNodeID ());
+        }
+
+        if (file.replaceWithData (s.getDataPtr (), s.getDataLength ()))
+        {
+            m_journal.info << "Saved " << objects.size () << " node objects and " <<
+                nodes.size () << " tree nodes for warm-up";
+        }
+        else
+        {
+            m_journal.warning << "Unable to write " << file.getFullPathName ();
+        }
+    }
+
+    void load (File const& file, int threads)
+    {
+        if (!file.existsAsFile ())
+            return;
+
+        double const start = Time::getMillisecondCounterHiRes ();
+
+        m_objects.clear ();
+        m_nodes.clear ();
+        m_next = 0;
+        m_totals = Counts ();
+
+        bool const valid = read (file);
+
+        file.deleteFile ();
+
+        if (!valid)
+        {
+            m_journal.warning << "Ignoring damaged warm-up file " << file.getFullPathName ();
+            return;
+        }
+
+        // Fetching in key order is far kinder to the backend than the
+        // order in which the objects happened to be used
+        std::sort (m_objects.begin (), m_objects.end ());
+        std::sort (m_nodes.begin (), m_nodes.end ());
+
+        int const tasks = getTaskCount ();
+
+        if (threads <= 0)
+            threads = SystemStats::getNumCpus ();
+        threads = std::max (1, std::min (threads, tasks));
+
+        {
+            OwnedArray <Worker> workers;
+
+            for (int i = 0; i < threads; ++i)
+            {
+                workers.add (new Worker (*this));
+                workers [i]->startThread ();
+            }
+
+            for (int i = 0; i < threads; ++i)
+                workers [i]->waitForThreadToExit (-1);
+        }
+
+        double const seconds = (Time::getMillisecondCounterHiRes () - start) / 1000.0;
+
+        m_journal.info << "Warmed caches with " << m_totals.fetched << " objects in " <<
+            seconds << "s on " << threads << " threads, " << m_totals.missing << " missing";
+
+        m_objects.clear ();
+        m_nodes.clear ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool read (File const& file)
+    {
+        MemoryBlock block;
+
+        if (!file.loadFileAsData (block) || (block.getSize () < preambleBytes))
+            return false;
+
+        unsigned char const* const data = static_cast <unsigned char const*> (block.getData ());
+        Serializer s (Blob (data, data + block.getSize ()));
+
+        uint32 objectCount;
+        uint32 nodeCount;
+
+        if ((memcmp (data, magic (), 8) != 0) ||
+            !s.get32 (objectCount, 8) ||
+            !s.get32 (nodeCount, 12))
+            return false;
+
+        std::size_t const expected = preambleBytes +
+            (std::size_t (objectCount) * objectRecordBytes) +
+            (std::size_t (nodeCount) * nodeRecordBytes);
+
+        if (block.getSize () != expected)
+            return false;
+
+        int offset = preambleBytes;
+
+        m_objects.reserve (objectCount);
+
+        for (uint32 i = 0; i < objectCount; ++i)
+        {
+            m_objects.push_back (s.get256 (offset));
+            offset += objectRecordBytes;
+        }
+
+        m_nodes.reserve (nodeCount);
+
+        for (uint32 i = 0; i < nodeCount; ++i)
+        {
+            int depth;
+
+            if (!s.get8 (depth, offset + 32))
+                return false;
+
+            SHAMapNode const id (depth, s.get256 (offset + 33));
+
+            if (!id.isValid ())
+                return false;
+
+            m_nodes.push_back (SHAMap::TNIndex (s.get256 (offset), id));
+            offset += nodeRecordBytes;
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Node objects come first so tree nodes built afterwards find their
+    // data already in the NodeStore cache
+    int getTaskCount () const
+    {
+        return ((m_objects.size () + keysPerTask - 1) / keysPerTask) +
+               ((m_nodes.size () + keysPerTask - 1) / keysPerTask);
+    }
+
+    bool getTask (int& task)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        if (m_next >= getTaskCount ())
+            return false;
+
+        task = m_next++;
+        return true;
+    }
+
+    void runWorker ()
+    {
+        int const objectTasks = (m_objects.size () + keysPerTask - 1) / keysPerTask;
+
+        Counts counts;
+        int task;
+
+        while (getTask (task))
+        {
+            if (task < objectTasks)
+            {
+                std::size_t const first = task * keysPerTask;
+                std::size_t const last = std::min <std::size_t> (first + keysPerTask, m_objects.size ());
+
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    if (m_nodeStore.fetch (m_objects [i]))
+                        ++counts.fetched;
+                    else
+                        ++counts.missing;
+                }
+            }
+            else
+            {
+                std::size_t const first = (task - objectTasks) * keysPerTask;
+                std::size_t const last = std::min <std::size_t> (first + keysPerTask, m_nodes.size ());
+
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    if (fetchTreeNode (m_nodes [i].first, m_nodes [i].second))
+                        ++counts.fetched;
+                    else
+                        ++counts.missing;
+                }
+            }
+        }
+
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+        m_totals.add (counts);
+    }
+
+    bool fetchTreeNode (uint256 const& hash, SHAMapNode const& id)
+    {
+        if (SHAMap::getCache (hash, id))
+            return true;
+
+        NodeObject::pointer const object (m_nodeStore.fetch (hash));
+
+        if (!object)
+            return false;
+
+        SHAMapTreeNode::pointer node;
+
+        try
+        {
+            node = boost::make_shared <SHAMapTreeNode> (
+                id, object->getData (), 0, snfPREFIX, hash, true);
+        }
+        catch (...)
+        {
+            return false;
+        }
+
+        if (id != *node)
+            return false;
+
+        SHAMap::canonicalize (hash, node);
+        return true;
+    }
+
+private:
+    NodeStore::Database& m_nodeStore;
+    Journal m_journal;
+
+    LockType m_lock;
+    std::vector <uint256> m_objects;
+    std::vector <SHAMap::TNIndex> m_nodes;
+    int m_next;
+    Counts m_totals;
+};
+
+//------------------------------------------------------------------------------
+
+CacheWarmup* CacheWarmup::New (NodeStore::Database& nodeStore, Journal journal)
+{
+    return new CacheWarmupImp (nodeStore, journal);
+}
+
+//------------------------------------------------------------------------------
+
+class CacheWarmupTests : public UnitTest
+{
+public:
+    enum
+    {
+        numObjects = 64
+    };
+
+    // Opens the node store in a fresh database, so its cache starts empty
+    static NodeStore::Database* openDatabase (NodeStore::Scheduler& scheduler, File const& path)
+    {
+        StringPairArray params;
+        params.set ("type", "leveldb");
+        params.set ("path", path.getFullPathName ());
+        return NodeStore::Database::New ("test", scheduler, params);
+    }
+
+    static uint256 getObjectHash (int i)
+    {
+        return Serializer::getSHA512Half (String (i).toStdString ());
+    }
+
+    // Returns the sorted hashes of the objects in the database's cache
+    static std::vector <uint256> getCached (NodeStore::Database& db)
+    {
+        std::vector <uint256> keys;
+        db.getCachedKeys (keys, 2 * numObjects);
+        std::sort (keys.begin (), keys.end ());
+        return keys;
+    }
+
+    // Store objects and use them in order, one per second of uptime,
+    // so the last ones stored are the most recently used
+    void createObjects (NodeStore::Database& db)
+    {
+        UptimeTimer::getInstance ().beginManualUpdates ();
+
+        for (int i = 0; i < numObjects; ++i)
+        {
+            std::string const text (String (i).toStdString ());
+            Blob data (text.begin (), text.end ());
+            db.store (hotLEDGER, 1, data, getObjectHash (i));
+            UptimeTimer::getInstance ().incrementElapsedTime ();
+        }
+
+        UptimeTimer::getInstance ().endManualUpdates ();
+    }
+
+    void testRoundTrip (int maxObjects)
+    {
+        beginTestCase (String ("save ") + String (maxObjects) + " of " + String (numObjects));
+
+        NodeStore::DummyScheduler scheduler;
+        File const path (File::createTempFile ("node_db"));
+        File const file (File::createTempFile ("warmup"));
+
+        {
+            ScopedPointer <NodeStore::Database> db (openDatabase (scheduler, path));
+            createObjects (*db);
+
+            ScopedPointer <CacheWarmup> warmup (CacheWarmup::New (*db, journal ()));
+            warmup->save (file, maxObjects, 0);
+        }
+
+        std::vector <uint256> expected;
+        for (int i = std::max (0, numObjects - maxObjects); i < numObjects; ++i)
+            expected.push_back (getObjectHash (i));
+        std::sort (expected.begin (), expected.end ());
+
+        {
+            ScopedPointer <NodeStore::Database> db (openDatabase (scheduler, path));
+            expect (getCached (*db).empty (), "Fresh cache is not empty");
+
+            ScopedPointer <CacheWarmup> warmup (CacheWarmup::New (*db, journal ()));
+            warmup->load (file, 2);
+
+            expect (getCached (*db) == expected, "Wrong objects warmed");
+            expect (!file.exists (), "Snapshot not deleted");
+        }
+
+        path.deleteRecursively ();
+    }
+
+    void testRecentKeys ()
+    {
+        beginTestCase ("recent keys");
+
+        TaggedCacheType <int, int, UptimeTimerAdapter> cache ("test", 0, 0);
+
+        std::vector <boost::shared_ptr <int> > held;
+
+        for (int i = 0; i < 10; ++i)
+        {
+            boost::shared_ptr <int> value (boost::make_shared <int> (i));
+            cache.canonicalize (i, value);
+            held.push_back (value);
+        }
+
+        std::vector <int> keys;
+        cache.getRecentKeys (keys, 4);
+        expect (keys.size () == 4);
+
+        cache.getRecentKeys (keys, 100);
+        expect (keys.size () == 10);
+
+        std::sort (keys.begin (), keys.end ());
+        for (int i = 0; i < 10; ++i)
+            expect (keys [i] == i);
+    }
+
+    void runTest ()
+    {
+        testRecentKeys ();
+        testRoundTrip (numObjects);
+
+        // Truncating keeps the most recently used objects
+        testRoundTrip (numObjects / 4);
+    }
+
+    CacheWarmupTests () : UnitTest ("CacheWarmup", "ripple")
+    {
+    }
+};
+
+static CacheWarmupTests cacheWarmupTests;
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_CACHEWARMUP_H_INCLUDED
+#define RIPPLE_APP_CACHEWARMUP_H_INCLUDED
+
+/** Carries the hot part of the node caches across a restart.
+
+    On a clean shutdown the keys of the most recently used NodeStore
+    objects and SHAMap tree nodes are written to a file. On the next
+    start the keys are sorted and fetched back into the caches by several
+    threads, so the server does not begin tracking the network with cold
+    caches and every early ledger hitting the backend.
+
+    The file only holds keys, never object data, so a snapshot that is
+    stale or belongs to a different database costs a few wasted reads
+    and nothing else.
+*/
+class CacheWarmup
+{
+public:
+    static CacheWarmup* New (NodeStore::Database& nodeStore, Journal journal);
+
+    virtual ~CacheWarmup () { }
+
+    /** Write the keys of the most recently used cached objects.
+
+        @param file The snapshot to write. An existing file is replaced.
+        @param maxObjects The most NodeStore keys to write.
+        @param maxTreeNodes The most tree node keys to write.
+    */
+    virtual void save (File const& file, int maxObjects, int maxTreeNodes) = 0;
+
+    /** Read a snapshot and fetch its objects into the caches.
+
+        The snapshot is deleted afterwards, so that a server which later
+        stops without writing a new one does not warm up from old keys.
+        Nothing happens if the file does not exist.
+
+        @param file The snapshot written by save().
+        @param threads The number of fetching threads, or 0 for one per CPU.
+    */
+    virtual void load (File const& file, int threads) = 0;
+};
+
+#endif
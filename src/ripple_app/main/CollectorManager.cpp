@@ -25,6 +25,7 @@ class CollectorManagerImp
 public:
     Journal m_journal;
     shared_ptr <insight::Collector> m_collector;
+    shared_ptr <insight::TextCollector> m_textCollector;
 
     CollectorManagerImp (StringPairArray const& params,
         Journal journal)
@@ -40,6 +41,13 @@ public:
 
             m_collector = insight::StatsDCollector::New (address, prefix, journal);
         }
+        else if (server == "text")
+        {
+            std::string const& prefix (params ["prefix"].toStdString ());
+
+            m_textCollector = insight::TextCollector::New (prefix);
+            m_collector = m_textCollector;
+        }
         else
         {
             m_collector = insight::NullCollector::New ();
@@ -54,6 +62,11 @@ public:
     {
         return m_collector;
     }
+
+    shared_ptr <insight::TextCollector> const& textCollector ()
+    {
+        return m_textCollector;
+    }
 };
 
 //------------------------------------------------------------------------------
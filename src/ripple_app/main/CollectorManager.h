@@ -32,6 +32,11 @@ public:
         Journal journal);
     virtual ~CollectorManager () = 0;
     virtual shared_ptr <insight::Collector> const& collector () = 0;
+
+    /** Returns the collector which serves metrics as text.
+        This is null unless the text server was chosen.
+    */
+    virtual shared_ptr <insight::TextCollector> const& textCollector () = 0;
 };
 
 }
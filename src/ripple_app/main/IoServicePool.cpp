@@ -17,16 +17,43 @@
 */
 //==============================================================================
 
+class IoServicePool::Reactor
+{
+public:
+    Reactor (int index, int concurrencyHint,
+        shared_ptr <insight::Collector> const& collector)
+        : m_index (index)
+        , m_service (concurrencyHint)
+        , m_work (new boost::asio::io_service::work (m_service))
+        , m_timer (m_service)
+        , m_expires (0)
+    {
+        m_latency = collector->make_event (
+            "io_latency_" + lexicalCastThrow <std::string> (index));
+    }
+
+    int m_index;
+    boost::asio::io_service m_service;
+    ScopedPointer <boost::asio::io_service::work> m_work;
+    boost::asio::deadline_timer m_timer;
+    insight::Event m_latency;
+    double m_expires;
+};
+
+//------------------------------------------------------------------------------
+
 class IoServicePool::ServiceThread : private Thread
 {
 public:
     explicit ServiceThread (
         String const& name,
         IoServicePool& owner,
-        boost::asio::io_service& service)
+        boost::asio::io_service& service,
+        int core)
         : Thread (name)
         , m_owner (owner)
         , m_service (service)
+        , m_core (core)
     {
         startThread ();
     }
@@ -44,6 +71,10 @@ public:
 
     void run ()
     {
+        // The affinity mask only covers the first 32 cores
+        if (m_core >= 0 && m_core < 32)
+            Thread::setCurrentThreadAffinityMask (uint32 (1) << m_core);
+
         m_service.run ();
 
         m_owner.onThreadExit();
@@ -52,18 +83,30 @@ public:
 private:
     IoServicePool& m_owner;
     boost::asio::io_service& m_service;
+    int m_core;
 };
 
 //------------------------------------------------------------------------------
 
-IoServicePool::IoServicePool (Stoppable& parent, String const& name, int numberOfThreads)
+IoServicePool::IoServicePool (Stoppable& parent, String const& name,
+    int numberOfThreads, bool multiReactor,
+        shared_ptr <insight::Collector> const& collector)
     : Stoppable (name.toStdString().c_str(), parent)
     , m_name (name)
-    , m_service (numberOfThreads)
-    , m_work (boost::ref (m_service))
     , m_threadsDesired (numberOfThreads)
+    , m_multiReactor (multiReactor && (numberOfThreads > 1))
 {
     bassert (m_threadsDesired > 0);
+
+    if (m_multiReactor)
+    {
+        for (int i = 0; i < m_threadsDesired; ++i)
+            m_reactors.add (new Reactor (i, 1, collector));
+    }
+    else
+    {
+        m_reactors.add (new Reactor (0, m_threadsDesired, collector));
+    }
 }
 
 IoServicePool::~IoServicePool ()
@@ -73,23 +116,50 @@ IoServicePool::~IoServicePool ()
 
 boost::asio::io_service& IoServicePool::getService ()
 {
-    return m_service;
+    return m_reactors [0]->m_service;
 }
 
 IoServicePool::operator boost::asio::io_service& ()
 {
-    return m_service;
+    return getService ();
+}
+
+boost::asio::io_service& IoServicePool::getNextService ()
+{
+    int const count = m_reactors.size ();
+
+    if (count == 1)
+        return getService ();
+
+    int const next = (++m_nextReactor) & 0x7fffffff;
+
+    return m_reactors [next % count]->m_service;
+}
+
+int IoServicePool::getServiceCount () const
+{
+    return m_reactors.size ();
 }
 
 void IoServicePool::onStart ()
 {
+    int const cores = SystemStats::getNumCpus ();
+
     m_threads.ensureStorageAllocated (m_threadsDesired);
     for (int i = 0; i < m_threadsDesired; ++i)
     {
-        m_threads.add (new ServiceThread (m_name, *this, m_service));
+        Reactor& reactor (m_multiReactor ? *m_reactors [i] : *m_reactors [0]);
+
+        // Pinning only makes sense when each thread has its own reactor
+        int const core = (m_multiReactor && cores > 1) ? (i % cores) : -1;
+
+        m_threads.add (new ServiceThread (m_name, *this, reactor.m_service, core));
         ++m_threadsRunning;
         m_threads[i]->start ();
     }
+
+    for (int i = 0; i < m_reactors.size (); ++i)
+        startLatencyTimer (*m_reactors [i]);
 }
 
 void IoServicePool::onStop ()
@@ -100,7 +170,12 @@ void IoServicePool::onStop ()
     //             just return naturally.
     //
     //m_work = boost::none;
-    m_service.stop ();
+    for (int i = 0; i < m_reactors.size (); ++i)
+    {
+        boost::system::error_code ec;
+        m_reactors [i]->m_timer.cancel (ec);
+        m_reactors [i]->m_service.stop ();
+    }
 }
 
 void IoServicePool::onChildrenStopped ()
@@ -123,3 +198,32 @@ void IoServicePool::onThreadExit()
         stopped ();
     }
 }
+
+//------------------------------------------------------------------------------
+
+// The latency of a reactor is how late its timer handler runs. A busy
+// event loop runs the handler well after the timer expires.
+//
+void IoServicePool::startLatencyTimer (Reactor& reactor)
+{
+    int const intervalMilliseconds = 1000;
+
+    reactor.m_expires = Time::getMillisecondCounterHiRes () + intervalMilliseconds;
+    reactor.m_timer.expires_from_now (
+        boost::posix_time::milliseconds (intervalMilliseconds));
+    reactor.m_timer.async_wait (boost::bind (&IoServicePool::onLatencyTimer,
+        this, boost::ref (reactor), boost::asio::placeholders::error));
+}
+
+void IoServicePool::onLatencyTimer (Reactor& reactor, boost::system::error_code const& ec)
+{
+    if (ec == boost::asio::error::operation_aborted || isStopping ())
+        return;
+
+    double const late = Time::getMillisecondCounterHiRes () - reactor.m_expires;
+
+    reactor.m_latency.notify (static_cast <insight::Event::value_type> (
+        std::max (0.0, late)));
+
+    startLatencyTimer (reactor);
+}
@@ -20,31 +20,63 @@
 #ifndef RIPPLE_APP_IOSERVICEPOOL_H_INCLUDED
 #define RIPPLE_APP_IOSERVICEPOOL_H_INCLUDED
 
-/** An io_service with an associated group of threads. */
+/** An io_service with an associated group of threads.
+
+    In multi-reactor mode the pool instead runs one io_service per thread,
+    each thread pinned to its own core. Connections are spread across the
+    reactors with getNextService so that their handlers, strands and the
+    reactor's internal locks stay on one core rather than being shared by
+    every thread in the process.
+*/
 class IoServicePool : public Stoppable
 {
 public:
-    IoServicePool (Stoppable& parent, String const& name, int numberOfThreads);
+    /** Create the pool.
+
+        @param numberOfThreads The number of threads to run.
+        @param multiReactor `true` to give each thread its own io_service.
+        @param collector Receives the event loop latency of each reactor.
+    */
+    IoServicePool (Stoppable& parent, String const& name,
+        int numberOfThreads, bool multiReactor,
+            shared_ptr <insight::Collector> const& collector);
+
     ~IoServicePool ();
 
+    /** Returns the primary io_service.
+        Listening sockets and timers which are not tied to a particular
+        connection belong here. With a single reactor it is the only one.
+    */
     boost::asio::io_service& getService ();
     operator boost::asio::io_service& ();
 
+    /** Returns the io_service which should own a new connection.
+        The reactors are chosen in turn.
+    */
+    boost::asio::io_service& getNextService ();
+
+    /** Returns the number of io_service instances in the pool. */
+    int getServiceCount () const;
+
     void onStart ();
     void onStop ();
     void onChildrenStopped ();
 
 private:
+    class Reactor;
     class ServiceThread;
 
     void onThreadExit();
+    void onLatencyTimer (Reactor& reactor, boost::system::error_code const& ec);
+    void startLatencyTimer (Reactor& reactor);
 
     String m_name;
-    boost::asio::io_service m_service;
-    boost::optional <boost::asio::io_service::work> m_work;
+    OwnedArray <Reactor> m_reactors;
     OwnedArray <ServiceThread> m_threads;
     int m_threadsDesired;
+    bool m_multiReactor;
     Atomic <int> m_threadsRunning;
+    Atomic <int> m_nextReactor;
 };
 
 #endif
@@ -17,10 +17,14 @@
 */
 //==============================================================================
 
-NodeStoreScheduler::NodeStoreScheduler (Stoppable& parent, JobQueue& jobQueue)
+NodeStoreScheduler::NodeStoreScheduler (Stoppable& parent, JobQueue& jobQueue,
+    shared_ptr <insight::Collector> const& collector)
     : Stoppable ("NodeStoreScheduler", parent)
     , m_jobQueue (jobQueue)
     , m_taskCount (1) // start it off at 1
+    , m_fetchLatency (collector->make_histogram ("nodestore_fetch_us"))
+    , m_cacheHits (collector->make_meter ("nodestore_cache_hits"))
+    , m_notFound (collector->make_meter ("nodestore_not_found"))
 {
 }
 
@@ -50,3 +54,16 @@ void NodeStoreScheduler::doTask (NodeStore::Task& task, Job&)
     if ((--m_taskCount == 0) && isStopping())
         stopped();
 }
+
+void NodeStoreScheduler::onFetch (NodeStore::FetchReport const& report)
+{
+    // Only fetches which went to a backend are worth timing
+    if (report.wentToDisk)
+        m_fetchLatency.record (static_cast <insight::Histogram::value_type> (
+            report.elapsed));
+    else
+        ++m_cacheHits;
+
+    if (! report.wasFound)
+        ++m_notFound;
+}
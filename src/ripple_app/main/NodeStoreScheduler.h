@@ -26,17 +26,23 @@ class NodeStoreScheduler
     , public Stoppable
 {
 public:
-    NodeStoreScheduler (Stoppable& parent, JobQueue& jobQueue);
+    NodeStoreScheduler (Stoppable& parent, JobQueue& jobQueue,
+        shared_ptr <insight::Collector> const& collector);
 
     void onStop ();
     void onChildrenStopped ();
     void scheduleTask (NodeStore::Task& task);
+    void onFetch (NodeStore::FetchReport const& report);
 
 private:
     void doTask (NodeStore::Task& task, Job&);
 
     JobQueue& m_jobQueue;
     Atomic <int> m_taskCount;
+
+    insight::Histogram m_fetchLatency;
+    insight::Meter m_cacheHits;
+    insight::Meter m_notFound;
 };
 
 
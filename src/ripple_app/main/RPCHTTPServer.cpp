@@ -77,6 +77,7 @@ public:
                 else
                     port.port = ep.port();
                 port.context = m_context;
+                port.maxConcurrentRequests = getConfig ().RPC_CONCURRENCY;
 
                 HTTP::Ports ports;
                 ports.push_back (port);
@@ -152,10 +153,19 @@ public:
 
     void processSession (Job& job, HTTP::Session& session)
     {
+        if (isMetricsRequest (session))
+        {
+            session.write (m_deprecatedHandler.processMetrics (
+                session.remoteAddress().withPort(0).to_string()));
+
+            session.complete();
+            return;
+        }
+
         session.write (m_deprecatedHandler.processRequest (
             session.content(), session.remoteAddress().withPort(0).to_string()));
 
-        session.close();
+        session.complete();
     }
 
     std::string createResponse (
@@ -165,6 +175,15 @@ public:
         return HTTPReply (statusCode, description);
     }
 
+    // A GET of /metrics returns the text collector's metrics
+    bool isMetricsRequest (HTTP::Session& session)
+    {
+        SharedPtr <beast::HTTPRequest> const& request (session.request ());
+
+        return request != nullptr &&
+            request->url ().upToFirstOccurrenceOf ("?", false, false) == "/metrics";
+    }
+
     bool isAuthorized (
         std::map <std::string, std::string> const& headers)
     {
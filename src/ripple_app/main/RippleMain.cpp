@@ -92,13 +92,16 @@ void printHelp (const po::options_description& desc)
     cerr << "     data_fetch <key>" << endl;
     cerr << "     data_store <key> <value>" << endl;
 #endif
+    cerr << "     export_snapshot <path> [<ledger>]" << endl;
     cerr << "     get_counts" << endl;
+    cerr << "     job_trace [<limit>]" << endl;
     cerr << "     json <method> <json>" << endl;
     cerr << "     ledger [<id>|current|closed|validated] [full]" << endl;
     cerr << "     ledger_accept" << endl;
     cerr << "     ledger_closed" << endl;
     cerr << "     ledger_current" << endl;
     cerr << "     ledger_header <ledger>" << endl;
+    cerr << "     lock_profile [<limit>] [reset]" << endl;
     cerr << "     logrotate " << endl;
     cerr << "     peers" << endl;
     cerr << "     proof_create [<difficulty>] [<secret>]" << endl;
@@ -241,6 +244,48 @@ static int runUnitTests (String const& match, String const& format)
 
 //------------------------------------------------------------------------------
 
+static int runReplayBenchmark (po::variables_map const& vm)
+{
+    LedgerReplayBenchmark::Setup setup;
+
+    try
+    {
+        std::string const range (vm ["replay_bench"].as <std::string> ());
+        std::string::size_type const dash (range.find ('-'));
+
+        setup.firstLedger = lexicalCastThrow <uint32> (range.substr (0, dash));
+        setup.lastLedger = (dash == std::string::npos) ? setup.firstLedger
+            : lexicalCastThrow <uint32> (range.substr (dash + 1));
+    }
+    catch (BadLexicalCast&)
+    {
+        Log::out () << "Invalid ledger range, expected <first>[-<last>]";
+        return 1;
+    }
+
+    if (setup.lastLedger < setup.firstLedger)
+    {
+        Log::out () << "Invalid ledger range, expected <first>[-<last>]";
+        return 1;
+    }
+
+    if (vm.count ("replay_threads"))
+        setup.threads = vm ["replay_threads"].as <int> ();
+
+    setup.checkSignatures = vm.count ("replay_checksig") != 0;
+
+    ScopedPointer <LedgerReplayBenchmark> benchmark (LedgerReplayBenchmark::New (
+        LogPartition::getJournal <Ledger> ()));
+
+    bool const passed (benchmark->run (setup));
+
+    std::cout << benchmark->getJson ().toStyledString ();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//------------------------------------------------------------------------------
+
 int RippleMain::run (int argc, char const* const* argv)
 {
     FatalErrorReporter reporter;
@@ -280,9 +325,13 @@ int RippleMain::run (int argc, char const* const* argv)
     ("verbose,v", "Verbose logging.")
     ("load", "Load the current ledger from the local DB.")
     ("replay","Replay a ledger close.")
+    ("replay_bench", po::value<std::string> (), "Benchmark the transaction engine by replaying the stored ledgers <first>[-<last>].")
+    ("replay_threads", po::value<int> (), "Replay this many ledgers at once with --replay_bench, 0 for one per CPU.")
+    ("replay_checksig", "Verify transaction signatures with --replay_bench.")
     ("ledger", po::value<std::string> (), "Load the specified ledger and start from .")
     ("start", "Start from a fresh Ledger.")
     ("net", "Get the initial ledger from the network.")
+    ("snapshot", po::value<std::string> (), "Import a ledger snapshot file and start from it, requires --ledger with the expected hash.")
     ("fg", "Run in the foreground.")
     ("import", importDescription.toStdString ().c_str ())
     ("version", "Display the build version.")
@@ -338,6 +387,13 @@ int RippleMain::run (int argc, char const* const* argv)
     {
         iResult = 1;
     }
+    else if (vm.count ("snapshot") && !vm.count ("ledger"))
+    {
+        // A snapshot is trusted as the validated ledger, so the operator
+        // must say which ledger that is.
+        std::cerr << "--snapshot requires --ledger <hash>" << std::endl;
+        iResult = 1;
+    }
 
     if (vm.count ("version"))
     {
@@ -353,6 +409,7 @@ int RippleMain::run (int argc, char const* const* argv)
         && !vm.count ("parameters")
         && !vm.count ("fg")
         && !vm.count ("standalone")
+        && !vm.count ("replay_bench")
         && !vm.count ("unittest"))
     {
         std::string logMe = DoSustain (getConfig ().DEBUG_LOGFILE.string());
@@ -394,7 +451,7 @@ int RippleMain::run (int argc, char const* const* argv)
             !!vm.count ("testnet"),                                 // Testnet flag.
             !!vm.count ("quiet"));                                  // Quiet flag.
 
-        if (vm.count ("standalone"))
+        if (vm.count ("standalone") || vm.count ("replay_bench"))
         {
             getConfig ().RUN_STANDALONE = true;
             getConfig ().LEDGER_HISTORY = 0;
@@ -410,7 +467,13 @@ int RippleMain::run (int argc, char const* const* argv)
         getConfig ().doImport = true;
     }
 
-    if (vm.count ("ledger"))
+    if (vm.count ("snapshot"))
+    {
+        getConfig ().START_SNAPSHOT = vm["snapshot"].as<std::string> ();
+        getConfig ().START_LEDGER = vm["ledger"].as<std::string> ();
+        getConfig ().START_UP = Config::SNAPSHOT;
+    }
+    else if (vm.count ("ledger"))
     {
         getConfig ().START_LEDGER = vm["ledger"].as<std::string> ();
         if (vm.count("replay"))
@@ -457,7 +520,11 @@ int RippleMain::run (int argc, char const* const* argv)
             // No arguments. Run server.
             ScopedPointer <Application> app (Application::New ());
             setupServer ();            
-            startServer ();
+
+            if (vm.count ("replay_bench"))
+                iResult = runReplayBenchmark (vm);
+            else
+                startServer ();
         }
         else
         {
@@ -21,6 +21,86 @@
 class HashRouter : public IHashRouter
 {
 private:
+    enum
+    {
+        // The table is split into this many independently locked shards.
+        // Hashes are uniformly distributed, so relays of different
+        // objects rarely contend for the same lock.
+        shardCount = 32
+    };
+
+    /** The peers from which a hash was received.
+
+        Most hashes arrive from only a handful of peers, so the first few
+        are stored inline in the entry and only the rest need an allocation.
+        Lookups are a short linear scan.
+    */
+    class PeerSet
+    {
+    public:
+        enum
+        {
+            inlineCapacity = 4
+        };
+
+        PeerSet ()
+            : m_inlineSize (0)
+        {
+        }
+
+        std::size_t size () const
+        {
+            return m_inlineSize + m_overflow.size ();
+        }
+
+        bool contains (uint64 peer) const
+        {
+            for (int i = 0; i < m_inlineSize; ++i)
+                if (m_inline [i] == peer)
+                    return true;
+
+            return std::find (m_overflow.begin (), m_overflow.end (), peer) != m_overflow.end ();
+        }
+
+        void insert (uint64 peer)
+        {
+            if (contains (peer))
+                return;
+
+            if (m_inlineSize < inlineCapacity)
+                m_inline [m_inlineSize++] = peer;
+            else
+                m_overflow.push_back (peer);
+        }
+
+        void clear ()
+        {
+            m_inlineSize = 0;
+            m_overflow.clear ();
+        }
+
+        void assign (std::set <uint64> const& peers)
+        {
+            clear ();
+
+            for (std::set <uint64>::const_iterator iter (peers.begin ());
+                iter != peers.end (); ++iter)
+                insert (*iter);
+        }
+
+        void copyTo (std::set <uint64>& peers) const
+        {
+            peers.clear ();
+            peers.insert (m_inline, m_inline + m_inlineSize);
+            peers.insert (m_overflow.begin (), m_overflow.end ());
+        }
+
+    private:
+        int m_inlineSize;
+        uint64 m_inline [inlineCapacity];
+        std::vector <uint64> m_overflow;
+    };
+
     /** An entry in the routing table.
     */
     class Entry : public CountedObject <Entry>
@@ -33,7 +113,7 @@ private:
         {
         }
 
-        std::set <uint64> const& peekPeers () const
+        PeerSet const& peekPeers () const
         {
             return mPeers;
         }
@@ -46,7 +126,7 @@ private:
         
         bool hasPeer (uint64 peer) const
         {
-            return mPeers.count (peer) > 0;
+            return mPeers.contains (peer);
         }
 
         int getFlags (void) const
@@ -71,19 +151,54 @@ private:
 
         void swapSet (std::set <uint64>& other)
         {
-            mPeers.swap (other);
+            std::set <uint64> previous;
+            mPeers.copyTo (previous);
+            mPeers.assign (other);
+            other.swap (previous);
         }
 
     private:
         int mFlags;
-        std::set <uint64> mPeers;
+        PeerSet mPeers;
+    };
+
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    /** A partition of the table with its own lock.
+
+        Expiry uses a timing wheel with one slot per second of the hold
+        time. A new hash is appended to the slot for the current second,
+        and when the wheel comes round to that slot again every hash in
+        it has been held long enough and is removed.
+    */
+    class Shard
+    {
+    public:
+        Shard ()
+            : mLock (this, "HashRouter", __FILE__, __LINE__)
+            , mWheelTime (0)
+        {
+        }
+
+        LockType mLock;
+
+        // Stores all suppressed hashes
+        boost::unordered_map <uint256, Entry> mSuppressionMap;
+
+        // The hashes created in each second, indexed by time modulo the size
+        std::vector <std::vector <uint256> > mWheel;
+
+        // The time up to which the wheel has been expired
+        int mWheelTime;
     };
 
 public:
     explicit HashRouter (int holdTime)
-        : mLock (this, "HashRouter", __FILE__, __LINE__)
-        , mHoldTime (holdTime)
+        : mHoldTime (holdTime)
     {
+        for (int i = 0; i < shardCount; ++i)
+            mShards [i].mWheel.resize (mHoldTime + 1);
     }
 
     bool addSuppression (uint256 const& index);
@@ -97,30 +212,30 @@ public:
     bool swapSet (uint256 const& index, std::set<uint64>& peers, int flag);
 
 private:
-    Entry getEntry (uint256 const& );
+    friend class HashRouterTests;
 
-    Entry& findCreateEntry (uint256 const& , bool& created);
+    Shard& getShard (uint256 const& index)
+    {
+        return mShards [index.begin () [0] % shardCount];
+    }
 
-    typedef RippleMutex LockType;
-    typedef LockType::ScopedLockType ScopedLockType;
-    LockType mLock;
+    Entry& findCreateEntry (Shard& shard, uint256 const& index, bool& created);
 
-    // Stores all suppressed hashes and their expiration time
-    boost::unordered_map <uint256, Entry> mSuppressionMap;
+    // Removes the hashes which have been held long enough as of `now`
+    void expire (Shard& shard, int now);
 
-    // Stores all expiration times and the hashes indexed for them
-    std::map< int, std::list<uint256> > mSuppressionTimes;
+    Shard mShards [shardCount];
 
     int mHoldTime;
 };
 
 //------------------------------------------------------------------------------
 
-HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& created)
+HashRouter::Entry& HashRouter::findCreateEntry (Shard& shard, uint256 const& index, bool& created)
 {
-    boost::unordered_map<uint256, Entry>::iterator fit = mSuppressionMap.find (index);
+    boost::unordered_map<uint256, Entry>::iterator fit = shard.mSuppressionMap.find (index);
 
-    if (fit != mSuppressionMap.end ())
+    if (fit != shard.mSuppressionMap.end ())
     {
         created = false;
         return fit->second;
@@ -129,54 +244,64 @@ HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& crea
     created = true;
 
     int now = UptimeTimer::getInstance ().getElapsedSeconds ();
-    int expireTime = now - mHoldTime;
 
     // See if any supressions need to be expired
-    std::map< int, std::list<uint256> >::iterator it = mSuppressionTimes.begin ();
+    expire (shard, now);
 
-    if ((it != mSuppressionTimes.end ()) && (it->first <= expireTime))
+    shard.mWheel [now % shard.mWheel.size ()].push_back (index);
+    return shard.mSuppressionMap.emplace (index, Entry ()).first->second;
+}
+
+void HashRouter::expire (Shard& shard, int now)
+{
+    int const slots = shard.mWheel.size ();
+
+    if (now <= shard.mWheelTime)
+        return;
+
+    // Each slot passed over holds hashes created a full turn ago
+    int const steps = std::min (now - shard.mWheelTime, slots);
+
+    for (int i = 1; i <= steps; ++i)
     {
-        BOOST_FOREACH (uint256 const & lit, it->second)
-        mSuppressionMap.erase (lit);
-        mSuppressionTimes.erase (it);
+        std::vector <uint256>& slot (shard.mWheel [(shard.mWheelTime + i) % slots]);
+
+        BOOST_FOREACH (uint256 const & lit, slot)
+        shard.mSuppressionMap.erase (lit);
+
+        slot.clear ();
     }
 
-    mSuppressionTimes[now].push_back (index);
-    return mSuppressionMap.emplace (index, Entry ()).first->second;
+    shard.mWheelTime = now;
 }
 
 bool HashRouter::addSuppression (uint256 const& index)
 {
-    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    Shard& shard (getShard (index));
+    ScopedLockType sl (shard.mLock, __FILE__, __LINE__);
 
     bool created;
-    findCreateEntry (index, created);
+    findCreateEntry (shard, index, created);
     return created;
 }
 
-HashRouter::Entry HashRouter::getEntry (uint256 const& index)
-{
-    ScopedLockType sl (mLock, __FILE__, __LINE__);
-
-    bool created;
-    return findCreateEntry (index, created);
-}
-
 bool HashRouter::addSuppressionPeer (uint256 const& index, uint64 peer)
 {
-    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    Shard& shard (getShard (index));
+    ScopedLockType sl (shard.mLock, __FILE__, __LINE__);
 
     bool created;
-    findCreateEntry (index, created).addPeer (peer);
+    findCreateEntry (shard, index, created).addPeer (peer);
     return created;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& index, uint64 peer, int& flags)
 {
-    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    Shard& shard (getShard (index));
+    ScopedLockType sl (shard.mLock, __FILE__, __LINE__);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = findCreateEntry (shard, index, created);
     s.addPeer (peer);
     flags = s.getFlags ();
     return created;
@@ -184,18 +309,20 @@ bool HashRouter::addSuppressionPeer (uint256 const& index, uint64 peer, int& fla
 
 int HashRouter::getFlags (uint256 const& index)
 {
-    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    Shard& shard (getShard (index));
+    ScopedLockType sl (shard.mLock, __FILE__, __LINE__);
 
     bool created;
-    return findCreateEntry (index, created).getFlags ();
+    return findCreateEntry (shard, index, created).getFlags ();
 }
 
 bool HashRouter::addSuppressionFlags (uint256 const& index, int flag)
 {
-    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    Shard& shard (getShard (index));
+    ScopedLockType sl (shard.mLock, __FILE__, __LINE__);
 
     bool created;
-    findCreateEntry (index, created).setFlag (flag);
+    findCreateEntry (shard, index, created).setFlag (flag);
     return created;
 }
 
@@ -208,10 +335,11 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
     // return: true = changed, false = unchanged
     assert (flag != 0);
 
-    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    Shard& shard (getShard (index));
+    ScopedLockType sl (shard.mLock, __FILE__, __LINE__);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = findCreateEntry (shard, index, created);
 
     if ((s.getFlags () & flag) == flag)
         return false;
@@ -222,10 +350,11 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
 
 bool HashRouter::swapSet (uint256 const& index, std::set<uint64>& peers, int flag)
 {
-    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    Shard& shard (getShard (index));
+    ScopedLockType sl (shard.mLock, __FILE__, __LINE__);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = findCreateEntry (shard, index, created);
 
     if ((s.getFlags () & flag) == flag)
         return false;
@@ -240,3 +369,65 @@ IHashRouter* IHashRouter::New (int holdTime)
 {
     return new HashRouter (holdTime);
 }
+
+//------------------------------------------------------------------------------
+
+class HashRouterTests : public UnitTest
+{
+public:
+    HashRouterTests () : UnitTest ("HashRouter", "ripple")
+    {
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("peers");
+
+        HashRouter router (2);
+        uint256 const a (1);
+        uint256 const b (2);
+
+        expect (router.addSuppressionPeer (a, 1));
+        expect (!router.addSuppressionPeer (a, 1));
+
+        // More peers than fit inline
+        for (uint64 peer = 2; peer <= 10; ++peer)
+            router.addSuppressionPeer (a, peer);
+        router.addSuppressionPeer (a, 7);
+
+        std::set <uint64> peers;
+        expect (router.swapSet (a, peers, SF_RELAYED));
+        expect (peers.size () == 10);
+        expect (peers.count (1) == 1 && peers.count (10) == 1);
+        expect (!router.swapSet (a, peers, SF_RELAYED), "already relayed");
+
+        beginTestCase ("flags");
+
+        expect (router.addSuppressionFlags (b, SF_BAD));
+        expect (!router.setFlag (b, SF_BAD));
+        expect (router.setFlag (b, SF_SIGGOOD));
+        expect (router.getFlags (b) == (SF_BAD | SF_SIGGOOD));
+
+        beginTestCase ("expiry");
+
+        // A hold time of two seconds gives three slots
+        HashRouter::Shard shard;
+        shard.mWheel.resize (3);
+        shard.mWheelTime = 100;
+
+        shard.mSuppressionMap.emplace (a, HashRouter::Entry ());
+        shard.mWheel [100 % 3].push_back (a);
+
+        router.expire (shard, 102);
+        expect (shard.mSuppressionMap.size () == 1, "held for the hold time");
+        router.expire (shard, 103);
+        expect (shard.mSuppressionMap.empty (), "expired after the hold time");
+
+        shard.mSuppressionMap.emplace (b, HashRouter::Entry ());
+        shard.mWheel [103 % 3].push_back (b);
+        router.expire (shard, 500);
+        expect (shard.mSuppressionMap.empty (), "expired after a long gap");
+    }
+};
+
+static HashRouterTests hashRouterTests;
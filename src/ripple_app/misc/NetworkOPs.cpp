@@ -33,9 +33,13 @@ public:
 public:
     // VFALCO TODO Make LedgerMaster a SharedPtr or a reference.
     //
-    NetworkOPsImp (LedgerMaster& ledgerMaster, Stoppable& parent, Journal journal)
+    NetworkOPsImp (LedgerMaster& ledgerMaster, Stoppable& parent,
+        shared_ptr <insight::Collector> const& collector, Journal journal)
         : NetworkOPs (parent)
         , m_journal (journal)
+        , m_collector (collector)
+        , m_consensusMetrics (collector)
+        , m_commandLock (this, "NetOPs::commands", __FILE__, __LINE__)
         , mLock (this, "NetOPs", __FILE__, __LINE__)
         , mMode (omDISCONNECTED)
         , mNeedNetworkLedger (false)
@@ -249,6 +253,27 @@ public:
     void setStateTimer ();
     
     void newLCL (int proposers, int convergeTime, uint256 const& ledgerHash);
+
+    void recordCommandLatency (std::string const& command, uint64 microseconds)
+    {
+        insight::Histogram latency;
+
+        {
+            RippleMutex::ScopedLockType sl (m_commandLock, __FILE__, __LINE__);
+
+            std::map <std::string, insight::Histogram>::iterator iter (
+                m_commandLatency.find (command));
+
+            if (iter == m_commandLatency.end ())
+                iter = m_commandLatency.insert (std::make_pair (command,
+                    m_collector->make_histogram ("rpc_" + command + "_us"))).first;
+
+            latency = iter->second;
+        }
+
+        latency.record (microseconds);
+    }
+
     void needNetworkLedger ()
     {
         mNeedNetworkLedger = true;
@@ -392,12 +417,52 @@ private:
     void setMode (OperatingMode);
 
     Json::Value transJson (const SerializedTransaction& stTxn, TER terResult, bool bValidated, Ledger::ref lpCurrent);
+    Json::Value transBinaryJson (const AcceptedLedgerTx& alTx, bool bValidated, Ledger::ref lpCurrent);
     bool haveConsensusObject ();
 
     Json::Value pubBootstrapAccountInfo (Ledger::ref lpAccepted, const RippleAddress& naAccountID);
 
+    static uint32 getPageLength (int limit, bool binary, bool bAdmin);
+
+    // Pages through the account history store, false if it can't answer
+    bool fetchAccountHistory (const RippleAddress& account, int32 minLedger, int32 maxLedger,
+        bool forward, bool hasMarker, uint32 findLedger, uint32 findSeq, uint32 offset,
+        uint32 numberOfResults, AccountHistory::Page& page);
+
+    static std::pair<Transaction::pointer, TransactionMetaSet::pointer>
+        historyEntryTxn (const AccountHistory::Entry& entry);
+    static txnMetaLedgerType historyEntryBinary (const AccountHistory::Entry& entry);
+
+    /** Renders a transaction event on demand.
+        Each form is built at most once and only if some subscriber wants it,
+        so a stream with only binary subscribers never renders the JSON.
+    */
+    class TxnPayloads
+    {
+    public:
+        TxnPayloads (NetworkOPsImp& ops, Ledger::ref ledger,
+            const AcceptedLedgerTx& alTx, bool bValidated);
+
+        EventPayload::pointer getJson ();
+        EventPayload::pointer getBinary ();
+
+        EventPayload::pointer get (InfoSub::ref sub)
+        {
+            return sub->isBinary () ? getBinary () : getJson ();
+        }
+
+    private:
+        NetworkOPsImp& m_ops;
+        Ledger::ref m_ledger;
+        const AcceptedLedgerTx& m_alTx;
+        bool const m_validated;
+        EventPayload::pointer m_json;
+        EventPayload::pointer m_binary;
+    };
+
     void pubValidatedTransaction (Ledger::ref alAccepted, const AcceptedLedgerTx& alTransaction);
-    void pubAccountTransaction (Ledger::ref lpCurrent, const AcceptedLedgerTx& alTransaction, bool isAccepted);
+    void pubAccountTransaction (Ledger::ref lpCurrent, const AcceptedLedgerTx& alTransaction, bool isAccepted,
+        TxnPayloads& payloads);
 
     void pubServer ();
 
@@ -412,6 +477,13 @@ private:
     typedef LockType::ScopedLockType ScopedLockType;
 
     Journal m_journal;
+    shared_ptr <insight::Collector> m_collector;
+    LedgerConsensus::Metrics m_consensusMetrics;
+
+    // Created the first time each command is used
+    RippleMutex m_commandLock;
+    std::map <std::string, insight::Histogram> m_commandLatency;
+
     LockType mLock;
 
     OperatingMode                       mMode;
@@ -1404,7 +1476,8 @@ int NetworkOPsImp::beginConsensus (uint256 const& networkClosed, Ledger::pointer
     assert (!mConsensus);
     prevLedger->setImmutable ();
     mConsensus = boost::make_shared<LedgerConsensus> (
-                     networkClosed, prevLedger, m_ledgerMaster.getCurrentLedger ()->getCloseTimeNC ());
+                     networkClosed, prevLedger, m_ledgerMaster.getCurrentLedger ()->getCloseTimeNC (),
+                     m_consensusMetrics);
 
     m_journal.debug << "Initiating consensus engine";
     return mConsensus->startup ();
@@ -1619,8 +1692,7 @@ void NetworkOPsImp::pubServer ()
         jvObj ["load_base"]     = (mLastLoadBase = getApp().getFeeTrack ().getLoadBase ());
         jvObj ["load_factor"]   = (mLastLoadFactor = getApp().getFeeTrack ().getLoadFactor ());
 
-        Json::FastWriter w;
-        std::string sObj = w.write (jvObj);
+        EventPayload::pointer const payload (EventPayload::New (jvObj));
 
         NetworkOPsImp::SubMapType::const_iterator it = mSubServer.begin ();
 
@@ -1632,7 +1704,7 @@ void NetworkOPsImp::pubServer ()
             //             the deletion of subscribers with the sending of JSON data.
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                p->send (payload, true);
 
                 ++it;
             }
@@ -1674,24 +1746,75 @@ void NetworkOPsImp::setMode (OperatingMode om)
 }
 
 
+uint32 NetworkOPsImp::getPageLength (int limit, bool binary, bool bAdmin)
+{
+    uint32 NONBINARY_PAGE_LENGTH = 200;
+    uint32 BINARY_PAGE_LENGTH = 500;
+
+    if (limit < 0)
+        return binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH;
+    else if (!bAdmin)
+        return std::min (binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH, static_cast<uint32> (limit));
+
+    return limit;
+}
+
+bool NetworkOPsImp::fetchAccountHistory (const RippleAddress& account, int32 minLedger, int32 maxLedger,
+    bool forward, bool hasMarker, uint32 findLedger, uint32 findSeq, uint32 offset,
+    uint32 numberOfResults, AccountHistory::Page& page)
+{
+    AccountHistory* const history = getApp().getAccountHistory ();
+
+    if ((history == nullptr) || (minLedger < 0) || (maxLedger < 0))
+        return false;
+
+    AccountHistory::Query query;
+    query.account = account.getAccountID ();
+    query.minLedger = minLedger;
+    query.maxLedger = maxLedger;
+    query.forward = forward;
+    query.hasMarker = hasMarker;
+    query.marker = AccountHistory::Marker (findLedger, findSeq);
+    query.offset = offset;
+    query.limit = numberOfResults;
+
+    return history->fetch (query, page);
+}
+
+std::pair<Transaction::pointer, TransactionMetaSet::pointer>
+NetworkOPsImp::historyEntryTxn (const AccountHistory::Entry& entry)
+{
+    Serializer rawTxn (entry.rawTxn);
+    SerializerIterator sit (rawTxn);
+
+    Transaction::pointer txn = boost::make_shared<Transaction> (
+        boost::make_shared<SerializedTransaction> (boost::ref (sit)), false);
+    txn->setStatus (COMMITTED);
+    txn->setLedger (entry.position.ledgerSeq);
+
+    TransactionMetaSet::pointer meta = boost::make_shared<TransactionMetaSet> (
+        txn->getID (), entry.position.ledgerSeq, entry.rawMeta);
+
+    return std::make_pair (txn, meta);
+}
+
+NetworkOPsImp::txnMetaLedgerType
+NetworkOPsImp::historyEntryBinary (const AccountHistory::Entry& entry)
+{
+    return boost::make_tuple (strHex (entry.rawTxn), strHex (entry.rawMeta), entry.position.ledgerSeq);
+}
+
 std::string
 NetworkOPsImp::transactionsSQL (std::string selection, const RippleAddress& account,
                              int32 minLedger, int32 maxLedger, bool descending, uint32 offset, int limit,
                              bool binary, bool count, bool bAdmin)
 {
-    uint32 NONBINARY_PAGE_LENGTH = 200;
-    uint32 BINARY_PAGE_LENGTH = 500;
-
     uint32 numberOfResults;
 
     if (count)
         numberOfResults = 1000000000;
-    else if (limit < 0)
-        numberOfResults = binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH;
-    else if (!bAdmin)
-        numberOfResults = std::min (binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH, static_cast<uint32> (limit));
     else
-        numberOfResults = limit;
+        numberOfResults = getPageLength (limit, binary, bAdmin);
 
     std::string maxClause = "";
     std::string minClause = "";
@@ -1741,6 +1864,15 @@ NetworkOPsImp::getAccountTxs (const RippleAddress& account, int32 minLedger, int
     // can be called with no locks
     std::vector< std::pair<Transaction::pointer, TransactionMetaSet::pointer> > ret;
 
+    AccountHistory::Page page;
+    if (fetchAccountHistory (account, minLedger, maxLedger, !descending, false, 0, 0,
+        offset, getPageLength (limit, false, bAdmin), page))
+    {
+        BOOST_FOREACH (const AccountHistory::Entry& entry, page.entries)
+            ret.push_back (historyEntryTxn (entry));
+        return ret;
+    }
+
     std::string sql = NetworkOPsImp::transactionsSQL ("AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta", account,
                       minLedger, maxLedger, descending, offset, limit, false, false, bAdmin);
 
@@ -1794,6 +1926,15 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
     // can be called with no locks
     std::vector< txnMetaLedgerType> ret;
 
+    AccountHistory::Page page;
+    if (fetchAccountHistory (account, minLedger, maxLedger, !descending, false, 0, 0,
+        offset, getPageLength (limit, true, bAdmin), page))
+    {
+        BOOST_FOREACH (const AccountHistory::Entry& entry, page.entries)
+            ret.push_back (historyEntryBinary (entry));
+        return ret;
+    }
+
     std::string sql = NetworkOPsImp::transactionsSQL ("AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta", account,
                       minLedger, maxLedger, descending, offset, limit, true/*binary*/, false, bAdmin);
 
@@ -1874,6 +2015,22 @@ NetworkOPsImp::getTxsAccount (const RippleAddress& account, int32 minLedger, int
     //         outputs, so we need to clear it in between.
     token = Json::nullValue;
 
+    AccountHistory::Page page;
+    if (fetchAccountHistory (account, minLedger, maxLedger, forward, !foundResume, findLedger, findSeq,
+        0, numberOfResults, page))
+    {
+        BOOST_FOREACH (const AccountHistory::Entry& entry, page.entries)
+            ret.push_back (historyEntryTxn (entry));
+
+        if (page.more)
+        {
+            token = Json::objectValue;
+            token["ledger"] = page.next.ledgerSeq;
+            token["seq"] = page.next.txnSeq;
+        }
+        return ret;
+    }
+
     std::string sql = boost::str (boost::format
         ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
          "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
@@ -1984,6 +2141,22 @@ NetworkOPsImp::getTxsAccountB (const RippleAddress& account, int32 minLedger, in
 
     token = Json::nullValue;
 
+    AccountHistory::Page page;
+    if (fetchAccountHistory (account, minLedger, maxLedger, forward, !foundResume, findLedger, findSeq,
+        0, numberOfResults, page))
+    {
+        BOOST_FOREACH (const AccountHistory::Entry& entry, page.entries)
+            ret.push_back (historyEntryBinary (entry));
+
+        if (page.more)
+        {
+            token = Json::objectValue;
+            token["ledger"] = page.next.ledgerSeq;
+            token["seq"] = page.next.txnSeq;
+        }
+        return ret;
+    }
+
     std::string sql = boost::str (boost::format
         ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
          "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
@@ -2275,7 +2448,8 @@ Json::Value NetworkOPsImp::pubBootstrapAccountInfo (Ledger::ref lpAccepted, cons
 
 void NetworkOPsImp::pubProposedTransaction (Ledger::ref lpCurrent, SerializedTransaction::ref stTxn, TER terResult)
 {
-    Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
+    AcceptedLedgerTx alt (stTxn, terResult);
+    TxnPayloads payloads (*this, lpCurrent, alt, false);
 
     {
         ScopedLockType sl (mLock, __FILE__, __LINE__);
@@ -2287,16 +2461,15 @@ void NetworkOPsImp::pubProposedTransaction (Ledger::ref lpCurrent, SerializedTra
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (payloads.get (p), true);
                 ++it;
             }
             else
                 it = mSubRTTransactions.erase (it);
         }
     }
-    AcceptedLedgerTx alt (stTxn, terResult);
     m_journal.trace << "pubProposed: " << alt.getJson ();
-    pubAccountTransaction (lpCurrent, AcceptedLedgerTx (stTxn, terResult), false);
+    pubAccountTransaction (lpCurrent, alt, false, payloads);
 }
 
 void NetworkOPsImp::pubLedger (Ledger::ref accepted)
@@ -2329,6 +2502,8 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
             if (mMode >= omSYNCING)
                 jvObj["validated_ledgers"]  = getApp().getLedgerMaster ().getCompleteLedgers ();
 
+            EventPayload::pointer const payload (EventPayload::New (jvObj));
+
             NetworkOPsImp::SubMapType::const_iterator it = mSubLedger.begin ();
 
             while (it != mSubLedger.end ())
@@ -2337,7 +2512,7 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
 
                 if (p)
                 {
-                    p->send (jvObj, true);
+                    p->send (payload, true);
                     ++it;
                 }
                 else
@@ -2403,13 +2578,92 @@ Json::Value NetworkOPsImp::transJson (const SerializedTransaction& stTxn, TER te
     return jvObj;
 }
 
-void NetworkOPsImp::pubValidatedTransaction (Ledger::ref alAccepted, const AcceptedLedgerTx& alTx)
+// Like transJson, but the transaction and its metadata are returned as the
+// canonical serialized blobs rather than being expanded into JSON.
+Json::Value NetworkOPsImp::transBinaryJson (const AcceptedLedgerTx& alTx, bool bValidated,
+                                   Ledger::ref lpCurrent)
 {
-    Json::Value jvObj   = transJson (*alTx.getTxn (), alTx.getResult (), true, alAccepted);
-    jvObj["meta"] = alTx.getMeta ()->getJson (0);
+    Json::Value jvObj (Json::objectValue);
+    std::string sToken;
+    std::string sHuman;
 
-    Json::FastWriter w;
-    std::string sObj = w.write (jvObj);
+    transResultInfo (alTx.getResult (), sToken, sHuman);
+
+    jvObj["type"]           = "transaction";
+    jvObj["hash"]           = alTx.getTransactionID ().GetHex ();
+    jvObj["tx_blob"]        = strHex (alTx.getTxn ()->getSerializer ().peekData ());
+
+    if (!alTx.getRawMeta ().empty ())
+    {
+        jvObj["meta"]       = strHex (alTx.getRawMeta ());
+    }
+    else if (alTx.isApplied ())
+    {
+        Serializer s;
+        alTx.getMeta ()->getAsObject ().add (s);
+        jvObj["meta"]       = strHex (s.peekData ());
+    }
+
+    if (bValidated)
+    {
+        jvObj["ledger_index"]           = lpCurrent->getLedgerSeq ();
+        jvObj["ledger_hash"]            = lpCurrent->getHash ().ToString ();
+        jvObj["date"]                   = lpCurrent->getCloseTimeNC ();
+        jvObj["validated"]              = true;
+    }
+    else
+    {
+        jvObj["validated"]              = false;
+        jvObj["ledger_current_index"]   = lpCurrent->getLedgerSeq ();
+    }
+
+    jvObj["status"]                 = bValidated ? "closed" : "proposed";
+    jvObj["engine_result"]          = sToken;
+    jvObj["engine_result_code"]     = alTx.getResult ();
+    jvObj["engine_result_message"]  = sHuman;
+
+    return jvObj;
+}
+
+NetworkOPsImp::TxnPayloads::TxnPayloads (NetworkOPsImp& ops, Ledger::ref ledger,
+    const AcceptedLedgerTx& alTx, bool bValidated)
+    : m_ops (ops)
+    , m_ledger (ledger)
+    , m_alTx (alTx)
+    , m_validated (bValidated)
+{
+}
+
+EventPayload::pointer NetworkOPsImp::TxnPayloads::getJson ()
+{
+    if (!m_json)
+    {
+        Json::Value jvObj = m_ops.transJson (*m_alTx.getTxn (), m_alTx.getResult (), m_validated, m_ledger);
+
+        if (m_alTx.isApplied ())
+            jvObj["meta"] = m_alTx.getMeta ()->getJson (0);
+
+        m_json = EventPayload::New (jvObj);
+    }
+
+    return m_json;
+}
+
+EventPayload::pointer NetworkOPsImp::TxnPayloads::getBinary ()
+{
+    if (!m_binary)
+    {
+        Json::Value jvObj = m_ops.transBinaryJson (m_alTx, m_validated, m_ledger);
+
+        m_binary = EventPayload::New (jvObj);
+    }
+
+    return m_binary;
+}
+
+void NetworkOPsImp::pubValidatedTransaction (Ledger::ref alAccepted, const AcceptedLedgerTx& alTx)
+{
+    TxnPayloads payloads (*this, alAccepted, alTx, true);
 
     {
         ScopedLockType sl (mLock, __FILE__, __LINE__);
@@ -2422,7 +2676,7 @@ void NetworkOPsImp::pubValidatedTransaction (Ledger::ref alAccepted, const Accep
 
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                p->send (payloads.get (p), true);
                 ++it;
             }
             else
@@ -2437,18 +2691,20 @@ void NetworkOPsImp::pubValidatedTransaction (Ledger::ref alAccepted, const Accep
 
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                p->send (payloads.get (p), true);
                 ++it;
             }
             else
                 it = mSubRTTransactions.erase (it);
         }
     }
-    getApp().getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
-    pubAccountTransaction (alAccepted, alTx, true);
+    getApp().getOrderBookDB ().processTxn (alAccepted, alTx,
+        BIND_TYPE (&TxnPayloads::get, &payloads, P_1));
+    pubAccountTransaction (alAccepted, alTx, true, payloads);
 }
 
-void NetworkOPsImp::pubAccountTransaction (Ledger::ref lpCurrent, const AcceptedLedgerTx& alTx, bool bAccepted)
+void NetworkOPsImp::pubAccountTransaction (Ledger::ref lpCurrent, const AcceptedLedgerTx& alTx, bool bAccepted,
+    TxnPayloads& payloads)
 {
     boost::unordered_set<InfoSub::pointer>  notify;
     int                             iProposed   = 0;
@@ -2514,17 +2770,9 @@ void NetworkOPsImp::pubAccountTransaction (Ledger::ref lpCurrent, const Accepted
 
     if (!notify.empty ())
     {
-        Json::Value jvObj   = transJson (*alTx.getTxn (), alTx.getResult (), bAccepted, lpCurrent);
-
-        if (alTx.isApplied ())
-            jvObj["meta"] = alTx.getMeta ()->getJson (0);
-
-        Json::FastWriter w;
-        std::string sObj = w.write (jvObj);
-
         BOOST_FOREACH (InfoSub::ref isrListener, notify)
         {
-            isrListener->send (jvObj, sObj, true);
+            isrListener->send (payloads.get (isrListener), true);
         }
     }
 }
@@ -3092,9 +3340,10 @@ NetworkOPs::NetworkOPs (Stoppable& parent)
 //------------------------------------------------------------------------------
 
 NetworkOPs* NetworkOPs::New (LedgerMaster& ledgerMaster,
-    Stoppable& parent, Journal journal)
+    Stoppable& parent, shared_ptr <insight::Collector> const& collector,
+        Journal journal)
 {
     ScopedPointer <NetworkOPs> object (new NetworkOPsImp (
-        ledgerMaster, parent, journal));
+        ledgerMaster, parent, collector, journal));
     return object.release ();
 }
@@ -81,7 +81,8 @@ public:
     // VFALCO TODO Make LedgerMaster a SharedPtr or a reference.
     //
     static NetworkOPs* New (LedgerMaster& ledgerMaster,
-        Stoppable& parent, Journal journal);
+        Stoppable& parent, shared_ptr <insight::Collector> const& collector,
+            Journal journal);
 
     virtual ~NetworkOPs () { }
 
@@ -253,6 +254,10 @@ public:
     virtual uint32 getLastCloseTime () = 0;
     virtual void setLastCloseTime (uint32 t) = 0;
 
+    // Reports how long a client command took, by command name
+    virtual void recordCommandLatency (std::string const& command,
+        uint64 microseconds) = 0;
+
     virtual Json::Value getConsensusInfo () = 0;
     virtual Json::Value getServerInfo (bool human, bool admin) = 0;
     virtual void clearLedgerFetch () = 0;
@@ -0,0 +1,315 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+class PublicKeyCacheImp
+    : public PublicKeyCache
+    , public LeakChecked <PublicKeyCacheImp>
+{
+public:
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    typedef boost::shared_ptr <Secp256k1::PublicKey const> KeyPtr;
+
+    enum
+    {
+        // Uses before a key gets the large tables
+        promoteAfter = 32,
+
+        // One key in this many may have the large tables
+        promotedFraction = 16,
+
+        // Lookups per update of the hit rate gauge
+        rateSamples = 1000
+    };
+
+    //--------------------------------------------------------------------------
+
+    PublicKeyCacheImp (int cacheSize,
+        shared_ptr <insight::Collector> const& collector)
+        : m_lock (this, "PublicKeyCache", __FILE__, __LINE__)
+        , m_cacheSize (std::max (1, cacheSize))
+        , m_maxPromoted (std::max (1, cacheSize / promotedFraction))
+        , m_promoted (0)
+        , m_lookups (0)
+        , m_lookupHits (0)
+    {
+        m_hits = collector->make_meter ("pubkey_cache_hits");
+        m_misses = collector->make_meter ("pubkey_cache_misses");
+        m_hitPercent = collector->make_gauge ("pubkey_cache_hit_percent");
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool verify (uint256 const& hash,
+        Blob const& publicKey, Blob const& signature)
+    {
+        if (publicKey.empty () || signature.empty ())
+            return false;
+
+#if RIPPLE_USE_SECP256K1_VERIFY
+        Secp256k1::Signature parsed;
+
+        if (parsed.parse (signature))
+        {
+            KeyPtr const key (fetch (publicKey));
+
+            if (key)
+                return Secp256k1::verify (hash, parsed, *key);
+        }
+#endif
+
+        // Whatever the fast path refused goes through OpenSSL
+        RippleAddress signer;
+        signer.setAccountPublic (publicKey);
+        return signer.accountPublicVerify (hash, signature);
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Returns the parsed key, or an empty pointer if it cannot be parsed
+    KeyPtr fetch (Blob const& publicKey)
+    {
+        KeyPtr key;
+        bool promote (false);
+
+        {
+            ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+            Cache::iterator const iter (m_cache.find (publicKey));
+
+            if (iter != m_cache.end ())
+            {
+                Entry& entry (iter->second);
+
+                // Most recently used moves to the front
+                m_order.splice (m_order.begin (), m_order, entry.order);
+
+                key = entry.key;
+
+                if (++entry.uses == promoteAfter && m_promoted < m_maxPromoted)
+                {
+                    ++m_promoted;
+                    entry.promoted = true;
+                    promote = true;
+                }
+            }
+
+            sample (key.get () != nullptr);
+        }
+
+        if (key)
+        {
+            ++m_hits;
+
+            if (promote)
+            {
+                // Build the large tables outside the lock. Callers already
+                // holding the old tables keep using them safely.
+                boost::shared_ptr <Secp256k1::PublicKey> promoted (
+                    boost::make_shared <Secp256k1::PublicKey> (*key));
+                promoted->precompute (Secp256k1::maximumWindow);
+                replace (publicKey, promoted);
+            }
+
+            return key;
+        }
+
+        ++m_misses;
+
+        boost::shared_ptr <Secp256k1::PublicKey> parsed (
+            boost::make_shared <Secp256k1::PublicKey> ());
+
+        if (! parsed->parse (publicKey))
+            return KeyPtr ();
+
+        insert (publicKey, parsed);
+
+        return parsed;
+    }
+
+    // Updates the hit rate gauge, called with the lock held
+    void sample (bool hit)
+    {
+        ++m_lookups;
+
+        if (hit)
+            ++m_lookupHits;
+
+        if (m_lookups >= rateSamples)
+        {
+            m_hitPercent = (m_lookupHits * 100) / m_lookups;
+            m_lookups = 0;
+            m_lookupHits = 0;
+        }
+    }
+
+    void insert (Blob const& publicKey, KeyPtr const& key)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        // Another thread may have parsed the same key meanwhile
+        if (m_cache.find (publicKey) != m_cache.end ())
+            return;
+
+        m_order.push_front (publicKey);
+
+        Entry entry;
+        entry.key = key;
+        entry.order = m_order.begin ();
+        m_cache.emplace (publicKey, entry);
+
+        if (m_cache.size () > m_cacheSize)
+        {
+            Cache::iterator const oldest (m_cache.find (m_order.back ()));
+
+            if (oldest->second.promoted)
+                --m_promoted;
+
+            m_cache.erase (oldest);
+            m_order.pop_back ();
+        }
+    }
+
+    void replace (Blob const& publicKey, KeyPtr const& key)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        Cache::iterator const iter (m_cache.find (publicKey));
+
+        // The key may have been evicted while its tables were built
+        if (iter != m_cache.end ())
+            iter->second.key = key;
+    }
+
+private:
+    typedef std::list <Blob> Order;
+
+    struct Entry
+    {
+        Entry ()
+            : uses (0)
+            , promoted (false)
+        {
+        }
+
+        KeyPtr key;
+        Order::iterator order;
+        int uses;
+        bool promoted;
+    };
+
+    typedef boost::unordered_map <Blob, Entry> Cache;
+
+    LockType m_lock;
+    Cache m_cache;
+    Order m_order;
+
+    std::size_t const m_cacheSize;
+    int const m_maxPromoted;
+    int m_promoted;
+
+    uint64 m_lookups;
+    uint64 m_lookupHits;
+
+    insight::Meter m_hits;
+    insight::Meter m_misses;
+    insight::Gauge m_hitPercent;
+
+    friend class PublicKeyCacheTests;
+};
+
+//------------------------------------------------------------------------------
+
+PublicKeyCache* PublicKeyCache::New (int cacheSize,
+    shared_ptr <insight::Collector> const& collector)
+{
+    return new PublicKeyCacheImp (cacheSize, collector);
+}
+
+//------------------------------------------------------------------------------
+
+class PublicKeyCacheTests : public UnitTest
+{
+public:
+    PublicKeyCacheTests () : UnitTest ("PublicKeyCache", "ripple")
+    {
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("verify");
+
+        PublicKeyCacheImp cache (2, insight::NullCollector::New ());
+
+        std::vector <RippleAddress> publicKeys;
+        std::vector <RippleAddress> privateKeys;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            RippleAddress const seed (RippleAddress::createSeedRandom ());
+            RippleAddress const generator (RippleAddress::createGeneratorPublic (seed));
+            publicKeys.push_back (RippleAddress::createAccountPublic (generator, 1));
+            privateKeys.push_back (RippleAddress::createAccountPrivate (generator, seed, 1));
+        }
+
+        for (int round = 0; round < PublicKeyCacheImp::promoteAfter + 2; ++round)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                // The first key is used far more often than the others
+                if (i != 0 && round % 8 != 0)
+                    continue;
+
+                uint256 const hash (round * 3 + i + 1);
+                Blob sig;
+                privateKeys [i].accountPrivateSign (hash, sig);
+
+                Blob const& key (publicKeys [i].getAccountPublic ());
+                expect (cache.verify (hash, key, sig), "Should verify");
+                expect (! cache.verify (uint256 (1000 + round), key, sig),
+                    "Should not verify");
+            }
+        }
+
+        expect (cache.m_cache.size () == 2, "Cache exceeds its size");
+
+        Cache::iterator const iter (cache.m_cache.find (
+            publicKeys [0].getAccountPublic ()));
+        expect (iter != cache.m_cache.end (), "Hot key was evicted");
+
+        if (iter != cache.m_cache.end ())
+        {
+            expect (iter->second.promoted);
+            expect (iter->second.key->getWindow () == Secp256k1::maximumWindow,
+                "Hot key was not promoted");
+        }
+
+        // Unparseable keys fall back and fail
+        Blob const badKey (33, 0);
+        Blob sig;
+        privateKeys [0].accountPrivateSign (uint256 (1), sig);
+        expect (! cache.verify (uint256 (1), badKey, sig));
+    }
+
+private:
+    typedef PublicKeyCacheImp::Cache Cache;
+};
+
+static PublicKeyCacheTests publicKeyCacheTests;
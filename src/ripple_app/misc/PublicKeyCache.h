@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_PUBLICKEYCACHE_H_INCLUDED
+#define RIPPLE_APP_PUBLICKEYCACHE_H_INCLUDED
+
+/** Remembers parsed public keys of repeat signers.
+
+    Before a signature can be checked its public key must be decompressed
+    and expanded into the tables used by Secp256k1, which is a sizeable part
+    of each verify. A small set of accounts and validators produce most of
+    the signatures we see, so parsed keys are kept in a bounded, least
+    recently used cache. Keys which keep coming back are promoted to larger
+    tables that make each verify cheaper still.
+
+    Lookups are reported to the collector as "pubkey_cache_hits" and
+    "pubkey_cache_misses", and the hit rate over recent lookups as the
+    gauge "pubkey_cache_hit_percent".
+*/
+class PublicKeyCache
+{
+public:
+    /** Create the cache.
+
+        @param cacheSize The number of keys to remember.
+    */
+    static PublicKeyCache* New (int cacheSize,
+        shared_ptr <insight::Collector> const& collector);
+
+    virtual ~PublicKeyCache () { }
+
+    /** Verify a signature by an account or node public key.
+
+        Keys or signatures which the fast verifier does not accept are
+        checked by OpenSSL instead, so the result is the same either way.
+
+        @param publicKey The public key, in its binary form.
+        @return `true` if the signature is valid.
+    */
+    virtual bool verify (uint256 const& hash,
+        Blob const& publicKey, Blob const& signature) = 0;
+};
+
+#endif
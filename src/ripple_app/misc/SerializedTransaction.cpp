@@ -195,10 +195,9 @@ bool SerializedTransaction::checkSign () const
 
     try
     {
-        RippleAddress n;
-        n.setAccountPublic (getFieldVL (sfSigningPubKey));
-
-        if (checkSign (n))
+        // Repeat signers hit the cache of parsed public keys
+        if (getApp ().getPublicKeyCache ().verify (getSigningHash (),
+            getFieldVL (sfSigningPubKey), getFieldVL (sfTxnSignature)))
         {
             mSigGood = true;
             return true;
@@ -0,0 +1,347 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+class SignatureVerifierImp
+    : public SignatureVerifier
+    , public LeakChecked <SignatureVerifierImp>
+{
+public:
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    // Tracks the threads working on one batch
+    //
+    struct Batch
+    {
+        typedef boost::shared_ptr <Batch> Ptr;
+
+        explicit Batch (int tasks)
+        {
+            remaining = tasks;
+        }
+
+        Atomic <int> remaining;
+        WaitableEvent done;
+    };
+
+    //--------------------------------------------------------------------------
+
+    class Worker : public Thread
+    {
+    public:
+        explicit Worker (SignatureVerifierImp& owner)
+            : Thread ("SigVerify")
+            , m_owner (owner)
+        {
+            startThread ();
+        }
+
+        ~Worker ()
+        {
+            stopThread ();
+        }
+
+        void run ()
+        {
+            m_owner.m_service.run ();
+        }
+
+    private:
+        SignatureVerifierImp& m_owner;
+    };
+
+    //--------------------------------------------------------------------------
+
+    SignatureVerifierImp (int threads, int cacheSize,
+        PublicKeyCache& publicKeys,
+            shared_ptr <insight::Collector> const& collector)
+        : m_publicKeys (publicKeys)
+        , m_lock (this, "SignatureVerifier", __FILE__, __LINE__)
+        , m_work (new boost::asio::io_service::work (m_service))
+        , m_cacheSize (std::max (1, cacheSize))
+    {
+        m_hits = collector->make_meter ("sig_cache_hits");
+        m_misses = collector->make_meter ("sig_cache_misses");
+        m_verifyLatency = collector->make_event ("sig_verify_us");
+        m_batchLatency = collector->make_event ("sig_batch_ms");
+
+        for (int i = 0; i < threads; ++i)
+            m_workers.add (new Worker (*this));
+    }
+
+    ~SignatureVerifierImp ()
+    {
+        m_work = nullptr;
+        m_service.stop ();
+        m_workers.clear ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool verify (uint256 const& signingHash,
+        Blob const& publicKey, Blob const& signature)
+    {
+        uint256 const key (getKey (signingHash, publicKey, signature));
+
+        bool valid;
+
+        if (lookup (key, valid))
+        {
+            ++m_hits;
+            return valid;
+        }
+
+        ++m_misses;
+
+        valid = check (signingHash, publicKey, signature);
+
+        insert (key, valid);
+
+        return valid;
+    }
+
+    void verifyBatch (Checks& checks)
+    {
+        double const start = Time::getMillisecondCounterHiRes ();
+
+        std::vector <uint256> keys;
+        std::vector <std::size_t> misses;
+
+        keys.reserve (checks.size ());
+
+        for (std::size_t i = 0; i < checks.size (); ++i)
+        {
+            Check& c (checks [i]);
+            keys.push_back (getKey (c.signingHash, c.publicKey, c.signature));
+
+            if (lookup (keys.back (), c.valid))
+            {
+                ++m_hits;
+            }
+            else
+            {
+                ++m_misses;
+                misses.push_back (i);
+            }
+        }
+
+        int const tasks = std::min <int> (m_workers.size (), misses.size ());
+
+        if (tasks <= 1)
+        {
+            runTask (checks, misses, 0, 1);
+        }
+        else
+        {
+            Batch::Ptr batch (boost::make_shared <Batch> (tasks));
+
+            for (int task = 0; task < tasks; ++task)
+            {
+                m_service.post (boost::bind (&SignatureVerifierImp::runBatchTask, this,
+                    boost::ref (checks), boost::cref (misses), task, tasks, batch));
+            }
+
+            batch->done.wait ();
+        }
+
+        for (std::size_t i = 0; i < misses.size (); ++i)
+            insert (keys [misses [i]], checks [misses [i]].valid);
+
+        m_batchLatency.notify (static_cast <insight::Event::value_type> (
+            Time::getMillisecondCounterHiRes () - start));
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Checks every `tasks`th signature which was not in the cache
+    //
+    void runTask (Checks& checks, std::vector <std::size_t> const& misses,
+        int task, int tasks)
+    {
+        for (std::size_t i = task; i < misses.size (); i += tasks)
+        {
+            Check& c (checks [misses [i]]);
+            c.valid = check (c.signingHash, c.publicKey, c.signature);
+        }
+    }
+
+    void runBatchTask (Checks& checks, std::vector <std::size_t> const& misses,
+        int task, int tasks, Batch::Ptr batch)
+    {
+        runTask (checks, misses, task, tasks);
+
+        if (--batch->remaining == 0)
+            batch->done.signal ();
+    }
+
+    bool check (uint256 const& signingHash,
+        Blob const& publicKey, Blob const& signature)
+    {
+        double const start = Time::getMillisecondCounterHiRes ();
+
+        bool valid = false;
+
+        try
+        {
+            valid = m_publicKeys.verify (signingHash, publicKey, signature);
+        }
+        catch (...)
+        {
+            valid = false;
+        }
+
+        m_verifyLatency.notify (static_cast <insight::Event::value_type> (
+            (Time::getMillisecondCounterHiRes () - start) * 1000));
+
+        return valid;
+    }
+
+    //--------------------------------------------------------------------------
+
+    // The signature is part of the key. Otherwise a message carrying a
+    // bad signature would pass once the same hash had been seen correctly
+    // signed by the same key.
+    //
+    static uint256 getKey (uint256 const& signingHash,
+        Blob const& publicKey, Blob const& signature)
+    {
+        Serializer s (32 + publicKey.size () + signature.size () + 4);
+        s.add256 (signingHash);
+        s.addVL (publicKey);
+        s.addVL (signature);
+        return s.getSHA512Half ();
+    }
+
+    bool lookup (uint256 const& key, bool& valid)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        Cache::iterator const iter (m_cache.find (key));
+
+        if (iter == m_cache.end ())
+            return false;
+
+        // Most recently used moves to the front
+        m_order.splice (m_order.begin (), m_order, iter->second.second);
+        valid = iter->second.first;
+        return true;
+    }
+
+    void insert (uint256 const& key, bool valid)
+    {
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        Cache::iterator const iter (m_cache.find (key));
+
+        if (iter != m_cache.end ())
+        {
+            iter->second.first = valid;
+            return;
+        }
+
+        m_order.push_front (key);
+        m_cache.emplace (key, std::make_pair (valid, m_order.begin ()));
+
+        if (m_cache.size () > m_cacheSize)
+        {
+            m_cache.erase (m_order.back ());
+            m_order.pop_back ();
+        }
+    }
+
+private:
+    typedef std::list <uint256> Order;
+    typedef boost::unordered_map <uint256, std::pair <bool, Order::iterator> > Cache;
+
+    PublicKeyCache& m_publicKeys;
+    LockType m_lock;
+    Cache m_cache;
+    Order m_order;
+
+    boost::asio::io_service m_service;
+    ScopedPointer <boost::asio::io_service::work> m_work;
+    OwnedArray <Worker> m_workers;
+    std::size_t const m_cacheSize;
+
+    insight::Meter m_hits;
+    insight::Meter m_misses;
+    insight::Event m_verifyLatency;
+    insight::Event m_batchLatency;
+};
+
+//------------------------------------------------------------------------------
+
+SignatureVerifier* SignatureVerifier::New (int threads, int cacheSize,
+    PublicKeyCache& publicKeys,
+        shared_ptr <insight::Collector> const& collector)
+{
+    return new SignatureVerifierImp (threads, cacheSize, publicKeys, collector);
+}
+
+//------------------------------------------------------------------------------
+
+class SignatureVerifierTests : public UnitTest
+{
+public:
+    SignatureVerifierTests () : UnitTest ("SignatureVerifier", "ripple")
+    {
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("verify");
+
+        RippleAddress const seed (RippleAddress::createSeedRandom ());
+        RippleAddress const privateKey (RippleAddress::createNodePrivate (seed));
+        RippleAddress const publicKey (RippleAddress::createNodePublic (seed));
+
+        ScopedPointer <PublicKeyCache> publicKeys (PublicKeyCache::New (
+            4, insight::NullCollector::New ()));
+        SignatureVerifierImp verifier (2, 4, *publicKeys, insight::NullCollector::New ());
+
+        SignatureVerifier::Checks checks;
+
+        for (int i = 0; i < 8; ++i)
+        {
+            SignatureVerifier::Check c;
+            c.signingHash = uint256 (i + 1);
+            c.publicKey = publicKey.getNodePublic ();
+            privateKey.signNodePrivate (c.signingHash, c.signature);
+            checks.push_back (c);
+        }
+
+        // The signature no longer matches the hash
+        checks [3].signingHash = uint256 (100);
+
+        expect (verifier.verify (checks [0].signingHash, checks [0].publicKey, checks [0].signature));
+        expect (! verifier.verify (checks [3].signingHash, checks [3].publicKey, checks [3].signature));
+
+        // A cached result must not vouch for a different signature
+        expect (! verifier.verify (checks [0].signingHash, checks [0].publicKey, checks [1].signature));
+
+        beginTestCase ("batch");
+
+        verifier.verifyBatch (checks);
+
+        for (std::size_t i = 0; i < checks.size (); ++i)
+            expect (checks [i].valid == (i != 3));
+    }
+};
+
+static SignatureVerifierTests signatureVerifierTests;
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_SIGNATUREVERIFIER_H_INCLUDED
+#define RIPPLE_APP_SIGNATUREVERIFIER_H_INCLUDED
+
+/** Verifies the node signatures on validations and proposals.
+
+    Results are remembered in a least recently used cache keyed by the
+    signing hash, public key and signature. A message which is seen again
+    costs a lookup rather than an ECDSA verify. Batches of signatures are
+    spread over a small pool of threads.
+
+    The time taken by each verify, in microseconds, is reported to the
+    collector as "sig_verify_us". Each batch, in milliseconds, is reported
+    as "sig_batch_ms".
+*/
+class SignatureVerifier
+{
+public:
+    /** One signature to check. */
+    struct Check
+    {
+        Check ()
+            : valid (false)
+        {
+        }
+
+        uint256 signingHash;
+        Blob publicKey;
+        Blob signature;
+
+        /** Set by verifyBatch. */
+        bool valid;
+    };
+
+    typedef std::vector <Check> Checks;
+
+    /** Create the verifier.
+
+        @param threads The number of threads which verify batches.
+        @param cacheSize The number of results to remember.
+        @param publicKeys Supplies parsed public keys for each verify.
+    */
+    static SignatureVerifier* New (int threads, int cacheSize,
+        PublicKeyCache& publicKeys,
+            shared_ptr <insight::Collector> const& collector);
+
+    virtual ~SignatureVerifier () { }
+
+    /** Verify one signature on the calling thread.
+
+        @param publicKey The node public key, in its binary form.
+        @return `true` if the signature is valid.
+    */
+    virtual bool verify (uint256 const& signingHash,
+        Blob const& publicKey, Blob const& signature) = 0;
+
+    /** Verify a batch of signatures in parallel.
+        The results are stored in each Check. This returns when the whole
+        batch has been checked.
+    */
+    virtual void verifyBatch (Checks& checks) = 0;
+};
+
+#endif
@@ -1993,6 +1993,8 @@ TER RippleCalc::rippleCalc (
     const bool          bOpenLedger
 )
 {
+    TransactionProfile::ScopedSection section (TransactionProfile::rippleCalc);
+
     assert (lesActive.isValid ());
     RippleCalc  rc (lesActive, bOpenLedger);
 
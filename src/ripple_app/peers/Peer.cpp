@@ -37,6 +37,8 @@ private:
     // These is up here to prevent warnings about order of initializations
     //
     Resource::Manager& m_resourceManager;
+    SSLHandshaker& m_handshaker;
+    insight::Histogram m_sendQueueDepth;
     bool m_isInbound;
 
 public:
@@ -62,14 +64,19 @@ public:
     PeerImp (Resource::Manager& resourceManager,
         boost::asio::io_service& io_service,
             boost::asio::ssl::context& ssl_context,
-                uint64 peerID, bool inbound,
-                    MultiSocket::Flag flags)
+                SSLHandshaker& handshaker,
+                    insight::Histogram const& sendQueueDepth,
+                        uint64 peerID, bool inbound,
+                            MultiSocket::Flag flags)
         : m_resourceManager (resourceManager)
+        , m_handshaker (handshaker)
+        , m_sendQueueDepth (sendQueueDepth)
         , m_isInbound (inbound)
         , m_socket (MultiSocket::New (
             io_service, ssl_context, flags.asBits ()))
         , m_strand (io_service)
         , mHelloed (false)
+        , mHandshaking (false)
         , mDetaching (false)
         , mActive (2)
         , mCluster (false)
@@ -87,6 +94,7 @@ public:
 private:
     bool            mClientConnect;     // In process of connecting as client.
     bool            mHelloed;           // True, if hello accepted.
+    bool            mHandshaking;       // True, while the SSL handshake runs.
     bool            mDetaching;         // True, if detaching.
     int             mActive;            // 0=idle, 1=pingsent, 2=active
     bool            mCluster;           // Node in our cluster
@@ -118,6 +126,7 @@ private:
     bool            m_remoteAddressSet;
     IPAddress      m_remoteAddress;
     Resource::Consumer m_usage;
+    PeerScore m_score;
     
 public:
     static char const* getCountedObjectName () { return "Peer"; }
@@ -216,6 +225,11 @@ public:
         return m_remoteAddress;
     }
 
+    PeerScore& getScore ()
+    {
+        return m_score;
+    }
+
 private:
     void handleShutdown (const boost::system::error_code & error)
     {
@@ -297,7 +311,13 @@ private:
     // Also need to establish no man in the middle attack is in progress.
     void handleStart (const boost::system::error_code& error)
     {
-        if (error)
+        mHandshaking = false;
+
+        if (mDetaching)
+        {
+            // Abandoned during the handshake
+        }
+        else if (error)
         {
             WriteLog (lsINFO, Peer) << "Peer: Handshake: Error: " << error.category ().name () << ": " << error.message () << ": " << error;
             detach ("hs", true);
@@ -516,9 +536,20 @@ void PeerImp::detach (const char* rsn, bool onIOStrand)
         mSendQ.clear ();
 
         (void) mActivityTimer.cancel ();
-        getHandshakeStream ().async_shutdown (m_strand.wrap (boost::bind
-                                   (&PeerImp::handleShutdown, boost::static_pointer_cast <PeerImp> (shared_from_this ()),
-                                    boost::asio::placeholders::error)));
+
+        if (mHandshaking)
+        {
+            // The handshake may be running on another thread, so the
+            // stream can't be used. Closing the TCP socket ends it.
+            boost::system::error_code ec;
+            getNativeSocket ().shutdown (boost::asio::socket_base::shutdown_both, ec);
+        }
+        else
+        {
+            getHandshakeStream ().async_shutdown (m_strand.wrap (boost::bind
+                                       (&PeerImp::handleShutdown, boost::static_pointer_cast <PeerImp> (shared_from_this ()),
+                                        boost::asio::placeholders::error)));
+        }
 
         if (mNodePublic.isValid ())
         {
@@ -685,7 +716,15 @@ void PeerImp::handleConnect (const boost::system::error_code& error, boost::asio
 
         getHandshakeStream ().set_verify_mode (boost::asio::ssl::verify_none);
 
-        getHandshakeStream ().async_handshake (boost::asio::ssl::stream_base::client,
+        // The address selects a saved session to resume
+        boost::system::error_code ec;
+        IPAddress const remoteAddress (IPAddressConversion::from_asio (
+            getNativeSocket ().remote_endpoint (ec)));
+
+        mHandshaking = true;
+
+        m_handshaker.async_handshake (getHandshakeStream (),
+            boost::asio::ssl::stream_base::client, remoteAddress,
             m_strand.wrap (boost::bind (&PeerImp::handleStart,
                 boost::static_pointer_cast <PeerImp> (shared_from_this ()),
                     boost::asio::placeholders::error)));
@@ -726,9 +765,13 @@ void PeerImp::connected (const boost::system::error_code& error)
 
         getHandshakeStream ().set_verify_mode (boost::asio::ssl::verify_none);
 
-        getHandshakeStream ().async_handshake (boost::asio::ssl::stream_base::server, m_strand.wrap (boost::bind (
-            &PeerImp::handleStart, boost::static_pointer_cast <PeerImp> (shared_from_this ()),
-            boost::asio::placeholders::error)));
+        mHandshaking = true;
+
+        m_handshaker.async_handshake (getHandshakeStream (),
+            boost::asio::ssl::stream_base::server, IPAddress (),
+            m_strand.wrap (boost::bind (&PeerImp::handleStart,
+                boost::static_pointer_cast <PeerImp> (shared_from_this ()),
+                    boost::asio::placeholders::error)));
     }
     else if (!mDetaching)
     {
@@ -766,9 +809,11 @@ void PeerImp::sendPacket (const PackedMessage::pointer& packet, bool onStrand)
         if (mSendingPacket)
         {
             mSendQ.push_back (packet);
+            m_sendQueueDepth.record (mSendQ.size ());
         }
         else
         {
+            m_sendQueueDepth.record (0);
             sendPacketForce (packet);
         }
     }
@@ -1352,6 +1397,13 @@ void PeerImp::recvTransaction (protocol::TMTransaction& packet, Application::Sco
 
 }
 
+// Checks a proposal signature through the shared verification cache
+static bool checkProposalSign (LedgerProposal& proposal, std::string const& signature)
+{
+    return getApp().getSignatureVerifier ().verify (proposal.getSigningHash (),
+        proposal.getPubKey (), Blob (signature.begin (), signature.end ()));
+}
+
 // Called from our JobQueue
 static void checkPropose (Job& job, boost::shared_ptr<protocol::TMProposeSet> packet,
                           LedgerProposal::pointer proposal, uint256 consensusLCL, RippleAddress nodePublic,
@@ -1373,7 +1425,7 @@ static void checkPropose (Job& job, boost::shared_ptr<protocol::TMProposeSet> pa
         WriteLog (lsTRACE, Peer) << "proposal with previous ledger";
         memcpy (prevLedger.begin (), set.previousledger ().data (), 256 / 8);
 
-        if (!fromCluster && !proposal->checkSign (set.signature ()))
+        if (!fromCluster && !checkProposalSign (*proposal, set.signature ()))
         {
             Peer::pointer p = peer.lock ();
             WriteLog (lsWARNING, Peer) << "proposal with previous ledger fails signature check: " <<
@@ -1386,7 +1438,7 @@ static void checkPropose (Job& job, boost::shared_ptr<protocol::TMProposeSet> pa
     }
     else
     {
-        if (consensusLCL.isNonZero () && proposal->checkSign (set.signature ()))
+        if (consensusLCL.isNonZero () && checkProposalSign (*proposal, set.signature ()))
         {
             prevLedger = consensusLCL;
             sigGood = true;
@@ -1519,7 +1571,8 @@ static void checkValidation (Job&, SerializedValidation::pointer val, bool isTru
 #endif
     {
         uint256 signingHash = val->getSigningHash();
-        if (!isCluster && !val->isValid (signingHash))
+        if (!isCluster && !getApp().getSignatureVerifier ().verify (signingHash,
+                val->getFieldVL (sfSigningPubKey), val->getSignature ()))
         {
             WriteLog (lsWARNING, Peer) << "Validation is invalid";
             Peer::charge (peer, Resource::feeInvalidRequest);
@@ -1850,7 +1903,14 @@ void PeerImp::recvGetObjectByHash (const boost::shared_ptr<protocol::TMGetObject
     }
     else
     {
-        // this is a reply
+        // this is a reply, score it if it answers one of our scored queries
+        if ((packet.type () != protocol::TMGetObjectByHash::otFETCH_PACK) &&
+            (packet.ledgerhash ().size () == (256 / 8)))
+        {
+            m_score.onReply (protocol::mtGET_OBJECTS,
+                uint256::fromVoid (packet.ledgerhash ().data ()), packet.ByteSize ());
+        }
+
         uint32 pLSeq = 0;
         bool pLDo = true;
         bool progress = false;
@@ -2397,6 +2457,8 @@ void PeerImp::recvLedger (const boost::shared_ptr<protocol::TMLedgerData>& packe
 
     memcpy (hash.begin (), packet.ledgerhash ().data (), 32);
 
+    m_score.onReply (protocol::mtGET_LEDGER, hash, packet.ByteSize ());
+
     if (packet.type () == protocol::liTS_CANDIDATE)
     {
         // got data for a candidate transaction set
@@ -2736,6 +2798,8 @@ Json::Value PeerImp::getJson ()
         }
     }
 
+    ret["score"] = m_score.getJson ();
+
     /*
     if (!mIpPort.first.empty())
     {
@@ -2750,8 +2814,9 @@ Json::Value PeerImp::getJson ()
 
 Peer::pointer Peer::New (Resource::Manager& resourceManager,
     boost::asio::io_service& io_service,
-        boost::asio::ssl::context& ssl_context, uint64 id,
-            bool inbound, bool requirePROXYHandshake)
+        boost::asio::ssl::context& ssl_context,
+            SSLHandshaker& handshaker, insight::Histogram const& sendQueueDepth,
+            uint64 id, bool inbound, bool requirePROXYHandshake)
 {
     MultiSocket::Flag flags;
 
@@ -2772,7 +2837,7 @@ Peer::pointer Peer::New (Resource::Manager& resourceManager,
     }
 
     return Peer::pointer (new PeerImp (resourceManager,
-        io_service, ssl_context, id, inbound, flags));
+        io_service, ssl_context, handshaker, sendQueueDepth, id, inbound, flags));
 }
 
 //------------------------------------------------------------------------------
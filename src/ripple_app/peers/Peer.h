@@ -42,6 +42,8 @@ public:
     static pointer New (Resource::Manager& resourceManager,
                         boost::asio::io_service& io_service,
                         boost::asio::ssl::context& ctx,
+                        SSLHandshaker& handshaker,
+                        insight::Histogram const& sendQueueDepth,
                         uint64 id,
                         bool inbound,
                         bool requirePROXYHandshake);
@@ -109,6 +111,9 @@ public:
 
     virtual IPAddress getPeerEndpoint() const = 0;
 
+    /** Returns the record of how well this peer answers our requests. */
+    virtual PeerScore& getScore () = 0;
+
     //--------------------------------------------------------------------------
 
     typedef boost::asio::ip::tcp::socket NativeSocketType;
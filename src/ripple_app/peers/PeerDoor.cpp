@@ -26,14 +26,17 @@ class PeerDoorImp
 public:
     PeerDoorImp (Stoppable& parent, Resource::Manager& resourceManager,
         Kind kind, std::string const& ip, int port,
-            boost::asio::io_service& io_service, boost::asio::ssl::context& ssl_context)
+            IoServicePool& io_pool, boost::asio::ssl::context& ssl_context,
+                SSLHandshaker& handshaker)
         : PeerDoor (parent)
         , m_resourceManager (resourceManager)
         , m_kind (kind)
         , m_ssl_context (ssl_context)
-        , mAcceptor (io_service, boost::asio::ip::tcp::endpoint (
+        , m_handshaker (handshaker)
+        , m_io_pool (io_pool)
+        , mAcceptor (io_pool.getService (), boost::asio::ip::tcp::endpoint (
             boost::asio::ip::address ().from_string (ip.empty () ? "0.0.0.0" : ip), port))
-        , mDelayTimer (io_service)
+        , mDelayTimer (io_pool.getService ())
     {
         if (! ip.empty () && port != 0)
         {
@@ -51,14 +54,18 @@ public:
 
     // Initiating function for performing an asynchronous accept
     //
+    // The connection is accepted into the next reactor's io_service, and
+    // stays there for its lifetime.
+    //
     void async_accept ()
     {
         bool const isInbound (true);
         bool const requirePROXYHandshake (m_kind == sslAndPROXYRequired);
 
         Peer::pointer new_connection (Peer::New (
-            m_resourceManager, mAcceptor.get_io_service (),
-                m_ssl_context, getApp().getPeers ().assignPeerId (),
+            m_resourceManager, m_io_pool.getNextService (),
+                m_ssl_context, m_handshaker, getApp().getPeers ().getSendQueueDepth (),
+                    getApp().getPeers ().assignPeerId (),
                     isInbound, requirePROXYHandshake));
 
         mAcceptor.async_accept (new_connection->getNativeSocket (),
@@ -127,6 +134,8 @@ private:
     Resource::Manager& m_resourceManager;
     Kind m_kind;
     boost::asio::ssl::context& m_ssl_context;
+    SSLHandshaker& m_handshaker;
+    IoServicePool& m_io_pool;
     boost::asio::ip::tcp::acceptor  mAcceptor;
     boost::asio::deadline_timer     mDelayTimer;
 };
@@ -143,9 +152,10 @@ PeerDoor::PeerDoor (Stoppable& parent)
 PeerDoor* PeerDoor::New (Stoppable& parent,
     Resource::Manager& resourceManager,
         Kind kind, std::string const& ip, int port,
-            boost::asio::io_service& io_service,
-                boost::asio::ssl::context& ssl_context)
+            IoServicePool& io_pool,
+                boost::asio::ssl::context& ssl_context,
+                    SSLHandshaker& handshaker)
 {
     return new PeerDoorImp (parent, resourceManager,
-        kind, ip, port, io_service, ssl_context);
+        kind, ip, port, io_pool, ssl_context, handshaker);
 }
@@ -42,8 +42,9 @@ public:
     static PeerDoor* New (Stoppable& parent,
         Resource::Manager& resourceManager,
             Kind kind, std::string const& ip, int port,
-                boost::asio::io_service& io_service,
-                    boost::asio::ssl::context& ssl_context);
+                IoServicePool& io_pool,
+                    boost::asio::ssl::context& ssl_context,
+                        SSLHandshaker& handshaker);
 
     //virtual boost::asio::ssl::context& getSSLContext () = 0;
 };
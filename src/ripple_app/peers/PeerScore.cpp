@@ -0,0 +1,325 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+// Requests unanswered for this long count as failures, in milliseconds
+static double const peerScoreTimeout = 4000;
+
+// Weight given to each new sample in the running averages
+static double const peerScoreSmoothing = 0.2;
+
+// Assumed values for a peer we have not heard from yet
+static double const peerScoreInitialLatency = 250;
+static double const peerScoreInitialThroughput = 64 * 1024;
+
+static int const peerScoreMaxRequests = 8;
+
+PeerScore::PeerScore (Clock clock)
+    : mClock (clock)
+    , mLock (this, "PeerScore", __FILE__, __LINE__)
+    , mLatency (peerScoreInitialLatency)
+    , mThroughput (peerScoreInitialThroughput)
+    , mSuccess (1)
+    , mReplies (0)
+    , mTimeouts (0)
+{
+}
+
+void PeerScore::onRequest (int messageType, uint256 const& hash)
+{
+    Request request;
+    request.sent = mClock ();
+    request.messageType = messageType;
+    request.hash = hash;
+
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    expire (request.sent);
+    mSent.push_back (request);
+}
+
+void PeerScore::onReply (int messageType, uint256 const& hash, std::size_t bytes)
+{
+    double const now (mClock ());
+
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    expire (now);
+
+    std::deque <Request>::iterator it (mSent.begin ());
+
+    while ((it != mSent.end ()) && ((it->messageType != messageType) || (it->hash != hash)))
+        ++it;
+
+    // Unsolicited, not scored, or the request already timed out
+    if (it == mSent.end ())
+        return;
+
+    double const elapsed (std::max (now - it->sent, 1.0));
+    mSent.erase (it);
+    ++mReplies;
+
+    mLatency += peerScoreSmoothing * (elapsed - mLatency);
+    mThroughput += peerScoreSmoothing * ((bytes * 1000.0 / elapsed) - mThroughput);
+    mSuccess += peerScoreSmoothing * (1 - mSuccess);
+}
+
+int PeerScore::getOutstanding ()
+{
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    expire (mClock ());
+    return mSent.size ();
+}
+
+int PeerScore::getRequestLimit ()
+{
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    return getRequestLimit (sl);
+}
+
+bool PeerScore::isSaturated ()
+{
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    expire (mClock ());
+    return int (mSent.size ()) >= getRequestLimit (sl);
+}
+
+bool PeerScore::isSlow ()
+{
+    double const now (mClock ());
+
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    expire (now);
+
+    if (mLatency > 4 * peerScoreInitialLatency)
+        return true;
+
+    // A request is overdue by well past the usual round trip
+    return !mSent.empty () &&
+        ((now - mSent.front ().sent) > (2 * mLatency + peerScoreInitialLatency));
+}
+
+double PeerScore::getWeight ()
+{
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    expire (mClock ());
+    return getWeight (sl);
+}
+
+Json::Value PeerScore::getJson ()
+{
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+    expire (mClock ());
+
+    Json::Value ret (Json::objectValue);
+    ret["latency_ms"] = static_cast <int> (mLatency);
+    ret["throughput_kbps"] = static_cast <int> (mThroughput / 1024);
+    ret["success_percent"] = static_cast <int> (mSuccess * 100);
+    ret["outstanding"] = static_cast <int> (mSent.size ());
+    ret["replies"] = static_cast <Json::UInt> (mReplies);
+    ret["timeouts"] = static_cast <Json::UInt> (mTimeouts);
+    return ret;
+}
+
+// Called with the lock held
+void PeerScore::expire (double now)
+{
+    while (!mSent.empty () && ((now - mSent.front ().sent) > peerScoreTimeout))
+    {
+        mSent.pop_front ();
+        ++mTimeouts;
+
+        mLatency += peerScoreSmoothing * (peerScoreTimeout - mLatency);
+        mSuccess -= peerScoreSmoothing * mSuccess;
+    }
+}
+
+double PeerScore::getWeight (ScopedLockType const&) const
+{
+    // Latency dominates since most replies are small, but a peer that
+    // streams large replies quickly is worth up to twice as much.
+    double const speed (peerScoreInitialLatency / (mLatency + 50));
+    double const volume (1 + std::min (mThroughput / (4 * peerScoreInitialThroughput), 1.0));
+
+    return mSuccess * speed * volume;
+}
+
+int PeerScore::getRequestLimit (ScopedLockType const&) const
+{
+    // Allow more requests in flight to peers that answer quickly and reliably
+    int const limit (1 + static_cast <int> (
+        mSuccess * (peerScoreMaxRequests - 1) * peerScoreInitialLatency / (mLatency + peerScoreInitialLatency)));
+
+    return std::min (limit, peerScoreMaxRequests);
+}
+
+//------------------------------------------------------------------------------
+
+class PeerScoreTests : public UnitTest
+{
+public:
+    PeerScoreTests () : UnitTest ("PeerScore", "ripple")
+    {
+    }
+
+    static double now;
+
+    static double getNow ()
+    {
+        return now;
+    }
+
+    // Sends a request and answers it after the given number of milliseconds
+    static void exchange (PeerScore& score, int count, double elapsed, std::size_t bytes)
+    {
+        uint256 const hash (1);
+
+        for (int i = 0; i < count; ++i)
+        {
+            score.onRequest (protocol::mtGET_LEDGER, hash);
+            now += elapsed;
+            score.onReply (protocol::mtGET_LEDGER, hash, bytes);
+        }
+    }
+
+    void testReplies ()
+    {
+        beginTestCase ("replies");
+
+        PeerScore score (&getNow);
+        uint256 const a (1);
+        uint256 const b (2);
+
+        score.onRequest (protocol::mtGET_LEDGER, a);
+        now += 1000;
+        score.onRequest (protocol::mtGET_LEDGER, a);
+        score.onRequest (protocol::mtGET_OBJECTS, b);
+        expect (score.getOutstanding () == 3);
+
+        now += 100;
+        score.onReply (protocol::mtGET_OBJECTS, a, 100);
+        score.onReply (protocol::mtGET_LEDGER, b, 100);
+        expect (score.getOutstanding () == 3, "reply matched the wrong request");
+        expect (score.getJson ()["replies"].asUInt () == 0);
+
+        // The oldest request is answered first: 250 + 0.2 * (1100 - 250)
+        score.onReply (protocol::mtGET_LEDGER, a, 100);
+        expect (score.getOutstanding () == 2);
+        expect (score.getJson ()["latency_ms"].asInt () == 420);
+
+        score.onReply (protocol::mtGET_OBJECTS, b, 100);
+        expect (score.getOutstanding () == 1);
+        expect (score.getJson ()["replies"].asUInt () == 2);
+    }
+
+    void testScoring ()
+    {
+        beginTestCase ("scoring");
+
+        PeerScore unknown (&getNow);
+        PeerScore fast (&getNow);
+        PeerScore slow (&getNow);
+        PeerScore large (&getNow);
+
+        exchange (fast, 30, 10, 1000);
+        exchange (slow, 30, 1500, 1000);
+        exchange (large, 30, 10, 1024 * 1024);
+
+        expect (fast.getWeight () > unknown.getWeight (), "fast peer not preferred");
+        expect (slow.getWeight () < unknown.getWeight (), "slow peer not avoided");
+        expect (large.getWeight () > fast.getWeight (), "throughput not counted");
+        expect (large.getWeight () < 2 * fast.getWeight ());
+
+        expect (!fast.isSlow ());
+        expect (slow.isSlow ());
+
+        beginTestCase ("limits");
+
+        expect (unknown.getRequestLimit () == 4);
+        expect (fast.getRequestLimit () == 7);
+        expect (slow.getRequestLimit () == 2);
+
+        for (int i = 0; i < 3; ++i)
+            unknown.onRequest (protocol::mtGET_LEDGER, uint256 (i));
+        expect (!unknown.isSaturated ());
+
+        unknown.onRequest (protocol::mtGET_LEDGER, uint256 (3));
+        expect (unknown.isSaturated ());
+    }
+
+    void testExpiry ()
+    {
+        beginTestCase ("expiry");
+
+        PeerScore score (&getNow);
+        uint256 const hash (1);
+        double const weight (score.getWeight ());
+
+        score.onRequest (protocol::mtGET_LEDGER, hash);
+
+        // An overdue request is hedged before it times out
+        now += 700;
+        expect (!score.isSlow ());
+        now += 100;
+        expect (score.isSlow (), "overdue request not hedged");
+
+        now += 3300;
+        expect (score.getOutstanding () == 0, "request did not expire");
+        expect (score.getJson ()["timeouts"].asUInt () == 1);
+        expect (score.getWeight () < weight);
+        expect (score.getJson ()["success_percent"].asInt () < 100);
+
+        // A reply to an expired request is not scored
+        score.onReply (protocol::mtGET_LEDGER, hash, 100);
+        expect (score.getJson ()["replies"].asUInt () == 0);
+    }
+
+    void testOrder ()
+    {
+        beginTestCase ("order");
+
+        int const trials = 1000;
+        int first = 0;
+
+        for (int i = 0; i < trials; ++i)
+        {
+            std::vector <std::pair <double, int> > keyed;
+            keyed.push_back (std::make_pair (1.0, 0));
+            keyed.push_back (std::make_pair (4.0, 1));
+
+            PeerScore::orderByWeight (keyed);
+
+            if (keyed.front ().second == 1)
+                ++first;
+        }
+
+        // Four times the weight comes first four times in five
+        expect ((first > 700) && (first < 900), "order not weighted");
+        expect (first < trials, "order not random");
+    }
+
+    void runTest ()
+    {
+        testReplies ();
+        testScoring ();
+        testExpiry ();
+        testOrder ();
+    }
+};
+
+double PeerScoreTests::now = 0;
+
+static PeerScoreTests peerScoreTests;
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PEERSCORE_H_INCLUDED
+#define RIPPLE_PEERSCORE_H_INCLUDED
+
+/** Tracks how well a peer answers our ledger and transaction set requests.
+
+    Round trip latency, throughput and success rate are exponentially
+    weighted averages over recent requests. A reply is matched to the oldest
+    outstanding request of the same message type for the same hash, and a
+    reply which matches no scored request is ignored. A request that goes
+    unanswered for too long counts as a failure.
+
+    Thread safety:
+        All functions may be called from any thread.
+*/
+class PeerScore : LeakChecked <PeerScore>
+{
+public:
+    /** Returns the current time in milliseconds. */
+    typedef double (*Clock) ();
+
+    explicit PeerScore (Clock clock = &Time::getMillisecondCounterHiRes);
+
+    /** Called when we send the peer a TMGetLedger or TMGetObjectByHash query.
+        @param messageType The type of the query, mtGET_LEDGER or mtGET_OBJECTS.
+        @param hash The ledger or transaction set the query is for.
+    */
+    void onRequest (int messageType, uint256 const& hash);
+
+    /** Called when the peer replies with TMLedgerData or TMGetObjectByHash.
+        @param messageType The type of the query being answered.
+    */
+    void onReply (int messageType, uint256 const& hash, std::size_t bytes);
+
+    /** Returns the number of requests still awaiting a reply. */
+    int getOutstanding ();
+
+    /** Returns the number of requests this peer should have outstanding.
+        Fast and reliable peers are given more work at once.
+    */
+    int getRequestLimit ();
+
+    /** Returns `true` if the peer has no capacity for another request. */
+    bool isSaturated ();
+
+    /** Returns `true` if a request sent to the peer now is likely to be slow.
+        A slow request should be hedged by also asking another peer.
+    */
+    bool isSlow ();
+
+    /** Returns the relative preference for choosing this peer.
+        Higher is better. A peer we know nothing about gets an average weight.
+    */
+    double getWeight ();
+
+    Json::Value getJson ();
+
+    /** Puts items in a weighted random order.
+        The chance of an item coming before another is proportional to
+        its weight, so a better peer is usually but not always chosen first.
+        @param keyed Pairs of weight and item. On return the items are in
+                     order, and each weight is replaced by the sort key.
+    */
+    template <class Item>
+    static void orderByWeight (std::vector <std::pair <double, Item> >& keyed)
+    {
+        // Each item gets the key u^(1/weight) for a uniform random u,
+        // and the highest keys come first.
+        for (std::size_t i = 0; i < keyed.size (); ++i)
+        {
+            double const weight = std::max (keyed[i].first, 0.001);
+            double const u = (rand () + 1.0) / (RAND_MAX + 2.0);
+            keyed[i].first = std::pow (u, 1 / weight);
+        }
+
+        std::sort (keyed.begin (), keyed.end (), &keyGreater <Item>);
+    }
+
+private:
+    template <class Item>
+    static bool keyGreater (std::pair <double, Item> const& lhs,
+                            std::pair <double, Item> const& rhs)
+    {
+        return lhs.first > rhs.first;
+    }
+
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+
+    void expire (double now);
+    double getWeight (ScopedLockType const&) const;
+    int getRequestLimit (ScopedLockType const&) const;
+
+    struct Request
+    {
+        double sent;
+        int messageType;
+        uint256 hash;
+    };
+
+    Clock mClock;
+    LockType mLock;
+    std::deque <Request> mSent; // Outstanding requests, oldest first
+    double mLatency;            // Round trip time in milliseconds
+    double mThroughput;         // Reply bytes per second
+    double mSuccess;            // Fraction of requests answered in time
+    uint64 mReplies;
+    uint64 mTimeouts;
+};
+
+#endif
@@ -121,9 +121,28 @@ bool PeerSet::isActive ()
 void PeerSet::sendRequest (const protocol::TMGetLedger& tmGL, Peer::ref peer)
 {
     if (!peer)
+    {
         sendRequest (tmGL);
-    else
-        peer->sendPacket (boost::make_shared<PackedMessage> (tmGL, protocol::mtGET_LEDGER), false);
+        return;
+    }
+
+    PackedMessage::pointer packet = boost::make_shared<PackedMessage> (tmGL, protocol::mtGET_LEDGER);
+
+    peer->getScore ().onRequest (protocol::mtGET_LEDGER, mHash);
+    peer->sendPacket (packet, false);
+
+    // Hedge a request that is likely to be slow by also asking another peer
+    if (peer->getScore ().isSlow ())
+    {
+        Peer::pointer hedge = getBestPeer (peer);
+
+        if (hedge)
+        {
+            WriteLog (lsTRACE, InboundLedger) << "Hedging request to slow peer " << peer->getIP ();
+            hedge->getScore ().onRequest (protocol::mtGET_LEDGER, mHash);
+            hedge->sendPacket (packet, false);
+        }
+    }
 }
 
 void PeerSet::sendRequest (const protocol::TMGetLedger& tmGL)
@@ -135,13 +154,82 @@ void PeerSet::sendRequest (const protocol::TMGetLedger& tmGL)
 
     PackedMessage::pointer packet = boost::make_shared<PackedMessage> (tmGL, protocol::mtGET_LEDGER);
 
+    // Skip peers which already have as many requests as their score allows
+    Peer::pointer best;
+    double bestWeight = 0;
+    int sent = 0;
+
     for (boost::unordered_map<uint64, int>::iterator it = mPeers.begin (), end = mPeers.end (); it != end; ++it)
     {
         Peer::pointer peer = getApp().getPeers ().getPeerById (it->first);
 
-        if (peer)
-            peer->sendPacket (packet, false);
+        if (!peer)
+            continue;
+
+        if (peer->getScore ().isSaturated ())
+        {
+            double const weight = peer->getScore ().getWeight ();
+
+            if (!best || (weight > bestWeight))
+            {
+                best = peer;
+                bestWeight = weight;
+            }
+
+            continue;
+        }
+
+        peer->getScore ().onRequest (protocol::mtGET_LEDGER, mHash);
+        peer->sendPacket (packet, false);
+        ++sent;
     }
+
+    // Every peer is busy, so ask the best one anyway
+    if ((sent == 0) && best)
+    {
+        best->getScore ().onRequest (protocol::mtGET_LEDGER, mHash);
+        best->sendPacket (packet, false);
+    }
+}
+
+Peer::pointer PeerSet::getBestPeer (Peer::ref except)
+{
+    ScopedLockType sl (mLock, __FILE__, __LINE__);
+
+    Peer::pointer best;
+    double bestWeight = 0;
+
+    for (boost::unordered_map<uint64, int>::iterator it = mPeers.begin (), end = mPeers.end (); it != end; ++it)
+    {
+        Peer::pointer peer = getApp().getPeers ().getPeerById (it->first);
+
+        if (!peer || (peer == except) || peer->getScore ().isSaturated ())
+            continue;
+
+        double const weight = peer->getScore ().getWeight ();
+
+        if (weight > bestWeight)
+        {
+            best = peer;
+            bestWeight = weight;
+        }
+    }
+
+    return best;
+}
+
+void PeerSet::orderByScore (std::vector <Peer::pointer>& peers)
+{
+    std::vector <std::pair <double, Peer::pointer> > keyed;
+    keyed.reserve (peers.size ());
+
+    BOOST_FOREACH (Peer::ref peer, peers)
+        keyed.push_back (std::make_pair (peer->getScore ().getWeight (), peer));
+
+    PeerScore::orderByWeight (keyed);
+
+    for (std::size_t i = 0; i < keyed.size (); ++i)
+        peers[i] = keyed[i].second;
 }
 
 int PeerSet::takePeerSetFrom (const PeerSet& s)
@@ -74,6 +74,13 @@ public:
         return mComplete || mFailed;
     }
 
+    /** Shuffle peers so that better scoring peers tend to come first.
+        Peers are still chosen at random, so that load is spread out and
+        a peer we know little about gets a chance to prove itself.
+        @see PeerScore
+    */
+    static void orderByScore (std::vector <Peer::pointer>& peers);
+
 private:
     static void TimerEntry (boost::weak_ptr<PeerSet>, const boost::system::error_code& result);
     static void TimerJobEntry (Job&, boost::shared_ptr<PeerSet>);
@@ -103,6 +110,11 @@ protected:
     void sendRequest (const protocol::TMGetLedger& message);
     void sendRequest (const protocol::TMGetLedger& message, Peer::ref peer);
 
+    /** Returns the best scoring peer in the set with room for a request.
+        @param except A peer to leave out, or null.
+    */
+    Peer::pointer getBestPeer (Peer::ref except);
+
 protected:
     LockType mLock;
 
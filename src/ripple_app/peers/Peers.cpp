@@ -48,8 +48,10 @@ public:
     Resource::Manager& m_resourceManager;
     ScopedPointer <PeerFinder::Manager> m_peerFinder;
 
-    boost::asio::io_service& m_io_service;
+    IoServicePool& m_io_pool;
     boost::asio::ssl::context& m_ssl_context;
+    SSLHandshaker& m_handshaker;
+    insight::Histogram m_sendQueueDepth;
 
     LockType mPeerLock;
 
@@ -96,8 +98,10 @@ public:
     PeersImp (Stoppable& parent,
         Resource::Manager& resourceManager,
             SiteFiles::Manager& siteFiles,
-                boost::asio::io_service& io_service,
-                    boost::asio::ssl::context& ssl_context)
+                IoServicePool& io_pool,
+                    boost::asio::ssl::context& ssl_context,
+                        SSLHandshaker& handshaker,
+                            shared_ptr <insight::Collector> const& collector)
         : Stoppable ("Peers", parent)
         , m_resourceManager (resourceManager)
         , m_peerFinder (add (PeerFinder::Manager::New (
@@ -105,15 +109,17 @@ public:
             siteFiles,
             *this,
             LogPartition::getJournal <PeerFinderLog> ())))
-        , m_io_service (io_service)
+        , m_io_pool (io_pool)
         , m_ssl_context (ssl_context)
+        , m_handshaker (handshaker)
+        , m_sendQueueDepth (collector->make_histogram ("peer_send_queue_depth"))
         , mPeerLock (this, "PeersImp", __FILE__, __LINE__)
         , mLastPeer (0)
         , mPhase (0)
-        , mScanTimer (io_service)
-        , mPolicyTimer (io_service)
+        , mScanTimer (io_pool.getService ())
+        , mPolicyTimer (io_pool.getService ())
         , m_resolver (NameResolver::New (
-            io_service,
+            io_pool.getService (),
             Journal()))
     {
 
@@ -310,6 +316,11 @@ public:
 
     // Peer 64-bit ID function
     uint64 assignPeerId ();
+
+    insight::Histogram const& getSendQueueDepth ()
+    {
+        return m_sendQueueDepth;
+    }
     Peer::pointer getPeerById (const uint64& id);
     bool hasPeer (const uint64& id);
 
@@ -672,8 +683,8 @@ Peer::pointer PeersImp::peerConnect (const std::string& strIp, int iPort)
             bool const isInbound (false);
             bool const requirePROXYHandshake (false);
 
-            ppResult = Peer::New (m_resourceManager, m_io_service, m_ssl_context,
-                ++mLastPeer, isInbound, requirePROXYHandshake);
+            ppResult = Peer::New (m_resourceManager, m_io_pool.getNextService (), m_ssl_context,
+                m_handshaker, m_sendQueueDepth, ++mLastPeer, isInbound, requirePROXYHandshake);
 
             mIpMap [pipPeer] = ppResult;
         }
@@ -1137,9 +1148,12 @@ Peers::Peers ()
 Peers* Peers::New (Stoppable& parent,
     Resource::Manager& resourceManager,
         SiteFiles::Manager& siteFiles,
-            boost::asio::io_service& io_service,
-                boost::asio::ssl::context& ssl_context)
+            IoServicePool& io_pool,
+                boost::asio::ssl::context& ssl_context,
+                    SSLHandshaker& handshaker,
+                        shared_ptr <insight::Collector> const& collector)
 {
-    return new PeersImp (parent, resourceManager, siteFiles, io_service, ssl_context);
+    return new PeersImp (parent, resourceManager, siteFiles, io_pool,
+        ssl_context, handshaker, collector);
 }
 
@@ -39,8 +39,10 @@ public:
     static Peers* New (Stoppable& parent,
         Resource::Manager& resourceManager,
             SiteFiles::Manager& siteFiles,
-            boost::asio::io_service& io_service,
-                boost::asio::ssl::context& context);
+            IoServicePool& io_pool,
+                boost::asio::ssl::context& context,
+                    SSLHandshaker& handshaker,
+                        shared_ptr <insight::Collector> const& collector);
 
     Peers ();
 
@@ -90,6 +92,10 @@ public:
 
     // Peer 64-bit ID function
     virtual uint64 assignPeerId () = 0;
+
+    // The depth of a peer's send queue each time a message is sent,
+    // shared by every peer.
+    virtual insight::Histogram const& getSendQueueDepth () = 0;
     virtual Peer::pointer getPeerById (const uint64& id) = 0;
     virtual bool hasPeer (const uint64& id) = 0;
 
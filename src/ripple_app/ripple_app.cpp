@@ -54,9 +54,11 @@ namespace ripple {
 # include "main/NodeStoreScheduler.h"
 #include "main/NodeStoreScheduler.cpp"
 
-# include "main/IoServicePool.h"
 #include "main/IoServicePool.cpp"
 
+# include "main/CacheWarmup.h"
+#include "main/CacheWarmup.cpp"
+
 # include "main/FatalErrorReporter.h"
 #include "main/FatalErrorReporter.cpp"
 
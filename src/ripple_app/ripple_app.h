@@ -77,6 +77,7 @@ namespace ripple {
 #include "shamap/SHAMapMissingNode.h"
 #include "shamap/SHAMapSyncFilter.h"
 #include "shamap/SHAMapAddNode.h"
+#include "ledger/LedgerSnapshot.h"
 #include "shamap/SHAMap.h"
 #include "misc/SerializedTransaction.h"
 #include "misc/SerializedLedger.h"
@@ -92,6 +93,10 @@ namespace ripple {
 #include "misc/IFeatures.h"
 #include "misc/IFeeVote.h"
 #include "misc/IHashRouter.h"
+#include "misc/PublicKeyCache.h"
+#include "misc/SignatureVerifier.h"
+#include "main/IoServicePool.h"
+#include "peers/PeerScore.h"
 #include "peers/Peer.h"
 #include "peers/Peers.h"
 #include "peers/ClusterNodeStatus.h"
@@ -104,8 +109,14 @@ namespace ripple {
 #include "misc/AccountItems.h"
 #include "ledger/AcceptedLedgerTx.h"
 #include "ledger/AcceptedLedger.h"
+#include "ledger/AccountHistory.h"
+#include "ledger/LedgerHeaderIndex.h"
+#include "ledger/LedgerVerifier.h"
+#include "ledger/LedgerReplayBenchmark.h"
+#include "tx/TransactionProfile.h"
 #include "ledger/LedgerEntrySet.h"
 #include "tx/TransactionEngine.h"
+#include "tx/SpeculativeEngine.h"
 #include "misc/CanonicalTXSet.h"
 #include "ledger/LedgerHistory.h"
 #include "ledger/LedgerCleaner.h"
@@ -24,6 +24,8 @@
 #include <boost/bimap/multiset_of.hpp>
 #include <boost/bimap/unordered_set_of.hpp>
 
+#include <bitset>
+
 #include "ripple_app.h"
 
 #include "../ripple/validators/ripple_validators.h"
@@ -44,6 +46,8 @@ namespace ripple
 
 #include "consensus/LedgerConsensus.cpp"
 
+#include "ledger/LedgerVerifier.cpp"
+#include "ledger/LedgerReplayBenchmark.cpp"
 # include "ledger/LedgerCleaner.h"
 #include "ledger/LedgerCleaner.cpp"
 #include "ledger/LedgerMaster.cpp"
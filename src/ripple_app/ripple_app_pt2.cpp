@@ -27,6 +27,7 @@ namespace ripple {
 #include "shamap/SHAMapItem.cpp"
 #include "shamap/SHAMapSync.cpp"
 #include "shamap/SHAMapMissingNode.cpp"
+#include "ledger/LedgerSnapshot.cpp"
 
 #include "misc/AccountItem.cpp"
 #include "tx/AccountSetTransactor.cpp"
@@ -41,6 +41,8 @@ namespace ripple
 #include "tx/TrustSetTransactor.cpp"
 #include "tx/Transaction.cpp"
 #include "tx/TransactionEngine.cpp"
+#include "tx/SpeculativeEngine.cpp"
+#include "tx/TransactionProfile.cpp"
 #include "tx/TransactionMeta.cpp"
 #include "tx/Transactor.cpp"
 
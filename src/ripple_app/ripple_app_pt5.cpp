@@ -43,6 +43,7 @@ namespace ripple {
 #   include "misc/PowResult.h"
 #  include "misc/ProofOfWork.h"
 # include "misc/ProofOfWorkFactory.h"
+#include "peers/PeerScore.cpp"
 #include "peers/Peer.cpp"
 #include "peers/PackedMessage.cpp"
 #include "peers/Peers.cpp"
@@ -28,6 +28,8 @@ namespace ripple
 #include "ledger/AcceptedLedger.cpp"
 #include "consensus/DisputedTx.cpp"
 #include "misc/HashRouter.cpp"
+#include "misc/PublicKeyCache.cpp"
+#include "misc/SignatureVerifier.cpp"
 #include "misc/Offer.cpp"
 #include "paths/Pathfinder.cpp"
 #include "misc/Features.cpp"
@@ -23,11 +23,15 @@
 
 #include "../ripple/resource/ripple_resource.h"
 
+#include "../ripple_leveldb/ripple_leveldb.h"
+
 namespace ripple
 {
 
 #include "ledger/InboundLedgers.cpp"
+#include "ledger/LedgerHeaderIndex.cpp"
 #include "ledger/LedgerHistory.cpp"
+#include "ledger/AccountHistory.cpp"
 #include "misc/SerializedLedger.cpp"
 #include "tx/TransactionAcquire.cpp"
 
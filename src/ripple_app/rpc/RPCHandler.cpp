@@ -2023,6 +2023,7 @@ Json::Value RPCHandler::doLedgerCurrent (Json::Value, Resource::Charge& loadType
 // {
 //    ledger: 'current' | 'closed' | <uint256> | <number>,  // optional
 //    full: true | false    // optional, defaults to false.
+//    binary: true | false  // optional, defaults to false.
 // }
 Json::Value RPCHandler::doLedger (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
 {
@@ -2052,7 +2053,9 @@ Json::Value RPCHandler::doLedger (Json::Value params, Resource::Charge& loadType
     bool    bTransactions   = params.isMember ("transactions") && params["transactions"].asBool ();
     bool    bAccounts       = params.isMember ("accounts") && params["accounts"].asBool ();
     bool    bExpand         = params.isMember ("expand") && params["expand"].asBool ();
+    bool    bBinary         = params.isMember ("binary") && params["binary"].asBool ();
     int     iOptions        = (bFull ? LEDGER_JSON_FULL : 0)
+                              | (bBinary ? LEDGER_JSON_BINARY : 0)
                               | (bExpand ? LEDGER_JSON_EXPAND : 0)
                               | (bTransactions ? LEDGER_JSON_DUMP_TXRP : 0)
                               | (bAccounts ? LEDGER_JSON_DUMP_STATE : 0);
@@ -2727,6 +2730,111 @@ Json::Value RPCHandler::doGetCounts (Json::Value params, Resource::Charge& loadT
     return ret;
 }
 
+// {
+//   limit: <number of recent jobs per thread>   // optional, default all
+// }
+Json::Value RPCHandler::doJobTrace (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
+{
+    masterLockHolder.unlock ();
+
+    int limit = 0;
+
+    if (params.isMember ("limit"))
+        limit = params["limit"].asUInt ();
+
+    return getApp().getJobQueue ().getTraceJson (limit);
+}
+
+#if RIPPLE_PROFILE_MUTEXES && ! RIPPLE_TRACK_MUTEXES
+static bool lockSiteWaitedLonger (ProfiledMutex::Site const& lhs, ProfiledMutex::Site const& rhs)
+{
+    return lhs.waitSeconds > rhs.waitSeconds;
+}
+#endif
+
+// {
+//   limit: <number of lock sites>   // optional, default 20
+//   reset: true                     // optional, clears the profile after reporting
+// }
+Json::Value RPCHandler::doLockProfile (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
+{
+    masterLockHolder.unlock ();
+
+#if RIPPLE_PROFILE_MUTEXES && ! RIPPLE_TRACK_MUTEXES
+    std::size_t limit = 20;
+
+    if (params.isMember ("limit"))
+        limit = params["limit"].asUInt ();
+
+    Array <ProfiledMutex::Site> profile;
+    ProfiledMutex::getSites (profile);
+
+    if (params.isMember ("reset") && params["reset"].asBool ())
+        ProfiledMutex::reset ();
+
+    std::vector <ProfiledMutex::Site> sites (profile.begin (), profile.end ());
+    std::sort (sites.begin (), sites.end (), &lockSiteWaitedLonger);
+
+    // Totals for each mutex across all of its lock sites
+    std::map <std::string, ProfiledMutex::Site> mutexes;
+
+    Json::Value ret (Json::objectValue);
+    Json::Value& jvSites = (ret["sites"] = Json::arrayValue);
+
+    for (std::size_t i = 0; i < sites.size (); ++i)
+    {
+        ProfiledMutex::Site const& site (sites[i]);
+
+        ProfiledMutex::Site& total (mutexes[site.mutexName.toStdString ()]);
+        total.mutexName = site.mutexName;
+        total.count += site.count;
+        total.contended += site.contended;
+        total.waitSeconds += site.waitSeconds;
+        total.maxWaitSeconds = std::max (total.maxWaitSeconds, site.maxWaitSeconds);
+        total.holdSeconds += site.holdSeconds;
+
+        if (i >= limit)
+            continue;
+
+        Json::Value& jvSite = jvSites.append (Json::objectValue);
+        jvSite["mutex"] = site.mutexName.toStdString ();
+        jvSite["location"] = site.sourceLocation.toStdString ();
+        jvSite["count"] = static_cast <Json::UInt> (site.count);
+        jvSite["contended"] = static_cast <Json::UInt> (site.contended);
+        jvSite["wait_ms"] = site.waitSeconds * 1000;
+        jvSite["max_wait_ms"] = site.maxWaitSeconds * 1000;
+        jvSite["hold_ms"] = site.holdSeconds * 1000;
+    }
+
+    std::vector <ProfiledMutex::Site> totals;
+    for (std::map <std::string, ProfiledMutex::Site>::const_iterator it = mutexes.begin ();
+        it != mutexes.end (); ++it)
+    {
+        totals.push_back (it->second);
+    }
+    std::sort (totals.begin (), totals.end (), &lockSiteWaitedLonger);
+
+    Json::Value& jvMutexes = (ret["mutexes"] = Json::arrayValue);
+
+    for (std::size_t i = 0; i < totals.size () && i < limit; ++i)
+    {
+        ProfiledMutex::Site const& total (totals[i]);
+
+        Json::Value& jvMutex = jvMutexes.append (Json::objectValue);
+        jvMutex["mutex"] = total.mutexName.toStdString ();
+        jvMutex["count"] = static_cast <Json::UInt> (total.count);
+        jvMutex["contended"] = static_cast <Json::UInt> (total.contended);
+        jvMutex["wait_ms"] = total.waitSeconds * 1000;
+        jvMutex["max_wait_ms"] = total.maxWaitSeconds * 1000;
+        jvMutex["hold_ms"] = total.holdSeconds * 1000;
+    }
+
+    return ret;
+#else
+    return rpcError (rpcNOT_SUPPORTED);
+#endif
+}
+
 Json::Value RPCHandler::doLogLevel (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
 {
     // log_level
@@ -3327,6 +3435,137 @@ Json::Value RPCHandler::doLedgerHeader (Json::Value params, Resource::Charge& lo
     return jvResult;
 }
 
+// Write a closed ledger, with its transactions, to a snapshot file which
+// another server can import with --snapshot <file> --ledger <hash>.
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>  // defaults to validated
+//   path : <file>
+// }
+Json::Value RPCHandler::doExportSnapshot (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
+{
+    if (!params.isMember ("path") || !params["path"].isString ())
+        return rpcError (rpcINVALID_PARAMS);
+
+    if (!params.isMember ("ledger_hash") && !params.isMember ("ledger_index"))
+        params["ledger_index"] = "validated";
+
+    Ledger::pointer     lpLedger;
+    Json::Value         jvResult    = lookupLedger (params, lpLedger);
+
+    if (!lpLedger)
+        return jvResult;
+
+    if (!lpLedger->isClosed ())
+        return rpcError (rpcNO_CLOSED);
+
+    // Walk a copy so that the nodes it loads are released when it is done
+    lpLedger = boost::make_shared<Ledger> (boost::ref (*lpLedger), false);
+
+    masterLockHolder.unlock ();
+
+    Serializer  s;
+    lpLedger->addRaw (s);
+
+    File const  file (File::getCurrentWorkingDirectory ().getChildFile (params["path"].asString ()));
+
+    if (!LedgerSnapshot::write (file, s.peekData (), *lpLedger->peekAccountStateMap (),
+        lpLedger->peekTransactionMap ().get (), LogPartition::getJournal <RPCHandler> ()))
+    {
+        return rpcError (rpcINTERNAL);
+    }
+
+    jvResult["path"]            = file.getFullPathName ().toStdString ();
+
+    return jvResult;
+}
+
+// Get the state entries of a ledger a page at a time.
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+//   binary : true | false      // optional, defaults to false
+//   limit : <integer>          // optional, number of entries per page
+//   marker : <opaque>          // optional, resume where a previous page ended
+// }
+Json::Value RPCHandler::doLedgerData (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
+{
+    int const BINARY_PAGE_LENGTH = 2048;
+    int const JSON_PAGE_LENGTH = 256;
+
+    Ledger::pointer     lpLedger;
+    Json::Value         jvResult    = lookupLedger (params, lpLedger);
+
+    if (!lpLedger)
+        return jvResult;
+
+    // Walk a snapshot so that the master lock is not held while paging.
+    if (!lpLedger->isImmutable ())
+        lpLedger = boost::make_shared<Ledger> (boost::ref (*lpLedger), false);
+
+    masterLockHolder.unlock ();
+
+    uint256     resumePoint;
+    bool        bResume     = params.isMember ("marker");
+
+    if (bResume)
+    {
+        Json::Value const& jMarker = params["marker"];
+
+        if (!jMarker.isString () || !resumePoint.SetHex (jMarker.asString (), true))
+            return rpcError (rpcINVALID_PARAMS);
+    }
+
+    bool        bBinary     = params.isMember ("binary") && params["binary"].asBool ();
+    int         maxLimit    = bBinary ? BINARY_PAGE_LENGTH : JSON_PAGE_LENGTH;
+    int         limit       = maxLimit;
+
+    if (params.isMember ("limit"))
+    {
+        Json::Value const& jLimit = params["limit"];
+
+        if (!jLimit.isIntegral () || (jLimit.asInt () <= 0))
+            return rpcError (rpcINVALID_PARAMS);
+
+        limit = jLimit.asInt ();
+
+        if ((limit > maxLimit) && (mRole != Config::ADMIN))
+            limit = maxLimit;
+    }
+
+    loadType = bBinary ? Resource::feeMediumBurdenRPC : Resource::feeHighBurdenRPC;
+
+    SHAMap::ref map = lpLedger->peekAccountStateMap ();
+    Json::Value& nodes = (jvResult["state"] = Json::arrayValue);
+
+    SHAMapItem::pointer item = bResume ? map->peekNextItem (resumePoint) : map->peekFirstItem ();
+
+    while (item && (limit-- > 0))
+    {
+        resumePoint = item->getTag ();
+
+        if (bBinary)
+        {
+            Json::Value& entry = nodes.append (Json::objectValue);
+            entry["data"] = strHex (item->peekData ());
+            entry["index"] = resumePoint.GetHex ();
+        }
+        else
+        {
+            SerializedLedgerEntry sle (item->peekSerializer (), resumePoint);
+            Json::Value& entry = nodes.append (sle.getJson (0));
+            entry["index"] = resumePoint.GetHex ();
+        }
+
+        item = map->peekNextItem (resumePoint);
+    }
+
+    if (item)
+        jvResult["marker"] = resumePoint.GetHex ();
+
+    return jvResult;
+}
+
 boost::unordered_set<RippleAddress> RPCHandler::parseAccountIds (const Json::Value& jvArray)
 {
     boost::unordered_set<RippleAddress> usnaResult;
@@ -3409,6 +3648,10 @@ Json::Value RPCHandler::doSubscribe (Json::Value params, Resource::Charge& loadT
         ispSub  = mInfoSub;
     }
 
+    // Transaction events are sent as serialized blobs rather than JSON.
+    if (params.isMember ("binary"))
+        ispSub->setBinary (params["binary"].asBool ());
+
     if (!params.isMember ("streams"))
     {
         nothing ();
@@ -3932,6 +4175,8 @@ Json::Value RPCHandler::doCommand (const Json::Value& params, int iRole, Resourc
         {   "consensus_info",       &RPCHandler::doConsensusInfo,       true,   optNone     },
         {   "get_counts",           &RPCHandler::doGetCounts,           true,   optNone     },
         {   "internal",             &RPCHandler::doInternal,            true,   optNone     },
+        {   "job_trace",            &RPCHandler::doJobTrace,            true,   optNone     },
+        {   "export_snapshot",      &RPCHandler::doExportSnapshot,      true,   optNetwork  },
         {   "feature",              &RPCHandler::doFeature,             true,   optNone     },
         {   "fetch_info",           &RPCHandler::doFetchInfo,           true,   optNone     },
         {   "ledger",               &RPCHandler::doLedger,              false,  optNetwork  },
@@ -3939,8 +4184,10 @@ Json::Value RPCHandler::doCommand (const Json::Value& params, int iRole, Resourc
         {   "ledger_cleaner",       &RPCHandler::doLedgerCleaner,       true,   optNetwork  },
         {   "ledger_closed",        &RPCHandler::doLedgerClosed,        false,  optClosed   },
         {   "ledger_current",       &RPCHandler::doLedgerCurrent,       false,  optCurrent  },
+        {   "ledger_data",          &RPCHandler::doLedgerData,          false,  optCurrent  },
         {   "ledger_entry",         &RPCHandler::doLedgerEntry,         false,  optCurrent  },
         {   "ledger_header",        &RPCHandler::doLedgerHeader,        false,  optCurrent  },
+        {   "lock_profile",         &RPCHandler::doLockProfile,         true,   optNone     },
         {   "log_level",            &RPCHandler::doLogLevel,            true,   optNone     },
         {   "logrotate",            &RPCHandler::doLogRotate,           true,   optNone     },
 //      {   "nickname_info",        &RPCHandler::doNicknameInfo,        false,  optCurrent  },
@@ -4028,8 +4275,12 @@ Json::Value RPCHandler::doCommand (const Json::Value& params, int iRole, Resourc
             {
                 LoadEvent::autoptr ev   = getApp().getJobQueue().getLoadEventAP(
                     jtGENERIC, std::string("cmd:") + strCommand);
+                double const start      = Time::getMillisecondCounterHiRes ();
                 Json::Value jvRaw       = (this->* (commandsA[i].dfpFunc)) (params, loadType, lock);
 
+                mNetOps->recordCommandLatency (commandsA[i].pCommand, static_cast <uint64> (
+                    (Time::getMillisecondCounterHiRes () - start) * 1000));
+
                 // Regularize result.
                 if (jvRaw.isObject ())
                 {
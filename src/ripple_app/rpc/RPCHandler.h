@@ -105,15 +105,19 @@ private:
     Json::Value doBlackList             (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doConnect               (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doConsensusInfo         (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
+    Json::Value doExportSnapshot        (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doFeature               (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doFetchInfo             (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doGetCounts             (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doInternal              (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
+    Json::Value doJobTrace              (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
+    Json::Value doLockProfile           (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedger                (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedgerAccept          (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedgerCleaner         (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedgerClosed          (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedgerCurrent         (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
+    Json::Value doLedgerData            (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedgerEntry           (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedgerHeader          (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLogLevel              (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
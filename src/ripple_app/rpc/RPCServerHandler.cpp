@@ -130,3 +130,30 @@ std::string RPCServerHandler::processRequest (std::string const& request, std::s
 
     return createResponse (200, response);
 }
+
+std::string RPCServerHandler::processMetrics (std::string const& remoteAddress)
+{
+    // Metrics reveal server internals, so only admins may read them
+    if (getConfig ().getAdminRole (Json::Value (Json::objectValue),
+        remoteAddress) != Config::ADMIN)
+    {
+        return HTTPReply (403, "Forbidden");
+    }
+
+    shared_ptr <insight::TextCollector> const& collector (
+        getApp().getCollectorManager().textCollector());
+
+    if (collector == nullptr)
+        return HTTPReply (404, "Not Found");
+
+    std::string const body (collector->text ());
+
+    std::stringstream ss;
+    ss <<
+        "HTTP/1.1 200 OK\r\n" <<
+        "Content-Type: text/plain; version=0.0.4\r\n" <<
+        "Content-Length: " << body.size () << "\r\n" <<
+        "\r\n" <<
+        body;
+    return ss.str ();
+}
@@ -35,6 +35,8 @@ public:
 
     std::string processRequest (std::string const& request, std::string const& remoteAddress);
 
+    std::string processMetrics (std::string const& remoteAddress);
+
 private:
     NetworkOPs& m_networkOPs;
     Resource::Manager& m_resourceManager;
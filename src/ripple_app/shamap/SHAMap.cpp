@@ -61,6 +61,23 @@ SHAMap::SHAMap (SHAMapType t, uint256 const& hash,
     mTNByID[*root] = root;
 }
 
+SHAMap::SHAMap (SHAMapType t, LedgerSnapshot::ref snapshot)
+    : mLock (this, "SHAMap", __FILE__, __LINE__)
+    , mSeq (1)
+    , mLedgerSeq (0)
+    , mState (smsImmutable)
+    , mType (t)
+    , m_missing_node_handler (DefaultMissingNodeHandler ())
+    , m_snapshot (snapshot)
+{
+    if (t == smtSTATE)
+        mTNByID.rehash (STATE_MAP_BUCKETS);
+
+    root = boost::make_shared<SHAMapTreeNode> (mSeq, SHAMapNode (0, uint256 ()));
+    root->makeInner ();
+    mTNByID[*root] = root;
+}
+
 TaggedCacheType< SHAMap::TNIndex, SHAMapTreeNode, UptimeTimerAdapter>
     SHAMap::treeNodeCache ("TreeNodeCache", 65536, 60);
 
@@ -118,6 +135,7 @@ SHAMap::pointer SHAMap::snapShot (bool isMutable)
         newMap.mSeq = mSeq;
         newMap.mTNByID = mTNByID;
         newMap.root = root;
+        newMap.m_snapshot = m_snapshot;
 
         if (!isMutable)
             newMap.mState = smsImmutable;
@@ -895,6 +913,9 @@ SHAMapTreeNode::pointer SHAMap::fetchNodeExternalNT (const SHAMapNode& id, uint2
 {
     SHAMapTreeNode::pointer ret;
 
+    if (m_snapshot != nullptr)
+        return fetchNodeSnapshot (id, hash);
+
     if (!getApp().running ())
         return ret;
 
@@ -955,6 +976,51 @@ SHAMapTreeNode::pointer SHAMap::fetchNodeExternalNT (const SHAMapNode& id, uint2
     return ret;
 }
 
+// Nodes of a mounted snapshot are not put in the tree node cache or fetched
+// from the network, the map holds on to them until its cache is dropped.
+SHAMapTreeNode::pointer SHAMap::fetchNodeSnapshot (const SHAMapNode& id, uint256 const& hash)
+{
+    SHAMapTreeNode::pointer ret;
+
+    unsigned char const* data;
+    std::size_t size;
+
+    if (!m_snapshot->findNode (mType, hash, data, size))
+        return ret;
+
+    try
+    {
+        // The file is not trusted, so every node is hashed
+        ret = boost::make_shared<SHAMapTreeNode> (id, Blob (data, data + size), 0, snfPREFIX, hash, false);
+    }
+    catch (...)
+    {
+        WriteLog (lsWARNING, SHAMap) << "Snapshot " << m_snapshot->getFile ().getFileName () <<
+            " has an invalid node: " << hash;
+        return SHAMapTreeNode::pointer ();
+    }
+
+    if (ret->getNodeHash () != hash)
+    {
+        WriteLog (lsWARNING, SHAMap) << "Snapshot " << m_snapshot->getFile ().getFileName () <<
+            " has a damaged node: " << hash;
+        return SHAMapTreeNode::pointer ();
+    }
+
+    if (id != *ret)
+    {
+        WriteLog (lsWARNING, SHAMap) << "Snapshot id:" << id << ", got:" << *ret;
+        return SHAMapTreeNode::pointer ();
+    }
+
+    mTNByID[id] = ret;
+
+    if (id.isRoot ())
+        root = ret;
+
+    return ret;
+}
+
 bool SHAMap::fetchRoot (uint256 const& hash, SHAMapSyncFilter* filter)
 {
     if (hash == root->getNodeHash ())
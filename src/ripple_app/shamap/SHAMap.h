@@ -68,6 +68,9 @@ public:
     SHAMap (SHAMapType t, uint256 const& hash,
         MissingNodeHandler missing_node_handler = DefaultMissingNodeHandler());
 
+    // build a read-only map whose nodes are read from a mounted snapshot
+    SHAMap (SHAMapType t, LedgerSnapshot::ref snapshot);
+
     ~SHAMap ();
 
     std::size_t size () const noexcept
@@ -219,6 +222,8 @@ public:
     void getFetchPack (SHAMap * have, bool includeLeaves, int max, FUNCTION_TYPE<void (const uint256&, const Blob&)>);
 
     // tree node cache operations
+    typedef std::pair<uint256, SHAMapNode> TNIndex;
+
     static SHAMapTreeNode::pointer getCache (uint256 const& hash, SHAMapNode const& id);
     static void canonicalize (uint256 const& hash, SHAMapTreeNode::pointer&);
 
@@ -240,11 +245,14 @@ public:
         treeNodeCache.setTargetSize (size);
         treeNodeCache.setTargetAge (age);
     }
+    static void getRecentTreeNodes (std::vector<TNIndex>& nodes, int maximum)
+    {
+        treeNodeCache.getRecentKeys (nodes, maximum);
+    }
 
 private:
     static KeyCache <uint256, UptimeTimerAdapter> fullBelowCache;
 
-    typedef std::pair<uint256, SHAMapNode> TNIndex;
     static TaggedCacheType <TNIndex, SHAMapTreeNode, UptimeTimerAdapter> treeNodeCache;
 
     void dirtyUp (std::stack<SHAMapTreeNode::pointer>& stack, uint256 const & target, uint256 prevHash);
@@ -266,6 +274,7 @@ private:
     SHAMapTreeNode* lastBelow (SHAMapTreeNode*);
 
     SHAMapItem::pointer onlyBelow (SHAMapTreeNode*);
+    SHAMapTreeNode::pointer fetchNodeSnapshot (const SHAMapNode & id, uint256 const & hash);
     void eraseChildren (SHAMapTreeNode::pointer);
     void dropBelow (SHAMapTreeNode*);
     bool hasInnerNode (const SHAMapNode & nodeID, uint256 const & hash);
@@ -291,6 +300,7 @@ private:
     SHAMapState mState;
     SHAMapType mType;
     MissingNodeHandler m_missing_node_handler;
+    LedgerSnapshot::pointer m_snapshot;
 };
 
 #endif
@@ -118,6 +118,8 @@ TER OfferCreateTransactor::takeOffers (
     STAmount&           saTakerGot,
     bool&               bUnfunded)
 {
+    TransactionProfile::ScopedSection section (TransactionProfile::takeOffers);
+
     // The book has the most elements. Take the perspective of the book.
     // Book is ordered for taker: taker pays / taker gets (smaller is better)
 
@@ -0,0 +1,458 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+class SpeculativeEngineImp
+    : public SpeculativeEngine
+    , public LeakChecked <SpeculativeEngineImp>
+{
+public:
+    enum
+    {
+        // Smaller batches are not worth taking a snapshot for
+        minimumBatch = 8
+    };
+
+    // Tracks the threads working on one batch
+    //
+    struct Batch
+    {
+        typedef boost::shared_ptr <Batch> Ptr;
+
+        explicit Batch (int tasks)
+        {
+            remaining = tasks;
+        }
+
+        Atomic <int> remaining;
+        WaitableEvent done;
+    };
+
+    // The result of applying one transaction to the snapshot
+    //
+    struct Speculation
+    {
+        Speculation ()
+            : result (temUNCERTAIN)
+            , didApply (false)
+            , valid (false)
+        {
+        }
+
+        TER result;
+        bool didApply;
+
+        // False if the transaction must be applied serially
+        bool valid;
+
+        LedgerEntrySet changes;
+        LedgerReadLog::pointer reads;
+    };
+
+    typedef std::vector <Speculation> Speculations;
+
+    //--------------------------------------------------------------------------
+
+    class Worker : public Thread
+    {
+    public:
+        explicit Worker (SpeculativeEngineImp& owner)
+            : Thread ("TxApply")
+            , m_owner (owner)
+        {
+            startThread ();
+        }
+
+        ~Worker ()
+        {
+            stopThread ();
+        }
+
+        void run ()
+        {
+            m_owner.m_service.run ();
+        }
+
+    private:
+        SpeculativeEngineImp& m_owner;
+    };
+
+    //--------------------------------------------------------------------------
+
+    SpeculativeEngineImp (int threads,
+        shared_ptr <insight::Collector> const& collector)
+        : m_work (new boost::asio::io_service::work (m_service))
+    {
+        m_speculated = collector->make_meter ("tx_apply_speculated");
+        m_conflicts = collector->make_meter ("tx_apply_conflicts");
+        m_batchLatency = collector->make_event ("tx_apply_batch_ms");
+
+        for (int i = 0; i < threads; ++i)
+            m_workers.add (new Worker (*this));
+    }
+
+    ~SpeculativeEngineImp ()
+    {
+        m_work = nullptr;
+        m_service.stop ();
+        m_workers.clear ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void apply (TransactionEngine& engine, Items& items)
+    {
+        double const start = Time::getMillisecondCounterHiRes ();
+
+        int const tasks = std::min <int> (m_workers.size (), items.size ());
+
+        if ((tasks <= 1) || (items.size () < minimumBatch))
+        {
+            for (std::size_t i = 0; i < items.size (); ++i)
+                applySerially (engine, items [i]);
+        }
+        else
+        {
+            applySpeculatively (engine, items, tasks);
+        }
+
+        m_batchLatency.notify (static_cast <insight::Event::value_type> (
+            Time::getMillisecondCounterHiRes () - start));
+    }
+
+    //--------------------------------------------------------------------------
+
+    void applySpeculatively (TransactionEngine& engine, Items& items, int tasks)
+    {
+        // The snapshot is hashed as it is made, so the workers only ever
+        // read the tree nodes which they share.
+        Ledger::pointer const snapshot (boost::make_shared <Ledger> (
+            boost::ref (*engine.getLedger ()), false));
+
+        Speculations speculations (items.size ());
+
+        Batch::Ptr batch (boost::make_shared <Batch> (tasks));
+
+        for (int task = 0; task < tasks; ++task)
+        {
+            m_service.post (boost::bind (&SpeculativeEngineImp::runBatchTask, this,
+                snapshot, boost::cref (items), boost::ref (speculations), task, tasks, batch));
+        }
+
+        batch->done.wait ();
+
+        // Keys written to the ledger by this batch so far
+        std::set <uint256> written;
+
+        std::set <uint256> seen;
+        bool serial = false;
+
+        for (std::size_t i = 0; i < items.size (); ++i)
+        {
+            Item& item (items [i]);
+            Speculation& s (speculations [i]);
+
+            if (isChange (*item.txn))
+                serial = true;
+
+            // A repeated transaction would find itself in the ledger
+            bool const repeated (! seen.insert (item.txn->getTransactionID ()).second);
+
+            if (serial || repeated || ! s.valid || conflicts (s, written))
+            {
+                ++m_conflicts;
+                reapply (engine, item, written, serial);
+                continue;
+            }
+
+            ++m_speculated;
+
+            item.result = s.result;
+            item.didApply = s.didApply;
+
+            if (item.didApply)
+            {
+                try
+                {
+                    engine.commitTransaction (*item.txn, item.params, item.result, s.changes);
+                    noteWrites (s.changes, written);
+                }
+                catch (...)
+                {
+                    item.threw = true;
+                    serial = true;
+                }
+            }
+        }
+    }
+
+    // Returns true if the transaction may have seen something which an
+    // earlier transaction in the batch went on to change.
+    //
+    static bool conflicts (Speculation const& s, std::set <uint256> const& written)
+    {
+        if (s.reads->intersects (written))
+            return true;
+
+        for (LedgerEntrySet::const_iterator it = s.changes.begin (); it != s.changes.end (); ++it)
+        {
+            if (written.count (it->first) != 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    static void noteWrites (LedgerEntrySet const& changes, std::set <uint256>& written)
+    {
+        for (LedgerEntrySet::const_iterator it = changes.begin (); it != changes.end (); ++it)
+        {
+            if (it->second.mAction != taaCACHED)
+                written.insert (it->first);
+        }
+    }
+
+    static bool isChange (SerializedTransaction const& txn)
+    {
+        return (txn.getTxnType () == ttFEATURE) || (txn.getTxnType () == ttFEE);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void applySerially (TransactionEngine& engine, Item& item)
+    {
+        try
+        {
+            item.result = engine.applyTransaction (*item.txn, item.params, item.didApply);
+        }
+        catch (...)
+        {
+            item.threw = true;
+        }
+    }
+
+    // Applies a transaction against the real ledger, in the middle of a
+    // batch. If it throws, we can't tell what was written so the rest of
+    // the batch is applied serially.
+    //
+    void reapply (TransactionEngine& engine, Item& item,
+        std::set <uint256>& written, bool& serial)
+    {
+        LedgerEntrySet changes;
+
+        try
+        {
+            item.result = engine.speculateTransaction (*item.txn, item.params,
+                item.didApply, changes, LedgerReadLog::pointer ());
+
+            if (item.didApply)
+            {
+                engine.commitTransaction (*item.txn, item.params, item.result, changes);
+                noteWrites (changes, written);
+            }
+        }
+        catch (...)
+        {
+            item.threw = true;
+            serial = true;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Applies every `tasks`th transaction to a view of the snapshot
+    //
+    void runTask (Ledger::ref snapshot, Items const& items,
+        Speculations& speculations, int task, int tasks)
+    {
+        TransactionEngine engine (snapshot);
+
+        for (std::size_t i = task; i < items.size (); i += tasks)
+        {
+            Item const& item (items [i]);
+            Speculation& s (speculations [i]);
+
+            if (isChange (*item.txn))
+                continue;
+
+            s.reads = boost::make_shared <LedgerReadLog> ();
+
+            try
+            {
+                s.result = engine.speculateTransaction (*item.txn, item.params,
+                    s.didApply, s.changes, s.reads);
+                s.valid = true;
+            }
+            catch (...)
+            {
+                // Applied again serially, where the exception is reported
+            }
+        }
+    }
+
+    void runBatchTask (Ledger::pointer snapshot, Items const& items,
+        Speculations& speculations, int task, int tasks, Batch::Ptr batch)
+    {
+        runTask (snapshot, items, speculations, task, tasks);
+
+        if (--batch->remaining == 0)
+            batch->done.signal ();
+    }
+
+private:
+    boost::asio::io_service m_service;
+    ScopedPointer <boost::asio::io_service::work> m_work;
+    OwnedArray <Worker> m_workers;
+
+    insight::Meter m_speculated;
+    insight::Meter m_conflicts;
+    insight::Event m_batchLatency;
+};
+
+//------------------------------------------------------------------------------
+
+SpeculativeEngine* SpeculativeEngine::New (int threads,
+    shared_ptr <insight::Collector> const& collector)
+{
+    return new SpeculativeEngineImp (threads, collector);
+}
+
+//------------------------------------------------------------------------------
+
+class SpeculativeEngineTests : public UnitTest
+{
+public:
+    SpeculativeEngineTests () : UnitTest ("SpeculativeEngine", "ripple")
+    {
+    }
+
+    struct Account
+    {
+        explicit Account (std::string const& passphrase)
+            : sequence (1)
+        {
+            RippleAddress const seed (RippleAddress::createSeedGeneric (passphrase));
+            RippleAddress const generator (RippleAddress::createGeneratorPublic (seed));
+            publicKey = RippleAddress::createAccountPublic (generator, 0);
+            privateKey = RippleAddress::createAccountPrivate (generator, seed, 0);
+        }
+
+        RippleAddress publicKey;
+        RippleAddress privateKey;
+        uint32 sequence;
+    };
+
+    static SerializedTransaction::pointer pay (Account& from, Account const& to, uint64 amount)
+    {
+        SerializedTransaction::pointer txn (boost::make_shared <SerializedTransaction> (ttPAYMENT));
+        txn->setSourceAccount (from.publicKey);
+        txn->setSigningPubKey (from.publicKey);
+        txn->setFieldU32 (sfSequence, from.sequence++);
+        txn->setFieldAmount (sfFee, STAmount (10));
+        txn->setFieldAccount (sfDestination, to.publicKey);
+        txn->setFieldAmount (sfAmount, STAmount (amount));
+        txn->sign (from.privateKey);
+        return txn;
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("serial equivalence");
+
+        uint64 const xrp (SYSTEM_CURRENCY_PARTS);
+
+        Account master ("speculative master");
+        Ledger::pointer const genesis (boost::make_shared <Ledger> (
+            master.publicKey, SYSTEM_CURRENCY_START));
+
+        std::vector <Account> sources;
+        std::vector <Account> destinations;
+
+        {
+            TransactionEngine engine (genesis);
+
+            for (int i = 0; i < 16; ++i)
+            {
+                sources.push_back (Account ("speculative source " + lexicalCast <std::string> (i)));
+                destinations.push_back (Account ("speculative destination " + lexicalCast <std::string> (i)));
+
+                bool didApply;
+                engine.applyTransaction (*pay (master, sources.back (), 10000 * xrp), tapNONE, didApply);
+                expect (didApply);
+            }
+        }
+
+        SpeculativeEngine::Items items;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            SpeculativeEngine::Item item;
+            item.txn = pay (sources [i], destinations [i], 1000 * xrp);
+            items.push_back (item);
+
+            // Every few transactions, one which depends on the last
+            if ((i % 4) == 3)
+            {
+                item.txn = pay (sources [i - 1], sources [i], 100 * xrp);
+                items.push_back (item);
+                item.txn = pay (sources [i], destinations [i - 2], 10 * xrp);
+                items.push_back (item);
+            }
+        }
+
+        // Too early, and for more than the source holds
+        ++sources [5].sequence;
+        items.push_back (SpeculativeEngine::Item ());
+        items.back ().txn = pay (sources [5], destinations [6], xrp);
+        items.push_back (SpeculativeEngine::Item ());
+        items.back ().txn = pay (sources [7], destinations [8], 100000 * xrp);
+
+        Ledger::pointer const serialLedger (boost::make_shared <Ledger> (boost::ref (*genesis), true));
+        Ledger::pointer const batchLedger (boost::make_shared <Ledger> (boost::ref (*genesis), true));
+
+        std::vector <TER> serialResults;
+
+        {
+            TransactionEngine engine (serialLedger);
+
+            for (std::size_t i = 0; i < items.size (); ++i)
+            {
+                bool didApply;
+                serialResults.push_back (engine.applyTransaction (*items [i].txn, tapNONE, didApply));
+            }
+        }
+
+        {
+            SpeculativeEngineImp speculative (4, insight::NullCollector::New ());
+            TransactionEngine engine (batchLedger);
+            speculative.apply (engine, items);
+        }
+
+        for (std::size_t i = 0; i < items.size (); ++i)
+        {
+            expect (! items [i].threw);
+            expect (items [i].result == serialResults [i], "Result differs from serial");
+        }
+
+        expect (batchLedger->peekAccountStateMap ()->getHash () ==
+            serialLedger->peekAccountStateMap ()->getHash (), "State differs from serial");
+        expect (batchLedger->peekTransactionMap ()->getHash () ==
+            serialLedger->peekTransactionMap ()->getHash (), "Transactions differ from serial");
+    }
+};
+
+static SpeculativeEngineTests speculativeEngineTests;
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+#ifndef RIPPLE_APP_SPECULATIVEENGINE_H_INCLUDED
+#define RIPPLE_APP_SPECULATIVEENGINE_H_INCLUDED
+
+/** Applies batches of transactions using several threads.
+
+    Each transaction in a batch is first applied against a private view of
+    an immutable snapshot of the ledger, recording every ledger key it reads
+    and every entry it touches. The results are then committed one at a time
+    in batch order. A transaction which read or touched anything written by
+    an earlier transaction in the batch is applied again, serially, against
+    the real ledger. The ledger, the metadata and the results are therefore
+    exactly what applying the batch one transaction at a time would produce.
+
+    Fee and feature changes have effects outside the ledger, so they and
+    everything after them in a batch are applied serially.
+
+    The number of transactions committed from their speculative result is
+    reported to the collector as "tx_apply_speculated", the number applied
+    again as "tx_apply_conflicts", and each batch, in milliseconds, as
+    "tx_apply_batch_ms".
+*/
+class SpeculativeEngine
+{
+public:
+    /** One transaction to apply. */
+    struct Item
+    {
+        Item ()
+            : params (tapNONE)
+            , result (temUNCERTAIN)
+            , didApply (false)
+            , threw (false)
+        {
+        }
+
+        SerializedTransaction::pointer txn;
+        TransactionEngineParams params;
+
+        /** Set by apply. */
+        TER result;
+        bool didApply;
+
+        /** Set by apply if applying the transaction threw an exception. */
+        bool threw;
+    };
+
+    typedef std::vector <Item> Items;
+
+    /** Create the engine.
+
+        @param threads The number of threads which apply transactions.
+                       With zero, every batch is applied serially.
+    */
+    static SpeculativeEngine* New (int threads,
+        shared_ptr <insight::Collector> const& collector);
+
+    virtual ~SpeculativeEngine () { }
+
+    /** Apply a batch of transactions to the ledger of an engine.
+        This returns when every transaction has been applied, with the
+        results stored in each Item.
+    */
+    virtual void apply (TransactionEngine& engine, Items& items) = 0;
+};
+
+#endif
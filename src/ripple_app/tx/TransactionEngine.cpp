@@ -31,6 +31,9 @@ void TransactionEngine::txnWrite ()
     {
         SLE::ref    sleEntry    = it.second.mEntry;
 
+        if (it.second.mAction != taaCACHED)
+            TransactionProfile::onWrite ();
+
         switch (it.second.mAction)
         {
         case taaNONE:
@@ -72,6 +75,49 @@ void TransactionEngine::txnWrite ()
 
 TER TransactionEngine::applyTransaction (const SerializedTransaction& txn, TransactionEngineParams params,
         bool& didApply)
+{
+    TER terResult = executeTransaction (txn, params, didApply);
+
+    if (didApply)
+        writeTransaction (txn, params, terResult);
+
+    mTxnAccount.reset ();
+    mNodes.clear ();
+
+    return terResult;
+}
+
+TER TransactionEngine::speculateTransaction (const SerializedTransaction& txn, TransactionEngineParams params,
+        bool& didApply, LedgerEntrySet& changes, LedgerReadLog::pointer const& reads)
+{
+    mNodes.setReadLog (reads);
+
+    TER terResult = executeTransaction (txn, params, didApply);
+
+    mNodes.setReadLog (LedgerReadLog::pointer ());
+    mTxnAccount.reset ();
+
+    changes.swapWith (mNodes);
+    mNodes.clear ();
+
+    return terResult;
+}
+
+void TransactionEngine::commitTransaction (const SerializedTransaction& txn, TransactionEngineParams params,
+        TER result, LedgerEntrySet& changes)
+{
+    // The changes may have been made against a snapshot of our ledger
+    mNodes.swapWith (changes);
+    mNodes.getLedger () = mLedger;
+
+    writeTransaction (txn, params, result);
+
+    mNodes.swapWith (changes);
+    mNodes.clear ();
+}
+
+TER TransactionEngine::executeTransaction (const SerializedTransaction& txn, TransactionEngineParams params,
+        bool& didApply)
 {
     WriteLog (lsTRACE, TransactionEngine) << "applyTransaction>";
     didApply = false;
@@ -172,45 +218,8 @@ TER TransactionEngine::applyTransaction (const SerializedTransaction& txn, Trans
                 didApply = false;
                 terResult = tefINTERNAL;
             }
-            else
-            {
-                // Transaction succeeded fully or (retries are not allowed and the transaction could claim a fee)
-                Serializer m;
-                mNodes.calcRawMeta (m, terResult, mTxnSeq++);
-
-                txnWrite ();
-
-                Serializer s;
-                txn.add (s);
-
-                if (isSetBit (params, tapOPEN_LEDGER))
-                {
-                    if (!mLedger->addTransaction (txID, s))
-                    {
-                        WriteLog (lsFATAL, TransactionEngine) << "Tried to add transaction to open ledger that already had it";
-                        assert (false);
-                        throw std::runtime_error ("Duplicate transaction applied");
-                    }
-                }
-                else
-                {
-                    if (!mLedger->addTransaction (txID, s, m))
-                    {
-                        WriteLog (lsFATAL, TransactionEngine) << "Tried to add transaction to ledger that already had it";
-                        assert (false);
-                        throw std::runtime_error ("Duplicate transaction applied to closed ledger");
-                    }
-
-                    // Charge whatever fee they specified.
-                    STAmount saPaid = txn.getTransactionFee ();
-                    mLedger->destroyCoins (saPaid.getNValue ());
-                }
-            }
         }
 
-        mTxnAccount.reset ();
-        mNodes.clear ();
-
         if (!isSetBit (params, tapOPEN_LEDGER) && isTemMalformed (terResult))
         {
             // XXX Malformed or failed transaction in closed ledger must bow out.
@@ -225,4 +234,42 @@ TER TransactionEngine::applyTransaction (const SerializedTransaction& txn, Trans
     }
 }
 
+void TransactionEngine::writeTransaction (const SerializedTransaction& txn, TransactionEngineParams params,
+        TER terResult)
+{
+    // Transaction succeeded fully or (retries are not allowed and the transaction could claim a fee)
+    uint256 txID        = txn.getTransactionID ();
+
+    Serializer m;
+    mNodes.calcRawMeta (m, terResult, mTxnSeq++);
+
+    txnWrite ();
+
+    Serializer s;
+    txn.add (s);
+
+    if (isSetBit (params, tapOPEN_LEDGER))
+    {
+        if (!mLedger->addTransaction (txID, s))
+        {
+            WriteLog (lsFATAL, TransactionEngine) << "Tried to add transaction to open ledger that already had it";
+            assert (false);
+            throw std::runtime_error ("Duplicate transaction applied");
+        }
+    }
+    else
+    {
+        if (!mLedger->addTransaction (txID, s, m))
+        {
+            WriteLog (lsFATAL, TransactionEngine) << "Tried to add transaction to ledger that already had it";
+            assert (false);
+            throw std::runtime_error ("Duplicate transaction applied to closed ledger");
+        }
+
+        // Charge whatever fee they specified.
+        STAmount saPaid = txn.getTransactionFee ();
+        mLedger->destroyCoins (saPaid.getNValue ());
+    }
+}
+
 // vim:ts=4
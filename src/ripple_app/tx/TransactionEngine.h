@@ -34,6 +34,9 @@ public:
 private:
     LedgerEntrySet      mNodes;
 
+    TER executeTransaction (const SerializedTransaction&, TransactionEngineParams, bool & didApply);
+    void writeTransaction (const SerializedTransaction&, TransactionEngineParams, TER result);
+
     TER setAuthorized (const SerializedTransaction & txn, bool bMustSetGenerator);
     TER checkSig (const SerializedTransaction & txn);
 
@@ -100,6 +103,17 @@ public:
     }
 
     TER applyTransaction (const SerializedTransaction&, TransactionEngineParams, bool & didApply);
+
+    // Apply a transaction without writing anything to the ledger. The entries it
+    // touched are left in changes and the keys it read are recorded in reads.
+    TER speculateTransaction (const SerializedTransaction&, TransactionEngineParams, bool & didApply,
+                              LedgerEntrySet & changes, LedgerReadLog::pointer const & reads);
+
+    // Write the result of speculateTransaction to this engine's ledger. Afterwards
+    // changes also holds the entries touched while threading the metadata.
+    void commitTransaction (const SerializedTransaction&, TransactionEngineParams, TER result,
+                            LedgerEntrySet & changes);
+
     bool checkInvariants (TER result, const SerializedTransaction & txn, TransactionEngineParams params);
 };
 
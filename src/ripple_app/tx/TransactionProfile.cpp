@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+ThreadLocalValue <TransactionProfile::Sample*> TransactionProfile::s_sample;
+
+TransactionProfile::Sample::Sample ()
+    : sleReads (0)
+    , sleWrites (0)
+{
+    for (int i = 0; i < sectionCount; ++i)
+        ticks [i] = 0;
+}
+
+TransactionProfile::ScopedSample::ScopedSample (Sample& sample)
+    : m_previous (s_sample.get ())
+{
+    s_sample.get () = &sample;
+}
+
+TransactionProfile::ScopedSample::~ScopedSample ()
+{
+    s_sample.get () = m_previous;
+}
+
+TransactionProfile::ScopedSection::ScopedSection (Section section)
+    : m_sample (s_sample.get ())
+    , m_section (section)
+    , m_start (0)
+{
+    if (m_sample != nullptr)
+        m_start = Time::getHighResolutionTicks ();
+}
+
+TransactionProfile::ScopedSection::~ScopedSection ()
+{
+    if (m_sample != nullptr)
+        m_sample->ticks [m_section] += Time::getHighResolutionTicks () - m_start;
+}
+
+void TransactionProfile::onRead ()
+{
+    Sample* const sample (s_sample.get ());
+    if (sample != nullptr)
+        ++sample->sleReads;
+}
+
+void TransactionProfile::onWrite ()
+{
+    Sample* const sample (s_sample.get ());
+    if (sample != nullptr)
+        ++sample->sleWrites;
+}
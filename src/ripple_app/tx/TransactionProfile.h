@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_TRANSACTIONPROFILE_H_INCLUDED
+#define RIPPLE_APP_TRANSACTIONPROFILE_H_INCLUDED
+
+/** Measures where the time goes while a transaction is applied.
+
+    A Sample is attached to the calling thread around the application of
+    one transaction. Code on the apply path reports into it through the
+    static functions, which do nothing when no Sample is attached. Path
+    finding, for example, also runs RippleCalc but is never counted.
+*/
+class TransactionProfile
+{
+public:
+    enum Section
+    {
+        rippleCalc,
+        takeOffers,
+
+        sectionCount
+    };
+
+    struct Sample
+    {
+        Sample ();
+
+        /** High resolution ticks spent in each section. */
+        int64 ticks [sectionCount];
+
+        /** Ledger entries read from, and written to, the ledger. */
+        int sleReads;
+        int sleWrites;
+    };
+
+    /** Attaches a sample to the current thread while in scope. */
+    class ScopedSample : public Uncopyable
+    {
+    public:
+        explicit ScopedSample (Sample& sample);
+        ~ScopedSample ();
+
+    private:
+        Sample* m_previous;
+    };
+
+    /** Adds the time spent in scope to a section of the attached sample. */
+    class ScopedSection : public Uncopyable
+    {
+    public:
+        explicit ScopedSection (Section section);
+        ~ScopedSection ();
+
+    private:
+        Sample* m_sample;
+        Section m_section;
+        int64 m_start;
+    };
+
+    /** Count a ledger entry read from the ledger. */
+    static void onRead ();
+
+    /** Count a ledger entry created, modified or deleted in the ledger. */
+    static void onWrite ();
+
+private:
+    static ThreadLocalValue <Sample*> s_sample;
+};
+
+#endif
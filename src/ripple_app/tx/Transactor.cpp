@@ -221,8 +221,21 @@ TER Transactor::apply ()
 
     if (terResult != tesSUCCESS) return (terResult);
 
+    // Nothing writes to an immutable ledger, so the speculative engines
+    // can all apply against the same snapshot without taking its lock.
+    if (mEngine->getLedger ()->isImmutable ())
+        return applyLocked ();
+
     Ledger::ScopedLockType sl (mEngine->getLedger ()->mLock, __FILE__, __LINE__);
 
+    return applyLocked ();
+}
+
+// Called with the ledger locked, unless the ledger is immutable
+TER Transactor::applyLocked ()
+{
+    TER     terResult   = tesSUCCESS;
+
     mTxnAccount = mEngine->entryCache (ltACCOUNT_ROOT, Ledger::getAccountRootIndex (mTxnAccountID));
     calculateFee ();
 
@@ -29,6 +29,9 @@ public:
 
     TER apply ();
 
+private:
+    TER applyLocked ();
+
 protected:
     const SerializedTransaction&    mTxn;
     TransactionEngine*              mEngine;
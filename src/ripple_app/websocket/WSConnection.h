@@ -132,12 +132,12 @@ public:
             m_serverHandler.send (ptr, jvObj, broadcast);
     }
 
-    void send (const Json::Value& jvObj, const std::string& sObj, bool broadcast)
+    void send (EventPayload::ref payload, bool broadcast)
     {
         connection_ptr ptr = m_connection.lock ();
 
         if (ptr)
-            m_serverHandler.send (ptr, sObj, broadcast);
+            m_serverHandler.send (ptr, payload, broadcast);
     }
 
     void disconnect ()
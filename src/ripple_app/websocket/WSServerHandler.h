@@ -118,6 +118,20 @@ public:
         }
     }
 
+    static void ssendp (connection_ptr cpClient, EventPayload::pointer payload, bool broadcast)
+    {
+        try
+        {
+            WriteLog (broadcast ? lsTRACE : lsDEBUG, WSServerHandlerLog) << "Ws:: Sending '" << payload->getText () << "'";
+
+            cpClient->send (payload->getText ());
+        }
+        catch (...)
+        {
+            cpClient->close (websocketpp::close::status::value (crTooSlow), std::string ("Client is too slow."));
+        }
+    }
+
     void send (connection_ptr cpClient, message_ptr mpMessage)
     {
         cpClient->get_strand ().post (BIND_TYPE (
@@ -130,6 +144,14 @@ public:
                                           &WSServerHandler<endpoint_type>::ssendb, cpClient, strMessage, broadcast));
     }
 
+    // The payload is shared by every subscriber of the event, only the
+    // reference is bound into the handler.
+    void send (connection_ptr cpClient, EventPayload::ref payload, bool broadcast)
+    {
+        cpClient->get_strand ().post (BIND_TYPE (
+                                          &WSServerHandler<endpoint_type>::ssendp, cpClient, payload, broadcast));
+    }
+
     void send (connection_ptr cpClient, const Json::Value& jvObj, bool broadcast)
     {
         Json::FastWriter    jfwWriter;
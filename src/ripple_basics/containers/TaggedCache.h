@@ -63,7 +63,7 @@ public:
     typedef TaggedCache::ScopedLockType ScopedLockType;
 
     TaggedCacheType (const char* name, int size, int age)
-        : mLock (static_cast <TaggedCache const*>(this), "TaggedCache", __FILE__, __LINE__)
+        : mLock (static_cast <TaggedCache const*>(this), String ("TaggedCache:") + name, __FILE__, __LINE__)
         , mName (name)
         , mTargetSize (size)
         , mTargetAge (age)
@@ -138,6 +138,44 @@ public:
         return found;
     }
 
+    /** Retrieve the keys of the most recently used cached objects.
+
+        Only strongly cached entries are considered. The keys are
+        returned in order of most recent use first.
+
+        @param keys Receives the keys. Existing contents are replaced.
+        @param maximum The largest number of keys to return.
+    */
+    void getRecentKeys (std::vector <key_type>& keys, std::size_t maximum)
+    {
+        typedef std::pair <int, key_type> use_pair;
+
+        std::vector <use_pair> uses;
+
+        {
+            ScopedLockType sl (mLock, __FILE__, __LINE__);
+
+            uses.reserve (mCacheCount);
+
+            for (cache_iterator cit = mCache.begin (); cit != mCache.end (); ++cit)
+            {
+                if (cit->second.isCached ())
+                    uses.push_back (use_pair (cit->second.last_use, cit->first));
+            }
+        }
+
+        std::size_t const count = std::min (maximum, uses.size ());
+
+        std::partial_sort (uses.begin (), uses.begin () + count, uses.end (),
+            boost::bind (&use_pair::first, _1) > boost::bind (&use_pair::first, _2));
+
+        keys.clear ();
+        keys.reserve (count);
+
+        for (std::size_t i = 0; i < count; ++i)
+            keys.push_back (uses [i].second);
+    }
+
     bool del (const key_type& key, bool valid);
 
     /** Replace aliased objects with originals.
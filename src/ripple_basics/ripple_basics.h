@@ -32,6 +32,10 @@
 # define RIPPLE_TRACK_MUTEXES 0
 #endif
 
+#ifndef RIPPLE_PROFILE_MUTEXES
+# define RIPPLE_PROFILE_MUTEXES 0
+#endif
+
 //------------------------------------------------------------------------------
 
 // From
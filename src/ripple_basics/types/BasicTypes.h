@@ -21,11 +21,14 @@
 #define RIPPLE_BASICTYPES_H
 
 /** Synchronization primitives.
-    This lets us switch between tracked and untracked mutexes.
+    This lets us switch between tracked, profiled and untracked mutexes.
 */
 #if RIPPLE_TRACK_MUTEXES
 typedef TrackedMutexType <boost::mutex> RippleMutex;
 typedef TrackedMutexType <boost::recursive_mutex> RippleRecursiveMutex;
+#elif RIPPLE_PROFILE_MUTEXES
+typedef ProfiledMutexType <boost::mutex> RippleMutex;
+typedef ProfiledMutexType <boost::recursive_mutex> RippleRecursiveMutex;
 #else
 typedef UntrackedMutexType <boost::mutex> RippleMutex;
 typedef UntrackedMutexType <boost::recursive_mutex> RippleRecursiveMutex;
@@ -70,6 +70,7 @@ Config::Config ()
     LEDGER_CREATOR          = false;
 
     RPC_ALLOW_REMOTE        = false;
+    RPC_CONCURRENCY         = 4;
     RPC_ADMIN_ALLOW.push_back ("127.0.0.1");
 
     PEER_SSL_CIPHER_LIST    = DEFAULT_PEER_SSL_CIPHER_LIST;
@@ -80,6 +81,8 @@ Config::Config ()
 
     PEER_PRIVATE            = false;
     PEERS_MAX               = 0;    // indicates "use default"
+    IO_REACTORS             = 0;
+    PEER_HANDSHAKE_THREADS  = 0;
 
     TRANSACTION_FEE_BASE    = DEFAULT_FEE_DEFAULT;
 
@@ -94,6 +97,7 @@ Config::Config ()
     FEE_CONTRACT_OPERATION  = DEFAULT_FEE_OPERATION;
 
     LEDGER_HISTORY          = 256;
+    TX_APPLY_THREADS        = 0;
 
     PATH_SEARCH_OLD         = DEFAULT_PATH_SEARCH_OLD;
     PATH_SEARCH             = DEFAULT_PATH_SEARCH;
@@ -307,6 +311,8 @@ void Config::load ()
             if (SectionSingleB (secConfig, SECTION_DATABASE_PATH, DATABASE_PATH))
                 DATA_DIR    = DATABASE_PATH;
 
+            (void) SectionSingleB (secConfig, SECTION_LEDGER_SNAPSHOTS, LEDGER_SNAPSHOTS);
+
 
             (void) SectionSingleB (secConfig, SECTION_VALIDATORS_SITE, VALIDATORS_SITE);
 
@@ -318,6 +324,12 @@ void Config::load ()
             if (SectionSingleB (secConfig, SECTION_PEERS_MAX, strTemp))
                 PEERS_MAX           = lexicalCastThrow <int> (strTemp);
 
+            if (SectionSingleB (secConfig, SECTION_IO_REACTORS, strTemp))
+                IO_REACTORS         = std::max (0, lexicalCastThrow <int> (strTemp));
+
+            if (SectionSingleB (secConfig, SECTION_PEER_HANDSHAKE_THREADS, strTemp))
+                PEER_HANDSHAKE_THREADS = std::max (0, lexicalCastThrow <int> (strTemp));
+
             smtTmp = SectionEntries (secConfig, SECTION_RPC_ADMIN_ALLOW);
 
             if (smtTmp)
@@ -346,6 +358,9 @@ void Config::load ()
             importNodeDatabase = parseKeyValueSection (
                 secConfig, ConfigSection::importNodeDatabase ());
 
+            accountHistoryDatabase = parseKeyValueSection (
+                secConfig, ConfigSection::accountHistoryDatabase ());
+
             if (SectionSingleB (secConfig, SECTION_PEER_PORT, strTemp))
                 peerListeningPort = lexicalCastThrow <int> (strTemp);
 
@@ -376,6 +391,9 @@ void Config::load ()
             if (SectionSingleB (secConfig, SECTION_RPC_ALLOW_REMOTE, strTemp))
                 RPC_ALLOW_REMOTE    = lexicalCastThrow <bool> (strTemp);
 
+            if (SectionSingleB (secConfig, SECTION_RPC_CONCURRENCY, strTemp))
+                RPC_CONCURRENCY     = std::max (1, lexicalCastThrow <int> (strTemp));
+
             if (SectionSingleB (secConfig, SECTION_NODE_SIZE, strTemp))
             {
                 if (strTemp == "tiny")
@@ -517,6 +535,9 @@ void Config::load ()
                     LEDGER_HISTORY = lexicalCastThrow <uint32> (strTemp);
             }
 
+            if (SectionSingleB (secConfig, SECTION_TX_APPLY_THREADS, strTemp))
+                TX_APPLY_THREADS    = std::max (0, lexicalCastThrow <int> (strTemp));
+
             if (SectionSingleB (secConfig, SECTION_PATH_SEARCH_OLD, strTemp))
                 PATH_SEARCH_OLD     = lexicalCastThrow <int> (strTemp);
             if (SectionSingleB (secConfig, SECTION_PATH_SEARCH, strTemp))
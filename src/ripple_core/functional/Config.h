@@ -333,6 +333,16 @@ public:
     bool doImport;
     StringPairArray importNodeDatabase;
 
+    /** Parameters for the account history store.
+
+        When present, account_tx is answered from a key-ordered store of
+        each account's transactions instead of the transaction database.
+        The 'path' key is required.
+
+        @see AccountHistory
+    */
+    StringPairArray accountHistoryDatabase;
+
     //
     //
     //--------------------------------------------------------------------------
@@ -359,16 +369,19 @@ public:
         NORMAL,
         LOAD,
         REPLAY,
-        NETWORK
+        NETWORK,
+        SNAPSHOT
     };
     StartUpType                 START_UP;
 
 
 
     std::string                 START_LEDGER;
+    std::string                 START_SNAPSHOT;         // Ledger snapshot file to import at startup.
 
     // Database
     std::string                 DATABASE_PATH;
+    std::string                 LEDGER_SNAPSHOTS;       // Directory of ledger snapshots to mount.
 
     // Network parameters
     int                         NETWORK_START_TIME;     // The Unix time we start ledger 0.
@@ -402,6 +415,8 @@ public:
     unsigned int                PEER_CONNECT_LOW_WATER;
     bool                        PEER_PRIVATE;           // True to ask peers not to relay current IP.
     unsigned int                PEERS_MAX;
+    int                         IO_REACTORS;            // Zero to share one io_service between the I/O threads.
+    int                         PEER_HANDSHAKE_THREADS; // Zero to handshake on the io_service.
 
     // Websocket networking parameters
     std::string                 WEBSOCKET_PUBLIC_IP;        // XXX Going away. Merge with the inbound peer connction.
@@ -429,6 +444,7 @@ public:
     std::string                 RPC_PASSWORD;
     std::string                 RPC_USER;
     bool                        RPC_ALLOW_REMOTE;
+    int                         RPC_CONCURRENCY;        // Requests processed at once per connection.
     Json::Value                 RPC_STARTUP;
 
     int                         RPC_SECURE;
@@ -461,6 +477,9 @@ public:
     uint32                      LEDGER_HISTORY;
     int                         NODE_SIZE;
 
+    // Transaction processing
+    int                         TX_APPLY_THREADS;       // Zero to apply transactions serially.
+
     // Client behavior
     int                         ACCOUNT_PROBE_MAX;      // How far to scan for accounts.
 
@@ -31,6 +31,7 @@ struct ConfigSection
     static String nodeDatabase ()                 { return "node_db"; }
     static String tempNodeDatabase ()             { return "temp_db"; }
     static String importNodeDatabase ()           { return "import_db"; }
+    static String accountHistoryDatabase ()       { return "account_history_db"; }
 };
 
 // VFALCO TODO Rename and replace these macros with variables.
@@ -47,9 +48,11 @@ struct ConfigSection
 #define SECTION_FEE_ACCOUNT_RESERVE     "fee_account_reserve"
 #define SECTION_FEE_OWNER_RESERVE       "fee_owner_reserve"
 #define SECTION_LEDGER_HISTORY          "ledger_history"
+#define SECTION_LEDGER_SNAPSHOTS        "ledger_snapshots"
 #define SECTION_INSIGHT                 "insight"
 #define SECTION_IPS                     "ips"
 #define SECTION_IPS_FIXED               "ips_fixed"
+#define SECTION_IO_REACTORS             "io_reactors"
 #define SECTION_NETWORK_QUORUM          "network_quorum"
 #define SECTION_NODE_SEED               "node_seed"
 #define SECTION_NODE_SIZE               "node_size"
@@ -58,6 +61,7 @@ struct ConfigSection
 #define SECTION_PATH_SEARCH_FAST        "path_search_fast"
 #define SECTION_PATH_SEARCH_MAX         "path_search_max"
 #define SECTION_PEER_CONNECT_LOW_WATER  "peer_connect_low_water"
+#define SECTION_PEER_HANDSHAKE_THREADS  "peer_handshake_threads"
 #define SECTION_PEER_IP                 "peer_ip"
 #define SECTION_PEER_PORT               "peer_port"
 #define SECTION_PEER_PROXY_PORT         "peer_port_proxy"
@@ -67,6 +71,7 @@ struct ConfigSection
 #define SECTION_PEER_SSL_CIPHER_LIST    "peer_ssl_cipher_list"
 #define SECTION_PEER_START_MAX          "peer_start_max"
 #define SECTION_RPC_ALLOW_REMOTE        "rpc_allow_remote"
+#define SECTION_RPC_CONCURRENCY         "rpc_concurrency"
 #define SECTION_RPC_ADMIN_ALLOW         "rpc_admin_allow"
 #define SECTION_RPC_ADMIN_USER          "rpc_admin_user"
 #define SECTION_RPC_ADMIN_PASSWORD      "rpc_admin_password"
@@ -85,6 +90,7 @@ struct ConfigSection
 #define SECTION_SMS_TO                  "sms_to"
 #define SECTION_SMS_URL                 "sms_url"
 #define SECTION_SNTP                    "sntp_servers"
+#define SECTION_TX_APPLY_THREADS        "transaction_apply_threads"
 #define SECTION_SSL_VERIFY              "ssl_verify"
 #define SECTION_SSL_VERIFY_FILE         "ssl_verify_file"
 #define SECTION_SSL_VERIFY_DIR          "ssl_verify_dir"
@@ -36,6 +36,7 @@ Job::Job (Job const& other)
     , mJob (other.mJob)
     , m_loadEvent (other.m_loadEvent)
     , mName (other.mName)
+    , m_queueTime (other.m_queueTime)
 {
 }
 
@@ -50,6 +51,7 @@ Job::Job (JobType type,
     , mJobIndex (index)
     , mJob (job)
     , mName (name)
+    , m_queueTime (RelativeTime::fromStartup ())
 {
     m_loadEvent = boost::make_shared <LoadEvent> (boost::ref (lm), name, false);
 }
@@ -62,6 +64,7 @@ Job& Job::operator= (Job const& other)
     m_loadEvent = other.m_loadEvent;
     mName = other.mName;
     m_cancelCallback = other.m_cancelCallback;
+    m_queueTime = other.m_queueTime;
     return *this;
 }
 
@@ -70,6 +73,16 @@ JobType Job::getType () const
     return mType;
 }
 
+std::string const& Job::getName () const
+{
+    return mName;
+}
+
+RelativeTime Job::getQueueTime () const
+{
+    return m_queueTime;
+}
+
 CancelCallback Job::getCancelCallback () const
 {
     bassert (! m_cancelCallback.empty());
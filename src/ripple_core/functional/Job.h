@@ -97,6 +97,11 @@ public:
 
     JobType getType () const;
 
+    std::string const& getName () const;
+
+    /** Returns the time the job was created, measured from startup. */
+    RelativeTime getQueueTime () const;
+
     CancelCallback getCancelCallback () const;
 
     /** Returns `true` if the running job should make a best-effort cancel. */
@@ -121,6 +126,7 @@ private:
     FUNCTION_TYPE <void (Job&)> mJob;
     LoadEvent::pointer          m_loadEvent;
     std::string                 mName;
+    RelativeTime                m_queueTime;
 };
 
 #endif
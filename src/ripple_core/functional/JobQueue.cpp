@@ -71,6 +71,7 @@ public:
     Workers m_workers;
     LoadMonitor m_loads [NUM_JOB_TYPES];
     CancelCallback m_cancelCallback;
+    JobTrace m_trace;
 
     //--------------------------------------------------------------------------
 
@@ -277,6 +278,13 @@ public:
         return count > 0;
     }
 
+    Json::Value getTraceJson (int limit)
+    {
+        return m_trace.getJson (limit);
+    }
+
+    //--------------------------------------------------------------------------
+
     Json::Value getJson (int)
     {
         Json::Value ret (Json::objectValue);
@@ -527,6 +535,7 @@ private:
         {
             Thread::setCurrentThreadName (name);
             m_journal.trace << "Doing " << name << " job";
+            JobTrace::ScopedJob trace (m_trace, job);
             job.doJob ();
         }
         else
@@ -65,6 +65,11 @@ public:
     virtual bool isOverloaded () = 0;
 
     virtual Json::Value getJson (int c = 0) = 0;
+
+    /** Returns the recent job timings in Chrome trace format.
+        @see JobTrace
+    */
+    virtual Json::Value getTraceJson (int limit = 0) = 0;
 };
 
 #endif
@@ -0,0 +1,346 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+struct JobTrace::Ring
+{
+    Ring (JobTrace const& owner_, int id_)
+        : owner (owner_)
+        , id (id_)
+        , next (0)
+        , running (false)
+        , window (0)
+    {
+    }
+
+    JobTrace const& owner;
+    int const id;
+
+    CriticalSection mutex;
+
+    // Finished jobs, oldest first starting at `next` once the buffer is full
+    std::vector <Record> records;
+    std::size_t next;
+
+    // The job this thread is running, if any
+    bool running;
+    Record current;
+
+    // Slowest finished jobs in `window` and in the window before it
+    int64 window;
+    std::vector <Record> slowest;
+    std::vector <Record> previous;
+};
+
+//------------------------------------------------------------------------------
+
+JobTrace::Record::Record ()
+    : type (jtINVALID)
+    , thread (0)
+    , queued (0)
+    , started (0)
+    , finished (0)
+    , lockWait (0)
+{
+}
+
+int64 JobTrace::Record::getRunTime (int64 now) const
+{
+    return (finished != 0 ? finished : now) - started;
+}
+
+//------------------------------------------------------------------------------
+
+double JobTrace::ScopedJob::getThreadWaitSeconds ()
+{
+#if RIPPLE_TRACK_MUTEXES
+    return TrackedMutex::getThreadWaitSeconds ();
+#elif RIPPLE_PROFILE_MUTEXES
+    return ProfiledMutex::getThreadWaitSeconds ();
+#else
+    return 0;
+#endif
+}
+
+JobTrace::ScopedJob::ScopedJob (JobTrace& trace, Job const& job)
+    : m_trace (trace)
+    , m_lockWaitStart (getThreadWaitSeconds ())
+{
+    Record record;
+    record.type = job.getType ();
+    record.name = job.getName ();
+    record.queued = int64 (job.getQueueTime ().inSeconds () * 1000000);
+    record.started = JobTrace::now ();
+    m_trace.started (record);
+}
+
+JobTrace::ScopedJob::~ScopedJob ()
+{
+    double const lockWait (getThreadWaitSeconds () - m_lockWaitStart);
+    m_trace.finished (JobTrace::now (), int64 (lockWait * 1000000));
+}
+
+//------------------------------------------------------------------------------
+
+JobTrace::JobTrace (int recordsPerThread, int slowestPerWindow, int windowSeconds)
+    : m_recordsPerThread (recordsPerThread)
+    , m_slowestPerWindow (slowestPerWindow)
+    , m_window (int64 (windowSeconds) * 1000000)
+{
+    bassert (m_recordsPerThread > 0);
+    bassert (m_slowestPerWindow > 0);
+    bassert (m_window > 0);
+}
+
+JobTrace::~JobTrace ()
+{
+    for (std::size_t i = 0; i < m_rings.size (); ++i)
+        delete m_rings [i];
+}
+
+int64 JobTrace::now ()
+{
+    return int64 (RelativeTime::fromStartup ().inSeconds () * 1000000);
+}
+
+JobTrace::Ring& JobTrace::getRing ()
+{
+    Ring*& ring (m_ring.get ());
+
+    // Some platforms share thread locals between instances
+    if (ring == nullptr || &ring->owner != this)
+    {
+        CriticalSection::ScopedLockType lock (m_mutex);
+        ring = new Ring (*this, int (m_rings.size () + 1));
+        ring->records.reserve (m_recordsPerThread);
+        m_rings.push_back (ring);
+    }
+
+    return *ring;
+}
+
+void JobTrace::started (Record const& record)
+{
+    Ring& ring (getRing ());
+    CriticalSection::ScopedLockType lock (ring.mutex);
+    ring.current = record;
+    ring.current.thread = ring.id;
+    ring.running = true;
+}
+
+void JobTrace::finished (int64 when, int64 lockWait)
+{
+    Ring& ring (getRing ());
+    CriticalSection::ScopedLockType lock (ring.mutex);
+
+    bassert (ring.running);
+    ring.running = false;
+    ring.current.finished = when;
+    ring.current.lockWait = lockWait;
+
+    if (ring.records.size () < std::size_t (m_recordsPerThread))
+    {
+        ring.records.push_back (ring.current);
+    }
+    else
+    {
+        ring.records [ring.next] = ring.current;
+        ring.next = (ring.next + 1) % ring.records.size ();
+    }
+
+    addSlowest (ring, ring.current);
+}
+
+// Called with the ring's lock held
+void JobTrace::addSlowest (Ring& ring, Record const& record)
+{
+    int64 const window (record.started / m_window);
+
+    if (window != ring.window)
+    {
+        if (window == ring.window + 1)
+            ring.previous.swap (ring.slowest);
+        else
+            ring.previous.clear ();
+        ring.slowest.clear ();
+        ring.window = window;
+    }
+
+    if (ring.slowest.size () < std::size_t (m_slowestPerWindow))
+    {
+        ring.slowest.push_back (record);
+        return;
+    }
+
+    // Replace the fastest of the slow jobs if this one took longer
+    std::size_t fastest (0);
+    for (std::size_t i = 1; i < ring.slowest.size (); ++i)
+    {
+        if (ring.slowest [i].getRunTime (0) < ring.slowest [fastest].getRunTime (0))
+            fastest = i;
+    }
+
+    if (record.getRunTime (0) > ring.slowest [fastest].getRunTime (0))
+        ring.slowest [fastest] = record;
+}
+
+//------------------------------------------------------------------------------
+
+bool JobTrace::isSlower (Record const& lhs, Record const& rhs)
+{
+    return lhs.getRunTime (0) > rhs.getRunTime (0);
+}
+
+Json::Value JobTrace::getRecordJson (Record const& record, int64 now)
+{
+    Json::Value json (Json::objectValue);
+    json ["type"] = Job::toString (record.type);
+    json ["name"] = record.name;
+    json ["thread"] = record.thread;
+    json ["started_ms"] = double (record.started) / 1000;
+    json ["queue_us"] = Json::UInt (record.started - record.queued);
+    json ["run_us"] = Json::UInt (record.getRunTime (now));
+    if (record.finished != 0)
+        json ["lock_wait_us"] = Json::UInt (record.lockWait);
+    else
+        json ["running"] = true;
+    return json;
+}
+
+// A "complete" event in the Chrome trace event format
+Json::Value JobTrace::getEventJson (Record const& record, int64 now)
+{
+    Json::Value json (Json::objectValue);
+    json ["name"] = record.name;
+    json ["cat"] = Job::toString (record.type);
+    json ["ph"] = "X";
+    json ["pid"] = 1;
+    json ["tid"] = record.thread;
+    json ["ts"] = double (record.started);
+    json ["dur"] = double (record.getRunTime (now));
+
+    Json::Value& args (json ["args"] = Json::objectValue);
+    args ["queue_us"] = Json::UInt (record.started - record.queued);
+    if (record.finished != 0)
+        args ["lock_wait_us"] = Json::UInt (record.lockWait);
+    else
+        args ["running"] = true;
+    return json;
+}
+
+Json::Value JobTrace::getSlowestJson (std::vector <Record>& records,
+    std::size_t count, int64 now)
+{
+    std::sort (records.begin (), records.end (), &JobTrace::isSlower);
+    if (records.size () > count)
+        records.resize (count);
+
+    Json::Value json (Json::arrayValue);
+    for (std::size_t i = 0; i < records.size (); ++i)
+        json.append (getRecordJson (records [i], now));
+    return json;
+}
+
+Json::Value JobTrace::getJson (int limit)
+{
+    int64 const when (now ());
+    int64 const window (when / m_window);
+
+    std::vector <Record> slowest;
+    std::vector <Record> previous;
+    Json::Value running (Json::arrayValue);
+    Json::Value events (Json::arrayValue);
+
+    CriticalSection::ScopedLockType lock (m_mutex);
+
+    for (std::size_t i = 0; i < m_rings.size (); ++i)
+    {
+        Ring& ring (*m_rings [i]);
+        CriticalSection::ScopedLockType ringLock (ring.mutex);
+
+        if (ring.window == window)
+        {
+            slowest.insert (slowest.end (), ring.slowest.begin (), ring.slowest.end ());
+            previous.insert (previous.end (), ring.previous.begin (), ring.previous.end ());
+        }
+        else if (ring.window == window - 1)
+        {
+            previous.insert (previous.end (), ring.slowest.begin (), ring.slowest.end ());
+        }
+
+        std::size_t const size (ring.records.size ());
+        std::size_t const count ((limit > 0 && std::size_t (limit) < size) ?
+            std::size_t (limit) : size);
+        for (std::size_t n = size - count; n < size; ++n)
+            events.append (getEventJson (ring.records [(ring.next + n) % size], when));
+
+        if (ring.running)
+        {
+            running.append (getRecordJson (ring.current, when));
+            events.append (getEventJson (ring.current, when));
+        }
+    }
+
+    Json::Value ret (Json::objectValue);
+    ret ["window_seconds"] = Json::UInt (m_window / 1000000);
+    ret ["slowest"] = getSlowestJson (slowest, m_slowestPerWindow, when);
+    ret ["slowest_previous"] = getSlowestJson (previous, m_slowestPerWindow, when);
+    ret ["running"] = running;
+    ret ["traceEvents"] = events;
+    ret ["displayTimeUnit"] = "ms";
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+class JobTraceTests : public UnitTest
+{
+public:
+    JobTraceTests () : UnitTest ("JobTrace", "ripple")
+    {
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("ring and slowest");
+
+        JobTrace trace (4, 2, 3600);
+        LoadMonitor monitor;
+
+        for (int i = 0; i < 6; ++i)
+        {
+            Job job (jtCLIENT, "job", i, monitor,
+                FUNCTION_TYPE <void (Job&)> (), CancelCallback ());
+            JobTrace::ScopedJob scoped (trace, job);
+            if (i == 2)
+                Thread::sleep (20);
+        }
+
+        Json::Value const json (trace.getJson ());
+        expect (json ["traceEvents"].size () == 4, "ring should keep 4 jobs");
+        expect (json ["running"].size () == 0);
+
+        Json::Value const& slowest (json ["slowest"]);
+        if (expect (slowest.size () == 2, "should keep 2 slowest jobs"))
+            expect (slowest [0u]["run_us"].asUInt () >= 20000, "slowest job missing");
+
+        expect (trace.getJson (1) ["traceEvents"].size () == 1);
+    }
+};
+
+static JobTraceTests jobTraceTests;
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JOBTRACE_H_INCLUDED
+#define RIPPLE_JOBTRACE_H_INCLUDED
+
+/** Records the timing of individual jobs run by the JobQueue.
+
+    LoadMonitor only keeps running averages per JobType. JobTrace keeps the
+    queue wait, start, finish and lock wait of every job in a fixed size ring
+    buffer owned by the worker thread that ran it, along with the slowest jobs
+    seen in each sampling window. The job currently running on each thread is
+    also available, so a stall shows what every worker was doing.
+
+    The output of getJson is loadable by Chrome's about:tracing viewer.
+*/
+class JobTrace : public Uncopyable
+{
+public:
+    /** Timing information for one job.
+        Times are in microseconds measured from startup.
+    */
+    struct Record
+    {
+        Record ();
+
+        JobType type;
+        std::string name;
+        int thread;         // Identifies the worker thread
+        int64 queued;       // When the job was added to the queue
+        int64 started;      // When the job started running
+        int64 finished;     // When the job finished, or zero if still running
+        int64 lockWait;     // Time spent blocked on tracked or profiled mutexes
+
+        /** Returns the time the job spent running, up to `now` if unfinished. */
+        int64 getRunTime (int64 now) const;
+    };
+
+    /** Records the job running on the calling thread while in scope. */
+    class ScopedJob : public Uncopyable
+    {
+    public:
+        ScopedJob (JobTrace& trace, Job const& job);
+        ~ScopedJob ();
+
+    private:
+        static double getThreadWaitSeconds ();
+
+        JobTrace& m_trace;
+        double m_lockWaitStart;
+    };
+
+    /** Create a trace.
+        @param recordsPerThread The size of each thread's ring buffer.
+        @param slowestPerWindow The number of slowest jobs kept per window.
+        @param windowSeconds    The length of the sampling window.
+    */
+    explicit JobTrace (int recordsPerThread = 1024,
+                       int slowestPerWindow = 20,
+                       int windowSeconds = 60);
+
+    ~JobTrace ();
+
+    /** Returns the slowest jobs for the current and previous window, the
+        jobs running right now, and the recorded jobs as Chrome trace events.
+        @param limit If non zero, the most recent jobs per thread to include.
+    */
+    Json::Value getJson (int limit = 0);
+
+    /** Returns the current time in microseconds from startup. */
+    static int64 now ();
+
+private:
+    struct Ring;
+
+    Ring& getRing ();
+    void started (Record const& record);
+    void finished (int64 when, int64 lockWait);
+    void addSlowest (Ring& ring, Record const& record);
+
+    static bool isSlower (Record const& lhs, Record const& rhs);
+    static Json::Value getRecordJson (Record const& record, int64 now);
+    static Json::Value getEventJson (Record const& record, int64 now);
+    static Json::Value getSlowestJson (std::vector <Record>& records,
+        std::size_t count, int64 now);
+
+    int const m_recordsPerThread;
+    int const m_slowestPerWindow;
+    int64 const m_window;
+
+    CriticalSection m_mutex;
+    std::vector <Ring*> m_rings;
+    ThreadLocalValue <Ring*> m_ring;
+};
+
+#endif
@@ -28,6 +28,8 @@ namespace ripple {
 #  include "impl/DecodedBlob.h"
 #  include "impl/EncodedBlob.h"
 #  include "impl/BatchWriter.h"
+# include "backend/AppendDBFactory.h"
+#include "backend/AppendDBFactory.cpp"
 # include "backend/HyperDBFactory.h"
 #include "backend/HyperDBFactory.cpp"
 # include "backend/KeyvaDBFactory.h"
@@ -54,5 +56,6 @@ namespace ripple {
 #include "tests/BasicTests.cpp"
 #include "tests/DatabaseTests.cpp"
 #include "tests/TimingTests.cpp"
+#include "tests/BenchmarkTests.cpp"
 
 }
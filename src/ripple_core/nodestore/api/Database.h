@@ -115,6 +115,13 @@ public:
                         Blob& data,
                         uint256 const& hash) = 0;
 
+    /** Store a batch of objects directly in the persistent backend.
+        This skips the cache, the fast backend and the write queue, and
+        is meant for bulk loads such as importing a ledger snapshot.
+        @param batch The objects to store.
+    */
+    virtual void storeBatch (Batch const& batch) = 0;
+
     /** Visit every object in the database
         This is usually called during import.
 
@@ -142,6 +149,14 @@ public:
     // VFALCO TODO Document this.
     virtual void sweep () = 0;
 
+    /** Retrieve the keys of the most recently used cached objects.
+        This is used to persist the hot set across a restart.
+
+        @param keys Receives the keys, most recently used first.
+        @param maximum The largest number of keys to return.
+    */
+    virtual void getCachedKeys (std::vector <uint256>& keys, int maximum) = 0;
+
     /** Add the known Backend factories to the singleton.
     */
     static void addAvailableBackends ();
@@ -23,6 +23,26 @@
 namespace NodeStore
 {
 
+/** Contains information about a fetch operation. */
+struct FetchReport
+{
+    FetchReport ()
+        : elapsed (0)
+        , wentToDisk (false)
+        , wasFound (false)
+    {
+    }
+
+    /** The time spent in the fetch, in microseconds. */
+    int64 elapsed;
+
+    /** `true` if the object was not in the cache. */
+    bool wentToDisk;
+
+    /** `true` if the object was found. */
+    bool wasFound;
+};
+
 /** Scheduling for asynchronous backend activity
     
     For improved performance, a backend has the option of performing writes
@@ -42,6 +62,14 @@ public:
         foreign thread.
     */
     virtual void scheduleTask (Task& task) = 0;
+
+    /** Reports completion of a fetch.
+        Allows the scheduler to monitor the node store's performance.
+        This is called on the thread which performed the fetch.
+    */
+    virtual void onFetch (FetchReport const& report)
+    {
+    }
 };
 
 }
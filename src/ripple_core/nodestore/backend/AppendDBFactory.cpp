@@ -0,0 +1,1052 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace NodeStore
+{
+
+/*  Layout
+
+    The backend's path names a directory holding a series of data files,
+    data.00000, data.00001 and so on, and one index file.
+
+    Each data file starts with a small header, followed by records which
+    are only ever appended:
+
+        key         keyBytes
+        size        4 bytes, big-endian, the size of the data
+        checksum    4 bytes, big-endian, FNV-1a of the key, size and data
+        data        the EncodedBlob
+
+    A batch is appended with a single write followed by a single flush.
+    When a data file reaches its maximum size a new one is started.
+
+    The index is a hash table using linear probing, memory mapped from
+    its file. Each entry holds the first eight bytes of a key along with
+    the record's location: the data file number in the high bits and the
+    offset in the low bits. The full key is compared against the record
+    when it is read. The header remembers how much of the data files has
+    been indexed, so records appended after that are picked up when the
+    backend is next opened.
+
+    Changes to the mapped index reach the disk whenever the OS chooses,
+    so after a crash the header may claim entries which were never
+    written. Every so often the mapping is flushed and the indexed
+    position recorded as a checkpoint, and the header carries a flag
+    which is only set while the backend is cleanly closed. When the
+    flag is missing, everything after the last checkpoint is indexed
+    again.
+*/
+class AppendDBFactory::BackendImp
+    : public Backend
+    , public BatchWriter::Callback
+    , public LeakChecked <AppendDBFactory::BackendImp>
+{
+public:
+    typedef RecycledObjectPool <MemoryBlock> MemoryPool;
+
+    enum
+    {
+        dataMagic = 0x41444244,     // "ADBD"
+        indexMagic = 0x41444249,    // "ADBI"
+        fileVersion = 1,
+        indexVersion = 2,
+
+        dataHeaderBytes = 16,
+        indexHeaderBytes = 64,
+
+        // Bytes read for a fetch before the size of the record is known.
+        // Most objects fit, so a fetch usually takes a single read.
+        fetchReadBytes = 1024,
+
+        // Anything larger is taken to be corruption
+        maxRecordBytes = 64 * 1024 * 1024,
+
+        initialCapacity = 65536,
+        maxCandidates = 4,
+        offsetBits = 40,
+
+        defaultFileMB = 1024,
+
+        // Data appended between flushes of the index
+        checkpointBytes = 64 * 1024 * 1024
+    };
+
+    // The start of the index file. This is in native byte order
+    // since the index is only ever read by the machine which built it.
+    struct IndexHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 keyBytes;
+        uint32 clean;       // non-zero if the backend was closed cleanly
+        uint64 capacity;
+        uint64 count;
+        uint64 indexedTo;
+        uint64 checkpoint;  // indexedTo as of the last flush
+    };
+
+    struct IndexEntry
+    {
+        uint64 prefix;
+        uint64 location;
+    };
+
+    // The locations in the index of keys which start like the one sought.
+    // Full keys are eight times longer, so there is almost always one.
+    struct Candidates
+    {
+        Candidates ()
+            : count (0)
+        {
+        }
+
+        int count;
+        uint64 locations [maxCandidates];
+    };
+
+    // A record which has been buffered by storeBatch but not yet indexed
+    struct Pending
+    {
+        void const* key;
+        uint64 location;
+    };
+
+    //--------------------------------------------------------------------------
+
+    BackendImp (size_t keyBytes,
+                Parameters const& keyValues,
+                Scheduler& scheduler)
+        : m_keyBytes (keyBytes)
+        , m_recordHeaderBytes (keyBytes + 8)
+        , m_scheduler (scheduler)
+        , m_name (keyValues ["path"])
+        , m_maxFileBytes (int64 (defaultFileMB) * 1024 * 1024)
+        , m_fileSize (0)
+        , m_sinceCheckpoint (0)
+        , m_batch (*this, scheduler)
+    {
+        static_bassert (sizeof (IndexHeader) <= indexHeaderBytes);
+
+        if (m_name.isEmpty ())
+            Throw (std::runtime_error ("Missing path in AppendDBFactory backend"));
+
+        if (keyValues ["file_mb"].isNotEmpty ())
+        {
+            m_maxFileBytes = std::min (
+                std::max (keyValues ["file_mb"].getLargeIntValue (), int64 (1)) * 1024 * 1024,
+                int64 (1) << offsetBits);
+        }
+
+        m_path = File::getCurrentWorkingDirectory ().getChildFile (m_name);
+
+        Result const result (m_path.createDirectory ());
+
+        if (result.failed ())
+            Throw (std::runtime_error (std::string ("Unable to create AppendDB directory: ") +
+                result.getErrorMessage ().toStdString ()));
+
+        openDataFiles ();
+
+        openIndex ();
+    }
+
+    ~BackendImp ()
+    {
+        m_batch.waitForWriting ();
+
+        if (checkpoint ())
+        {
+            {
+                LockType::scoped_lock sl (m_mutex);
+
+                getHeader ().clean = 1;
+            }
+
+            m_index->flush ();
+        }
+    }
+
+    std::string getName ()
+    {
+        return m_name.toStdString ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    Status fetch (void const* key, NodeObject::Ptr* pObject)
+    {
+        pObject->reset ();
+
+        Candidates candidates;
+
+        {
+            LockType::scoped_lock sl (m_mutex);
+
+            findCandidates (getPrefix (key), candidates);
+        }
+
+        MemoryPool::ScopedItem item (m_memoryPool);
+        MemoryBlock& block (item.getObject ());
+
+        Status status (notFound);
+
+        for (int i = 0; i < candidates.count; ++i)
+        {
+            uint32 dataBytes;
+            Status const readStatus (readRecord (candidates.locations [i], block, dataBytes));
+
+            if (readStatus != ok)
+            {
+                status = readStatus;
+            }
+            else if (memcmp (block.getData (), key, m_keyBytes) == 0)
+            {
+                DecodedBlob decoded (key, static_cast <char const*> (
+                    block.getData ()) + m_recordHeaderBytes, dataBytes);
+
+                if (decoded.wasOk ())
+                {
+                    *pObject = decoded.createObject ();
+
+                    status = ok;
+                }
+                else
+                {
+                    status = dataCorrupt;
+                }
+
+                break;
+            }
+        }
+
+        return status;
+    }
+
+    void store (NodeObject::ref object)
+    {
+        m_batch.store (object);
+    }
+
+    void storeBatch (Batch const& batch)
+    {
+        EncodedBlob::Pool::ScopedItem item (m_blobPool);
+        EncodedBlob& encoded (item.getObject ());
+
+        MemoryPool::ScopedItem readItem (m_memoryPool);
+
+        std::vector <Pending> pending;
+        pending.reserve (batch.size ());
+        size_t bytes = 0;
+
+        for (std::size_t i = 0; i < batch.size (); ++i)
+        {
+            encoded.prepare (batch [i]);
+
+            void const* const key (encoded.getKey ());
+
+            // Objects never change, so one copy is enough
+            if (isPending (pending, key) || contains (key, readItem.getObject ()))
+                continue;
+
+            size_t const recordBytes = m_recordHeaderBytes + encoded.getSize ();
+
+            // Start a new data file rather than let this one grow too large
+            if (m_fileSize + bytes + recordBytes > m_maxFileBytes &&
+                m_fileSize + bytes > dataHeaderBytes)
+            {
+                if (! append (pending, bytes))
+                    return;
+
+                pending.clear ();
+                bytes = 0;
+
+                addDataFile ();
+            }
+
+            m_writeBuffer.ensureSize (bytes + recordBytes);
+
+            unsigned char* const p (static_cast <unsigned char*> (
+                m_writeBuffer.getData ()) + bytes);
+
+            uint32 const size (ByteOrder::swapIfLittleEndian (
+                static_cast <uint32> (encoded.getSize ())));
+            uint32 const sum (ByteOrder::swapIfLittleEndian (
+                getChecksum (key, encoded.getData (), encoded.getSize ())));
+
+            memcpy (p, key, m_keyBytes);
+            memcpy (p + m_keyBytes, &size, 4);
+            memcpy (p + m_keyBytes + 4, &sum, 4);
+            memcpy (p + m_recordHeaderBytes, encoded.getData (), encoded.getSize ());
+
+            Pending entry;
+            entry.key = key;
+            entry.location = makeLocation (m_files.size () - 1, m_fileSize + bytes);
+            pending.push_back (entry);
+
+            bytes += recordBytes;
+        }
+
+        append (pending, bytes);
+    }
+
+    void visitAll (VisitCallback& callback)
+    {
+        MemoryPool::ScopedItem item (m_memoryPool);
+        MemoryBlock& block (item.getObject ());
+
+        for (int fileNumber = 0; fileNumber < m_files.size (); ++fileNumber)
+        {
+            int64 const end ((fileNumber == m_files.size () - 1) ? m_fileSize
+                : m_files [fileNumber]->getFile ().getSize ());
+
+            int64 offset (dataHeaderBytes);
+
+            while (offset < end)
+            {
+                uint64 const location (makeLocation (fileNumber, offset));
+                uint32 dataBytes;
+
+                if (readRecord (location, block, dataBytes) != ok)
+                {
+                    WriteLog (lsFATAL, NodeObject) << "Corrupt record in " <<
+                        getDataFile (fileNumber).getFullPathName ().toStdString () <<
+                        " at " << offset;
+                    break;
+                }
+
+                char const* const p (static_cast <char const*> (block.getData ()));
+
+                // Skip extra copies, which were never indexed
+                if (isIndexedAt (p, location))
+                {
+                    DecodedBlob decoded (p, p + m_recordHeaderBytes, dataBytes);
+
+                    if (decoded.wasOk ())
+                    {
+                        NodeObject::Ptr object (decoded.createObject ());
+
+                        callback.visitObject (object);
+                    }
+                    else
+                    {
+                        WriteLog (lsFATAL, NodeObject) << "Corrupt NodeObject #" << uint256 (p);
+                    }
+                }
+
+                offset += m_recordHeaderBytes + dataBytes;
+            }
+        }
+    }
+
+    int getWriteLoad ()
+    {
+        return m_batch.getWriteLoad ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void writeBatch (Batch const& batch)
+    {
+        storeBatch (batch);
+    }
+
+    //--------------------------------------------------------------------------
+
+private:
+    typedef boost::mutex LockType;
+
+    static uint64 makeLocation (int fileNumber, int64 offset)
+    {
+        return (static_cast <uint64> (fileNumber) << offsetBits) | static_cast <uint64> (offset);
+    }
+
+    static int getFileNumber (uint64 location)
+    {
+        return static_cast <int> (location >> offsetBits);
+    }
+
+    static int64 getOffset (uint64 location)
+    {
+        return static_cast <int64> (location & ((uint64 (1) << offsetBits) - 1));
+    }
+
+    static uint64 getPrefix (void const* key)
+    {
+        uint64 prefix;
+        memcpy (&prefix, key, sizeof (prefix));
+        return prefix;
+    }
+
+    static uint32 updateChecksum (uint32 hash, void const* data, size_t bytes)
+    {
+        unsigned char const* p (static_cast <unsigned char const*> (data));
+
+        for (size_t i = 0; i < bytes; ++i)
+            hash = (hash ^ p [i]) * 16777619;
+
+        return hash;
+    }
+
+    uint32 getChecksum (void const* key, void const* data, size_t dataBytes) const
+    {
+        uint32 const size (ByteOrder::swapIfLittleEndian (static_cast <uint32> (dataBytes)));
+
+        uint32 hash (2166136261u);
+        hash = updateChecksum (hash, key, m_keyBytes);
+        hash = updateChecksum (hash, &size, sizeof (size));
+        return updateChecksum (hash, data, dataBytes);
+    }
+
+    //--------------------------------------------------------------------------
+
+    File getDataFile (int fileNumber) const
+    {
+        return m_path.getChildFile (String ("data.") + String (fileNumber).paddedLeft ('0', 5));
+    }
+
+    RandomAccessFile* openDataFile (File const& path)
+    {
+        ScopedPointer <RandomAccessFile> file (new RandomAccessFile);
+
+        Result const result (file->open (path, RandomAccessFile::readWrite));
+
+        if (result.failed ())
+            Throw (std::runtime_error (std::string ("Unable to open AppendDB data file: ") +
+                result.getErrorMessage ().toStdString ()));
+
+        return file.release ();
+    }
+
+    void writeDataHeader (RandomAccessFile& file)
+    {
+        uint32 header [4];
+        header [0] = ByteOrder::swapIfLittleEndian (static_cast <uint32> (dataMagic));
+        header [1] = ByteOrder::swapIfLittleEndian (static_cast <uint32> (fileVersion));
+        header [2] = ByteOrder::swapIfLittleEndian (static_cast <uint32> (m_keyBytes));
+        header [3] = 0;
+
+        Result result (file.setPosition (0));
+
+        if (result.wasOk ())
+            result = file.write (header, sizeof (header));
+
+        if (result.wasOk ())
+            result = file.flush ();
+
+        if (result.failed ())
+            Throw (std::runtime_error (std::string ("Unable to write AppendDB data file: ") +
+                result.getErrorMessage ().toStdString ()));
+    }
+
+    bool readDataHeader (RandomAccessFile& file)
+    {
+        uint32 header [4];
+        RandomAccessFile::ByteCount actual;
+
+        Result const result (file.readAt (0, header, sizeof (header), &actual));
+
+        return result.wasOk () && actual == sizeof (header) &&
+            ByteOrder::swapIfLittleEndian (header [0]) == dataMagic &&
+            ByteOrder::swapIfLittleEndian (header [1]) == fileVersion &&
+            ByteOrder::swapIfLittleEndian (header [2]) == m_keyBytes;
+    }
+
+    void openDataFiles ()
+    {
+        for (int fileNumber = 0; getDataFile (fileNumber).existsAsFile (); ++fileNumber)
+        {
+            File const path (getDataFile (fileNumber));
+
+            ScopedPointer <RandomAccessFile> file (openDataFile (path));
+
+            if (! readDataHeader (*file))
+            {
+                // A crash can leave a new file without its header
+                if (! getDataFile (fileNumber + 1).existsAsFile () &&
+                    path.getSize () < dataHeaderBytes)
+                {
+                    writeDataHeader (*file);
+                }
+                else
+                {
+                    Throw (std::runtime_error (std::string ("Not an AppendDB data file: ") +
+                        path.getFullPathName ().toStdString ()));
+                }
+            }
+
+            m_files.add (file.release ());
+        }
+
+        if (m_files.size () == 0)
+            addDataFile ();
+        else
+            m_fileSize = m_files.getLast ()->getFile ().getSize ();
+    }
+
+    void addDataFile ()
+    {
+        ScopedPointer <RandomAccessFile> file (openDataFile (getDataFile (m_files.size ())));
+
+        writeDataHeader (*file);
+
+        {
+            LockType::scoped_lock sl (m_mutex);
+
+            m_files.add (file.release ());
+        }
+
+        m_fileSize = dataHeaderBytes;
+    }
+
+    // Reads the record at a location. On success the block holds the record,
+    // header first, and dataBytes is set to the size of the record's data.
+    //
+    Status readRecord (uint64 location, MemoryBlock& block, uint32& dataBytes)
+    {
+        int const fileNumber (getFileNumber (location));
+        int64 const offset (getOffset (location));
+
+        RandomAccessFile* file;
+
+        {
+            LockType::scoped_lock sl (m_mutex);
+
+            if (fileNumber >= m_files.size ())
+                return dataCorrupt;
+
+            file = m_files [fileNumber];
+        }
+
+        block.ensureSize (m_recordHeaderBytes + fetchReadBytes);
+
+        RandomAccessFile::ByteCount actual;
+
+        Result result (file->readAt (offset, block.getData (),
+            m_recordHeaderBytes + fetchReadBytes, &actual));
+
+        if (result.failed ())
+            return unknown;
+
+        if (actual < m_recordHeaderBytes)
+            return dataCorrupt;
+
+        dataBytes = ByteOrder::bigEndianInt (
+            static_cast <char const*> (block.getData ()) + m_keyBytes);
+
+        if (dataBytes > maxRecordBytes)
+            return dataCorrupt;
+
+        size_t const recordBytes (m_recordHeaderBytes + dataBytes);
+
+        if (actual < recordBytes)
+        {
+            block.ensureSize (recordBytes);
+
+            RandomAccessFile::ByteCount more;
+
+            result = file->readAt (offset + actual, static_cast <char*> (
+                block.getData ()) + actual, recordBytes - actual, &more);
+
+            if (result.failed ())
+                return unknown;
+
+            if (actual + more < recordBytes)
+                return dataCorrupt;
+        }
+
+        char const* const p (static_cast <char const*> (block.getData ()));
+
+        if (ByteOrder::bigEndianInt (p + m_keyBytes + 4) !=
+            getChecksum (p, p + m_recordHeaderBytes, dataBytes))
+            return dataCorrupt;
+
+        return ok;
+    }
+
+    // Returns `true` if the key is already stored.
+    // This is only called by the thread which writes.
+    //
+    bool contains (void const* key, MemoryBlock& block)
+    {
+        Candidates candidates;
+
+        {
+            LockType::scoped_lock sl (m_mutex);
+
+            findCandidates (getPrefix (key), candidates);
+        }
+
+        for (int i = 0; i < candidates.count; ++i)
+        {
+            uint32 dataBytes;
+
+            if (readRecord (candidates.locations [i], block, dataBytes) == ok &&
+                memcmp (block.getData (), key, m_keyBytes) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    bool isPending (std::vector <Pending> const& pending, void const* key) const
+    {
+        for (std::size_t i = 0; i < pending.size (); ++i)
+            if (memcmp (pending [i].key, key, m_keyBytes) == 0)
+                return true;
+
+        return false;
+    }
+
+    bool isIndexedAt (void const* key, uint64 location)
+    {
+        Candidates candidates;
+
+        {
+            LockType::scoped_lock sl (m_mutex);
+
+            findCandidates (getPrefix (key), candidates);
+        }
+
+        for (int i = 0; i < candidates.count; ++i)
+            if (candidates.locations [i] == location)
+                return true;
+
+        return false;
+    }
+
+    // Writes the buffered records to the last data file, then indexes them
+    //
+    bool append (std::vector <Pending> const& pending, size_t bytes)
+    {
+        if (bytes == 0)
+            return true;
+
+        RandomAccessFile& file (*m_files.getLast ());
+
+        RandomAccessFile::ByteCount written (0);
+
+        Result result (file.setPosition (m_fileSize));
+
+        if (result.wasOk ())
+            result = file.write (m_writeBuffer.getData (), bytes, &written);
+
+        if (result.wasOk () && written != bytes)
+            result = Result::fail ("Short write");
+
+        if (result.wasOk ())
+            result = file.flush ();
+
+        if (result.failed ())
+        {
+            WriteLog (lsFATAL, NodeObject) << "AppendDB write failed: " <<
+                result.getErrorMessage ().toStdString ();
+
+            // Cut off whatever part of the batch reached the file
+            if (file.setPosition (m_fileSize).wasOk ())
+                file.truncate ();
+
+            return false;
+        }
+
+        m_fileSize += bytes;
+
+        {
+            LockType::scoped_lock sl (m_mutex);
+
+            for (std::size_t i = 0; i < pending.size (); ++i)
+                addToIndex (getPrefix (pending [i].key), pending [i].location);
+
+            getHeader ().indexedTo = makeLocation (m_files.size () - 1, m_fileSize);
+        }
+
+        m_sinceCheckpoint += bytes;
+
+        if (m_sinceCheckpoint >= checkpointBytes)
+            checkpoint ();
+
+        return true;
+    }
+
+    // Flushes the index, then records how far it goes. The checkpoint is
+    // only advanced once the entries it covers are known to be on disk.
+    // This is only called by the thread which writes.
+    //
+    bool checkpoint ()
+    {
+        uint64 const indexedTo (getHeader ().indexedTo);
+
+        if (! m_index->flush ())
+        {
+            WriteLog (lsWARNING, NodeObject) << "AppendDB unable to flush the index for " <<
+                m_name.toStdString ();
+            return false;
+        }
+
+        {
+            LockType::scoped_lock sl (m_mutex);
+
+            getHeader ().checkpoint = indexedTo;
+        }
+
+        m_sinceCheckpoint = 0;
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    static IndexHeader& getHeader (MemoryMappedFile& index)
+    {
+        return *static_cast <IndexHeader*> (index.getData ());
+    }
+
+    static IndexEntry* getEntries (MemoryMappedFile& index)
+    {
+        return reinterpret_cast <IndexEntry*> (
+            static_cast <char*> (index.getData ()) + indexHeaderBytes);
+    }
+
+    IndexHeader& getHeader ()
+    {
+        return getHeader (*m_index);
+    }
+
+    // The caller must hold the lock
+    void findCandidates (uint64 prefix, Candidates& candidates)
+    {
+        IndexEntry const* const entries (getEntries (*m_index));
+        uint64 const mask (getHeader ().capacity - 1);
+
+        for (uint64 slot = prefix & mask; entries [slot].location != 0; slot = (slot + 1) & mask)
+        {
+            if (entries [slot].prefix == prefix && candidates.count < maxCandidates)
+                candidates.locations [candidates.count++] = entries [slot].location;
+        }
+    }
+
+    static void insertEntry (MemoryMappedFile& index, uint64 prefix, uint64 location)
+    {
+        IndexHeader& header (getHeader (index));
+        IndexEntry* const entries (getEntries (index));
+        uint64 const mask (header.capacity - 1);
+
+        uint64 slot (prefix & mask);
+
+        while (entries [slot].location != 0)
+            slot = (slot + 1) & mask;
+
+        entries [slot].prefix = prefix;
+        entries [slot].location = location;
+
+        ++header.count;
+    }
+
+    // The caller must hold the lock
+    void addToIndex (uint64 prefix, uint64 location)
+    {
+        IndexHeader const& header (getHeader ());
+
+        // Linear probing slows down quickly past three quarters full
+        if ((header.count + 1) * 4 > header.capacity * 3)
+            growIndex ();
+
+        insertEntry (*m_index, prefix, location);
+    }
+
+    MemoryMappedFile* createIndex (File const& path, uint64 capacity, uint64 indexedTo)
+    {
+        path.deleteFile ();
+
+        {
+            RandomAccessFile file;
+
+            Result result (file.open (path, RandomAccessFile::readWrite));
+
+            // Extending the file fills it with zeroes, which are empty entries
+            if (result.wasOk ())
+                result = file.setPosition (indexHeaderBytes + capacity * sizeof (IndexEntry));
+
+            if (result.wasOk ())
+                result = file.truncate ();
+
+            if (result.failed ())
+                Throw (std::runtime_error (std::string ("Unable to create AppendDB index: ") +
+                    result.getErrorMessage ().toStdString ()));
+        }
+
+        ScopedPointer <MemoryMappedFile> index (
+            new MemoryMappedFile (path, MemoryMappedFile::readWrite));
+
+        if (index->getData () == nullptr)
+            Throw (std::runtime_error ("Unable to map AppendDB index"));
+
+        IndexHeader& header (getHeader (*index));
+        header.magic = indexMagic;
+        header.version = indexVersion;
+        header.keyBytes = m_keyBytes;
+        header.clean = 0;
+        header.capacity = capacity;
+        header.count = 0;
+        header.indexedTo = indexedTo;
+        header.checkpoint = indexedTo;
+
+        return index.release ();
+    }
+
+    // Returns `false` if there is no usable index at the path
+    bool mapIndex (File const& path)
+    {
+        if (! path.existsAsFile ())
+            return false;
+
+        ScopedPointer <MemoryMappedFile> index (
+            new MemoryMappedFile (path, MemoryMappedFile::readWrite));
+
+        if (index->getData () == nullptr || index->getSize () < indexHeaderBytes)
+            return false;
+
+        IndexHeader const& header (getHeader (*index));
+
+        // Past the checkpoint, only a clean close vouches for the index
+        uint64 const indexedTo (header.clean ? header.indexedTo : header.checkpoint);
+        int const fileNumber (getFileNumber (indexedTo));
+
+        if (header.magic != indexMagic ||
+            header.version != indexVersion ||
+            header.keyBytes != m_keyBytes ||
+            header.capacity == 0 ||
+            (header.capacity & (header.capacity - 1)) != 0 ||
+            header.count >= header.capacity ||
+            index->getSize () != indexHeaderBytes + header.capacity * sizeof (IndexEntry) ||
+            header.checkpoint > header.indexedTo ||
+            fileNumber >= m_files.size () ||
+            getOffset (indexedTo) > m_files [fileNumber]->getFile ().getSize ())
+            return false;
+
+        m_index = index;
+
+        return true;
+    }
+
+    void openIndex ()
+    {
+        File const path (m_path.getChildFile ("index"));
+
+        if (! mapIndex (path))
+        {
+            if (m_files.size () > 1 || m_fileSize > dataHeaderBytes)
+                WriteLog (lsWARNING, NodeObject) << "AppendDB rebuilding the index for " <<
+                    m_name.toStdString ();
+
+            m_index = createIndex (path, initialCapacity, makeLocation (0, dataHeaderBytes));
+        }
+        else if (! getHeader ().clean)
+        {
+            WriteLog (lsWARNING, NodeObject) << "AppendDB was not closed cleanly, " <<
+                "checking the index for " << m_name.toStdString ();
+
+            recover ();
+        }
+
+        // Mark the index as in use before anything else is written to it
+        getHeader ().clean = 0;
+
+        if (! m_index->flush ())
+            Throw (std::runtime_error ("Unable to flush AppendDB index"));
+
+        catchUp ();
+
+        checkpoint ();
+    }
+
+    // Falls back to the last checkpoint after a crash. Entries past it may
+    // or may not have reached the disk, so the count is taken again, and
+    // catchUp skips the records which did make it into the index.
+    //
+    void recover ()
+    {
+        IndexHeader& header (getHeader ());
+        IndexEntry const* const entries (getEntries (*m_index));
+
+        uint64 count (0);
+
+        for (uint64 slot = 0; slot < header.capacity; ++slot)
+            if (entries [slot].location != 0)
+                ++count;
+
+        header.count = count;
+        header.indexedTo = header.checkpoint;
+    }
+
+    // The caller must hold the lock
+    void growIndex ()
+    {
+        File const path (m_path.getChildFile ("index"));
+        File const temp (m_path.getChildFile ("index.new"));
+
+        IndexHeader const& header (getHeader ());
+        IndexEntry const* const entries (getEntries (*m_index));
+
+        ScopedPointer <MemoryMappedFile> index (
+            createIndex (temp, header.capacity * 2, header.indexedTo));
+
+        for (uint64 slot = 0; slot < header.capacity; ++slot)
+            if (entries [slot].location != 0)
+                insertEntry (*index, entries [slot].prefix, entries [slot].location);
+
+        // The new index must be complete on disk before it replaces the old one
+        if (! index->flush ())
+            Throw (std::runtime_error ("Unable to flush AppendDB index"));
+
+        index = nullptr;
+        m_index = nullptr;
+
+        if (! temp.moveFileTo (path) || ! mapIndex (path))
+            Throw (std::runtime_error ("Unable to replace AppendDB index"));
+
+        m_sinceCheckpoint = 0;
+    }
+
+    // Indexes the records appended after the index was last updated.
+    // These are left by a crash, or the index is being built from scratch.
+    //
+    void catchUp ()
+    {
+        MemoryPool::ScopedItem item (m_memoryPool);
+        MemoryBlock& block (item.getObject ());
+
+        MemoryPool::ScopedItem readItem (m_memoryPool);
+
+        uint64 const indexedTo (getHeader ().indexedTo);
+        int64 added (0);
+
+        for (int fileNumber = getFileNumber (indexedTo); fileNumber < m_files.size (); ++fileNumber)
+        {
+            RandomAccessFile& file (*m_files [fileNumber]);
+            int64 const size (file.getFile ().getSize ());
+
+            int64 offset ((fileNumber == getFileNumber (indexedTo))
+                ? getOffset (indexedTo) : int64 (dataHeaderBytes));
+
+            while (offset < size)
+            {
+                uint64 const location (makeLocation (fileNumber, offset));
+                uint32 dataBytes;
+
+                if (readRecord (location, block, dataBytes) != ok)
+                    break;
+
+                if (! contains (block.getData (), readItem.getObject ()))
+                {
+                    LockType::scoped_lock sl (m_mutex);
+
+                    addToIndex (getPrefix (block.getData ()), location);
+
+                    ++added;
+                }
+
+                offset += m_recordHeaderBytes + dataBytes;
+            }
+
+            if (offset < size)
+            {
+                if (fileNumber == m_files.size () - 1)
+                {
+                    // The last batch was only partly written
+                    WriteLog (lsWARNING, NodeObject) << "AppendDB discarding " <<
+                        (size - offset) << " bytes at the end of " <<
+                        file.getFile ().getFullPathName ().toStdString ();
+
+                    if (file.setPosition (offset).wasOk ())
+                        file.truncate ();
+                }
+                else
+                {
+                    WriteLog (lsFATAL, NodeObject) << "AppendDB skipping corrupt data in " <<
+                        file.getFile ().getFullPathName ().toStdString () << " at " << offset;
+                }
+            }
+
+            m_fileSize = offset;
+        }
+
+        {
+            LockType::scoped_lock sl (m_mutex);
+
+            getHeader ().indexedTo = makeLocation (m_files.size () - 1, m_fileSize);
+        }
+
+        if (added > 0)
+            WriteLog (lsINFO, NodeObject) << "AppendDB indexed " << added << " records";
+    }
+
+private:
+    size_t const m_keyBytes;
+    size_t const m_recordHeaderBytes;
+    Scheduler& m_scheduler;
+    String m_name;
+    File m_path;
+    int64 m_maxFileBytes;
+
+    // Guards the list of data files and the index, which are used by fetch
+    LockType m_mutex;
+    OwnedArray <RandomAccessFile> m_files;
+    ScopedPointer <MemoryMappedFile> m_index;
+
+    // Only used by the thread which writes
+    int64 m_fileSize;
+    int64 m_sinceCheckpoint;
+    MemoryBlock m_writeBuffer;
+
+    MemoryPool m_memoryPool;
+    EncodedBlob::Pool m_blobPool;
+
+    // Last, so that pending writes finish before the rest is destroyed
+    BatchWriter m_batch;
+};
+
+//------------------------------------------------------------------------------
+
+AppendDBFactory::AppendDBFactory ()
+{
+}
+
+AppendDBFactory::~AppendDBFactory ()
+{
+}
+
+AppendDBFactory* AppendDBFactory::getInstance ()
+{
+    return new AppendDBFactory;
+}
+
+String AppendDBFactory::getName () const
+{
+    return "AppendDB";
+}
+
+Backend* AppendDBFactory::createInstance (
+    size_t keyBytes,
+    Parameters const& keyValues,
+    Scheduler& scheduler)
+{
+    return new AppendDBFactory::BackendImp (keyBytes, keyValues, scheduler);
+}
+
+}
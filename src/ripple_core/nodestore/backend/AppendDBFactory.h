@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_APPENDDBFACTORY_H_INCLUDED
+#define RIPPLE_NODESTORE_APPENDDBFACTORY_H_INCLUDED
+
+namespace NodeStore
+{
+
+/** Factory to produce append-only, log-structured backends for the NodeStore.
+
+    Node objects never change once written, and are looked up by their
+    hash, so there is no need to keep them sorted. This backend appends
+    each batch of objects to the end of a large data file, and finds them
+    again through a hash index kept in a memory mapped file alongside.
+    Nothing is ever rewritten, so there is no compaction.
+
+    The index can always be rebuilt from the data files. Deleting it
+    forces a rebuild the next time the backend is opened.
+
+    @see Database
+*/
+class AppendDBFactory : public Factory
+{
+private:
+    AppendDBFactory ();
+    ~AppendDBFactory ();
+
+public:
+    class BackendImp;
+
+    static AppendDBFactory* getInstance ();
+
+    String getName () const;
+
+    Backend* createInstance (size_t keyBytes,
+                             Parameters const& keyValues,
+                             Scheduler& scheduler);
+};
+
+}
+
+#endif
@@ -48,6 +48,8 @@ public:
     {
         uint256 const hash (uint256::fromVoid (key));
 
+        LockType::scoped_lock sl (m_mutex);
+
         Map::iterator iter = m_map.find (hash);
 
         if (iter != m_map.end ())
@@ -64,6 +66,8 @@ public:
 
     void store (NodeObject::ref object)
     {
+        LockType::scoped_lock sl (m_mutex);
+
         Map::iterator iter = m_map.find (object->getHash ());
 
         if (iter == m_map.end ())
@@ -80,6 +84,8 @@ public:
 
     void visitAll (VisitCallback& callback)
     {
+        LockType::scoped_lock sl (m_mutex);
+
         for (Map::const_iterator iter = m_map.begin (); iter != m_map.end (); ++iter)
             callback.visitObject (iter->second);
     }
@@ -92,8 +98,12 @@ public:
     //--------------------------------------------------------------------------
 
 private:
+    typedef boost::mutex LockType;
+
     size_t const m_keyBytes;
 
+    // Fetches and stores may come from any thread
+    LockType m_mutex;
     Map m_map;
     Scheduler& m_scheduler;
 };
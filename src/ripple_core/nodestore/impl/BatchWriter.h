@@ -63,10 +63,12 @@ public:
     /** Get an estimate of the amount of writing I/O pending. */
     int getWriteLoad ();
 
+    /** Block until everything stored so far has been written. */
+    void waitForWriting ();
+
 private:
     void performScheduledTask ();
     void writeBatch ();
-    void waitForWriting ();
 
 private:
     typedef boost::recursive_mutex LockType;
@@ -50,12 +50,18 @@ public:
 
     NodeObject::Ptr fetch (uint256 const& hash)
     {
+        double const start (Time::getMillisecondCounterHiRes ());
+
+        FetchReport report;
+
         // See if the object already exists in the cache
         //
         NodeObject::Ptr obj = m_cache.fetch (hash);
 
         if (obj == nullptr)
         {
+            report.wentToDisk = true;
+
             // There's still a chance it could be in one of the databases.
 
             bool foundInFastBackend = false;
@@ -118,6 +124,11 @@ public:
             // found it!
         }
 
+        report.wasFound = (obj != nullptr);
+        report.elapsed = static_cast <int64> (
+            (Time::getMillisecondCounterHiRes () - start) * 1000);
+        m_scheduler.onFetch (report);
+
         return obj;
     }
 
@@ -198,11 +209,21 @@ public:
         m_cache.sweep ();
     }
 
+    void getCachedKeys (std::vector <uint256>& keys, int maximum)
+    {
+        m_cache.getRecentKeys (keys, maximum);
+    }
+
     int getWriteLoad ()
     {
         return m_backend->getWriteLoad ();
     }
 
+    void storeBatch (Batch const& batch)
+    {
+        m_backend->storeBatch (batch);
+    }
+
     //------------------------------------------------------------------------------
 
     void visitAll (VisitCallback& callback)
@@ -327,6 +348,8 @@ void Database::addAvailableBackends ()
 #endif
 
     addFactory (KeyvaDBFactory::getInstance ());
+
+    addFactory (AppendDBFactory::getInstance ());
 }
 
 //------------------------------------------------------------------------------
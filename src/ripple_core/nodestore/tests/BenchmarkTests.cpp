@@ -0,0 +1,492 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace NodeStore
+{
+
+/** Measures backends under workloads shaped like those of a running server.
+
+    Each workload opens the database afresh, so it starts with a cold cache,
+    and reports throughput along with p50, p99 and p999 latencies:
+
+    - Write bursts: a ledger's worth of objects is stored at a time, the way
+      a ledger close does, and the writes are allowed to drain in between.
+
+    - Random reads: objects are fetched in random order, as when syncing,
+      mixed with fetches of missing keys so only some of them are found.
+
+    - Fetch pack scans: every object written by one ledger is fetched in
+      turn, as when building a fetch pack for a peer.
+
+    - Mixed: several threads fetch and store at the same time.
+
+    Every backend is measured alone and then with a memory fast backend.
+*/
+class BenchmarkTests : public TestBase
+{
+public:
+    struct Setup
+    {
+        Setup ()
+            : numLedgers (50)
+            , objectsPerLedger (400)
+            , numReads (10000)
+            , hitRatio (0.75)
+            , numScans (10)
+            , numThreads (4)
+            , opsPerThread (5000)
+            , writeRatio (0.2)
+        {
+        }
+
+        int numLedgers;
+        int objectsPerLedger;
+        int numReads;
+        double hitRatio;
+        int numScans;
+        int numThreads;
+        int opsPerThread;
+        double writeRatio;
+    };
+
+    BenchmarkTests ()
+        : TestBase ("NodeStoreBenchmark", UnitTest::runManual)
+    {
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Runs scheduled tasks on a thread of its own, as the job queue does in
+    // the server, so that batched writes overlap the stores which feed them.
+    //
+    class ThreadScheduler
+        : public Scheduler
+        , public Thread
+    {
+    public:
+        ThreadScheduler ()
+            : Thread ("NodeStoreBenchmark")
+        {
+            startThread ();
+        }
+
+        ~ThreadScheduler ()
+        {
+            stopThread ();
+        }
+
+        void scheduleTask (Task& task)
+        {
+            {
+                LockType::scoped_lock sl (m_mutex);
+
+                m_tasks.push_back (&task);
+            }
+
+            notify ();
+        }
+
+        void run ()
+        {
+            while (! threadShouldExit ())
+            {
+                Task* task = nullptr;
+
+                {
+                    LockType::scoped_lock sl (m_mutex);
+
+                    if (! m_tasks.empty ())
+                    {
+                        task = m_tasks.front ();
+                        m_tasks.pop_front ();
+                    }
+                }
+
+                if (task != nullptr)
+                    task->performScheduledTask ();
+                else
+                    wait ();
+            }
+        }
+
+    private:
+        typedef boost::mutex LockType;
+
+        LockType m_mutex;
+        std::deque <Task*> m_tasks;
+    };
+
+    //--------------------------------------------------------------------------
+
+    // The latencies recorded by the mixed workload's threads
+    struct MixedState
+    {
+        MixedState (Database& db_, Batch const& stored_, Setup const& setup_)
+            : db (db_)
+            , stored (stored_)
+            , setup (setup_)
+        {
+        }
+
+        Database& db;
+        Batch const& stored;
+        Setup const& setup;
+        insight::HistogramBuckets reads;
+        insight::HistogramBuckets writes;
+    };
+
+    class MixedWorker : public Thread
+    {
+    public:
+        MixedWorker (MixedState& state, Batch& toStore, int64 seedValue)
+            : Thread ("NodeStoreBenchmark")
+            , m_state (state)
+            , m_random (seedValue)
+        {
+            m_toStore.swap (toStore);
+        }
+
+        ~MixedWorker ()
+        {
+            stopThread ();
+        }
+
+        void run ()
+        {
+            Batch const& stored (m_state.stored);
+            std::size_t nextWrite = 0;
+
+            for (int i = 0; i < m_state.setup.opsPerThread; ++i)
+            {
+                if (nextWrite < m_toStore.size () &&
+                    m_random.nextDouble () < m_state.setup.writeRatio)
+                {
+                    NodeObject::Ptr const object (m_toStore [nextWrite++]);
+                    Blob data (object->getData ());
+
+                    int64 const start (getTicks ());
+                    m_state.db.store (object->getType (), object->getIndex (),
+                        data, object->getHash ());
+                    m_state.writes.record (getMicrosSince (start));
+                }
+                else
+                {
+                    uint256 const& hash (
+                        stored [m_random.nextInt (stored.size ())]->getHash ());
+
+                    int64 const start (getTicks ());
+                    m_state.db.fetch (hash);
+                    m_state.reads.record (getMicrosSince (start));
+                }
+            }
+        }
+
+    private:
+        MixedState& m_state;
+        Random m_random;
+        Batch m_toStore;
+    };
+
+    //--------------------------------------------------------------------------
+
+    static int64 getTicks ()
+    {
+        return Time::getHighResolutionTicks ();
+    }
+
+    static double getSecondsSince (int64 startTicks)
+    {
+        return Time::highResolutionTicksToSeconds (getTicks () - startTicks);
+    }
+
+    static insight::HistogramBuckets::value_type getMicrosSince (int64 startTicks)
+    {
+        return static_cast <insight::HistogramBuckets::value_type> (
+            getSecondsSince (startTicks) * 1000000);
+    }
+
+    void report (String name, insight::HistogramBuckets const& micros,
+        double seconds, String extra = String::empty)
+    {
+        insight::HistogramBuckets::Snapshot const s (micros.snapshot ());
+
+        String text;
+        text << "  " << (name + ":").paddedRight (' ', 14);
+        if (seconds > 0)
+            text << String (s.count / seconds, 0) << " ops/s";
+        text << ", p50 "  << String (s.percentile (0.50)) <<
+                "us, p99 " << String (s.percentile (0.99)) <<
+                "us, p999 " << String (s.percentile (0.999)) <<
+                "us, max " << String (s.max) << "us";
+        if (extra.isNotEmpty ())
+            text << ", " << extra;
+
+        logMessage (text);
+    }
+
+    // Blocks until the backend has written everything given to it
+    static void waitForWrites (Database& db)
+    {
+        while (db.getWriteLoad () > 0)
+            Thread::sleep (1);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void testWriteBursts (Database& db, Batch const& stored, Setup const& setup)
+    {
+        insight::HistogramBuckets micros;
+
+        int64 const start (getTicks ());
+
+        for (int ledger = 0; ledger < setup.numLedgers; ++ledger)
+        {
+            int const first = ledger * setup.objectsPerLedger;
+
+            for (int i = first; i < first + setup.objectsPerLedger; ++i)
+            {
+                NodeObject::Ptr const object (stored [i]);
+                Blob data (object->getData ());
+
+                int64 const opStart (getTicks ());
+                db.store (object->getType (), object->getIndex (),
+                    data, object->getHash ());
+                micros.record (getMicrosSince (opStart));
+            }
+
+            waitForWrites (db);
+        }
+
+        report ("Write bursts", micros, getSecondsSince (start));
+    }
+
+    void testRandomReads (Database& db, Batch const& stored,
+        Setup const& setup, int64 seedValue)
+    {
+        Random r (seedValue);
+
+        // Visit the stored objects in a random order so that
+        // none of the hits can be answered by the cache.
+        std::vector <int> order (stored.size ());
+        for (int i = 0; i < order.size (); ++i)
+            order [i] = i;
+        for (int i = order.size () - 1; i > 0; --i)
+            std::swap (order [i], order [r.nextInt (i + 1)]);
+
+        insight::HistogramBuckets micros;
+        int expected = 0;
+        int found = 0;
+
+        int64 const start (getTicks ());
+
+        for (int i = 0; i < setup.numReads; ++i)
+        {
+            uint256 hash;
+
+            if (expected < order.size () && r.nextDouble () < setup.hitRatio)
+            {
+                hash = stored [order [expected++]]->getHash ();
+            }
+            else
+            {
+                r.fillBitsRandomly (hash.begin (), hash.size ());
+            }
+
+            int64 const opStart (getTicks ());
+            NodeObject::Ptr const object (db.fetch (hash));
+            micros.record (getMicrosSince (opStart));
+
+            if (object != nullptr)
+                ++found;
+        }
+
+        String extra;
+        extra << found << " of " << setup.numReads << " found";
+        report ("Random reads", micros, getSecondsSince (start), extra);
+
+        expect (found == expected, "Should find every stored object");
+    }
+
+    void testFetchPackScans (Database& db, Batch const& stored,
+        Setup const& setup, int64 seedValue)
+    {
+        Random r (seedValue);
+
+        insight::HistogramBuckets micros;
+        int missing = 0;
+
+        int64 const start (getTicks ());
+
+        for (int scan = 0; scan < setup.numScans; ++scan)
+        {
+            int const first = r.nextInt (setup.numLedgers) * setup.objectsPerLedger;
+
+            for (int i = first; i < first + setup.objectsPerLedger; ++i)
+            {
+                int64 const opStart (getTicks ());
+                NodeObject::Ptr const object (db.fetch (stored [i]->getHash ()));
+                micros.record (getMicrosSince (opStart));
+
+                if (object == nullptr)
+                    ++missing;
+            }
+        }
+
+        report ("Fetch packs", micros, getSecondsSince (start));
+
+        expect (missing == 0, "Should find every stored object");
+    }
+
+    void testMixed (Database& db, Batch const& stored,
+        Setup const& setup, int64 seedValue)
+    {
+        MixedState state (db, stored, setup);
+
+        double seconds;
+
+        {
+            OwnedArray <MixedWorker> workers;
+
+            // Each thread stores objects of its own, made before timing starts
+            int const writesPerThread = static_cast <int> (
+                setup.opsPerThread * setup.writeRatio * 2) + 1;
+
+            for (int i = 0; i < setup.numThreads; ++i)
+            {
+                Batch toStore;
+                createPredictableBatch (toStore,
+                    stored.size () + i * writesPerThread, writesPerThread, seedValue);
+                workers.add (new MixedWorker (state, toStore, seedValue + i));
+            }
+
+            int64 const start (getTicks ());
+
+            for (int i = 0; i < setup.numThreads; ++i)
+                workers [i]->startThread ();
+
+            for (int i = 0; i < setup.numThreads; ++i)
+                workers [i]->waitForThreadToExit ();
+
+            waitForWrites (db);
+
+            seconds = getSecondsSince (start);
+        }
+
+        String threads;
+        threads << setup.numThreads << " threads";
+
+        report ("Mixed reads", state.reads, seconds, threads);
+        report ("Mixed writes", state.writes, seconds, threads);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void testBackend (String type, String fastType, Setup const& setup, int64 seedValue)
+    {
+        String s;
+        s << "Benchmarking backend '" << type << "'";
+        if (fastType.isNotEmpty ())
+            s << " with fast backend '" << fastType << "'";
+        beginTestCase (s);
+
+        StringPairArray params;
+        File const path (File::createTempFile ("node_db"));
+        params.set ("type", type);
+        params.set ("path", path.getFullPathName ());
+
+        StringPairArray fastParams;
+        if (fastType.isNotEmpty ())
+        {
+            File const fastPath (File::createTempFile ("node_db_fast"));
+            fastParams.set ("type", fastType);
+            fastParams.set ("path", fastPath.getFullPathName ());
+        }
+
+        Batch stored;
+        createPredictableBatch (stored, 0,
+            setup.numLedgers * setup.objectsPerLedger, seedValue);
+
+        // The scheduler must outlive each database, which
+        // waits for its pending writes when it is destroyed.
+        ThreadScheduler scheduler;
+        ScopedPointer <Database> db;
+
+        // The memory backend loses everything when it is closed, so it is
+        // kept open from one workload to the next and reads from the cache.
+        bool const reopen = type.compareIgnoreCase ("memory") != 0;
+
+        for (int workload = 0; workload < 4; ++workload)
+        {
+            if (reopen || db == nullptr)
+            {
+                db = nullptr;
+                db = Database::New ("test", scheduler, params, fastParams);
+            }
+
+            switch (workload)
+            {
+            case 0: testWriteBursts (*db, stored, setup); break;
+            case 1: testRandomReads (*db, stored, setup, seedValue); break;
+            case 2: testFetchPackScans (*db, stored, setup, seedValue); break;
+            case 3: testMixed (*db, stored, setup, seedValue); break;
+            };
+        }
+
+        db = nullptr;
+    }
+
+    void testBackend (String type, Setup const& setup, int64 seedValue)
+    {
+        testBackend (type, String::empty, setup, seedValue);
+        testBackend (type, "memory", setup, seedValue);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void runTest ()
+    {
+        int const seedValue = 50;
+
+        Setup const setup;
+
+        testBackend ("leveldb", setup, seedValue);
+
+    #if RIPPLE_HYPERLEVELDB_AVAILABLE
+        testBackend ("hyperleveldb", setup, seedValue);
+    #endif
+
+    #if RIPPLE_ROCKSDB_AVAILABLE
+        testBackend ("rocksdb", setup, seedValue);
+    #endif
+
+    #if RIPPLE_SOPHIA_AVAILABLE
+        testBackend ("sophia", setup, seedValue);
+    #endif
+
+        testBackend ("keyvadb", setup, seedValue);
+
+        testBackend ("appenddb", setup, seedValue);
+
+        testBackend ("memory", String::empty, setup, seedValue);
+    }
+};
+
+static BenchmarkTests benchmarkTests;
+
+}
@@ -122,6 +122,8 @@ public:
         testBackend ("rocksdb", seedValue);
     #endif
 
+        testBackend ("appenddb", seedValue);
+
     /*
         testBackend ("sqlite", seedValue);
     */
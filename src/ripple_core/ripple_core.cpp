@@ -41,6 +41,7 @@ namespace ripple
 #include "functional/LoadFeeTrackImp.cpp"
 #include "functional/Job.cpp"
 #include "functional/JobQueue.cpp"
+#include "functional/JobTrace.cpp"
 #include "functional/LoadEvent.cpp"
 #include "functional/LoadMonitor.cpp"
 
@@ -41,6 +41,7 @@ namespace ripple
 #  include "functional/LoadEvent.h"
 #  include "functional/LoadMonitor.h"
 # include "functional/Job.h"
+# include "functional/JobTrace.h"
 #include "functional/JobQueue.h"
 
 }
@@ -0,0 +1,1537 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace secp256k1 {
+
+//------------------------------------------------------------------------------
+//
+// Multi-precision helpers. Numbers are arrays of 32-bit limbs, least
+// significant limb first. Products are formed in 64-bit intermediates.
+//
+
+inline int compareLimbs (uint32 const* a, uint32 const* b, int count)
+{
+    for (int i = count - 1; i >= 0; --i)
+    {
+        if (a [i] != b [i])
+            return (a [i] < b [i]) ? -1 : 1;
+    }
+    return 0;
+}
+
+inline bool isZeroLimbs (uint32 const* a, int count)
+{
+    for (int i = 0; i < count; ++i)
+        if (a [i] != 0)
+            return false;
+    return true;
+}
+
+// r = a + b, returns the carry
+inline uint32 addLimbs (uint32* r, uint32 const* a, uint32 const* b, int count)
+{
+    uint64 t = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        t += uint64 (a [i]) + b [i];
+        r [i] = uint32 (t);
+        t >>= 32;
+    }
+    return uint32 (t);
+}
+
+// r = a - b, returns the borrow
+inline uint32 subtractLimbs (uint32* r, uint32 const* a, uint32 const* b, int count)
+{
+    int64 t = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        t += int64 (a [i]) - b [i];
+        r [i] = uint32 (t);
+        t >>= 32;
+    }
+    return t ? 1 : 0;
+}
+
+// r += a * b, where r has room for the full result
+inline void multiplyAddLimbs (uint32* r, int rCount,
+    uint32 const* a, int aCount, uint32 const* b, int bCount)
+{
+    for (int i = 0; i < aCount; ++i)
+    {
+        uint64 carry = 0;
+        int j = 0;
+        for (; j < bCount; ++j)
+        {
+            uint64 const t = uint64 (a [i]) * b [j] + r [i + j] + carry;
+            r [i + j] = uint32 (t);
+            carry = t >> 32;
+        }
+        for (int k = i + j; carry != 0 && k < rCount; ++k)
+        {
+            uint64 const t = uint64 (r [k]) + carry;
+            r [k] = uint32 (t);
+            carry = t >> 32;
+        }
+    }
+}
+
+// r [16] = a [8] * b [8]
+#if defined (__SIZEOF_INT128__)
+// Where the compiler offers a 128-bit type, multiply in 64-bit halves.
+// This is the innermost loop of verification and runs about twice as fast.
+inline void multiplyLimbs (uint32* r, uint32 const* a, uint32 const* b)
+{
+    typedef unsigned __int128 uint128;
+
+    uint64 x [4];
+    uint64 y [4];
+    uint64 z [8] = { 0 };
+    for (int i = 0; i < 4; ++i)
+    {
+        x [i] = a [2 * i] | (uint64 (a [2 * i + 1]) << 32);
+        y [i] = b [2 * i] | (uint64 (b [2 * i + 1]) << 32);
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        uint64 carry = 0;
+        for (int j = 0; j < 4; ++j)
+        {
+            uint128 const t = uint128 (x [i]) * y [j] + z [i + j] + carry;
+            z [i + j] = uint64 (t);
+            carry = uint64 (t >> 64);
+        }
+        z [i + 4] = carry;
+    }
+
+    for (int i = 0; i < 8; ++i)
+    {
+        r [2 * i] = uint32 (z [i]);
+        r [2 * i + 1] = uint32 (z [i] >> 32);
+    }
+}
+#else
+inline void multiplyLimbs (uint32* r, uint32 const* a, uint32 const* b)
+{
+    std::fill (r, r + 16, 0);
+    multiplyAddLimbs (r, 16, a, 8, b, 8);
+}
+#endif
+
+// Returns `count` bits of a starting at bit `offset`, count <= 31
+inline uint32 getBits (uint32 const* a, int offset, int count)
+{
+    int const limb = offset >> 5;
+    int const shift = offset & 31;
+    uint64 v = a [limb] >> shift;
+    if (shift + count > 32 && limb < 7)
+        v |= uint64 (a [limb + 1]) << (32 - shift);
+    return uint32 (v) & ((1u << count) - 1);
+}
+
+inline bool isOneLimbs (uint32 const* a)
+{
+    return a [0] == 1 && isZeroLimbs (a + 1, 7);
+}
+
+inline void shiftRightLimbs (uint32* a, uint32 topBit)
+{
+    for (int i = 0; i < 7; ++i)
+        a [i] = (a [i] >> 1) | (a [i + 1] << 31);
+    a [7] = (a [7] >> 1) | (topBit << 31);
+}
+
+// r = a - b (mod m), for a, b < m
+inline void subtractModulo (uint32* r, uint32 const* a, uint32 const* b, uint32 const* m)
+{
+    if (subtractLimbs (r, a, b, 8))
+        addLimbs (r, r, m, 8);
+}
+
+// r = 1 / a (mod m) for odd m and 0 < a < m, by binary extended Euclid.
+// Everything passed here is public, so variable time is acceptable.
+void inverseModulo (uint32* r, uint32 const* a, uint32 const* m)
+{
+    bassert (! isZeroLimbs (a, 8));
+
+    uint32 u [8];
+    uint32 v [8];
+    uint32 x1 [8] = { 1 };
+    uint32 x2 [8] = { 0 };
+    std::copy (a, a + 8, u);
+    std::copy (m, m + 8, v);
+
+    // Invariants: x1 * a = u and x2 * a = v (mod m)
+    while (! isOneLimbs (u) && ! isOneLimbs (v))
+    {
+        while ((u [0] & 1) == 0)
+        {
+            shiftRightLimbs (u, 0);
+            uint32 const carry = (x1 [0] & 1) ? addLimbs (x1, x1, m, 8) : 0;
+            shiftRightLimbs (x1, carry);
+        }
+        while ((v [0] & 1) == 0)
+        {
+            shiftRightLimbs (v, 0);
+            uint32 const carry = (x2 [0] & 1) ? addLimbs (x2, x2, m, 8) : 0;
+            shiftRightLimbs (x2, carry);
+        }
+        if (compareLimbs (u, v, 8) >= 0)
+        {
+            subtractLimbs (u, u, v, 8);
+            subtractModulo (x1, x1, x2, m);
+        }
+        else
+        {
+            subtractLimbs (v, v, u, 8);
+            subtractModulo (x2, x2, x1, m);
+        }
+    }
+
+    uint32 const* const result (isOneLimbs (u) ? x1 : x2);
+    std::copy (result, result + 8, r);
+}
+
+// Big endian bytes to limbs, bytes <= 32
+inline void limbsFromBytes (uint32* r, uint8 const* data, std::size_t bytes)
+{
+    std::fill (r, r + 8, 0);
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+        std::size_t const bit = 8 * (bytes - 1 - i);
+        r [bit >> 5] |= uint32 (data [i]) << (bit & 31);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+// Field elements modulo p = 2^256 - 2^32 - 977, always fully reduced.
+//
+
+struct FieldElement
+{
+    uint32 n [8];
+};
+
+static uint32 const fieldPrime [8] = {
+    0xFFFFFC2F, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+
+// (p + 1) / 4, for square roots
+static uint32 const fieldSqrtExponent [8] = {
+    0xBFFFFF0C, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x3FFFFFFF };
+
+// The cube root of unity used by the endomorphism (beta)
+static uint32 const fieldBeta [8] = {
+    0x719501EE, 0xC1396C28, 0x12F58995, 0x9CF04975,
+    0xAC3434E9, 0x6E64479E, 0x657C0710, 0x7AE96A2B };
+
+inline void fieldSetInt (FieldElement& r, uint32 v)
+{
+    std::fill (r.n, r.n + 8, 0);
+    r.n [0] = v;
+}
+
+inline bool fieldIsZero (FieldElement const& a)
+{
+    return isZeroLimbs (a.n, 8);
+}
+
+inline bool fieldIsOdd (FieldElement const& a)
+{
+    return (a.n [0] & 1) != 0;
+}
+
+inline bool fieldEqual (FieldElement const& a, FieldElement const& b)
+{
+    return compareLimbs (a.n, b.n, 8) == 0;
+}
+
+// r += k * (2^256 - p), returns the carry out of the top limb
+inline uint32 fieldAddFold (uint32* r, uint64 k)
+{
+    uint64 t = uint64 (r [0]) + k * 977;
+    r [0] = uint32 (t);
+    t >>= 32;
+    t += uint64 (r [1]) + k;
+    r [1] = uint32 (t);
+    t >>= 32;
+    for (int i = 2; i < 8; ++i)
+    {
+        t += r [i];
+        r [i] = uint32 (t);
+        t >>= 32;
+    }
+    return uint32 (t);
+}
+
+inline void fieldNormalize (FieldElement& r)
+{
+    if (compareLimbs (r.n, fieldPrime, 8) >= 0)
+        subtractLimbs (r.n, r.n, fieldPrime, 8);
+}
+
+inline void fieldAdd (FieldElement& r, FieldElement const& a, FieldElement const& b)
+{
+    if (addLimbs (r.n, a.n, b.n, 8))
+        fieldAddFold (r.n, 1);
+    fieldNormalize (r);
+}
+
+inline void fieldSub (FieldElement& r, FieldElement const& a, FieldElement const& b)
+{
+    if (subtractLimbs (r.n, a.n, b.n, 8))
+        addLimbs (r.n, r.n, fieldPrime, 8);
+}
+
+inline void fieldNegate (FieldElement& r, FieldElement const& a)
+{
+    if (fieldIsZero (a))
+        r = a;
+    else
+        subtractLimbs (r.n, fieldPrime, a.n, 8);
+}
+
+void fieldMultiply (FieldElement& r, FieldElement const& a, FieldElement const& b)
+{
+    uint32 t [16];
+    multiplyLimbs (t, a.n, b.n);
+
+    // Fold the high half down using 2^256 = 2^32 + 977 (mod p)
+    uint64 c = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        c += uint64 (t [i]) + uint64 (t [8 + i]) * 977;
+        if (i > 0)
+            c += t [7 + i];
+        r.n [i] = uint32 (c);
+        c >>= 32;
+    }
+    c += t [15];
+
+    if (fieldAddFold (r.n, c))
+        fieldAddFold (r.n, 1);
+    fieldNormalize (r);
+}
+
+inline void fieldSquare (FieldElement& r, FieldElement const& a)
+{
+    fieldMultiply (r, a, a);
+}
+
+// r = a ^ e using a fixed 4-bit window
+void fieldPower (FieldElement& r, FieldElement const& a, uint32 const* e)
+{
+    FieldElement table [16];
+    fieldSetInt (table [0], 1);
+    table [1] = a;
+    for (int i = 2; i < 16; ++i)
+        fieldMultiply (table [i], table [i - 1], a);
+
+    FieldElement x;
+    fieldSetInt (x, 1);
+    for (int i = 63; i >= 0; --i)
+    {
+        if (i != 63)
+        {
+            for (int j = 0; j < 4; ++j)
+                fieldSquare (x, x);
+        }
+        uint32 const nibble = (e [i >> 3] >> ((i & 7) * 4)) & 0xF;
+        if (nibble != 0)
+            fieldMultiply (x, x, table [nibble]);
+    }
+    r = x;
+}
+
+inline void fieldInverse (FieldElement& r, FieldElement const& a)
+{
+    inverseModulo (r.n, a.n, fieldPrime);
+}
+
+// Returns false if a is not a quadratic residue
+bool fieldSqrt (FieldElement& r, FieldElement const& a)
+{
+    FieldElement x;
+    fieldPower (x, a, fieldSqrtExponent);
+    FieldElement check;
+    fieldSquare (check, x);
+    if (! fieldEqual (check, a))
+        return false;
+    r = x;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+// Scalars modulo the group order n.
+//
+
+struct Scalar
+{
+    uint32 n [8];
+};
+
+static uint32 const groupOrder [8] = {
+    0xD0364141, 0xBFD25E8C, 0xAF48A03B, 0xBAAEDCE6,
+    0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+
+// 2^256 - n
+static uint32 const groupOrderComplement [5] = {
+    0x2FC9BEBF, 0x402DA173, 0x50B75FC4, 0x45512319, 0x00000001 };
+
+// (n - 1) / 2
+static uint32 const groupHalfOrder [8] = {
+    0x681B20A0, 0xDFE92F46, 0x57A4501D, 0x5D576E73,
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x7FFFFFFF };
+
+// p - n, the bound on r for the second x coordinate candidate
+static uint32 const fieldMinusOrder [8] = {
+    0x2FC9BAEE, 0x402DA172, 0x50B75FC4, 0x45512319,
+    0x00000001, 0x00000000, 0x00000000, 0x00000000 };
+
+// Endomorphism decomposition constants
+static Scalar const minusLambda = { {
+    0xB51283CF, 0xE0CFC810, 0x8EC739C2, 0xA880B9FC,
+    0x77ED9BA4, 0x5AD9E3FD, 0x3FA3CF1F, 0xAC9C52B3 } };
+
+static Scalar const minusB1 = { {
+    0x0ABFE4C3, 0x6F547FA9, 0x010E8828, 0xE4437ED6,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000 } };
+
+static Scalar const minusB2 = { {
+    0x3DB1562C, 0xD765CDA8, 0x0774346D, 0x8A280AC5,
+    0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF } };
+
+static uint32 const glvG1 [8] = {
+    0x45DBB031, 0xE893209A, 0x71E8CA7F, 0x3DAA8A14,
+    0x9284EB15, 0xE86C90E4, 0xA7D46BCD, 0x3086D221 };
+
+static uint32 const glvG2 [8] = {
+    0x8AC47F71, 0x1571B4AE, 0x9DF506C6, 0x221208AC,
+    0x0ABFE4C4, 0x6F547FA9, 0x010E8828, 0xE4437ED6 };
+
+inline bool scalarIsZero (Scalar const& a)
+{
+    return isZeroLimbs (a.n, 8);
+}
+
+inline void scalarNormalize (Scalar& r)
+{
+    if (compareLimbs (r.n, groupOrder, 8) >= 0)
+        subtractLimbs (r.n, r.n, groupOrder, 8);
+}
+
+// Reduces a 512-bit number
+void scalarReduce (Scalar& r, uint32 const* wide)
+{
+    uint32 x [17];
+    std::copy (wide, wide + 16, x);
+
+    int used = 16;
+    while (used > 0 && x [used - 1] == 0)
+        --used;
+
+    // Fold using 2^256 = 2^256 - n (mod n) until the high half is empty
+    while (used > 8)
+    {
+        uint32 y [17];
+        std::copy (x, x + 8, y);
+        std::fill (y + 8, y + 17, 0);
+        multiplyAddLimbs (y, 17, x + 8, used - 8, groupOrderComplement, 5);
+
+        used = 17;
+        while (used > 0 && y [used - 1] == 0)
+            --used;
+        std::copy (y, y + 17, x);
+    }
+
+    std::copy (x, x + 8, r.n);
+    while (compareLimbs (r.n, groupOrder, 8) >= 0)
+        subtractLimbs (r.n, r.n, groupOrder, 8);
+}
+
+inline void scalarMultiply (Scalar& r, Scalar const& a, Scalar const& b)
+{
+    uint32 t [16];
+    multiplyLimbs (t, a.n, b.n);
+    scalarReduce (r, t);
+}
+
+inline void scalarAdd (Scalar& r, Scalar const& a, Scalar const& b)
+{
+    if (addLimbs (r.n, a.n, b.n, 8))
+    {
+        uint32 c [8] = { 0 };
+        std::copy (groupOrderComplement, groupOrderComplement + 5, c);
+        addLimbs (r.n, r.n, c, 8);
+    }
+    scalarNormalize (r);
+}
+
+inline void scalarNegate (Scalar& r, Scalar const& a)
+{
+    if (scalarIsZero (a))
+        r = a;
+    else
+        subtractLimbs (r.n, groupOrder, a.n, 8);
+}
+
+inline void scalarInverse (Scalar& r, Scalar const& a)
+{
+    inverseModulo (r.n, a.n, groupOrder);
+}
+
+// r = round (a * g / 2^384)
+inline void scalarMultiplyShift384 (Scalar& r, Scalar const& a, uint32 const* g)
+{
+    uint32 t [16];
+    multiplyLimbs (t, a.n, g);
+    std::fill (r.n, r.n + 8, 0);
+    std::copy (t + 12, t + 16, r.n);
+    uint32 const one [8] = { 1 };
+    if (t [11] >> 31)
+        addLimbs (r.n, r.n, one, 8);
+}
+
+// Splits k into r1 + r2 * lambda with r1, r2 around 128 bits
+void scalarSplitLambda (Scalar& r1, Scalar& r2, Scalar const& k)
+{
+    Scalar c1;
+    Scalar c2;
+    scalarMultiplyShift384 (c1, k, glvG1);
+    scalarMultiplyShift384 (c2, k, glvG2);
+    scalarMultiply (c1, c1, minusB1);
+    scalarMultiply (c2, c2, minusB2);
+    scalarAdd (r2, c1, c2);
+    scalarMultiply (r1, r2, minusLambda);
+    scalarAdd (r1, r1, k);
+}
+
+// Replaces a by its negation if that is smaller, returns true if negated
+inline bool scalarMakeSmall (Scalar& a)
+{
+    if (compareLimbs (a.n, groupHalfOrder, 8) > 0)
+    {
+        scalarNegate (a, a);
+        return true;
+    }
+    return false;
+}
+
+// Computes the width-w non adjacent form of a, which must be below 2^(len-1).
+// Returns the number of digits used.
+int computeWnaf (int* wnaf, int len, Scalar const& a, int w)
+{
+    std::fill (wnaf, wnaf + len, 0);
+    int carry = 0;
+    int last = -1;
+    int bit = 0;
+    while (bit < len)
+    {
+        if (int (getBits (a.n, bit, 1)) == carry)
+        {
+            ++bit;
+            continue;
+        }
+        int now = w;
+        if (now > len - bit)
+            now = len - bit;
+        int word = int (getBits (a.n, bit, now)) + carry;
+        carry = (word >> (w - 1)) & 1;
+        word -= carry << w;
+        wnaf [bit] = word;
+        last = bit;
+        bit += now;
+    }
+    bassert (carry == 0);
+    return last + 1;
+}
+
+//------------------------------------------------------------------------------
+//
+// Curve points on y^2 = x^3 + 7.
+//
+
+struct AffinePoint
+{
+    FieldElement x;
+    FieldElement y;
+};
+
+struct JacobianPoint
+{
+    FieldElement x;
+    FieldElement y;
+    FieldElement z;
+    bool infinity;
+};
+
+bool isOnCurve (FieldElement const& x, FieldElement const& y)
+{
+    FieldElement lhs;
+    FieldElement rhs;
+    FieldElement seven;
+    fieldSetInt (seven, 7);
+    fieldSquare (lhs, y);
+    fieldSquare (rhs, x);
+    fieldMultiply (rhs, rhs, x);
+    fieldAdd (rhs, rhs, seven);
+    return fieldEqual (lhs, rhs);
+}
+
+inline void pointFromAffine (JacobianPoint& r, AffinePoint const& a)
+{
+    r.x = a.x;
+    r.y = a.y;
+    fieldSetInt (r.z, 1);
+    r.infinity = false;
+}
+
+// dbl-2009-l
+void pointDouble (JacobianPoint& r, JacobianPoint const& a)
+{
+    if (a.infinity || fieldIsZero (a.y))
+    {
+        r.infinity = true;
+        return;
+    }
+
+    FieldElement A, B, C, D, E, F, t;
+    fieldSquare (A, a.x);
+    fieldSquare (B, a.y);
+    fieldSquare (C, B);
+    fieldAdd (t, a.x, B);
+    fieldSquare (t, t);
+    fieldSub (t, t, A);
+    fieldSub (t, t, C);
+    fieldAdd (D, t, t);
+    fieldAdd (E, A, A);
+    fieldAdd (E, E, A);
+    fieldSquare (F, E);
+
+    // Z3 first, since r may alias a
+    fieldMultiply (r.z, a.y, a.z);
+    fieldAdd (r.z, r.z, r.z);
+
+    fieldSub (r.x, F, D);
+    fieldSub (r.x, r.x, D);
+
+    fieldSub (t, D, r.x);
+    fieldMultiply (t, E, t);
+    fieldAdd (C, C, C);
+    fieldAdd (C, C, C);
+    fieldAdd (C, C, C);
+    fieldSub (r.y, t, C);
+    r.infinity = false;
+}
+
+// madd-2007-bl, adds an affine point
+void pointAddAffine (JacobianPoint& r, JacobianPoint const& a, AffinePoint const& b)
+{
+    if (a.infinity)
+    {
+        pointFromAffine (r, b);
+        return;
+    }
+
+    FieldElement Z1Z1, U2, S2, H, HH, I, J, R, V, t;
+    fieldSquare (Z1Z1, a.z);
+    fieldMultiply (U2, b.x, Z1Z1);
+    fieldMultiply (S2, b.y, a.z);
+    fieldMultiply (S2, S2, Z1Z1);
+    fieldSub (H, U2, a.x);
+    fieldSub (R, S2, a.y);
+
+    if (fieldIsZero (H))
+    {
+        if (fieldIsZero (R))
+        {
+            pointDouble (r, a);
+        }
+        else
+        {
+            r.infinity = true;
+        }
+        return;
+    }
+
+    fieldAdd (R, R, R);
+    fieldSquare (HH, H);
+    fieldAdd (I, HH, HH);
+    fieldAdd (I, I, I);
+    fieldMultiply (J, H, I);
+    fieldMultiply (V, a.x, I);
+
+    FieldElement y1J;
+    fieldMultiply (y1J, a.y, J);
+    fieldAdd (y1J, y1J, y1J);
+
+    fieldAdd (t, a.z, H);
+    fieldSquare (t, t);
+    fieldSub (t, t, Z1Z1);
+    fieldSub (r.z, t, HH);
+
+    fieldSquare (t, R);
+    fieldSub (t, t, J);
+    fieldSub (t, t, V);
+    fieldSub (r.x, t, V);
+
+    fieldSub (t, V, r.x);
+    fieldMultiply (t, R, t);
+    fieldSub (r.y, t, y1J);
+    r.infinity = false;
+}
+
+// add-2007-bl, used only when building tables
+void pointAdd (JacobianPoint& r, JacobianPoint const& a, JacobianPoint const& b)
+{
+    if (a.infinity)
+    {
+        r = b;
+        return;
+    }
+    if (b.infinity)
+    {
+        r = a;
+        return;
+    }
+
+    FieldElement Z1Z1, Z2Z2, U1, U2, S1, S2, H, I, J, R, V, t;
+    fieldSquare (Z1Z1, a.z);
+    fieldSquare (Z2Z2, b.z);
+    fieldMultiply (U1, a.x, Z2Z2);
+    fieldMultiply (U2, b.x, Z1Z1);
+    fieldMultiply (S1, a.y, b.z);
+    fieldMultiply (S1, S1, Z2Z2);
+    fieldMultiply (S2, b.y, a.z);
+    fieldMultiply (S2, S2, Z1Z1);
+    fieldSub (H, U2, U1);
+    fieldSub (R, S2, S1);
+
+    if (fieldIsZero (H))
+    {
+        if (fieldIsZero (R))
+        {
+            pointDouble (r, a);
+        }
+        else
+        {
+            r.infinity = true;
+        }
+        return;
+    }
+
+    fieldAdd (R, R, R);
+    fieldAdd (I, H, H);
+    fieldSquare (I, I);
+    fieldMultiply (J, H, I);
+    fieldMultiply (V, U1, I);
+
+    fieldAdd (t, a.z, b.z);
+    fieldSquare (t, t);
+    fieldSub (t, t, Z1Z1);
+    fieldSub (t, t, Z2Z2);
+    fieldMultiply (r.z, t, H);
+
+    fieldSquare (t, R);
+    fieldSub (t, t, J);
+    fieldSub (t, t, V);
+    fieldSub (r.x, t, V);
+
+    fieldMultiply (S1, S1, J);
+    fieldAdd (S1, S1, S1);
+    fieldSub (t, V, r.x);
+    fieldMultiply (t, R, t);
+    fieldSub (r.y, t, S1);
+    r.infinity = false;
+}
+
+// Converts points to affine form with a single inversion.
+// None of the points may be at infinity.
+void pointsToAffine (AffinePoint* r, JacobianPoint const* a, std::size_t count)
+{
+    std::vector <FieldElement> products (count);
+    products [0] = a [0].z;
+    for (std::size_t i = 1; i < count; ++i)
+        fieldMultiply (products [i], products [i - 1], a [i].z);
+
+    FieldElement inverse;
+    fieldInverse (inverse, products [count - 1]);
+
+    for (std::size_t i = count; i-- > 0;)
+    {
+        FieldElement zi;
+        if (i > 0)
+        {
+            fieldMultiply (zi, inverse, products [i - 1]);
+            fieldMultiply (inverse, inverse, a [i].z);
+        }
+        else
+        {
+            zi = inverse;
+        }
+
+        FieldElement zi2;
+        FieldElement zi3;
+        fieldSquare (zi2, zi);
+        fieldMultiply (zi3, zi2, zi);
+        fieldMultiply (r [i].x, a [i].x, zi2);
+        fieldMultiply (r [i].y, a [i].y, zi3);
+    }
+}
+
+// Fills r with P, 3P, 5P ... in affine form
+void buildOddMultiples (AffinePoint* r, AffinePoint const& p, std::size_t count)
+{
+    std::vector <JacobianPoint> points (count);
+    pointFromAffine (points [0], p);
+
+    JacobianPoint twice;
+    pointDouble (twice, points [0]);
+
+    for (std::size_t i = 1; i < count; ++i)
+        pointAdd (points [i], points [i - 1], twice);
+
+    pointsToAffine (r, &points [0], count);
+}
+
+//------------------------------------------------------------------------------
+
+enum
+{
+    // Window for multiples of the generator, tables hold 2^(w-2) points
+    generatorWindow = 12,
+    generatorTableSize = 1 << (generatorWindow - 2),
+
+    // Limbs stored per public key table entry
+    publicKeyEntryLimbs = 24,
+
+    // Digits in the wNAF of a 128-bit scalar
+    wnafLength = 129
+};
+
+/** Odd multiples of G and of 2^128 G, built on first use. */
+struct GeneratorTables
+{
+    GeneratorTables ()
+    {
+        AffinePoint g;
+        limbsFromBytes (g.x.n, generatorX, 32);
+        limbsFromBytes (g.y.n, generatorY, 32);
+        buildOddMultiples (low, g, generatorTableSize);
+
+        JacobianPoint h;
+        pointFromAffine (h, g);
+        for (int i = 0; i < 128; ++i)
+            pointDouble (h, h);
+        AffinePoint high128;
+        pointsToAffine (&high128, &h, 1);
+        buildOddMultiples (high, high128, generatorTableSize);
+    }
+
+    static uint8 const generatorX [32];
+    static uint8 const generatorY [32];
+
+    AffinePoint low [generatorTableSize];
+    AffinePoint high [generatorTableSize];
+};
+
+uint8 const GeneratorTables::generatorX [32] = {
+    0x79, 0xBE, 0x66, 0x7E, 0xF9, 0xDC, 0xBB, 0xAC,
+    0x55, 0xA0, 0x62, 0x95, 0xCE, 0x87, 0x0B, 0x07,
+    0x02, 0x9B, 0xFC, 0xDB, 0x2D, 0xCE, 0x28, 0xD9,
+    0x59, 0xF2, 0x81, 0x5B, 0x16, 0xF8, 0x17, 0x98 };
+
+uint8 const GeneratorTables::generatorY [32] = {
+    0x48, 0x3A, 0xDA, 0x77, 0x26, 0xA3, 0xC4, 0x65,
+    0x5D, 0xA4, 0xFB, 0xFC, 0x0E, 0x11, 0x08, 0xA8,
+    0xFD, 0x17, 0xB4, 0x48, 0xA6, 0x85, 0x54, 0x19,
+    0x9C, 0x47, 0xD0, 0x8F, 0xFB, 0x10, 0xD4, 0xB8 };
+
+typedef SharedSingleton <GeneratorTables>::Ptr GeneratorTablesPtr;
+
+inline GeneratorTablesPtr getGeneratorTables ()
+{
+    return SharedSingleton <GeneratorTables>::get (
+        SingletonLifetime::neverDestroyed);
+}
+
+// Adds the table entry selected by a wNAF digit, negating when needed
+inline void addDigit (JacobianPoint& r, int digit, bool negate,
+    AffinePoint const* table)
+{
+    if (digit > 0)
+    {
+        AffinePoint const& p (table [(digit - 1) / 2]);
+        if (! negate)
+        {
+            pointAddAffine (r, r, p);
+            return;
+        }
+        AffinePoint q;
+        q.x = p.x;
+        fieldNegate (q.y, p.y);
+        pointAddAffine (r, r, q);
+    }
+    else if (digit < 0)
+    {
+        AffinePoint const& p (table [(-digit - 1) / 2]);
+        if (negate)
+        {
+            pointAddAffine (r, r, p);
+            return;
+        }
+        AffinePoint q;
+        q.x = p.x;
+        fieldNegate (q.y, p.y);
+        pointAddAffine (r, r, q);
+    }
+}
+
+// Verifies with a precomputed inverse of s
+bool verifyWithInverse (GeneratorTables const& g,
+    Scalar const& e, Scalar const& r, Scalar const& sInverse,
+    AffinePoint const* keyTable, AffinePoint const* keyLambdaTable, int keyWindow)
+{
+    Scalar u1;
+    Scalar u2;
+    scalarMultiply (u1, e, sInverse);
+    scalarMultiply (u2, r, sInverse);
+
+    // u1 G = u1low G + u1high (2^128 G)
+    Scalar u1Low = { { u1.n [0], u1.n [1], u1.n [2], u1.n [3] } };
+    Scalar u1High = { { u1.n [4], u1.n [5], u1.n [6], u1.n [7] } };
+
+    // u2 Q = k1 Q + k2 lambda(Q)
+    Scalar k1;
+    Scalar k2;
+    scalarSplitLambda (k1, k2, u2);
+    bool const negate1 = scalarMakeSmall (k1);
+    bool const negate2 = scalarMakeSmall (k2);
+
+    int wnafLow [wnafLength];
+    int wnafHigh [wnafLength];
+    int wnaf1 [wnafLength];
+    int wnaf2 [wnafLength];
+    int bits = computeWnaf (wnafLow, wnafLength, u1Low, generatorWindow);
+    bits = std::max (bits, computeWnaf (wnafHigh, wnafLength, u1High, generatorWindow));
+    bits = std::max (bits, computeWnaf (wnaf1, wnafLength, k1, keyWindow));
+    bits = std::max (bits, computeWnaf (wnaf2, wnafLength, k2, keyWindow));
+
+    JacobianPoint x;
+    x.infinity = true;
+    for (int i = bits - 1; i >= 0; --i)
+    {
+        pointDouble (x, x);
+        addDigit (x, wnafLow [i], false, g.low);
+        addDigit (x, wnafHigh [i], false, g.high);
+        addDigit (x, wnaf1 [i], negate1, keyTable);
+        addDigit (x, wnaf2 [i], negate2, keyLambdaTable);
+    }
+
+    if (x.infinity)
+        return false;
+
+    // Compare r against X / Z^2 without inverting Z. Since r < n < p,
+    // the affine x coordinate reduced mod n equals r when x == r or,
+    // for r < p - n, when x == r + n.
+    FieldElement zz;
+    FieldElement t;
+    fieldSquare (zz, x.z);
+
+    FieldElement candidate;
+    std::copy (r.n, r.n + 8, candidate.n);
+    fieldMultiply (t, candidate, zz);
+    if (fieldEqual (t, x.x))
+        return true;
+
+    if (compareLimbs (r.n, fieldMinusOrder, 8) >= 0)
+        return false;
+
+    addLimbs (candidate.n, candidate.n, groupOrder, 8);
+    fieldMultiply (t, candidate, zz);
+    return fieldEqual (t, x.x);
+}
+
+// Parses a strictly encoded positive DER integer into 0 < a < n
+bool parseInteger (Scalar& a, uint8 const* data, std::size_t bytes)
+{
+    if (bytes == 0 || (data [0] & 0x80) != 0)
+        return false;
+
+    if (bytes > 1 && data [0] == 0 && (data [1] & 0x80) == 0)
+        return false;
+
+    if (data [0] == 0)
+    {
+        ++data;
+        --bytes;
+    }
+
+    if (bytes > 32)
+        return false;
+
+    limbsFromBytes (a.n, data, bytes);
+
+    return ! scalarIsZero (a) && compareLimbs (a.n, groupOrder, 8) < 0;
+}
+
+void hashToScalar (Scalar& e, uint256 const& hash)
+{
+    limbsFromBytes (e.n, hash.begin (), 32);
+    scalarNormalize (e);
+}
+
+// Fills the table stored by a PublicKey
+void buildPublicKeyTable (std::vector <uint32>& table,
+    AffinePoint const& point, int window)
+{
+    std::size_t const entries (std::size_t (1) << (window - 2));
+    std::vector <AffinePoint> points (entries);
+    buildOddMultiples (&points [0], point, entries);
+
+    FieldElement beta;
+    std::copy (fieldBeta, fieldBeta + 8, beta.n);
+
+    table.resize (entries * publicKeyEntryLimbs);
+    for (std::size_t i = 0; i < entries; ++i)
+    {
+        uint32* const entry (&table [i * publicKeyEntryLimbs]);
+        FieldElement lambdaX;
+        fieldMultiply (lambdaX, points [i].x, beta);
+        std::copy (points [i].x.n, points [i].x.n + 8, entry);
+        std::copy (points [i].y.n, points [i].y.n + 8, entry + 8);
+        std::copy (lambdaX.n, lambdaX.n + 8, entry + 16);
+    }
+}
+
+// Unpacks a stored table, returns the number of entries
+std::size_t unpackPublicKeyTable (AffinePoint* table, AffinePoint* lambdaTable,
+    std::vector <uint32> const& packed)
+{
+    std::size_t const entries (packed.size () / publicKeyEntryLimbs);
+    for (std::size_t i = 0; i < entries; ++i)
+    {
+        uint32 const* const entry (&packed [i * publicKeyEntryLimbs]);
+        std::copy (entry, entry + 8, table [i].x.n);
+        std::copy (entry + 8, entry + 16, table [i].y.n);
+        std::copy (entry + 16, entry + 24, lambdaTable [i].x.n);
+        lambdaTable [i].y = table [i].y;
+    }
+    return entries;
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+Secp256k1::PublicKey::PublicKey ()
+    : m_valid (false)
+    , m_window (0)
+{
+}
+
+bool Secp256k1::PublicKey::parse (void const* data, std::size_t bytes)
+{
+    using namespace secp256k1;
+
+    m_valid = false;
+
+    uint8 const* const p (static_cast <uint8 const*> (data));
+    AffinePoint point;
+
+    if (bytes == 33 && (p [0] == 0x02 || p [0] == 0x03))
+    {
+        limbsFromBytes (point.x.n, p + 1, 32);
+        if (compareLimbs (point.x.n, fieldPrime, 8) >= 0)
+            return false;
+
+        FieldElement rhs;
+        FieldElement seven;
+        fieldSetInt (seven, 7);
+        fieldSquare (rhs, point.x);
+        fieldMultiply (rhs, rhs, point.x);
+        fieldAdd (rhs, rhs, seven);
+        if (! fieldSqrt (point.y, rhs))
+            return false;
+
+        if (fieldIsOdd (point.y) != (p [0] == 0x03))
+            fieldNegate (point.y, point.y);
+    }
+    else if (bytes == 65 && (p [0] == 0x04 || p [0] == 0x06 || p [0] == 0x07))
+    {
+        limbsFromBytes (point.x.n, p + 1, 32);
+        limbsFromBytes (point.y.n, p + 33, 32);
+        if (compareLimbs (point.x.n, fieldPrime, 8) >= 0 ||
+            compareLimbs (point.y.n, fieldPrime, 8) >= 0)
+            return false;
+
+        // Hybrid encodings carry the parity of y in the prefix
+        if (p [0] != 0x04 && fieldIsOdd (point.y) != (p [0] == 0x07))
+            return false;
+
+        if (! isOnCurve (point.x, point.y))
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    buildPublicKeyTable (m_table, point, defaultWindow);
+    m_window = defaultWindow;
+    m_valid = true;
+    return true;
+}
+
+void Secp256k1::PublicKey::precompute (int window)
+{
+    using namespace secp256k1;
+
+    bassert (window >= 2 && window <= maximumWindow);
+
+    if (! m_valid || window == m_window)
+        return;
+
+    AffinePoint point;
+    std::copy (&m_table [0], &m_table [0] + 8, point.x.n);
+    std::copy (&m_table [8], &m_table [8] + 8, point.y.n);
+    buildPublicKeyTable (m_table, point, window);
+    m_window = window;
+}
+
+bool Secp256k1::PublicKey::parse (Blob const& data)
+{
+    if (data.empty ())
+    {
+        m_valid = false;
+        return false;
+    }
+    return parse (&data [0], data.size ());
+}
+
+//------------------------------------------------------------------------------
+
+Secp256k1::Signature::Signature ()
+    : m_valid (false)
+{
+}
+
+bool Secp256k1::Signature::parse (void const* data, std::size_t bytes)
+{
+    using namespace secp256k1;
+
+    m_valid = false;
+
+    uint8 const* const p (static_cast <uint8 const*> (data));
+
+    // 0x30 len 0x02 rlen r 0x02 slen s
+    if (bytes < 8 || bytes > 72)
+        return false;
+
+    if (p [0] != 0x30 || p [1] != bytes - 2)
+        return false;
+
+    if (p [2] != 0x02)
+        return false;
+
+    std::size_t const rBytes (p [3]);
+    if (rBytes == 0 || 4 + rBytes + 2 >= bytes)
+        return false;
+
+    if (p [4 + rBytes] != 0x02)
+        return false;
+
+    std::size_t const sBytes (p [5 + rBytes]);
+    if (6 + rBytes + sBytes != bytes)
+        return false;
+
+    Scalar r;
+    Scalar s;
+    if (! parseInteger (r, p + 4, rBytes) ||
+        ! parseInteger (s, p + 6 + rBytes, sBytes))
+        return false;
+
+    std::copy (r.n, r.n + 8, m_r);
+    std::copy (s.n, s.n + 8, m_s);
+    m_valid = true;
+    return true;
+}
+
+bool Secp256k1::Signature::parse (Blob const& data)
+{
+    if (data.empty ())
+    {
+        m_valid = false;
+        return false;
+    }
+    return parse (&data [0], data.size ());
+}
+
+//------------------------------------------------------------------------------
+
+bool Secp256k1::verify (uint256 const& hash,
+    Signature const& signature, PublicKey const& publicKey)
+{
+    using namespace secp256k1;
+
+    if (! signature.isValid () || ! publicKey.isValid ())
+        return false;
+
+    Scalar e;
+    Scalar r;
+    Scalar s;
+    hashToScalar (e, hash);
+    std::copy (signature.m_r, signature.m_r + 8, r.n);
+    std::copy (signature.m_s, signature.m_s + 8, s.n);
+
+    Scalar sInverse;
+    scalarInverse (sInverse, s);
+
+    AffinePoint table [1 << (maximumWindow - 2)];
+    AffinePoint lambdaTable [1 << (maximumWindow - 2)];
+    unpackPublicKeyTable (table, lambdaTable, publicKey.m_table);
+
+    return verifyWithInverse (*getGeneratorTables (),
+        e, r, sInverse, table, lambdaTable, publicKey.m_window);
+}
+
+bool Secp256k1::tryVerify (uint256 const& hash,
+    Blob const& signature, Blob const& publicKey, bool& valid)
+{
+    Signature sig;
+    PublicKey key;
+    if (! sig.parse (signature) || ! key.parse (publicKey))
+        return false;
+    valid = verify (hash, sig, key);
+    return true;
+}
+
+void Secp256k1::verifyBatch (Check* checks, std::size_t count)
+{
+    using namespace secp256k1;
+
+    // There is no sound way to combine ECDSA equations without the y
+    // coordinate of each R, so batching shares the work that can be
+    // shared: all of the s inverses are computed with a single inversion.
+
+    std::vector <std::size_t> usable;
+    usable.reserve (count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Check& c (checks [i]);
+        c.valid = false;
+        if (c.signature != nullptr && c.signature->isValid () &&
+            c.publicKey != nullptr && c.publicKey->isValid ())
+            usable.push_back (i);
+    }
+
+    if (usable.empty ())
+        return;
+
+    GeneratorTablesPtr const tables (getGeneratorTables ());
+
+    std::vector <Scalar> products (usable.size ());
+    for (std::size_t i = 0; i < usable.size (); ++i)
+    {
+        Scalar s;
+        uint32 const* const src (checks [usable [i]].signature->m_s);
+        std::copy (src, src + 8, s.n);
+        if (i == 0)
+            products [i] = s;
+        else
+            scalarMultiply (products [i], products [i - 1], s);
+    }
+
+    Scalar inverse;
+    scalarInverse (inverse, products.back ());
+
+    for (std::size_t i = usable.size (); i-- > 0;)
+    {
+        Check& c (checks [usable [i]]);
+
+        Scalar s;
+        std::copy (c.signature->m_s, c.signature->m_s + 8, s.n);
+
+        Scalar sInverse;
+        if (i > 0)
+        {
+            scalarMultiply (sInverse, inverse, products [i - 1]);
+            scalarMultiply (inverse, inverse, s);
+        }
+        else
+        {
+            sInverse = inverse;
+        }
+
+        Scalar e;
+        Scalar r;
+        hashToScalar (e, c.hash);
+        std::copy (c.signature->m_r, c.signature->m_r + 8, r.n);
+
+        AffinePoint table [1 << (maximumWindow - 2)];
+        AffinePoint lambdaTable [1 << (maximumWindow - 2)];
+        unpackPublicKeyTable (table, lambdaTable, c.publicKey->m_table);
+
+        c.valid = verifyWithInverse (*tables,
+            e, r, sInverse, table, lambdaTable, c.publicKey->m_window);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+class Secp256k1Tests : public UnitTest
+{
+public:
+    Secp256k1Tests () : UnitTest ("Secp256k1", "ripple")
+    {
+    }
+
+    static uint256 randomHash ()
+    {
+        uint256 hash;
+        RandomNumbers::getInstance ().fillBytes (hash.begin (), hash.size ());
+        return hash;
+    }
+
+    // Our answer must match OpenSSL whenever we accept the encoding
+    void expectSame (uint256 const& hash, Blob const& sig, CKey& key)
+    {
+        bool valid;
+        if (Secp256k1::tryVerify (hash, sig, key.GetPubKey (), valid))
+            expect (valid == key.Verify (hash, sig), "Disagrees with OpenSSL");
+    }
+
+    void testCrossCheck ()
+    {
+        beginTestCase ("cross check");
+
+        Random r;
+
+        for (int i = 0; i < 32; ++i)
+        {
+            CKey key;
+            key.MakeNewKey ();
+
+            uint256 const hash (randomHash ());
+            Blob sig;
+            expect (key.Sign (hash, sig));
+
+            bool valid (false);
+            expect (Secp256k1::tryVerify (hash, sig, key.GetPubKey (), valid),
+                "Should parse");
+            expect (valid, "Should verify");
+
+            uint256 otherHash (hash);
+            otherHash.begin () [r.nextInt (32)] ^= 1 << r.nextInt (8);
+            expectSame (otherHash, sig, key);
+
+            Blob otherSig (sig);
+            otherSig [r.nextInt (int (otherSig.size ()))] ^= 1 << r.nextInt (8);
+            expectSame (hash, otherSig, key);
+        }
+    }
+
+    void testEncoding ()
+    {
+        beginTestCase ("encoding");
+
+        Secp256k1::Signature sig;
+
+        uint8 const minimal [] = { 0x30, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01 };
+        expect (sig.parse (minimal, sizeof (minimal)));
+
+        uint8 const zero [] = { 0x30, 0x06, 0x02, 0x01, 0x00, 0x02, 0x01, 0x01 };
+        expect (! sig.parse (zero, sizeof (zero)), "Zero r accepted");
+
+        uint8 const negative [] = { 0x30, 0x06, 0x02, 0x01, 0x81, 0x02, 0x01, 0x01 };
+        expect (! sig.parse (negative, sizeof (negative)), "Negative r accepted");
+
+        uint8 const padded [] = { 0x30, 0x07, 0x02, 0x02, 0x00, 0x01, 0x02, 0x01, 0x01 };
+        expect (! sig.parse (padded, sizeof (padded)), "Padded r accepted");
+
+        uint8 const trailing [] = { 0x30, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01, 0x00 };
+        expect (! sig.parse (trailing, sizeof (trailing)), "Trailing byte accepted");
+
+        CKey key;
+        key.MakeNewKey ();
+        Blob publicKey (key.GetPubKey ());
+
+        Secp256k1::PublicKey parsed;
+        expect (parsed.parse (publicKey), "Compressed key rejected");
+
+        // Flip the parity of y, this is still a valid point
+        publicKey [0] ^= 1;
+        expect (parsed.parse (publicKey), "Negated key rejected");
+
+        publicKey [0] = 0x05;
+        expect (! parsed.parse (publicKey), "Bad prefix accepted");
+    }
+
+    void testBatch ()
+    {
+        beginTestCase ("batch");
+
+        int const count = 16;
+        std::vector <Secp256k1::Check> checks (count);
+        std::vector <Secp256k1::Signature> sigs (count);
+        std::vector <Secp256k1::PublicKey> keys (count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            CKey key;
+            key.MakeNewKey ();
+            keys [i].parse (key.GetPubKey ());
+
+            // Mix the default and the largest tables
+            if (i % 2 == 1)
+                keys [i].precompute (Secp256k1::maximumWindow);
+
+            Secp256k1::Check& c (checks [i]);
+            c.hash = randomHash ();
+            Blob sig;
+            key.Sign (c.hash, sig);
+            sigs [i].parse (sig);
+
+            // Every third entry is signed over a different hash
+            if (i % 3 == 0)
+                c.hash = randomHash ();
+
+            c.signature = &sigs [i];
+            c.publicKey = &keys [i];
+        }
+
+        Secp256k1::verifyBatch (&checks [0], checks.size ());
+
+        for (int i = 0; i < count; ++i)
+        {
+            expect (checks [i].valid == (i % 3 != 0), "Wrong batch result");
+            expect (checks [i].valid == Secp256k1::verify (
+                checks [i].hash, sigs [i], keys [i]));
+        }
+    }
+
+    void runTest ()
+    {
+        testCrossCheck ();
+        testEncoding ();
+        testBatch ();
+    }
+};
+
+static Secp256k1Tests secp256k1Tests;
+
+//------------------------------------------------------------------------------
+
+class Secp256k1TimingTests : public UnitTest
+{
+public:
+    enum
+    {
+        signatureCount = 500
+    };
+
+    Secp256k1TimingTests () : UnitTest ("Secp256k1Timing", "ripple", runManual)
+    {
+    }
+
+    void report (String const& name, double start)
+    {
+        double const elapsed = Time::getMillisecondCounterHiRes () - start;
+        logMessage (name + ": " + String (1000 * elapsed / signatureCount, 1) +
+            " microseconds per signature");
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("verify");
+
+        std::vector <uint256> hashes (signatureCount);
+        std::vector <Blob> sigs (signatureCount);
+        std::vector <Blob> publicKeys (signatureCount);
+
+        for (int i = 0; i < signatureCount; ++i)
+        {
+            CKey key;
+            key.MakeNewKey ();
+            publicKeys [i] = key.GetPubKey ();
+            RandomNumbers::getInstance ().fillBytes (
+                hashes [i].begin (), hashes [i].size ());
+            key.Sign (hashes [i], sigs [i]);
+        }
+
+        int failures = 0;
+
+        double start = Time::getMillisecondCounterHiRes ();
+        for (int i = 0; i < signatureCount; ++i)
+        {
+            CKey key;
+            if (! key.SetPubKey (publicKeys [i]) || ! key.Verify (hashes [i], sigs [i]))
+                ++failures;
+        }
+        report ("CKey", start);
+
+        start = Time::getMillisecondCounterHiRes ();
+        for (int i = 0; i < signatureCount; ++i)
+        {
+            bool valid (false);
+            if (! Secp256k1::tryVerify (hashes [i], sigs [i], publicKeys [i], valid) || ! valid)
+                ++failures;
+        }
+        report ("Secp256k1", start);
+
+        std::vector <Secp256k1::Check> checks (signatureCount);
+        std::vector <Secp256k1::Signature> parsedSigs (signatureCount);
+        std::vector <Secp256k1::PublicKey> parsedKeys (signatureCount);
+        for (int i = 0; i < signatureCount; ++i)
+        {
+            parsedSigs [i].parse (sigs [i]);
+            parsedKeys [i].parse (publicKeys [i]);
+            checks [i].hash = hashes [i];
+            checks [i].signature = &parsedSigs [i];
+            checks [i].publicKey = &parsedKeys [i];
+        }
+
+        start = Time::getMillisecondCounterHiRes ();
+        for (int i = 0; i < signatureCount; ++i)
+        {
+            if (! Secp256k1::verify (hashes [i], parsedSigs [i], parsedKeys [i]))
+                ++failures;
+        }
+        report ("Secp256k1, parsed key", start);
+
+        start = Time::getMillisecondCounterHiRes ();
+        Secp256k1::verifyBatch (&checks [0], checks.size ());
+        report ("Secp256k1, parsed key, batch", start);
+
+        for (int i = 0; i < signatureCount; ++i)
+        {
+            if (! checks [i].valid)
+                ++failures;
+        }
+
+        expect (failures == 0, "Verification failed");
+    }
+};
+
+static Secp256k1TimingTests secp256k1TimingTests;
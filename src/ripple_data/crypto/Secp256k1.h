@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SECP256K1_H_INCLUDED
+#define RIPPLE_SECP256K1_H_INCLUDED
+
+/** ECDSA signature verification on the secp256k1 curve.
+
+    This is a self contained replacement for the OpenSSL EC_KEY verify path
+    used by CKey. It accepts exactly the same DER signatures and encoded
+    public keys, but is considerably faster:
+
+    - Multiples of the generator come from precomputed tables built once.
+    - Public key multiplication is split in half with the curve endomorphism
+      (GLV), and all four partial products share one chain of doublings.
+    - A parsed PublicKey keeps its own table, so callers that see the same
+      key repeatedly can parse it once and reuse it.
+    - verifyBatch shares the scalar inversions across many signatures.
+
+    Only verification is provided; signing remains on CKey. This code is
+    not constant time and must never be used with secret data.
+
+    Signatures which are not strict DER are rejected by Signature::parse.
+    Callers that need to accept everything OpenSSL accepts should fall back
+    to CKey when parsing fails.
+*/
+class Secp256k1
+{
+public:
+    enum
+    {
+        /** Window used for public keys unless precompute is called. */
+        defaultWindow = 5,
+
+        /** Largest window accepted by PublicKey::precompute. */
+        maximumWindow = 8
+    };
+
+    //--------------------------------------------------------------------------
+
+    /** A parsed public key, with the tables needed to verify against it. */
+    class PublicKey
+    {
+    public:
+        PublicKey ();
+
+        /** Parse a compressed, uncompressed or hybrid encoded key.
+            @return `true` if the key is a valid point on the curve.
+        */
+        bool parse (void const* data, std::size_t bytes);
+        bool parse (Blob const& data);
+
+        /** Rebuild the tables for a different window size.
+            A window of w stores 2^(w-2) multiples of the key. Larger windows
+            cost memory and setup time but save additions on every verify,
+            which pays off for keys that sign often.
+        */
+        void precompute (int window);
+
+        int getWindow () const
+        {
+            return m_window;
+        }
+
+        bool isValid () const
+        {
+            return m_valid;
+        }
+
+    private:
+        friend class Secp256k1;
+
+        bool m_valid;
+        int m_window;
+
+        // For each odd multiple P, 3P, 5P ... the affine x and y, followed by
+        // x under the endomorphism, all as little endian limbs.
+        std::vector <uint32> m_table;
+    };
+
+    //--------------------------------------------------------------------------
+
+    /** A parsed DER signature. */
+    class Signature
+    {
+    public:
+        Signature ();
+
+        /** Parse a strictly encoded DER signature.
+            @return `true` if the encoding is canonical and 0 < r, s < n.
+        */
+        bool parse (void const* data, std::size_t bytes);
+        bool parse (Blob const& data);
+
+        bool isValid () const
+        {
+            return m_valid;
+        }
+
+    private:
+        friend class Secp256k1;
+
+        bool m_valid;
+        uint32 m_r [8];
+        uint32 m_s [8];
+    };
+
+    //--------------------------------------------------------------------------
+
+    /** One entry in a call to verifyBatch. */
+    struct Check
+    {
+        Check ()
+            : signature (nullptr)
+            , publicKey (nullptr)
+            , valid (false)
+        {
+        }
+
+        uint256 hash;
+        Signature const* signature;
+        PublicKey const* publicKey;
+        bool valid;
+    };
+
+    /** Verify a signature of a 256-bit hash.
+        The hash is interpreted as big endian bytes, like ECDSA_verify.
+    */
+    static bool verify (uint256 const& hash,
+        Signature const& signature, PublicKey const& publicKey);
+
+    /** Parse and verify in one step.
+        @param valid Receives the result if both inputs were parsed.
+        @return `false` if either input could not be parsed, in which case
+                the caller should fall back to CKey.
+    */
+    static bool tryVerify (uint256 const& hash,
+        Blob const& signature, Blob const& publicKey, bool& valid);
+
+    /** Verify many signatures at once.
+        Sets the valid field in each Check. Entries with missing or
+        unparsed inputs are marked invalid.
+    */
+    static void verifyBatch (Check* checks, std::size_t count);
+};
+
+#endif
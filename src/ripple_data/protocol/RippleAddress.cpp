@@ -163,6 +163,15 @@ void RippleAddress::setNodePublic (Blob const& vPublic)
 
 bool RippleAddress::verifyNodePublic (uint256 const& hash, Blob const& vchSig) const
 {
+#if RIPPLE_USE_SECP256K1_VERIFY
+    {
+        // Strict DER goes to the fast verifier, anything else to OpenSSL.
+        bool bVerified;
+        if (Secp256k1::tryVerify (hash, vchSig, getNodePublic (), bVerified))
+            return bVerified;
+    }
+#endif
+
     CKey    pubkey  = CKey ();
     bool    bVerified;
 
@@ -444,6 +453,15 @@ void RippleAddress::setAccountPublic (const RippleAddress& generator, int seq)
 
 bool RippleAddress::accountPublicVerify (uint256 const& uHash, Blob const& vucSig) const
 {
+#if RIPPLE_USE_SECP256K1_VERIFY
+    {
+        // Strict DER goes to the fast verifier, anything else to OpenSSL.
+        bool bVerified;
+        if (Secp256k1::tryVerify (uHash, vucSig, getAccountPublic (), bVerified))
+            return bVerified;
+    }
+#endif
+
     CKey        ckPublic;
     bool        bVerified;
 
@@ -66,6 +66,7 @@ namespace ripple
 #include "crypto/CKeyECIES.cpp"
 #include "crypto/Base58Data.cpp"
 #include "crypto/RFC1751.cpp"
+#include "crypto/Secp256k1.cpp"
 
 #include "protocol/BuildInfo.cpp"
 #include "protocol/FieldNames.cpp"
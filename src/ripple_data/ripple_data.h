@@ -30,6 +30,7 @@ namespace ripple {
 
 #include "crypto/Base58Data.h"
 #include "crypto/RFC1751.h"
+#include "crypto/Secp256k1.h"
 
 #include "protocol/BuildInfo.h"
 #include "protocol/FieldNames.h"
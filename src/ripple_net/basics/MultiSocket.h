@@ -110,6 +110,13 @@ public:
     /** Returns a pointer to the SSL handle or nullptr if no SSL. */
     virtual SSL* ssl_handle () = 0;
 
+    /** Offer a previously negotiated session for resumption.
+        The session is in the DER form written by i2d_SSL_SESSION. It is
+        presented by the next client handshake, servers ignore it. If the
+        other end no longer knows the session a full handshake takes place.
+    */
+    virtual void set_ssl_session (std::string const& session) = 0;
+
     static MultiSocket* New (
         boost::asio::io_service& io_service,
             boost::asio::ssl::context& ssl_context,
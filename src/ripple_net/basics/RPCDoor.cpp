@@ -22,8 +22,10 @@ SETUP_LOG (RPCDoor)
 class RPCDoorImp : public RPCDoor, public LeakChecked <RPCDoorImp>
 {
 public:
-    RPCDoorImp (boost::asio::io_service& io_service, RPCServer::Handler& handler)
+    RPCDoorImp (boost::asio::io_service& io_service,
+        ServiceSelector const& selectService, RPCServer::Handler& handler)
         : m_rpcServerHandler (handler)
+        , m_selectService (selectService)
         , mAcceptor (io_service,
                      boost::asio::ip::tcp::endpoint (boost::asio::ip::address::from_string (getConfig ().getRpcIP ()), getConfig ().getRpcPort ()))
         , mDelayTimer (io_service)
@@ -53,8 +55,11 @@ public:
     void startListening ()
     {
         // VFALCO NOTE Why not use make_shared?
+        boost::asio::io_service& io_service (m_selectService ?
+            m_selectService () : mAcceptor.get_io_service ());
+
         RPCServerImp::pointer new_connection (boost::make_shared <RPCServerImp> (
-            boost::ref (mAcceptor.get_io_service ()),
+            boost::ref (io_service),
                 boost::ref (m_sslContext->get ()),
                     boost::ref (m_rpcServerHandler)));
 
@@ -129,6 +134,7 @@ public:
 
 private:
     RPCServer::Handler& m_rpcServerHandler;
+    ServiceSelector                     m_selectService;
     boost::asio::ip::tcp::acceptor      mAcceptor;
     boost::asio::deadline_timer         mDelayTimer;
     ScopedPointer <RippleSSLContext>    m_sslContext;
@@ -138,7 +144,15 @@ private:
 
 RPCDoor* RPCDoor::New (boost::asio::io_service& io_service, RPCServer::Handler& handler)
 {
-    ScopedPointer <RPCDoor> result (new RPCDoorImp (io_service, handler));
+    ScopedPointer <RPCDoor> result (new RPCDoorImp (io_service, ServiceSelector (), handler));
+
+    return result.release ();
+}
+
+RPCDoor* RPCDoor::New (boost::asio::io_service& io_service,
+    ServiceSelector const& selectService, RPCServer::Handler& handler)
+{
+    ScopedPointer <RPCDoor> result (new RPCDoorImp (io_service, selectService, handler));
 
     return result.release ();
 }
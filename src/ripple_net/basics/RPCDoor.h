@@ -25,8 +25,17 @@
 class RPCDoor
 {
 public:
+    /** Returns the io_service which should own the next accepted connection. */
+    typedef FUNCTION_TYPE <boost::asio::io_service& ()> ServiceSelector;
+
     static RPCDoor* New (boost::asio::io_service& io_service, RPCServer::Handler& handler);
 
+    /** Create a door which spreads its connections over several io_service.
+        The listening socket itself belongs to `io_service`.
+    */
+    static RPCDoor* New (boost::asio::io_service& io_service,
+        ServiceSelector const& selectService, RPCServer::Handler& handler);
+
     virtual ~RPCDoor () { }
 };
 
@@ -47,6 +47,13 @@ public:
             @return         The server's response.
         */
         virtual std::string processRequest (std::string const& request, std::string const& remoteAddress) = 0;
+
+        /** Produce the response to a GET of /metrics.
+
+            @param  remoteAddress The address of the client.
+            @return         The complete HTTP response.
+        */
+        virtual std::string processMetrics (std::string const& remoteAddress) = 0;
     };
 
     virtual ~RPCServer () { }
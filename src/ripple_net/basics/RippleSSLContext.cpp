@@ -20,6 +20,15 @@
 class RippleSSLContextImp : public RippleSSLContext
 {
 private:
+    enum
+    {
+        // Sessions remembered by the server for resumption
+        sessionCacheSize = 16384,
+
+        // How long a session or ticket may be resumed
+        sessionTimeoutSeconds = 60 * 60
+    };
+
     boost::asio::ssl::context m_context;
 
 public:
@@ -86,6 +95,28 @@ public:
         SSL_CTX_set_tmp_dh_callback (
             m_context.native_handle (),
             tmp_dh_handler);
+
+        initSessionCache ();
+    }
+
+    // Lets clients which reconnect resume their previous session instead
+    // of repeating the key exchange. The server keeps recent sessions by
+    // ID, and also issues session tickets so that clients can resume
+    // without any server state. The ticket keys are generated randomly
+    // by OpenSSL for each context, so tickets do not outlive the process.
+    //
+    void initSessionCache ()
+    {
+        SSL_CTX* const ctx = m_context.native_handle ();
+
+        static unsigned char const sessionContext [] = "rippled";
+
+        SSL_CTX_set_session_cache_mode (ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size (ctx, sessionCacheSize);
+        SSL_CTX_set_timeout (ctx, sessionTimeoutSeconds);
+        SSL_CTX_set_session_id_context (ctx,
+            sessionContext, sizeof (sessionContext) - 1);
+        SSL_CTX_clear_options (ctx, SSL_OP_NO_TICKET);
     }
 
     //--------------------------------------------------------------------------
@@ -26,6 +26,9 @@
     parameters are predefined and verified to be secure. The context is set to
     sslv23, Transport Layer Security / General. This is primarily used for peer to peer servers that don't care
     about certificates or identity verification.
+
+    Apart from the bare context, servers keep a session cache and issue
+    session tickets so that reconnecting clients can resume a session.
 */
 class RippleSSLContext : public SSLContext
 {
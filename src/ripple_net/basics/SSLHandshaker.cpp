@@ -0,0 +1,417 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+class SSLHandshakerImp
+    : public SSLHandshaker
+    , public LeakChecked <SSLHandshakerImp>
+{
+public:
+    typedef RippleMutex LockType;
+    typedef LockType::ScopedLockType ScopedLockType;
+    typedef boost::system::error_code error_code;
+    typedef boost::asio::ip::tcp::socket NativeSocketType;
+
+    enum
+    {
+        // An offloaded handshake is abandoned after this long
+        timeoutSeconds = 15,
+
+        // Outbound sessions remembered for resumption
+        maxClientSessions = 1024,
+
+        // Handshakes in each sample of the resumption rate
+        resumptionSampleSize = 100
+    };
+
+    //--------------------------------------------------------------------------
+
+    // A handshake in progress
+    //
+    class Op : public LeakChecked <Op>
+    {
+    public:
+        typedef boost::shared_ptr <Op> Ptr;
+
+        Op (MultiSocket& socket_, Socket::handshake_type type_,
+            IPAddress const& remoteAddress_, HandlerType const& handler_)
+            : socket (socket_)
+            , type (type_)
+            , remoteAddress (remoteAddress_)
+            , handler (handler_)
+            , strand (socket_.get_io_service ())
+            , timer (socket_.get_io_service ())
+            , start (Time::getMillisecondCounterHiRes ())
+            , finished (false)
+            , timedOut (false)
+        {
+        }
+
+        // Closes the TCP socket, which makes a blocked handshake return
+        //
+        void abandon ()
+        {
+            CriticalSection::ScopedLockType lock (mutex);
+
+            if (! finished)
+            {
+                error_code ec;
+                timedOut = true;
+                socket.next_layer <NativeSocketType> ().shutdown (
+                    boost::asio::socket_base::shutdown_both, ec);
+            }
+        }
+
+        // Returns `true` if the handshake was abandoned first
+        //
+        bool finish ()
+        {
+            CriticalSection::ScopedLockType lock (mutex);
+            finished = true;
+            return timedOut;
+        }
+
+        static void onTimer (Ptr op, error_code const& ec)
+        {
+            if (ec != boost::asio::error::operation_aborted)
+                op->abandon ();
+        }
+
+        static void cancelTimer (Ptr op)
+        {
+            error_code ec;
+            op->timer.cancel (ec);
+        }
+
+        MultiSocket& socket;
+        Socket::handshake_type const type;
+        IPAddress const remoteAddress;
+        HandlerType handler;
+
+        // The timer belongs to the socket's io_service, and is
+        // only touched through the strand.
+        boost::asio::io_service::strand strand;
+        boost::asio::deadline_timer timer;
+
+        double const start;
+
+        CriticalSection mutex;
+        bool finished;
+        bool timedOut;
+    };
+
+    //--------------------------------------------------------------------------
+
+    class Worker : public Thread
+    {
+    public:
+        explicit Worker (SSLHandshakerImp& owner)
+            : Thread ("SSLHandshake")
+            , m_owner (owner)
+        {
+            startThread ();
+        }
+
+        ~Worker ()
+        {
+            stopThread ();
+        }
+
+        void run ()
+        {
+            m_owner.m_service.run ();
+            m_owner.onThreadExit ();
+        }
+
+    private:
+        SSLHandshakerImp& m_owner;
+    };
+
+    //--------------------------------------------------------------------------
+
+    SSLHandshakerImp (Stoppable& parent, int threads,
+        shared_ptr <insight::Collector> const& collector, Journal journal)
+        : SSLHandshaker (parent)
+        , m_journal (journal)
+        , m_lock (this, "SSLHandshaker", __FILE__, __LINE__)
+        , m_work (new boost::asio::io_service::work (m_service))
+        , m_sampleCount (0)
+        , m_sampleResumed (0)
+    {
+        m_handshakes = collector->make_meter ("ssl_handshakes");
+        m_resumed = collector->make_meter ("ssl_handshakes_resumed");
+        m_failed = collector->make_meter ("ssl_handshakes_failed");
+        m_resumptionRate = collector->make_gauge ("ssl_resumption_percent");
+        m_latency = collector->make_event ("ssl_handshake_latency");
+
+        for (int i = 0; i < threads; ++i)
+        {
+            ++m_threadsRunning;
+            m_workers.add (new Worker (*this));
+        }
+    }
+
+    ~SSLHandshakerImp ()
+    {
+        m_workers.clear ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void async_handshake (MultiSocket& socket,
+        Socket::handshake_type type, IPAddress const& remoteAddress,
+            HandlerType const& handler)
+    {
+        Op::Ptr op (boost::make_shared <Op> (
+            boost::ref (socket), type, remoteAddress, handler));
+
+        if (type == Socket::client)
+        {
+            std::string session;
+
+            if (getSession (remoteAddress, session))
+                socket.set_ssl_session (session);
+        }
+
+        if (m_workers.isEmpty ())
+        {
+            socket.async_handshake (type, boost::bind (
+                &SSLHandshakerImp::onHandshake, this, op,
+                    boost::asio::placeholders::error));
+        }
+        else
+        {
+            error_code ec;
+            op->timer.expires_from_now (
+                boost::posix_time::seconds (timeoutSeconds), ec);
+            op->timer.async_wait (op->strand.wrap (boost::bind (
+                &Op::onTimer, op, boost::asio::placeholders::error)));
+
+            m_service.post (boost::bind (
+                &SSLHandshakerImp::runHandshake, this, op));
+        }
+    }
+
+    // Runs on a handshake thread
+    //
+    void runHandshake (Op::Ptr op)
+    {
+        error_code ec;
+
+        if (isStopping ())
+        {
+            ec = boost::asio::error::operation_aborted;
+        }
+        else
+        {
+            {
+                ScopedLockType sl (m_lock, __FILE__, __LINE__);
+                m_active.insert (op);
+            }
+
+            op->socket.handshake (op->type, ec);
+
+            {
+                ScopedLockType sl (m_lock, __FILE__, __LINE__);
+                m_active.erase (op);
+            }
+        }
+
+        if (op->finish () && ! ec)
+            ec = boost::asio::error::timed_out;
+
+        op->strand.post (boost::bind (&Op::cancelTimer, op));
+
+        onHandshake (op, ec);
+    }
+
+    void onHandshake (Op::Ptr op, error_code const& ec)
+    {
+        double const elapsed = Time::getMillisecondCounterHiRes () - op->start;
+
+        if (ec)
+        {
+            ++m_failed;
+
+            if (ec != boost::asio::error::operation_aborted)
+                m_journal.debug << "Handshake with " << op->remoteAddress <<
+                    " failed after " << elapsed << "ms: " << ec.message ();
+        }
+        else
+        {
+            SSL* const ssl (op->socket.ssl_handle ());
+            bool const resumed (ssl != nullptr && SSL_session_reused (ssl));
+
+            ++m_handshakes;
+            if (resumed)
+                ++m_resumed;
+
+            m_latency.notify (static_cast <insight::Event::value_type> (elapsed));
+
+            ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+            ++m_sampleCount;
+            if (resumed)
+                ++m_sampleResumed;
+
+            if (m_sampleCount >= resumptionSampleSize)
+            {
+                m_resumptionRate = (100 * m_sampleResumed) / m_sampleCount;
+                m_sampleCount = 0;
+                m_sampleResumed = 0;
+            }
+
+            if (op->type == Socket::client && ssl != nullptr)
+                saveSession (op->remoteAddress, ssl);
+        }
+
+        op->handler (ec);
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool getSession (IPAddress const& address, std::string& session)
+    {
+        if (address.empty ())
+            return false;
+
+        ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+        Sessions::iterator const iter (m_sessions.find (address));
+
+        if (iter == m_sessions.end ())
+            return false;
+
+        session = iter->second;
+        return true;
+    }
+
+    // Called with the lock held
+    //
+    void saveSession (IPAddress const& address, SSL* ssl)
+    {
+        if (address.empty ())
+            return;
+
+        SSL_SESSION* const sslSession (SSL_get1_session (ssl));
+
+        if (sslSession == nullptr)
+            return;
+
+        std::string session;
+        int const size (i2d_SSL_SESSION (sslSession, nullptr));
+
+        if (size > 0)
+        {
+            session.resize (size);
+            unsigned char* p (reinterpret_cast <unsigned char*> (&session [0]));
+            i2d_SSL_SESSION (sslSession, &p);
+        }
+
+        SSL_SESSION_free (sslSession);
+
+        if (session.empty ())
+            return;
+
+        std::pair <Sessions::iterator, bool> const result (
+            m_sessions.insert (std::make_pair (address, session)));
+
+        if (result.second)
+        {
+            m_sessionOrder.push_back (address);
+
+            if (m_sessionOrder.size () > maxClientSessions)
+            {
+                m_sessions.erase (m_sessionOrder.front ());
+                m_sessionOrder.pop_front ();
+            }
+        }
+        else
+        {
+            result.first->second = session;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void onStop ()
+    {
+        if (m_workers.isEmpty ())
+        {
+            stopped ();
+            return;
+        }
+
+        {
+            ScopedLockType sl (m_lock, __FILE__, __LINE__);
+
+            for (Active::iterator iter (m_active.begin ());
+                iter != m_active.end (); ++iter)
+                (*iter)->abandon ();
+        }
+
+        // Queued handshakes are failed as the threads drain the queue
+        m_work = nullptr;
+    }
+
+    void onThreadExit ()
+    {
+        bassert (isStopping ());
+
+        if (--m_threadsRunning == 0)
+            stopped ();
+    }
+
+private:
+    typedef std::set <Op::Ptr> Active;
+    typedef std::map <IPAddress, std::string> Sessions;
+
+    Journal m_journal;
+    LockType m_lock;
+
+    boost::asio::io_service m_service;
+    ScopedPointer <boost::asio::io_service::work> m_work;
+    OwnedArray <Worker> m_workers;
+    Atomic <int> m_threadsRunning;
+
+    Active m_active;
+    Sessions m_sessions;
+    std::deque <IPAddress> m_sessionOrder;
+
+    int m_sampleCount;
+    int m_sampleResumed;
+
+    insight::Meter m_handshakes;
+    insight::Meter m_resumed;
+    insight::Meter m_failed;
+    insight::Gauge m_resumptionRate;
+    insight::Event m_latency;
+};
+
+//------------------------------------------------------------------------------
+
+SSLHandshaker::SSLHandshaker (Stoppable& parent)
+    : Stoppable ("SSLHandshaker", parent)
+{
+}
+
+SSLHandshaker* SSLHandshaker::New (Stoppable& parent, int threads,
+    shared_ptr <insight::Collector> const& collector, Journal journal)
+{
+    return new SSLHandshakerImp (parent, threads, collector, journal);
+}
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NET_BASICS_SSLHANDSHAKER_H_INCLUDED
+#define RIPPLE_NET_BASICS_SSLHANDSHAKER_H_INCLUDED
+
+/** Performs the SSL handshakes of peer connections.
+
+    Every handshake is timed, and the outcome and whether the session was
+    resumed are reported to the collector. Outbound connections offer the
+    session last negotiated with the same address, so that reconnecting to
+    a known peer can skip the key exchange.
+
+    With no threads the handshake runs asynchronously on the socket's
+    io_service as before. With one or more threads each handshake instead
+    runs synchronously on a small pool of dedicated threads, so that a
+    burst of key exchanges does not hold up message processing. Offloaded
+    handshakes which take too long are abandoned by closing the socket.
+*/
+class SSLHandshaker : public Stoppable
+{
+protected:
+    explicit SSLHandshaker (Stoppable& parent);
+
+public:
+    typedef FUNCTION_TYPE <void (boost::system::error_code const&)> HandlerType;
+
+    /** Create the handshaker.
+
+        @param threads The number of handshake threads, or zero to run
+                       handshakes on the io_service of each socket.
+        @param collector Receives the handshake counts and latencies.
+    */
+    static SSLHandshaker* New (Stoppable& parent, int threads,
+        shared_ptr <insight::Collector> const& collector, Journal journal);
+
+    virtual ~SSLHandshaker () { }
+
+    /** Perform the handshake on a connected socket.
+
+        The handler is called exactly once, from any thread. Callers
+        should wrap it in the strand of the connection. While the handshake
+        is in progress the caller must not use the socket, apart from
+        shutting down the underlying TCP socket to abandon the handshake.
+
+        @param remoteAddress The address used to find a session to resume.
+                             This is only used for client handshakes.
+    */
+    virtual void async_handshake (MultiSocket& socket,
+        Socket::handshake_type type, IPAddress const& remoteAddress,
+            HandlerType const& handler) = 0;
+};
+
+#endif
@@ -51,6 +51,7 @@ private:
     bool m_proxyInfoSet;
     SSL* m_native_ssl_handle;
     Flag m_origFlags;
+    std::string m_ssl_session;
 
 protected:
     typedef boost::system::error_code error_code;
@@ -129,6 +130,11 @@ protected:
         return m_native_ssl_handle;
     }
 
+    void set_ssl_session (std::string const& session)
+    {
+        m_ssl_session = session;
+    }
+
     //--------------------------------------------------------------------------
     //
     // MultiSocketType
@@ -621,6 +627,21 @@ protected:
             (ssl_stream);
         m_ssl_stream->set_verify_mode (m_verify_mode);
         m_native_ssl_handle = ssl_stream.native_handle ();
+
+        if (is_client () && ! m_ssl_session.empty ())
+        {
+            unsigned char const* p (reinterpret_cast <unsigned char const*> (
+                m_ssl_session.data ()));
+            SSL_SESSION* const session (d2i_SSL_SESSION (
+                nullptr, &p, m_ssl_session.size ()));
+
+            // SSL_set_session takes its own reference
+            if (session != nullptr)
+            {
+                SSL_set_session (m_native_ssl_handle, session);
+                SSL_SESSION_free (session);
+            }
+        }
     }
 
     //--------------------------------------------------------------------------
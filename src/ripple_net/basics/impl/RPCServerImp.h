@@ -100,7 +100,22 @@ public:
         {
             HTTPRequest::Action action = mHTTPRequest.consume (mLineBuffer);
 
-            if (action == HTTPRequest::haDO_REQUEST)
+            if (action == HTTPRequest::haDO_REQUEST && isMetricsRequest ())
+            {
+                if (! m_handler.isAuthorized (mHTTPRequest.peekHeaders ()))
+                    mReplyStr = m_handler.createResponse (403, "Forbidden");
+                else
+                    mReplyStr = handleMetrics ();
+
+                boost::asio::async_write (
+                    mSocket,
+                    boost::asio::buffer (mReplyStr),
+                    mStrand.wrap (boost::bind (
+                        &RPCServerImp::handle_write,
+                        boost::static_pointer_cast <RPCServerImp> (shared_from_this ()),
+                        boost::asio::placeholders::error)));
+            }
+            else if (action == HTTPRequest::haDO_REQUEST)
             {
                 // request with no body
                 WriteLog (lsWARNING, RPCServer) << "RPC HTTP request with no body";
@@ -237,6 +252,34 @@ public:
         return m_handler.processRequest (request, remoteAddress);
     }
 
+    // A GET of /metrics has no body, unlike a JSON-RPC request
+    //
+    bool isMetricsRequest ()
+    {
+        std::vector <std::string> parts;
+        boost::split (parts, mHTTPRequest.peekRequest (), boost::is_any_of (" "));
+
+        return parts.size () >= 2 && parts [0] == "GET" &&
+            parts [1].substr (0, parts [1].find ('?')) == "/metrics";
+    }
+
+    std::string handleMetrics ()
+    {
+        std::string remoteAddress;
+
+        try
+        {
+            remoteAddress = mSocket.PlainSocket ().remote_endpoint ().address ().to_string ();
+        }
+        catch (...)
+        {
+            // endpoint already disconnected
+            return "";
+        }
+
+        return m_handler.processMetrics (remoteAddress);
+    }
+
     //--------------------------------------------------------------------------
 
     AutoSocket& getSocket ()
@@ -52,6 +52,7 @@ namespace ripple
 #include "basics/MultiSocket.cpp"
 
 #include "basics/RippleSSLContext.cpp"
+#include "basics/SSLHandshaker.cpp"
 
 # include "basics/impl/RPCServerImp.h"
 #include "basics/RPCDoor.cpp"
@@ -62,5 +63,6 @@ namespace ripple
 #include "rpc/RPCSub.cpp"
 #include "rpc/RPCUtil.cpp"
 #include "rpc/InfoSub.cpp"
+#include "rpc/EventPayload.cpp"
 
 }
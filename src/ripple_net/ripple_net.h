@@ -36,6 +36,7 @@ namespace ripple {
 
 #include "basics/RippleSSLContext.h"
 #include "basics/MultiSocket.h"
+#include "basics/SSLHandshaker.h"
 #include "basics/HTTPRequest.h"
 #include "basics/HTTPClient.h"
 #include "basics/RPCServer.h"
@@ -45,6 +46,7 @@ namespace ripple {
 # include "rpc/RPCErr.h"
 # include "rpc/RPCUtil.h"
 #include "rpc/RPCCall.h"
+# include "rpc/EventPayload.h"
 # include "rpc/InfoSub.h"
 #include "rpc/RPCSub.h"
 
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+EventPayload::EventPayload (Json::Value& jvObj)
+{
+    m_json.swap (jvObj);
+
+    Json::FastWriter w;
+    m_text = w.write (m_json);
+}
+
+EventPayload::pointer EventPayload::New (Json::Value& jvObj)
+{
+    return pointer (new EventPayload (jvObj));
+}
+
+EventPayload::pointer EventPayload::New (Json::Value const& jvObj)
+{
+    Json::Value jvCopy (jvObj);
+
+    return pointer (new EventPayload (jvCopy));
+}
+
+std::string EventPayload::getTextWith (std::string const& name, uint32 value) const
+{
+    std::string::size_type const last = m_text.rfind ('}');
+
+    if (!m_json.isObject () || (last == std::string::npos))
+    {
+        Json::Value jvObj (m_json);
+        jvObj[name] = value;
+
+        Json::FastWriter w;
+        return w.write (jvObj);
+    }
+
+    std::string const field ("\"" + name + "\":" + lexicalCastThrow <std::string> (value));
+
+    std::string text;
+    text.reserve (m_text.size () + field.size () + 1);
+    text.append (m_text, 0, last);
+
+    if (m_json.size () != 0)
+        text.push_back (',');
+
+    text.append (field);
+    text.append (m_text, last, std::string::npos);
+
+    return text;
+}
+
+//------------------------------------------------------------------------------
+
+class EventPayloadTests : public UnitTest
+{
+public:
+    EventPayloadTests () : UnitTest ("EventPayload", "ripple")
+    {
+    }
+
+    void runTest ()
+    {
+        beginTestCase ("render");
+
+        Json::Value jvObj (Json::objectValue);
+        jvObj["type"] = "ledgerClosed";
+        jvObj["ledger_index"] = 42;
+
+        EventPayload::pointer const payload (EventPayload::New (jvObj));
+
+        expect (jvObj.isNull (), "source should be moved");
+        expect (payload->getJson ()["ledger_index"].asUInt () == 42);
+
+        Json::FastWriter w;
+        expect (payload->getText () == w.write (payload->getJson ()));
+
+        beginTestCase ("splice");
+
+        Json::Value jvParsed;
+        Json::Reader reader;
+
+        expect (reader.parse (payload->getTextWith ("seq", 7), jvParsed));
+        expect (jvParsed["seq"].asUInt () == 7);
+        expect (jvParsed["type"].asString () == "ledgerClosed");
+
+        Json::Value jvEmpty (Json::objectValue);
+        EventPayload::pointer const empty (EventPayload::New (jvEmpty));
+
+        expect (reader.parse (empty->getTextWith ("seq", 1), jvParsed));
+        expect (jvParsed.size () == 1 && jvParsed["seq"].asUInt () == 1);
+    }
+};
+
+static EventPayloadTests eventPayloadTests;
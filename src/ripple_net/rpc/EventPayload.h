@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NET_RPC_EVENTPAYLOAD_H_INCLUDED
+#define RIPPLE_NET_RPC_EVENTPAYLOAD_H_INCLUDED
+
+/** An immutable, rendered subscription event.
+
+    A publisher builds the JSON for an event once, wraps it in a payload,
+    and hands the same reference counted object to every subscriber. The
+    text form is produced exactly once, when the payload is created, so
+    fanning an event out to many clients costs no further serialization
+    or string copies.
+*/
+class EventPayload
+    : public CountedObject <EventPayload>
+    , public Uncopyable
+{
+public:
+    static char const* getCountedObjectName () { return "EventPayload"; }
+
+    typedef boost::shared_ptr <EventPayload const> pointer;
+    typedef pointer const& ref;
+
+    /** Create a payload from an event.
+        The contents of jvObj are moved into the payload and jvObj
+        is left null.
+    */
+    static pointer New (Json::Value& jvObj);
+
+    /** Create a payload from a copy of an event. */
+    static pointer New (Json::Value const& jvObj);
+
+    /** The event as a JSON object. */
+    Json::Value const& getJson () const
+    {
+        return m_json;
+    }
+
+    /** The event rendered with Json::FastWriter. */
+    std::string const& getText () const
+    {
+        return m_text;
+    }
+
+    /** Render the event with an extra unsigned field appended.
+        This splices the field into the shared rendering, which is much
+        cheaper than re-serializing the event for a single subscriber.
+    */
+    std::string getTextWith (std::string const& name, uint32 value) const;
+
+private:
+    explicit EventPayload (Json::Value& jvObj);
+
+    Json::Value m_json;
+    std::string m_text;
+};
+
+#endif
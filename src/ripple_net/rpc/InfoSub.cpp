@@ -41,6 +41,7 @@ InfoSub::InfoSub (Source& source, Consumer consumer)
     : mLock (this, "InfoSub", __FILE__, __LINE__)
     , m_consumer (consumer)
     , m_source (source)
+    , mBinary (0)
 {
     static Atomic <int> s_seq_id;
     mSeq = ++s_seq_id;
@@ -61,9 +62,9 @@ Resource::Consumer& InfoSub::getConsumer()
     return m_consumer;
 }
 
-void InfoSub::send (const Json::Value& jvObj, const std::string& sObj, bool broadcast)
+void InfoSub::send (EventPayload::ref payload, bool broadcast)
 {
-    send (jvObj, broadcast);
+    send (payload->getJson (), broadcast);
 }
 
 uint64 InfoSub::getSeq ()
@@ -71,6 +72,16 @@ uint64 InfoSub::getSeq ()
     return mSeq;
 }
 
+bool InfoSub::isBinary () const
+{
+    return mBinary.get () != 0;
+}
+
+void InfoSub::setBinary (bool binary)
+{
+    mBinary.set (binary ? 1 : 0);
+}
+
 void InfoSub::onSendEmpty ()
 {
 }
@@ -105,11 +105,18 @@ public:
 
     virtual void send (const Json::Value & jvObj, bool broadcast) = 0;
 
-    // VFALCO NOTE Why is this virtual?
-    virtual void send (const Json::Value & jvObj, const std::string & sObj, bool broadcast);
+    /** Send an event that is shared with other subscribers.
+        The default implementation forwards the JSON to send() above.
+    */
+    virtual void send (EventPayload::ref payload, bool broadcast);
 
     uint64 getSeq ();
 
+    /** Whether transaction events carry serialized blobs instead of JSON. */
+    bool isBinary () const;
+
+    void setBinary (bool binary);
+
     void onSendEmpty ();
 
     void insertSubAccountInfo (RippleAddress addr, uint32 uLedgerIndex);
@@ -133,6 +140,9 @@ private:
     boost::shared_ptr <PathRequest>             mPathRequest;
 
     uint64                                      mSeq;
+
+    // Set by the client's thread, read when publishing
+    Atomic <int>                                mBinary;
 };
 
 #endif
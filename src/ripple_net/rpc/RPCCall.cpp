@@ -110,6 +110,19 @@ private:
         return v;
     }
 
+    // export_snapshot <path> [<ledger>]
+    Json::Value parseExportSnapshot (const Json::Value& jvParams)
+    {
+        Json::Value     jvRequest (Json::objectValue);
+
+        jvRequest["path"]   = jvParams[0u].asString ();
+
+        if (jvParams.size () >= 2)
+            jvParseLedger (jvRequest, jvParams[1u].asString ());
+
+        return jvRequest;
+    }
+
     // fetch_info [clear]
     Json::Value parseFetchInfo (const Json::Value& jvParams)
     {
@@ -395,6 +408,35 @@ private:
         return jvRequest;
     }
 
+    // job_trace [<limit>]
+    Json::Value parseJobTrace (const Json::Value& jvParams)
+    {
+        Json::Value     jvRequest (Json::objectValue);
+
+        if (jvParams.size ())
+            jvRequest["limit"]      = jvParams[0u].asUInt ();
+
+        return jvRequest;
+    }
+
+    // lock_profile [<limit>] [reset]
+    Json::Value parseLockProfile (const Json::Value& jvParams)
+    {
+        Json::Value     jvRequest (Json::objectValue);
+
+        for (unsigned int i = 0; i < jvParams.size (); ++i)
+        {
+            std::string const param = jvParams[i].asString ();
+
+            if (param == "reset")
+                jvRequest["reset"]  = true;
+            else
+                jvRequest["limit"]  = lexicalCastThrow <unsigned int> (param);
+        }
+
+        return jvRequest;
+    }
+
     // json <command> <json>
     Json::Value parseJson (const Json::Value& jvParams)
     {
@@ -846,16 +888,20 @@ public:
             {   "book_offers",          &RPCParser::parseBookOffers,            2,  7   },
             {   "connect",              &RPCParser::parseConnect,               1,  2   },
             {   "consensus_info",       &RPCParser::parseAsIs,                  0,  0   },
+            {   "export_snapshot",      &RPCParser::parseExportSnapshot,        1,  2   },
             {   "feature",              &RPCParser::parseFeature,               0,  2   },
             {   "fetch_info",           &RPCParser::parseFetchInfo,             0,  1   },
             {   "get_counts",           &RPCParser::parseGetCounts,             0,  1   },
+            {   "job_trace",            &RPCParser::parseJobTrace,              0,  1   },
             {   "json",                 &RPCParser::parseJson,                  2,  2   },
             {   "ledger",               &RPCParser::parseLedger,                0,  2   },
             {   "ledger_accept",        &RPCParser::parseAsIs,                  0,  0   },
             {   "ledger_closed",        &RPCParser::parseAsIs,                  0,  0   },
             {   "ledger_current",       &RPCParser::parseAsIs,                  0,  0   },
     //      {   "ledger_entry",         &RPCParser::parseLedgerEntry,          -1, -1   },
+            {   "ledger_data",          &RPCParser::parseLedgerId,              1,  1   },
             {   "ledger_header",        &RPCParser::parseLedgerId,              1,  1   },
+            {   "lock_profile",         &RPCParser::parseLockProfile,           0,  2   },
             {   "log_level",            &RPCParser::parseLogLevel,              0,  2   },
             {   "logrotate",            &RPCParser::parseAsIs,                  0,  0   },
     //      {   "nickname_info",        &RPCParser::parseNicknameInfo,          1,  1   },
@@ -999,6 +1045,23 @@ struct RPCCallImp
                       JSONRPCRequest (strMethod, jvParams, Json::Value (1)),
                       mHeaders);
     }
+
+    // Build the request from a pre-rendered body.
+    static void onRequestText (const std::string& strRequest,
+        const std::map<std::string, std::string>& mHeaders, const std::string& strPath,
+            boost::asio::streambuf& sb, const std::string& strHost)
+    {
+        WriteLog (lsDEBUG, RPCParser) << "requestRPC: strPath='" << strPath << "'";
+
+        std::ostream    osRequest (&sb);
+
+        osRequest <<
+                  createHTTPPost (
+                      strHost,
+                      strPath,
+                      strRequest,
+                      mHeaders);
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -1165,3 +1228,36 @@ void RPCCall::fromNetwork (
         boost::posix_time::seconds (RPC_NOTIFY_SECONDS),
         BIND_TYPE (&RPCCallImp::onResponse, callbackFuncP, P_1, P_2, P_3));
 }
+
+void RPCCall::fromNetwork (
+    boost::asio::io_service& io_service,
+    const std::string& strIp, const int iPort,
+    const std::string& strUsername, const std::string& strPassword,
+    const std::string& strPath, const std::string& strRequest,
+    const bool bSSL,
+    FUNCTION_TYPE<void (const Json::Value& jvInput)> callbackFuncP)
+{
+    // HTTP basic authentication
+    std::string strUserPass64 = RPCParser::EncodeBase64 (strUsername + ":" + strPassword);
+
+    std::map<std::string, std::string> mapRequestHeaders;
+
+    mapRequestHeaders["Authorization"] = std::string ("Basic ") + strUserPass64;
+
+    const int RPC_REPLY_MAX_BYTES (128*1024*1024);
+    const int RPC_NOTIFY_SECONDS (30);
+
+    HTTPClient::request (
+        bSSL,
+        io_service,
+        strIp,
+        iPort,
+        BIND_TYPE (
+            &RPCCallImp::onRequestText,
+            strRequest,
+            mapRequestHeaders,
+            strPath, P_1, P_2),
+        RPC_REPLY_MAX_BYTES,
+        boost::posix_time::seconds (RPC_NOTIFY_SECONDS),
+        BIND_TYPE (&RPCCallImp::onResponse, callbackFuncP, P_1, P_2, P_3));
+}
@@ -42,6 +42,15 @@ public:
         const std::string& strPath, const std::string& strMethod,
         const Json::Value& jvParams, const bool bSSL,
         FUNCTION_TYPE<void (const Json::Value& jvInput)> callbackFuncP = FUNCTION_TYPE<void (const Json::Value& jvInput)> ());
+
+    /** Post a JSON-RPC request whose body has already been rendered. */
+    static void fromNetwork (
+        boost::asio::io_service& io_service,
+        const std::string& strIp, const int iPort,
+        const std::string& strUsername, const std::string& strPassword,
+        const std::string& strPath, const std::string& strRequest,
+        const bool bSSL,
+        FUNCTION_TYPE<void (const Json::Value& jvInput)> callbackFuncP = FUNCTION_TYPE<void (const Json::Value& jvInput)> ());
 };
 
 #endif
@@ -69,6 +69,11 @@ public:
     }
 
     void send (const Json::Value& jvObj, bool broadcast)
+    {
+        send (EventPayload::New (jvObj), broadcast);
+    }
+
+    void send (EventPayload::ref payload, bool broadcast)
     {
         ScopedLockType sl (mLock, __FILE__, __LINE__);
 
@@ -80,9 +85,9 @@ public:
         }
 
         WriteLog (broadcast ? lsDEBUG : lsINFO, RPCSub) <<
-            "RPCCall::fromNetwork push: " << jvObj;
+            "RPCCall::fromNetwork push: " << payload->getJson ();
 
-        mDeque.push_back (std::make_pair (mSeq++, jvObj));
+        mDeque.push_back (std::make_pair (mSeq++, payload));
 
         if (!mSending)
         {
@@ -114,7 +119,7 @@ private:
     // XXX Could probably create a bunch of send jobs in a single get of the lock.
     void sendThread ()
     {
-        Json::Value jvEvent;
+        std::string strRequest;
         bool bSend;
 
         do
@@ -130,12 +135,16 @@ private:
                 }
                 else
                 {
-                    std::pair<int, Json::Value> pEvent  = mDeque.front ();
+                    std::pair<int, EventPayload::pointer> pEvent  = mDeque.front ();
 
                     mDeque.pop_front ();
 
-                    jvEvent     = pEvent.second;
-                    jvEvent["seq"]  = pEvent.first;
+                    // The event is shared with other subscribers, so splice
+                    // our sequence number into its rendering instead of
+                    // building and serializing a private copy.
+                    strRequest  = "{\"id\":1,\"method\":\"event\",\"params\":["
+                        + pEvent.second->getTextWith ("seq", pEvent.first)
+                        + "]}\n";
 
                     bSend       = true;
                 }
@@ -153,8 +162,8 @@ private:
                         m_io_service,
                         mIp, mPort,
                         mUsername, mPassword,
-                        mPath, "event",
-                        jvEvent,
+                        mPath,
+                        strRequest,
                         mSSL);
                 }
                 catch (const std::exception& e)
@@ -188,7 +197,7 @@ private:
 
     bool                    mSending;                   // Sending threead is active.
 
-    std::deque<std::pair<int, Json::Value> >    mDeque;
+    std::deque<std::pair<int, EventPayload::pointer> >  mDeque;
 };
 
 //------------------------------------------------------------------------------